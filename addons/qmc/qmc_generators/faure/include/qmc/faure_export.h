@@ -0,0 +1,42 @@
+
+#ifndef FAURE_EXPORT_H
+#define FAURE_EXPORT_H
+
+#ifdef FAURE_STATIC_DEFINE
+#  define FAURE_EXPORT
+#  define FAURE_NO_EXPORT
+#else
+#  ifndef FAURE_EXPORT
+#    ifdef alsvinn_qmc_faure_EXPORTS
+        /* We are building this library */
+#      define FAURE_EXPORT __attribute__((visibility("default")))
+#    else
+        /* We are using this library */
+#      define FAURE_EXPORT __attribute__((visibility("default")))
+#    endif
+#  endif
+
+#  ifndef FAURE_NO_EXPORT
+#    define FAURE_NO_EXPORT __attribute__((visibility("hidden")))
+#  endif
+#endif
+
+#ifndef FAURE_DEPRECATED
+#  define FAURE_DEPRECATED __attribute__ ((__deprecated__))
+#endif
+
+#ifndef FAURE_DEPRECATED_EXPORT
+#  define FAURE_DEPRECATED_EXPORT FAURE_EXPORT FAURE_DEPRECATED
+#endif
+
+#ifndef FAURE_DEPRECATED_NO_EXPORT
+#  define FAURE_DEPRECATED_NO_EXPORT FAURE_NO_EXPORT FAURE_DEPRECATED
+#endif
+
+#if 0 /* DEFINE_NO_DEPRECATED */
+#  ifndef FAURE_NO_DEPRECATED
+#    define FAURE_NO_DEPRECATED
+#  endif
+#endif
+
+#endif /* FAURE_EXPORT_H */
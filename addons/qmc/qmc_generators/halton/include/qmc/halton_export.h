@@ -0,0 +1,42 @@
+
+#ifndef HALTON_EXPORT_H
+#define HALTON_EXPORT_H
+
+#ifdef HALTON_STATIC_DEFINE
+#  define HALTON_EXPORT
+#  define HALTON_NO_EXPORT
+#else
+#  ifndef HALTON_EXPORT
+#    ifdef alsvinn_qmc_halton_EXPORTS
+        /* We are building this library */
+#      define HALTON_EXPORT __attribute__((visibility("default")))
+#    else
+        /* We are using this library */
+#      define HALTON_EXPORT __attribute__((visibility("default")))
+#    endif
+#  endif
+
+#  ifndef HALTON_NO_EXPORT
+#    define HALTON_NO_EXPORT __attribute__((visibility("hidden")))
+#  endif
+#endif
+
+#ifndef HALTON_DEPRECATED
+#  define HALTON_DEPRECATED __attribute__ ((__deprecated__))
+#endif
+
+#ifndef HALTON_DEPRECATED_EXPORT
+#  define HALTON_DEPRECATED_EXPORT HALTON_EXPORT HALTON_DEPRECATED
+#endif
+
+#ifndef HALTON_DEPRECATED_NO_EXPORT
+#  define HALTON_DEPRECATED_NO_EXPORT HALTON_NO_EXPORT HALTON_DEPRECATED
+#endif
+
+#if 0 /* DEFINE_NO_DEPRECATED */
+#  ifndef HALTON_NO_DEPRECATED
+#    define HALTON_NO_DEPRECATED
+#  endif
+#endif
+
+#endif /* HALTON_EXPORT_H */
@@ -0,0 +1,42 @@
+
+#ifndef HALTON409_EXPORT_H
+#define HALTON409_EXPORT_H
+
+#ifdef HALTON409_STATIC_DEFINE
+#  define HALTON409_EXPORT
+#  define HALTON409_NO_EXPORT
+#else
+#  ifndef HALTON409_EXPORT
+#    ifdef alsvinn_qmc_halton409_EXPORTS
+        /* We are building this library */
+#      define HALTON409_EXPORT __attribute__((visibility("default")))
+#    else
+        /* We are using this library */
+#      define HALTON409_EXPORT __attribute__((visibility("default")))
+#    endif
+#  endif
+
+#  ifndef HALTON409_NO_EXPORT
+#    define HALTON409_NO_EXPORT __attribute__((visibility("hidden")))
+#  endif
+#endif
+
+#ifndef HALTON409_DEPRECATED
+#  define HALTON409_DEPRECATED __attribute__ ((__deprecated__))
+#endif
+
+#ifndef HALTON409_DEPRECATED_EXPORT
+#  define HALTON409_DEPRECATED_EXPORT HALTON409_EXPORT HALTON409_DEPRECATED
+#endif
+
+#ifndef HALTON409_DEPRECATED_NO_EXPORT
+#  define HALTON409_DEPRECATED_NO_EXPORT HALTON409_NO_EXPORT HALTON409_DEPRECATED
+#endif
+
+#if 0 /* DEFINE_NO_DEPRECATED */
+#  ifndef HALTON409_NO_DEPRECATED
+#    define HALTON409_NO_DEPRECATED
+#  endif
+#endif
+
+#endif /* HALTON409_EXPORT_H */
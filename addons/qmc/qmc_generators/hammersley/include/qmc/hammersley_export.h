@@ -0,0 +1,42 @@
+
+#ifndef HAMMERSLEY_EXPORT_H
+#define HAMMERSLEY_EXPORT_H
+
+#ifdef HAMMERSLEY_STATIC_DEFINE
+#  define HAMMERSLEY_EXPORT
+#  define HAMMERSLEY_NO_EXPORT
+#else
+#  ifndef HAMMERSLEY_EXPORT
+#    ifdef alsvinn_qmc_hammersley_EXPORTS
+        /* We are building this library */
+#      define HAMMERSLEY_EXPORT __attribute__((visibility("default")))
+#    else
+        /* We are using this library */
+#      define HAMMERSLEY_EXPORT __attribute__((visibility("default")))
+#    endif
+#  endif
+
+#  ifndef HAMMERSLEY_NO_EXPORT
+#    define HAMMERSLEY_NO_EXPORT __attribute__((visibility("hidden")))
+#  endif
+#endif
+
+#ifndef HAMMERSLEY_DEPRECATED
+#  define HAMMERSLEY_DEPRECATED __attribute__ ((__deprecated__))
+#endif
+
+#ifndef HAMMERSLEY_DEPRECATED_EXPORT
+#  define HAMMERSLEY_DEPRECATED_EXPORT HAMMERSLEY_EXPORT HAMMERSLEY_DEPRECATED
+#endif
+
+#ifndef HAMMERSLEY_DEPRECATED_NO_EXPORT
+#  define HAMMERSLEY_DEPRECATED_NO_EXPORT HAMMERSLEY_NO_EXPORT HAMMERSLEY_DEPRECATED
+#endif
+
+#if 0 /* DEFINE_NO_DEPRECATED */
+#  ifndef HAMMERSLEY_NO_DEPRECATED
+#    define HAMMERSLEY_NO_DEPRECATED
+#  endif
+#endif
+
+#endif /* HAMMERSLEY_EXPORT_H */
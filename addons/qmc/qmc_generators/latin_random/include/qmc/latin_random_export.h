@@ -0,0 +1,42 @@
+
+#ifndef LATIN_RANDOM_EXPORT_H
+#define LATIN_RANDOM_EXPORT_H
+
+#ifdef LATIN_RANDOM_STATIC_DEFINE
+#  define LATIN_RANDOM_EXPORT
+#  define LATIN_RANDOM_NO_EXPORT
+#else
+#  ifndef LATIN_RANDOM_EXPORT
+#    ifdef alsvinn_qmc_latin_random_EXPORTS
+        /* We are building this library */
+#      define LATIN_RANDOM_EXPORT __attribute__((visibility("default")))
+#    else
+        /* We are using this library */
+#      define LATIN_RANDOM_EXPORT __attribute__((visibility("default")))
+#    endif
+#  endif
+
+#  ifndef LATIN_RANDOM_NO_EXPORT
+#    define LATIN_RANDOM_NO_EXPORT __attribute__((visibility("hidden")))
+#  endif
+#endif
+
+#ifndef LATIN_RANDOM_DEPRECATED
+#  define LATIN_RANDOM_DEPRECATED __attribute__ ((__deprecated__))
+#endif
+
+#ifndef LATIN_RANDOM_DEPRECATED_EXPORT
+#  define LATIN_RANDOM_DEPRECATED_EXPORT LATIN_RANDOM_EXPORT LATIN_RANDOM_DEPRECATED
+#endif
+
+#ifndef LATIN_RANDOM_DEPRECATED_NO_EXPORT
+#  define LATIN_RANDOM_DEPRECATED_NO_EXPORT LATIN_RANDOM_NO_EXPORT LATIN_RANDOM_DEPRECATED
+#endif
+
+#if 0 /* DEFINE_NO_DEPRECATED */
+#  ifndef LATIN_RANDOM_NO_DEPRECATED
+#    define LATIN_RANDOM_NO_DEPRECATED
+#  endif
+#endif
+
+#endif /* LATIN_RANDOM_EXPORT_H */
@@ -0,0 +1,42 @@
+
+#ifndef SOBOL_EXPORT_H
+#define SOBOL_EXPORT_H
+
+#ifdef SOBOL_STATIC_DEFINE
+#  define SOBOL_EXPORT
+#  define SOBOL_NO_EXPORT
+#else
+#  ifndef SOBOL_EXPORT
+#    ifdef alsvinn_qmc_sobol_EXPORTS
+        /* We are building this library */
+#      define SOBOL_EXPORT __attribute__((visibility("default")))
+#    else
+        /* We are using this library */
+#      define SOBOL_EXPORT __attribute__((visibility("default")))
+#    endif
+#  endif
+
+#  ifndef SOBOL_NO_EXPORT
+#    define SOBOL_NO_EXPORT __attribute__((visibility("hidden")))
+#  endif
+#endif
+
+#ifndef SOBOL_DEPRECATED
+#  define SOBOL_DEPRECATED __attribute__ ((__deprecated__))
+#endif
+
+#ifndef SOBOL_DEPRECATED_EXPORT
+#  define SOBOL_DEPRECATED_EXPORT SOBOL_EXPORT SOBOL_DEPRECATED
+#endif
+
+#ifndef SOBOL_DEPRECATED_NO_EXPORT
+#  define SOBOL_DEPRECATED_NO_EXPORT SOBOL_NO_EXPORT SOBOL_DEPRECATED
+#endif
+
+#if 0 /* DEFINE_NO_DEPRECATED */
+#  ifndef SOBOL_NO_DEPRECATED
+#    define SOBOL_NO_DEPRECATED
+#  endif
+#endif
+
+#endif /* SOBOL_EXPORT_H */
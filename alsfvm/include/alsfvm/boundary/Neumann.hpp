@@ -34,6 +34,15 @@ public:
                     z + sign * (boundaryCell - 1) * zDir);
     }
 
+    //! The layer (index along one direction, ghost cells included) the
+    //! ghost layer is copied from. n is the total number of cells in the
+    //! direction.
+    __device__ __host__ static int getSourceLayer(int layer,
+        int numberOfGhostCells, int n) {
+        return layer < numberOfGhostCells ? 2 * numberOfGhostCells - 1 - layer
+            : 2 * (n - numberOfGhostCells) - 1 - layer;
+    }
+
 };
 }
 }
@@ -41,6 +41,15 @@ public:
                     z + sign * (-boundaryCell + nz) * zDir);
     }
 
+    //! The layer (index along one direction, ghost cells included) the
+    //! ghost layer is copied from. n is the total number of cells in the
+    //! direction.
+    __device__ __host__ static int getSourceLayer(int layer,
+        int numberOfGhostCells, int n) {
+        const int innerCells = n - 2 * numberOfGhostCells;
+        return layer < numberOfGhostCells ? layer + innerCells : layer - innerCells;
+    }
+
 };
 }
 }
@@ -39,6 +39,14 @@ public:
 
     void setWriterFactory(std::shared_ptr<io::WriterFactory> writerFactory);
 
+    //! Makes the simulator advance ensembleSize samples at once, see
+    //! simulator::SimulatorParameters::setEnsembleSize. The simulator can
+    //! then not have any writers or functionals of its own, and does not
+    //! support diffusion nor domain decomposition.
+    //!
+    //! Has to be called *before* readSetupFromFile.
+    void setEnsembleSize(size_t ensembleSize);
+
 #ifdef ALSVINN_USE_MPI
 
     //! Call to enable mpi. Has to be called *before* readSetupFromFile.
@@ -47,6 +55,14 @@ public:
     //! Call to enable mpi. Has to be called *before* readSetupFromFile.
     void enableMPI(mpi::ConfigurationPtr configuration, int multiX, int multiY,
         int multiZ);
+
+    //! Call to enable mpi, where the number of processors in each direction
+    //! is chosen to minimize the communication, see
+    //! CartesianDecomposition::findNumberOfProcessorsPerDirection. The ranks
+    //! may be reordered to match the hardware.
+    //!
+    //! Has to be called *before* readSetupFromFile.
+    void enableMPI(MPI_Comm communicator);
 #endif
 protected:
 
@@ -78,19 +94,35 @@ protected:
         simulator::SimulatorParameters& parameters);
 
     std::string readFlux(const ptree& configuration);
+    std::string readFluxEngine(const ptree& configuration);
+    real readIntegratorTolerance(const ptree& configuration);
+    size_t readHaloStages(const ptree& configuration);
+    size_t readConstraintCheckInterval(const ptree& configuration);
+    bool readPrimitiveCache(const ptree& configuration);
+
+    //! Throws if the configuration can not be used for an ensemble
+    void checkEnsembleConfiguration(const ptree& configuration);
 
     std::shared_ptr<io::WriterFactory> writerFactory{new io::WriterFactory};
+    size_t ensembleSize{1};
     std::string basePath;
 
 
 #ifdef ALSVINN_USE_MPI
+    //! @param requireEvenBlocks every processor has to get the same number
+    //!        of cells (needed by the functionals)
     mpi::domain::DomainInformationPtr decomposeGrid(const
-        alsfvm::shared_ptr<grid::Grid>& grid);
+        alsfvm::shared_ptr<grid::Grid>& grid, bool requireEvenBlocks);
+
+    //! Reads fvm.waveSpeedReduction and sets up the cell exchanger for it
+    void setupWaveSpeedReduction(const ptree& configuration,
+        mpi::CellExchangerPtr cellExchanger);
     bool useMPI{false};
     mpi::ConfigurationPtr mpiConfiguration;
     int multiX;
     int multiY;
     int multiZ;
+    bool automaticDecomposition{false};
 #endif
 
     //! Loops through all the configuration and looks for the pattern
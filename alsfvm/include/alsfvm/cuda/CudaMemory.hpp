@@ -24,13 +24,27 @@ public:
     /// \param nx the number of cells in x direction
     /// \param ny the number of cells in y direction
     /// \param nz the number of cells in z direction
+    /// \param pooled take the device memory from (and return it to) the
+    ///        device memory pool, see alsutils::memory::MemoryPool
     ///
-    CudaMemory(size_t nx, size_t ny = 1, size_t nz = 1);
+    CudaMemory(size_t nx, size_t ny = 1, size_t nz = 1, bool pooled = false);
+
+    ///
+    /// Makes the memory area a view of the elements
+    /// [offset, offset + nx * ny * nz) of storage. The storage is kept
+    /// alive for as long as this memory area lives.
+    ///
+    CudaMemory(std::shared_ptr<CudaMemory<T> > storage, size_t offset,
+        size_t nx, size_t ny, size_t nz);
 
 
-    //! Clones the memory area, but *does not copy the content*
+    //! Clones the memory area, but *does not copy the content*. The clone
+    //! is pooled if this memory area is.
     virtual std::shared_ptr<memory::Memory<T> > makeInstance() const override;
 
+    //! Whether the device memory is taken from the device memory pool
+    bool isPooled() const;
+
     // Note: Virtual distructor since we will inherit
     // from this.
     virtual ~CudaMemory();
@@ -157,6 +171,11 @@ public:
         T a4, const memory::Memory<T>& v4,
         T a5, const memory::Memory<T>& v5) override;
 
+    //! Evaluates the linear combination and stores it in this memory area,
+    //! in a single kernel launch.
+    virtual void assign(const memory::LinearCombination<memory::Memory<T>, T>&
+        combination) override;
+
 
 
     //! Adds a power of the other memory area to this memory area, ie
@@ -218,7 +237,12 @@ public:
 
 
 private:
+    const bool pooled;
     T* memoryPointer;
+
+    //! The memory area we are a view of (if any), in which case we do not
+    //! own memoryPointer
+    std::shared_ptr<CudaMemory<T> > storage;
 };
 
 }
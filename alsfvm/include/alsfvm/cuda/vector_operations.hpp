@@ -122,6 +122,18 @@ void add_linear_combination(T a1, T* v1,
     T a5, const T* v5,
     size_t size);
 
+//! Computes the linear combination
+//! \f[\mathrm{result}=\sum_{i=1}^{n} a_iv_i\f]
+//! in one kernel launch.
+//! \param result the device memory to write to (can be one of the operands)
+//! \param coefficients the n coefficients (host memory)
+//! \param operands the n device pointers (host array)
+//! \param numberOfTerms n, at most memory::LinearCombination::maximumNumberOfTerms
+//! \param size the size of the memory (in T)
+template<class T>
+void linear_combination(T* result, const T* coefficients,
+    const T* const* operands, size_t numberOfTerms, size_t size);
+
 //! Basically runs
 //!
 //! \f[a += pow(b,power)\f]
@@ -54,6 +54,12 @@ public:
     virtual bool obeysConstraints(const volume::Volume& conservedVariables)
     override;
 
+    ///
+    /// Checks the constraints of all cells as one parallel reduction
+    ///
+    virtual ConstraintReport checkConstraints(const volume::Volume&
+        conservedVariables) override;
+
     ///
     /// \brief computeFromPrimitive computes the conserved and extra variables based
     ///                             on the primtive variables
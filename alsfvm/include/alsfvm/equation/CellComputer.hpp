@@ -15,6 +15,7 @@
 
 #pragma once
 #include "alsfvm/volume/Volume.hpp"
+#include "alsfvm/equation/ConstraintReport.hpp"
 
 namespace alsfvm {
 namespace equation {
@@ -60,6 +61,14 @@ public:
     ///
     virtual bool obeysConstraints(const volume::Volume& conservedVariables) = 0;
 
+    ///
+    /// Same check as obeysConstraints, but also tells which constraints are
+    /// violated, in how many cells, and the first cell. The default only
+    /// calls obeysConstraints, so the cells and the index are not known.
+    ///
+    virtual ConstraintReport checkConstraints(const volume::Volume&
+        conservedVariables);
+
     ///
     /// \brief computeFromPrimitive computes the conserved and extra variables based
     ///                             on the primtive variables
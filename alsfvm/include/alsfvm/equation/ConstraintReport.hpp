@@ -0,0 +1,101 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include "alsfvm/types.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+
+namespace alsfvm {
+namespace equation {
+
+//! Summary of a constraint check over a volume, see
+//! CellComputer::checkConstraints.
+//!
+//! Reports of different cells are combined with merge, so the check can be
+//! done as a parallel reduction, or folded into any sweep over the cells
+//! that already computes the extra variables (see checkCellConstraints).
+struct ConstraintReport {
+    enum Violation : unsigned int {
+        //! Some conserved variable is nan or inf
+        conservedNotFinite = 1,
+        //! Some extra variable (eg. pressure) is nan or inf
+        extraNotFinite = 2,
+        //! Equation::obeysConstraints failed (eg. negative density)
+        equationConstraints = 4
+    };
+
+    //! Bitwise or of the violations found
+    unsigned int violations = 0;
+
+    size_t numberOfViolatingCells = 0;
+
+    //! The lowest index of a cell violating the constraints. Left at the
+    //! maximum value if the index is not known.
+    size_t firstViolatingIndex = std::numeric_limits<size_t>::max();
+
+    bool obeys() const {
+        return violations == 0;
+    }
+
+    ConstraintReport& merge(const ConstraintReport& other) {
+        violations |= other.violations;
+        numberOfViolatingCells += other.numberOfViolatingCells;
+        firstViolatingIndex = std::min(firstViolatingIndex, other.firstViolatingIndex);
+        return *this;
+    }
+
+    //! A one line description, eg. "2 cells violate the constraints
+    //! (equation constraints), the first at index 37"
+    std::string toString() const;
+};
+
+//! Checks the constraints of one cell
+template<class Equation>
+ConstraintReport checkCellConstraints(const Equation& equation,
+    const typename Equation::ConservedVariables& conserved,
+    const typename Equation::ExtraVariables& extra,
+    size_t index) {
+    ConstraintReport report;
+    const real* conservedAsRealPtr = (const real*)&conserved;
+
+    for (size_t i = 0; i < sizeof(conserved) / sizeof(real); i++) {
+        if (!std::isfinite(conservedAsRealPtr[i])) {
+            report.violations |= ConstraintReport::conservedNotFinite;
+        }
+    }
+
+    const real* extraAsRealPtr = (const real*)&extra;
+
+    for (size_t i = 0; i < sizeof(extra) / sizeof(real); i++) {
+        if (!std::isfinite(extraAsRealPtr[i])) {
+            report.violations |= ConstraintReport::extraNotFinite;
+        }
+    }
+
+    if (!equation.obeysConstraints(conserved, extra)) {
+        report.violations |= ConstraintReport::equationConstraints;
+    }
+
+    if (!report.obeys()) {
+        report.numberOfViolatingCells = 1;
+        report.firstViolatingIndex = index;
+    }
+
+    return report;
+}
+} // namespace equation
+} // namespace alsfvm
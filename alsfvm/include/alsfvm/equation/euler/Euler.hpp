@@ -100,6 +100,18 @@ public:
                 views.E.at(index));
     }
 
+    ///
+    /// Fetches the conserved variables and the already computed extra
+    /// variables from memory (no division by rho is done).
+    ///
+    __device__ __host__ AllVariables fetchAllVariables(ConstViews& views,
+        ConstViewsExtra& viewsExtra, size_t index) const {
+        return AllVariables(views.rho.at(index),
+                views.m(index).template convert<real>(),
+                views.E.at(index), viewsExtra.p.at(index),
+                viewsExtra.u(index).template convert<real>());
+    }
+
     template<class T, class S>
     __device__ __host__ static ConservedVariables fetchConservedVariables(
         euler::Views<T, S, nsd>& views, size_t index) {
@@ -0,0 +1,119 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsfvm/integrator/Integrator.hpp"
+#include "alsfvm/integrator/System.hpp"
+
+namespace alsfvm {
+namespace integrator {
+
+///
+/// Adaptive Bogacki-Shampine 3(2) embedded Runge-Kutta pair, see
+///
+/// P. Bogacki and L. F. Shampine, A 3(2) pair of Runge-Kutta formulas,
+/// Appl. Math. Lett. 2(4) (1989)
+///
+/// The third order solution is propagated, and the difference to the
+/// embedded second order solution is used as a local error estimate
+/// \f[\mathrm{err}=\max_{i}\frac{|e_i|}{\mathrm{tol}(1 + \max(|u^n_i|, |u^{n+1}_i|))}\f]
+/// (maximum over all cells and variables). The step is accepted if
+/// \f$\mathrm{err}\leq 1\f$, and the next timestep is
+/// \f[\Delta t_{\mathrm{new}} = \Delta t\cdot\min(5, \max(0.2, 0.9\,\mathrm{err}^{-1/3}))\f]
+/// (not growing after a rejection). The timestep is always capped by the
+/// CFL timestep and the timestep adjusters.
+///
+/// The registers are
+///   * 0: the solution \f$u^n\f$ (untouched, so a rejected step can be redone)
+///   * 1: scratch space for the flux
+///   * 2: the intermediate stages
+///   * 3: the new solution \f$u^{n+1}\f$
+///   * 4: the error estimate
+///
+class BogackiShampine : public Integrator {
+public:
+    ///
+    /// \param system the system to integrate
+    /// \param tolerance the (relative and absolute) error tolerance per step
+    ///
+    BogackiShampine(alsfvm::shared_ptr<System> system, real tolerance);
+
+    ///
+    /// \returns 4 (the last stage is only used for the error estimate)
+    ///
+    virtual size_t getNumberOfSubsteps() const override;
+
+    ///
+    /// \returns 5
+    ///
+    virtual size_t getNumberOfRegisters() const override;
+
+    ///
+    /// \returns 2 for the first two substeps and 3 afterwards
+    ///
+    virtual size_t getOutputRegister(size_t substep) const override;
+
+    ///
+    /// \returns 3
+    ///
+    virtual size_t getSolutionRegister() const override;
+
+    ///
+    /// \returns true if the error estimate of the last step was within
+    ///          the tolerance.
+    ///
+    virtual bool isStepAccepted() const override;
+
+    ///
+    /// Performs one stage of the method. The error estimate is computed in
+    /// the last substep.
+    ///
+    /// \param inputConserved the five registers (see class documentation)
+    /// \param spatialCellSizes should be the cell size in each direction
+    /// \param dt is the timestep
+    /// \param substep is the currently computed substep, starting at 0.
+    /// \param output where to write the output (see getOutputRegister)
+    /// \param cfl the cfl number to use.
+    /// \param timestepInformation the current timestepInformation (needed for current time)
+    /// \returns the newly computed timestep (computed in the first substep)
+    ///
+    virtual real performSubstep( std::vector<alsfvm::shared_ptr< volume::Volume> >&
+        inputConserved,
+        rvec3 spatialCellSizes, real dt, real cfl,
+        volume::Volume& output, size_t substep,
+        const simulator::TimestepInformation& timestepInformation) override;
+
+    ///
+    /// \returns the number of rejected steps so far
+    ///
+    size_t getNumberOfRejectedSteps() const;
+
+private:
+    //! Computes the scaled maximum norm of the error estimate
+    real computeErrorNorm(const volume::Volume& solution,
+        const volume::Volume& newSolution,
+        const volume::Volume& error) const;
+
+    alsfvm::shared_ptr<System> system;
+    const real tolerance;
+
+    //! The timestep proposed by the step size controller (infinite at
+    //! the start, so the first step is taken at the CFL timestep)
+    real proposedTimestep;
+    bool accepted = true;
+    size_t numberOfRejectedSteps = 0;
+};
+} // namespace integrator
+} // namespace alsfvm
@@ -33,18 +33,18 @@ namespace integrator {
 /// so that it can be run in the following manner
 /// \code{.cpp}
 /// // PSEUDOCODE!!!
-/// // For each substep we need one buffer to hold the output
-/// buffers = makeBuffers(integrator.getNumberOfSubsteps());
+/// // The integrator tells us how many buffers (registers) it needs
+/// buffers = makeBuffers(integrator.getNumberOfRegisters());
 /// setupInput(buffers[0]);
 /// const size_t numberOfSubsteps = integrator.getNumberOfSubsteps();
 /// while(t < tEnd) {
 ///
 ///    for(size_t subStep = 0; subStep < numberOfSubsteps; subStep++) {
-///
-///        integrator.performSubstep(buffers[subStep].conserved(),
-///                                  buffers[(subStep+1) % numberOfSubsteps].conserved(), substep);
-///        buffers[(subStep+1) % numberOfSubsteps].computeExtra();
+///        auto& output = buffers[integrator.getOutputRegister(subStep)];
+///        integrator.performSubstep(buffers, ..., output, subStep, ...);
+///        applyBoundary(output);
 ///     }
+///     swap(buffers[0], buffers[integrator.getSolutionRegister()]);
 ///     t += dt;
 /// }
 /// \endcode
@@ -58,6 +58,72 @@ public:
     ///
     virtual size_t getNumberOfSubsteps() const = 0;
 
+    ///
+    /// Returns the number of full conserved volumes (registers) the
+    /// integrator needs, including the one holding the current solution.
+    /// The caller allocates this many volumes and passes them as
+    /// inputConserved to performSubstep.
+    ///
+    /// The default is one register per substep plus the current solution.
+    /// Low storage integrators overwrite their registers in place and
+    /// need fewer.
+    ///
+    virtual size_t getNumberOfRegisters() const;
+
+    ///
+    /// Returns the index of the register that is written to (and needs
+    /// boundary conditions applied) in the given substep. This is the
+    /// register the caller passes as output to performSubstep.
+    ///
+    /// The default is substep + 1.
+    ///
+    virtual size_t getOutputRegister(size_t substep) const;
+
+    ///
+    /// Returns the index of the register holding the new solution after
+    /// the last substep. The caller swaps this with register 0 before the
+    /// next timestep.
+    ///
+    /// The default is the last register.
+    ///
+    virtual size_t getSolutionRegister() const;
+
+    ///
+    /// Returns the CFL multiplier of the integrator, that is, the SSP
+    /// coefficient relative to forward Euler. The scheme is strong
+    /// stability preserving for timesteps up to this multiple of the
+    /// forward Euler timestep.
+    ///
+    /// computeTimestep scales the given CFL number by this factor, so the
+    /// CFL number in the configuration is always the forward Euler one.
+    /// This also holds for the automatic CFL number, switching eg. from
+    /// rungekutta2 to ssprk104 with the same CFL number makes the timestep
+    /// six times larger (the effective CFL number is logged).
+    ///
+    /// The default is 1.
+    ///
+    virtual real getCFLMultiplier() const;
+
+    ///
+    /// Returns true if the step made by the last sequence of substeps
+    /// should be kept.
+    ///
+    /// Adaptive integrators estimate the local error in their last substep
+    /// and reject the step if it is too large. They leave register 0
+    /// untouched, so the caller can redo the step, eg.
+    /// \code{.cpp}
+    /// do {
+    ///     for (size_t substep = 0; ...) {
+    ///         integrator.performSubstep(...);
+    ///     }
+    /// } while (!integrator.isStepAccepted());
+    /// \endcode
+    /// The next attempt will use a smaller timestep.
+    ///
+    /// The default always accepts.
+    ///
+    virtual bool isStepAccepted() const;
+
     ///
     /// Performs one substep and stores the result to output.
     ///
@@ -81,6 +147,7 @@ public:
 
     ///
     /// Computes the timestep (dt).
+    /// The CFL number is scaled by getCFLMultiplier().
     /// \param[in] waveSpeeds the wave speeds in each direction
     /// \param[in] cellLengths the cell lengths in each direction
     /// \param[in] cfl the CFL number
@@ -108,6 +175,15 @@ protected:
     real adjustTimestep(real dt,
         const simulator::TimestepInformation& timestepInformation) const;
 
+    ///
+    /// \brief reduceMaximum runs the value through the wave speed adjusters.
+    /// With MPI, these take the maximum over all processes, so this is
+    /// used to agree on other maximums (eg. error estimates) as well.
+    /// \param value the local value
+    /// \return the maximum over all processes (or value if no adjusters)
+    ///
+    real reduceMaximum(real value) const;
+
 private:
     std::vector<alsfvm::shared_ptr<TimestepAdjuster> > timestepAdjusters;
     std::vector<WaveSpeedAdjusterPtr > waveSpeedAdjusters;
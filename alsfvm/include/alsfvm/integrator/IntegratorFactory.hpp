@@ -23,13 +23,19 @@ namespace integrator {
 
 class IntegratorFactory {
 public:
-    IntegratorFactory(const std::string& integratorName);
+    ///
+    /// \param integratorName the name of the integrator
+    /// \param tolerance the error tolerance per step for the adaptive
+    ///        integrators (ignored by the others)
+    ///
+    IntegratorFactory(const std::string& integratorName, real tolerance = 1e-4);
     alsfvm::shared_ptr<Integrator> createIntegrator(alsfvm::shared_ptr<System>&
         system);
 
 
 private:
     std::string integratorName;
+    real tolerance;
 
 };
 } // namespace alsfvm
@@ -0,0 +1,102 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsfvm/integrator/Integrator.hpp"
+#include "alsfvm/integrator/System.hpp"
+
+namespace alsfvm {
+namespace integrator {
+
+///
+/// Low storage Runge-Kutta integrator in Williamson's 2N form. Each stage
+/// computes
+/// \f[\Delta U \leftarrow A_i\Delta U + \Delta t F(U)\f]
+/// \f[U \leftarrow U + B_i \Delta U\f]
+/// so that the solution is updated in place. Since the system writes
+/// \f$F(U)\f$ to a separate volume, this uses three conserved volumes
+/// independent of the number of stages (compared to four for RungeKutta3
+/// and five for RungeKutta4).
+///
+/// The registers are
+///   * 0: the solution \f$U\f$ (input and output of every substep)
+///   * 1: the increment \f$\Delta U\f$
+///   * 2: scratch space for \f$F(U)\f$
+///
+/// Supported orders are
+///   * 3: Williamson's three stage, third order scheme (williamson3)
+///   * 4: Carpenter and Kennedy's five stage, fourth order scheme
+///        (carpenterkennedy4)
+///
+/// \note Neither scheme is strong stability preserving, so they may give
+///       oscillations at shocks that RungeKutta2 and RungeKutta3 do not
+///       give. For low storage SSP integration, use SSPRungeKutta3
+///       (ssprk43, ssprk93) or SSPRungeKutta104 (ssprk104), which need the
+///       same three registers.
+///
+class LowStorageRungeKutta : public Integrator {
+public:
+    ///
+    /// \param system the system to integrate
+    /// \param order the order of the scheme (3 or 4)
+    ///
+    LowStorageRungeKutta(alsfvm::shared_ptr<System> system, size_t order);
+
+    ///
+    /// \returns the number of stages (3 for third order, 5 for fourth order)
+    ///
+    virtual size_t getNumberOfSubsteps() const override;
+
+    ///
+    /// \returns 3 (solution, increment and flux)
+    ///
+    virtual size_t getNumberOfRegisters() const override;
+
+    ///
+    /// \returns 0, the solution is updated in place
+    ///
+    virtual size_t getOutputRegister(size_t substep) const override;
+
+    ///
+    /// \returns 0, the solution is updated in place
+    ///
+    virtual size_t getSolutionRegister() const override;
+
+    ///
+    /// Performs one stage of the 2N scheme.
+    ///
+    /// \param inputConserved the three registers (see class documentation)
+    /// \param spatialCellSizes should be the cell size in each direction
+    /// \param dt is the timestep
+    /// \param substep is the currently computed substep, starting at 0.
+    /// \param output must be the same volume as inputConserved[0]
+    /// \param cfl the cfl number to use.
+    /// \param timestepInformation the current timestepInformation (needed for current time)
+    /// \returns the newly computed timestep (computed in the first substep)
+    ///
+    virtual real performSubstep( std::vector<alsfvm::shared_ptr< volume::Volume> >&
+        inputConserved,
+        rvec3 spatialCellSizes, real dt, real cfl,
+        volume::Volume& output, size_t substep,
+        const simulator::TimestepInformation& timestepInformation) override;
+
+private:
+    alsfvm::shared_ptr<System> system;
+
+    std::vector<real> A;
+    std::vector<real> B;
+};
+} // namespace integrator
+} // namespace alsfvm
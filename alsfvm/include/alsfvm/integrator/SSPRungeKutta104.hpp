@@ -0,0 +1,91 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsfvm/integrator/Integrator.hpp"
+#include "alsfvm/integrator/System.hpp"
+
+namespace alsfvm {
+namespace integrator {
+
+///
+/// Ketcheson's ten stage, fourth order strong stability preserving
+/// Runge-Kutta method SSPRK(10,4), see
+///
+/// D. I. Ketcheson, Highly efficient strong stability preserving
+/// Runge-Kutta methods with low-storage implementations,
+/// SIAM J. Sci. Comput. 30(4) (2008)
+///
+/// The SSP coefficient is 6, so each timestep may be six times the forward
+/// Euler timestep (0.6 per flux evaluation, compared to 0.5 for
+/// RungeKutta2 and 1/3 for RungeKutta3).
+///
+/// We use the low storage implementation, the registers are
+///   * 0: the solution (input and output of every substep)
+///   * 1: the second storage register of the method
+///   * 2: scratch space for the flux
+///
+class SSPRungeKutta104 : public Integrator {
+public:
+    SSPRungeKutta104(alsfvm::shared_ptr<System> system);
+
+    ///
+    /// \returns 10
+    ///
+    virtual size_t getNumberOfSubsteps() const override;
+
+    ///
+    /// \returns 3
+    ///
+    virtual size_t getNumberOfRegisters() const override;
+
+    ///
+    /// \returns 0, the solution is updated in place
+    ///
+    virtual size_t getOutputRegister(size_t substep) const override;
+
+    ///
+    /// \returns 0, the solution is updated in place
+    ///
+    virtual size_t getSolutionRegister() const override;
+
+    ///
+    /// \returns 6
+    ///
+    virtual real getCFLMultiplier() const override;
+
+    ///
+    /// Performs one stage of the method.
+    ///
+    /// \param inputConserved the three registers (see class documentation)
+    /// \param spatialCellSizes should be the cell size in each direction
+    /// \param dt is the timestep
+    /// \param substep is the currently computed substep, starting at 0.
+    /// \param output must be the same volume as inputConserved[0]
+    /// \param cfl the cfl number to use.
+    /// \param timestepInformation the current timestepInformation (needed for current time)
+    /// \returns the newly computed timestep (computed in the first substep)
+    ///
+    virtual real performSubstep( std::vector<alsfvm::shared_ptr< volume::Volume> >&
+        inputConserved,
+        rvec3 spatialCellSizes, real dt, real cfl,
+        volume::Volume& output, size_t substep,
+        const simulator::TimestepInformation& timestepInformation) override;
+
+private:
+    alsfvm::shared_ptr<System> system;
+};
+} // namespace integrator
+} // namespace alsfvm
@@ -0,0 +1,98 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsfvm/integrator/Integrator.hpp"
+#include "alsfvm/integrator/System.hpp"
+
+namespace alsfvm {
+namespace integrator {
+
+///
+/// Ketcheson's third order strong stability preserving Runge-Kutta methods
+/// SSPRK(s,3) with \f$s=n^2\f$ stages, see
+///
+/// D. I. Ketcheson, Highly efficient strong stability preserving
+/// Runge-Kutta methods with low-storage implementations,
+/// SIAM J. Sci. Comput. 30(4) (2008)
+///
+/// The SSP coefficient is \f$n^2-n\f$, eg. 2 for SSPRK(4,3) and 6 for
+/// SSPRK(9,3), compared to 1 for RungeKutta3.
+///
+/// We use the low storage implementation, the registers are
+///   * 0: the solution (input and output of every substep)
+///   * 1: the second storage register of the method
+///   * 2: scratch space for the flux
+///
+class SSPRungeKutta3 : public Integrator {
+public:
+    ///
+    /// \param system the system to integrate
+    /// \param numberOfStages the number of stages, has to be a square
+    ///        number greater than one.
+    ///
+    SSPRungeKutta3(alsfvm::shared_ptr<System> system, size_t numberOfStages);
+
+    ///
+    /// \returns the number of stages
+    ///
+    virtual size_t getNumberOfSubsteps() const override;
+
+    ///
+    /// \returns 3
+    ///
+    virtual size_t getNumberOfRegisters() const override;
+
+    ///
+    /// \returns 0, the solution is updated in place
+    ///
+    virtual size_t getOutputRegister(size_t substep) const override;
+
+    ///
+    /// \returns 0, the solution is updated in place
+    ///
+    virtual size_t getSolutionRegister() const override;
+
+    ///
+    /// \returns \f$n^2-n\f$
+    ///
+    virtual real getCFLMultiplier() const override;
+
+    ///
+    /// Performs one stage of the method.
+    ///
+    /// \param inputConserved the three registers (see class documentation)
+    /// \param spatialCellSizes should be the cell size in each direction
+    /// \param dt is the timestep
+    /// \param substep is the currently computed substep, starting at 0.
+    /// \param output must be the same volume as inputConserved[0]
+    /// \param cfl the cfl number to use.
+    /// \param timestepInformation the current timestepInformation (needed for current time)
+    /// \returns the newly computed timestep (computed in the first substep)
+    ///
+    virtual real performSubstep( std::vector<alsfvm::shared_ptr< volume::Volume> >&
+        inputConserved,
+        rvec3 spatialCellSizes, real dt, real cfl,
+        volume::Volume& output, size_t substep,
+        const simulator::TimestepInformation& timestepInformation) override;
+
+private:
+    alsfvm::shared_ptr<System> system;
+
+    //! The square root of the number of stages
+    const size_t n;
+};
+} // namespace integrator
+} // namespace alsfvm
@@ -25,6 +25,14 @@ class WaveSpeedAdjuster {
 public:
     virtual ~WaveSpeedAdjuster() {};
     virtual real adjustWaveSpeed(real waveSpeed)  = 0;
+
+    //! Adjusts the wave speeds in all directions at once, this is called
+    //! once per timestep when computing the timestep. By default calls
+    //! adjustWaveSpeed for each direction.
+    virtual rvec3 adjustWaveSpeeds(const rvec3& waveSpeeds) {
+        return {adjustWaveSpeed(waveSpeeds.x), adjustWaveSpeed(waveSpeeds.y),
+                adjustWaveSpeed(waveSpeeds.z)};
+    }
 };
 
 typedef alsfvm::shared_ptr<WaveSpeedAdjuster> WaveSpeedAdjusterPtr;
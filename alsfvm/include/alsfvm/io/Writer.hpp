@@ -45,6 +45,21 @@ public:
         const simulator::TimestepInformation& timestepInformation) = 0;
 
 
+    //! Writes every member of an ensemble (see volume/ensemble.hpp), called
+    //! by the simulator instead of write when it advances several samples
+    //! at once.
+    //!
+    //! The default implementation copies out one member at a time and calls
+    //! write for it. Writers that can do better (eg. statistics reducing over
+    //! the members first) override this.
+    //!
+    //! \param conservedVariables the ensemble of conserved variables
+    //! \param grid the grid of a single member
+    //! \param timestepInformation the (common) timestep information
+    virtual void writeEnsemble(const volume::Volume& conservedVariables,
+        const grid::Grid& grid,
+        const simulator::TimestepInformation& timestepInformation);
+
     //! This method should be called at the end of the simulation
     virtual void finalize(const grid::Grid& grid,
         const simulator::TimestepInformation& timestepInformation) {}
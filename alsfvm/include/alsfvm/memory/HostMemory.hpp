@@ -17,6 +17,7 @@
 #include <vector>
 #include "alsfvm/memory/Memory.hpp"
 #include "alsfvm/memory/index.hpp"
+#include "alsutils/memory/AlignedAllocator.hpp"
 
 namespace alsfvm {
 namespace memory {
@@ -29,13 +30,32 @@ public:
     /// @param nx the size of the memory area in X (number of T)
     /// @param ny the size of the memory area in Y (number of T)
     /// @param nz the size of the memory area in Z (number of T)
+    /// @param pooled take the storage from (and return it to) the host
+    ///        memory pool, see alsutils::memory::MemoryPool::getHostPool()
     ///
-    HostMemory(size_t nx, size_t ny = 1, size_t nz = 1);
+    HostMemory(size_t nx, size_t ny = 1, size_t nz = 1, bool pooled = false);
 
+    ///
+    /// Makes the memory area a view of the elements
+    /// [offset, offset + nx * ny * nz) of storage. The storage is kept
+    /// alive for as long as this memory area lives. This is used to keep
+    /// all variables of a volume in one allocation, see volume::VolumeLayout.
+    ///
+    HostMemory(std::shared_ptr<HostMemory<T> > storage, size_t offset,
+        size_t nx, size_t ny, size_t nz);
 
-    //! Clones the memory area, but *does not copy the content*
+    //! A copy would keep pointing at the storage of the original, use
+    //! makeInstance and copyFrom instead
+    HostMemory(const HostMemory&) = delete;
+    HostMemory& operator=(const HostMemory&) = delete;
+
+    //! Clones the memory area, but *does not copy the content*. The clone
+    //! is pooled if this memory area is.
     virtual std::shared_ptr<Memory<T> > makeInstance() const override;
 
+    //! Whether the storage is taken from the host memory pool
+    bool isPooled() const;
+
     ///
     /// Checks if the memory area is on the host (CPU) or
     /// on some device, if the latter, one needs to copy to host
@@ -198,6 +218,11 @@ public:
         T a4, const Memory<T>& v4,
         T a5, const Memory<T>& v5) override;
 
+    //! Evaluates the linear combination and stores it in this memory area,
+    //! in a single pass over the data.
+    virtual void assign(const LinearCombination<Memory<T>, T>& combination)
+    override;
+
 
     //! Adds a power of the other memory area to this memory area, ie
     //!
@@ -259,7 +284,18 @@ public:
 
 
 private:
-    std::vector<T> data;
+    const bool pooled;
+
+    //! Aligned and left uninitialized by the allocator, the constructor
+    //! does the first touch according to alsutils::memory::AllocationPolicy.
+    //! Empty if this is a view of another memory area.
+    std::vector<T, alsutils::memory::AlignedAllocator<T> > ownedData;
+
+    //! Either ownedData.data() or a pointer into storage
+    T* data;
+
+    //! The memory area we are a view of (if any)
+    std::shared_ptr<HostMemory<T> > storage;
 };
 
 template<class T>
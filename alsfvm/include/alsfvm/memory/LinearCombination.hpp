@@ -0,0 +1,136 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsfvm/types.hpp"
+#include "alsutils/error/Exception.hpp"
+#include <array>
+
+namespace alsfvm {
+namespace memory {
+
+template<class T>
+class Memory;
+
+//! A lazily evaluated linear combination
+//!
+//! \f[a_1v_1+a_2v_2+\cdots+a_nv_n\f]
+//!
+//! of memory areas (or volumes). Building the expression does not touch
+//! the data, it is evaluated in a single sweep when assigned, eg.
+//! \code{.cpp}
+//! output.assign(0.75 * U0 + 0.25 * U1 + 0.25 * dt * output);
+//! \endcode
+//!
+//! \note The operands are stored by reference, so the expression must be
+//!       assigned before the operands go out of scope. The memory being
+//!       assigned to may itself be one of the operands.
+template<class Operand, class T = real>
+class LinearCombination {
+public:
+    typedef T value_type;
+
+    //! The maximum number of terms in one expression
+    static constexpr size_t maximumNumberOfTerms = 8;
+
+    LinearCombination(T coefficient, const Operand& operand)
+        : numberOfTerms(1) {
+        coefficients[0] = coefficient;
+        operands[0] = &operand;
+    }
+
+    size_t getNumberOfTerms() const {
+        return numberOfTerms;
+    }
+
+    T getCoefficient(size_t term) const {
+        return coefficients[term];
+    }
+
+    const Operand& getOperand(size_t term) const {
+        return *operands[term];
+    }
+
+    //! Appends the terms of other to this expression
+    LinearCombination& operator+=(const LinearCombination& other) {
+        if (numberOfTerms + other.numberOfTerms > maximumNumberOfTerms) {
+            THROW("Too many terms in linear combination, at most "
+                << maximumNumberOfTerms << " are supported.");
+        }
+
+        for (size_t term = 0; term < other.numberOfTerms; ++term) {
+            coefficients[numberOfTerms + term] = other.coefficients[term];
+            operands[numberOfTerms + term] = other.operands[term];
+        }
+
+        numberOfTerms += other.numberOfTerms;
+        return *this;
+    }
+
+    //! Scales every coefficient
+    LinearCombination& operator*=(T scalar) {
+        for (size_t term = 0; term < numberOfTerms; ++term) {
+            coefficients[term] *= scalar;
+        }
+
+        return *this;
+    }
+
+private:
+    std::array<T, maximumNumberOfTerms> coefficients;
+    std::array<const Operand*, maximumNumberOfTerms> operands;
+    size_t numberOfTerms;
+};
+
+template<class Operand, class T>
+LinearCombination<Operand, T> operator+(LinearCombination<Operand, T> a,
+    const LinearCombination<Operand, T>& b) {
+    return a += b;
+}
+
+template<class Operand, class T>
+LinearCombination<Operand, T> operator*(typename
+    LinearCombination<Operand, T>::value_type scalar,
+    LinearCombination<Operand, T> a) {
+    return a *= scalar;
+}
+
+template<class Operand, class T>
+LinearCombination<Operand, T> operator*(LinearCombination<Operand, T> a,
+    typename LinearCombination<Operand, T>::value_type scalar) {
+    return a *= scalar;
+}
+
+template<class Operand, class T>
+LinearCombination<Operand, T> operator-(LinearCombination<Operand, T> a) {
+    return a *= T(-1);
+}
+
+template<class Operand, class T>
+LinearCombination<Operand, T> operator-(LinearCombination<Operand, T> a,
+    const LinearCombination<Operand, T>& b) {
+    return a += -b;
+}
+
+//! Starts a linear combination of memory areas, see LinearCombination
+template<class T>
+LinearCombination<Memory<T>, T> operator*(typename
+    LinearCombination<Memory<T>, T>::value_type scalar,
+    const Memory<T>& memory) {
+    return LinearCombination<Memory<T>, T>(scalar, memory);
+}
+
+} // namespace memory
+} // namespace alsfvm
@@ -18,6 +18,7 @@
 #include "alsfvm/types.hpp"
 #include "alsfvm/memory/MemoryBase.hpp"
 #include "alsfvm/memory/View.hpp"
+#include "alsfvm/memory/LinearCombination.hpp"
 namespace alsfvm {
 namespace memory {
 ///
@@ -273,6 +274,12 @@ public:
         T a4, const Memory<T>& v4,
         T a5, const Memory<T>& v5) = 0;
 
+    //! Evaluates the linear combination and stores it in this memory area,
+    //! in a single pass over the data, ie.
+    //! \f[this = a_1v_1+a_2v_2+\cdots+a_nv_n\f]
+    //! This memory area may itself be one of the operands.
+    virtual void assign(const LinearCombination<Memory<T>, T>& combination) = 0;
+
 
 
     //! Adds a power of the other memory area to this memory area, ie
@@ -20,9 +20,20 @@
 #include "alsfvm/types.hpp"
 #include <functional>
 #include <map>
+#include <vector>
 
 namespace alsfvm {
 namespace memory {
+///
+/// Creates the memory areas for a platform.
+///
+/// If asked to, the memory areas take their storage from a size bucketed
+/// pool (see alsutils::memory::MemoryPool), and return it there when they
+/// are destroyed, so that running many samples or writing many snapshots
+/// of the same size does not allocate anew every time. Instances of the
+/// memory areas (makeInstance) are pooled as well. The hit and miss counts
+/// end up in the run report under report.memoryPools.
+///
 class MemoryFactory {
 public:
     ///
@@ -33,8 +44,11 @@ public:
 
     ///
     /// \param deviceConfiguration the deviceConfiguration to use (this is mostly only relevant for GPU, on CPU it can be empty)
+    /// \param useMemoryPool take the memory from the memory pool of the
+    ///        platform
     ///
-    MemoryFactory(alsfvm::shared_ptr<DeviceConfiguration>& deviceConfiguration);
+    MemoryFactory(alsfvm::shared_ptr<DeviceConfiguration>& deviceConfiguration,
+        bool useMemoryPool = false);
 
     ///
     /// Creates scalar memory of the given size
@@ -47,10 +61,28 @@ public:
     alsfvm::shared_ptr<Memory<real> > createScalarMemory(size_t nx, size_t ny,
         size_t nz);
 
+    ///
+    /// Creates numberOfAreas scalar memory areas of the given size in a
+    /// single allocation, one after the other. Every area starts on a
+    /// cache line boundary, so consecutive areas are
+    /// getContiguousStride(nx, ny, nz) elements apart.
+    ///
+    std::vector<alsfvm::shared_ptr<Memory<real> > > createContiguousScalarMemory(
+        size_t nx, size_t ny, size_t nz, size_t numberOfAreas);
+
+    ///
+    /// The distance (in number of reals) between two areas made by
+    /// createContiguousScalarMemory
+    ///
+    static size_t getContiguousStride(size_t nx, size_t ny, size_t nz);
+
     const std::string& getPlatform() const;
+
+    bool getUseMemoryPool() const;
 private:
 
     alsfvm::shared_ptr<DeviceConfiguration> deviceConfiguration;
+    const bool useMemoryPool;
 };
 
 typedef alsfvm::shared_ptr<MemoryFactory> MemoryFactoryPointer;
@@ -20,13 +20,39 @@
 #include "alsfvm/mpi/MpiIndexType.hpp"
 #include "alsfvm/mpi/Request.hpp"
 #include "alsfvm/mpi/RequestContainer.hpp"
+#include "alsfvm/mpi/LaggedWaveSpeedReduction.hpp"
+#include "alsfvm/mpi/SharedMemoryHalo.hpp"
 
 namespace alsfvm {
 namespace mpi {
 
 //! Does the cell exchange for a cartesian grid.
+//!
+//! There are three ways of doing the exchange (see ExchangeMode):
+//!
+//! * datatypes: one message per variable and side, described by an indexed
+//!   MPI datatype pointing directly into the volume.
+//! * packed: all variables of a side are packed (in parallel) into one
+//!   contiguous buffer and sent as a single message with persistent
+//!   requests that are set up on the first exchange. The received buffers
+//!   are unpacked when their side is completed in the RequestContainer.
+//! * sharedMemory: neighbours on the same node pack their cells into an
+//!   MPI-3 shared memory window, and the ghost cells are unpacked straight
+//!   from the neighbour's buffer, synchronized by flags only (see
+//!   SharedMemoryHalo). These sides are done when exchangeCells returns.
+//!   Neighbours on other nodes are exchanged as in packed mode.
 class CartesianCellExchanger : public CellExchanger {
 public:
+    enum class ExchangeMode {
+        datatypes,
+        packed,
+        sharedMemory
+    };
+
+    //! The mode used when none is given. This is datatypes, unless the
+    //! environment variable ALSVINN_MPI_HALO_EXCHANGE is set to packed or
+    //! shared.
+    static ExchangeMode getDefaultExchangeMode();
 
     //! Constructs a new instance
     //!
@@ -42,17 +68,51 @@ public:
     //!    3   |     < not used > |     top         |    top
     //!    4   |     < not used > |   < not used >  |    front
     //!    5   |     < not used > |   < not used >  |    back
+    //! @param exchangeMode how to send the cells, see ExchangeMode
     CartesianCellExchanger(ConfigurationPtr& configuration,
-        const ivec6& neighbours);
+        const ivec6& neighbours,
+        ExchangeMode exchangeMode = getDefaultExchangeMode());
 
     //! Does the exchange of data
+    //!
+    //! The requests receiving the ghost cells of a side are in the group
+    //! with the same index as the side (see RequestContainer::waitForAnyGroup).
+    //!
+    //! \note In packed mode the ghost cells of a side of outputVolume are
+    //!       only written once its group is completed in the returned
+    //!       container. In sharedMemory mode the on-node sides have no
+    //!       group, their ghost cells are written before this returns.
     virtual RequestContainer exchangeCells(alsfvm::volume::Volume& outputVolume,
         const alsfvm::volume::Volume& inputVolume) override;
 
+    //! Same as exchangeCells, but only for the two sides in the given
+    //! direction (see CellExchanger::exchangeCellsInDirection).
+    virtual RequestContainer exchangeCellsInDirection(
+        alsfvm::volume::Volume& outputVolume,
+        const alsfvm::volume::Volume& inputVolume, int direction) override;
+
+    ExchangeMode getExchangeMode() const;
+
     bool hasSide(int side) const;
 
+    //! Is the side exchanged with MPI messages? This is every side with a
+    //! neighbour, except the ones going through shared memory.
+    bool hasMessageSide(int side) const;
+
     real max(real value) override;
 
+    //! One reduction for all three components
+    rvec3 componentwiseMax(const rvec3& values) override;
+
+    //! Uses a lagged estimate of the global wave speeds instead of waiting
+    //! for the maximum over all processors every timestep, see
+    //! LaggedWaveSpeedReduction. Other maxima (max and componentwiseMax)
+    //! are still exact.
+    void setLaggedWaveSpeedReduction(real safetyFactor);
+
+    //! Either the lagged estimate, or the exact maximum
+    rvec3 adjustWaveSpeeds(const rvec3& waveSpeeds) override;
+
     ivec6 getNeighbours() const override;
 
 private:
@@ -60,12 +120,63 @@ private:
 
     const ivec6 neighbours;
 
+    const ExchangeMode exchangeMode;
+
+    //! Only set with setLaggedWaveSpeedReduction
+    LaggedWaveSpeedReductionPtr laggedWaveSpeedReduction;
+
     std::vector<MpiIndexTypePtr> datatypesReceive;
     std::vector<MpiIndexTypePtr> datatypesSend;
 
+    //! The cells of one side of one variable, as segments of consecutive
+    //! cells. Used for packing.
+    struct Segments {
+        std::vector<int> displacements;
+        std::vector<int> lengths;
+
+        //! The offset of each segment in the packed buffer (of one variable)
+        std::vector<int> packedOffsets;
+        int numberOfCells = 0;
+    };
+
+    //! For each side
+    std::vector<Segments> segmentsSend;
+    std::vector<Segments> segmentsReceive;
+
+    //! For each side, all variables after each other
+    std::vector<std::vector<real> > buffersSend;
+    std::vector<std::vector<real> > buffersReceive;
+
+    //! For each side (null if there is no neighbour)
+    std::vector<RequestPtr> persistentSends;
+    std::vector<RequestPtr> persistentReceives;
+
+    //! Only in sharedMemory mode
+    SharedMemoryHaloPtr sharedMemoryHalo;
+
+    //! Exchanges the sides in [firstSide, endSide)
+    RequestContainer exchangeSides(volume::Volume& outputVolume,
+        const volume::Volume& inputVolume, int firstSide, int endSide);
+
+    RequestContainer exchangeCellsWithDatatypes(volume::Volume& outputVolume,
+        const volume::Volume& inputVolume, int firstSide, int endSide);
+
+    RequestContainer exchangeCellsPacked(volume::Volume& outputVolume,
+        const volume::Volume& inputVolume, int firstSide, int endSide);
+
+    //! Copies the ghost cells of the on-node sides in [firstSide, endSide)
+    //! through the shared memory window.
+    void exchangeCellsSharedMemory(volume::Volume& outputVolume,
+        const volume::Volume& inputVolume, int firstSide, int endSide);
+
+    void pack(int side, const volume::Volume& inputVolume, real* buffer);
+    void unpack(int side, const real* buffer, volume::Volume& outputVolume);
+
     void createDataTypes(const volume::Volume& volume);
     void createDataTypeSend(int side, const volume::Volume& volume);
     void createDataTypeReceive(int side, const volume::Volume& volume);
+    void createPersistentRequests(const volume::Volume& volume);
+    void createSharedMemoryHalo(const volume::Volume& volume);
 };
 } // namespace mpi
 } // namespace alsfvm
@@ -31,12 +31,31 @@ public:
     virtual RequestContainer exchangeCells(alsfvm::volume::Volume& outputVolume,
         const alsfvm::volume::Volume& inputVolume) = 0;
 
+    //! Exchanges the cells of the two sides in the given direction only.
+    //!
+    //! The cells sent in one direction span the ghost cells of the other
+    //! directions, so exchanging the directions one after the other (waiting
+    //! for each) also fills the ghost cells in the corners.
+    //!
+    //! The default implementation throws, not all exchangers support this.
+    virtual RequestContainer exchangeCellsInDirection(
+        alsfvm::volume::Volume& outputVolume,
+        const alsfvm::volume::Volume& inputVolume, int direction);
+
     //! Does the maximum over all processors
     virtual real max(real number) = 0;
 
+    //! Does the maximum over all processors for each component. By
+    //! default calls max for each component.
+    virtual rvec3 componentwiseMax(const rvec3& values);
+
     //! Does the maximum over all wave speeds across processors
     real adjustWaveSpeed(real waveSpeed);
 
+    //! Does the maximum over all wave speeds across processors, in all
+    //! directions at once
+    rvec3 adjustWaveSpeeds(const rvec3& waveSpeeds) override;
+
     virtual ivec6 getNeighbours() const = 0;
 };
 
@@ -0,0 +1,82 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include "alsfvm/mpi/Configuration.hpp"
+#include "alsfvm/mpi/Request.hpp"
+#include "alsfvm/types.hpp"
+#include <array>
+
+namespace alsfvm {
+namespace mpi {
+
+//! Estimates the global maximum wave speed without waiting for the other
+//! processors.
+//!
+//! Every call starts a non-blocking reduction (MPI_Iallreduce) of the local
+//! wave speeds, which completes in the background while the timestep is
+//! computed, and is waited for in the next call. The wave speeds returned
+//! are the global maximum of the previous call, extrapolated with the
+//! change since the call before that, and divided by the safety factor.
+//! The estimate is the same on all processors, so they all get the same
+//! timestep.
+//!
+//! If the global maximum of the previous call turns out to be larger than
+//! the estimate that was used for it, the CFL condition was violated for
+//! that timestep. That timestep has already been taken and is not redone,
+//! the current call only waits for its own reduction and returns the exact
+//! maximum instead of an estimate. The same is done on the first call.
+//!
+//! \note Must be called the same number of times on all processors.
+class LaggedWaveSpeedReduction {
+public:
+    LaggedWaveSpeedReduction(ConfigurationPtr configuration,
+        real safetyFactor);
+
+    //! Returns the wave speeds to use in each direction (see class
+    //! description)
+    rvec3 estimateMaximum(const rvec3& localWaveSpeeds);
+
+    //! The number of times the global maximum was larger than the estimate
+    size_t getNumberOfUnderestimates() const;
+
+    real getSafetyFactor() const;
+
+private:
+    ConfigurationPtr configuration;
+    const real safetyFactor;
+
+    //! The buffers of the reduction in flight
+    std::array<real, 3> localBuffer;
+    std::array<real, 3> globalBuffer;
+    RequestPtr reduction;
+
+    //! The last two global maxima, and how many we have had
+    rvec3 lastMaximum;
+    rvec3 secondLastMaximum;
+    size_t numberOfMaxima{0};
+
+    //! The value returned by the last call
+    rvec3 lastEstimate;
+
+    size_t numberOfUnderestimates{0};
+
+    //! Waits for the reduction in flight, returns the global maximum
+    rvec3 finishReduction();
+};
+
+typedef alsfvm::shared_ptr<LaggedWaveSpeedReduction>
+LaggedWaveSpeedReductionPtr;
+} // namespace mpi
+} // namespace alsfvm
@@ -0,0 +1,73 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace alsfvm {
+namespace mpi {
+
+//! A thread that lives as long as the object, and runs one job at a time.
+//!
+//! Used to drive the communication (posting the messages and completing
+//! them as they arrive) while the calling thread computes, without starting
+//! a new thread for every exchange.
+//!
+//! The thread calls MPI, so MPI has to be initialized with
+//! MPI_THREAD_MULTIPLE. Otherwise, make it with runOnThread set to false,
+//! then submit runs the job right away on the calling thread (there is no
+//! overlap, but the calling code stays the same).
+class ProgressThread {
+public:
+    ProgressThread(bool runOnThread = true);
+
+    //! Waits for the current job (if any) and stops the thread.
+    ~ProgressThread();
+
+    ProgressThread(const ProgressThread&) = delete;
+    ProgressThread& operator=(const ProgressThread&) = delete;
+
+    //! Runs the job on the thread and returns immediately. Waits for the
+    //! previous job first.
+    void submit(std::function<void()> job);
+
+    //! Waits until the current job is done. If the job threw an exception,
+    //! it is rethrown here.
+    void wait();
+
+private:
+    std::mutex mutex;
+    std::condition_variable jobChanged;
+
+    std::function<void()> job;
+    bool hasJob{false};
+    bool stop{false};
+    std::exception_ptr exception;
+
+    const bool runOnThread;
+
+    std::thread thread;
+
+    void run();
+};
+
+typedef std::unique_ptr<ProgressThread> ProgressThreadPtr;
+} // namespace mpi
+} // namespace alsfvm
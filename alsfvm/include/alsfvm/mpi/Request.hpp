@@ -19,6 +19,7 @@
 #include "alsfvm/mpi/Configuration.hpp"
 #include "alsfvm/types.hpp"
 #include <memory>
+#include <vector>
 #ifdef ALSVINN_HAVE_CUDA
     #include <thrust/host_vector.h>
 #endif
@@ -45,18 +46,48 @@ public:
     template<class Data>
     static RequestPtr ireceive(Data& receiveBuffer, int count,
         MPI_Datatype datatype,
-        int source, int tag, Configuration configuration);
+        int source, int tag, Configuration& configuration);
 
 
+    //! Maps to MPI_Send_init. The request is persistent, it does nothing
+    //! until start() is called, and can be started again once it has been
+    //! waited for. See https://www.mpich.org/static/docs/v3.1/www3/MPI_Send_init.html
+    static RequestPtr sendInit(const void* buffer, int count,
+        MPI_Datatype datatype, int destination, int tag,
+        Configuration& configuration);
+
+    //! Maps to MPI_Recv_init, see sendInit.
+    static RequestPtr receiveInit(void* buffer, int count,
+        MPI_Datatype datatype, int source, int tag,
+        Configuration& configuration);
+
+    //! Maps to MPI_Iallreduce. The buffers must stay alive until the
+    //! request has been waited for. See https://www.mpich.org/static/docs/v3.1/www3/MPI_Iallreduce.html
+    static RequestPtr iallreduce(const void* sendBuffer, void* receiveBuffer,
+        int count, MPI_Datatype datatype, MPI_Op operation,
+        Configuration& configuration);
+
+    //! Starts a persistent request, maps to MPI_Start.
+    void start();
+
     //! Wait for the request to finish, maps to MPI_Wait.
     void wait();
 
+    //! Waits for any of the given requests to finish, maps to MPI_Waitany.
+    //!
+    //! @return the index of the request that finished, or -1 if none of
+    //!         the requests are active.
+    static int waitAny(const std::vector<RequestPtr>& requests);
+
     friend class std::unique_ptr<Request>;
 
     ~Request();
 private:
 
     MPI_Request request{NULL};
+
+    //! Made by sendInit or receiveInit, freed in the destructor
+    bool persistent{false};
 };
 
 typedef Request::RequestPtr RequestPtr;
@@ -78,7 +109,7 @@ inline  RequestPtr Request::isend(const Data& data, int count,
 template<class Data>
 inline  RequestPtr Request::ireceive(Data& receiveBuffer, int count,
     MPI_Datatype datatype,
-    int source, int tag, Configuration configuration) {
+    int source, int tag, Configuration& configuration) {
     std::shared_ptr<Request> requestPointer(new Request());
 
 
@@ -108,7 +139,7 @@ inline  RequestPtr Request::isend(const thrust::host_vector<real>& data,
 template<>
 inline  RequestPtr Request::ireceive(thrust::host_vector<real>& receiveBuffer,
     int count, MPI_Datatype datatype,
-    int source, int tag, Configuration configuration) {
+    int source, int tag, Configuration& configuration) {
     std::shared_ptr<Request> requestPointer(new Request());
 
 
@@ -15,21 +15,62 @@
 
 #pragma once
 #include "alsfvm/mpi/Request.hpp"
+#include <functional>
+#include <map>
+#include <set>
+#include <vector>
 
 namespace alsfvm {
 namespace mpi {
 
 //! Holds a collection of requests
+//!
+//! Requests (and completion handlers) can be put in a group, eg. all
+//! requests receiving the ghost cells of one side. Groups can then be
+//! completed one at a time with waitForAnyGroup, in the order the
+//! messages arrive.
 class RequestContainer {
 public:
     typedef Request::RequestPtr RequestPtr;
 
-    void addRequest(RequestPtr request);
+    //! Adds a request. A negative group means the request is not part of
+    //! any group.
+    void addRequest(RequestPtr request, int group = -1);
 
+    //! Adds a function to be called once all requests are done, eg. to
+    //! unpack received buffers. If group is non-negative, the handler
+    //! is called as soon as the requests of that group are done.
+    void addCompletionHandler(std::function<void()> handler, int group = -1);
+
+    //! Waits for all requests, then calls the completion handlers (once).
     void waitForAll();
 
+    //! Is there any request or handler in the given group that has not
+    //! been completed by waitForAnyGroup?
+    bool hasGroup(int group) const;
+
+    //! Waits until all requests of some group are done, calls the
+    //! completion handlers of that group and returns the group.
+    //!
+    //! When all groups are done, this does waitForAll and returns -1.
+    int waitForAnyGroup();
+
 private:
     std::vector<RequestPtr> requests;
+    std::vector<int> requestGroups;
+    std::vector<bool> requestsDone;
+
+    std::map<int, std::vector<std::function<void()> > > completionHandlers;
+
+    //! The groups already returned by waitForAnyGroup
+    std::set<int> completedGroups;
+
+    //! The groups not yet returned by waitForAnyGroup
+    std::set<int> getRemainingGroups() const;
+
+    //! Returns a remaining group that has all its requests done, or -1
+    int findCompletedGroup() const;
+    void callCompletionHandlers(int group);
 };
 } // namespace mpi
 } // namespace alsfvm
@@ -0,0 +1,114 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+#include "alsfvm/mpi/Configuration.hpp"
+#include "alsfvm/types.hpp"
+#include <mpi.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+
+namespace alsfvm {
+namespace mpi {
+
+//! Exchanges packed halos with the neighbours that are on the same node
+//! through an MPI-3 shared memory window (MPI_Win_allocate_shared) instead
+//! of messages.
+//!
+//! Every processor on the node has a segment of the window with one send
+//! buffer per side. The sender packs the cells into its own buffer and
+//! raises a flag, the receiver waits for the flag and unpacks directly from
+//! the sender's buffer, then acknowledges, so the sender knows when it may
+//! overwrite the buffer again. The flags are counters, so no reset is
+//! needed between the exchanges.
+//!
+//! Sides are numbered as in CartesianCellExchanger.
+//!
+//! \note The constructor, allocate and the destructor are collective over
+//!       the processors on the node.
+class SharedMemoryHalo {
+public:
+    //! Finds the neighbours on the same node
+    //! (MPI_Comm_split_type(MPI_COMM_TYPE_SHARED)).
+    SharedMemoryHalo(ConfigurationPtr configuration, const ivec6& neighbours);
+
+    ~SharedMemoryHalo();
+
+    SharedMemoryHalo(const SharedMemoryHalo&) = delete;
+    SharedMemoryHalo& operator=(const SharedMemoryHalo&) = delete;
+
+    //! Is the neighbour on this side on the same node?
+    bool isOnNode(int side) const;
+
+    //! Allocates the window, with a send buffer with the given number of
+    //! reals for each side.
+    void allocate(const std::array<size_t, 6>& sendSizes);
+
+    bool isAllocated() const;
+
+    //! Waits until the neighbour has read the last cells sent to this side,
+    //! and returns the buffer to pack the next ones into.
+    real* beginSend(int side);
+
+    //! Makes the buffer visible to the neighbour
+    void endSend(int side);
+
+    //! Waits until the neighbour on this side has sent the next cells, and
+    //! returns its buffer (with receiveSize reals) to unpack them from.
+    const real* beginReceive(int side, size_t receiveSize);
+
+    //! Lets the neighbour on this side reuse its buffer
+    void endReceive(int side);
+
+private:
+    //! At the start of the segment of each processor
+    struct Header {
+        //! The number of times the buffer of each side was filled
+        int64_t sent[6];
+
+        //! The number of times we have read the neighbour's buffer, for
+        //! each side we receive on
+        int64_t received[6];
+
+        //! Where the buffers are, in reals after the header
+        int64_t offsets[6];
+        int64_t sizes[6];
+    };
+
+    ConfigurationPtr configuration;
+    const ivec6 neighbours;
+
+    MPI_Comm nodeCommunicator{MPI_COMM_NULL};
+
+    //! For each side, the rank of the neighbour in nodeCommunicator, or -1
+    //! if it is not on the node
+    std::array<int, 6> nodeNeighbours;
+
+    MPI_Win window{MPI_WIN_NULL};
+    Header* header{nullptr};
+    std::array<Header*, 6> neighbourHeaders;
+
+    std::array<int64_t, 6> numberOfSends;
+    std::array<int64_t, 6> numberOfReceives;
+
+    real* getBuffer(Header* bufferHeader, int side) const;
+
+    //! Spins until the counter is at least the value
+    void waitFor(const int64_t* counter, int64_t value);
+};
+
+typedef std::unique_ptr<SharedMemoryHalo> SharedMemoryHaloPtr;
+} // namespace mpi
+} // namespace alsfvm
@@ -0,0 +1,63 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsfvm/types.hpp"
+#include <algorithm>
+
+namespace alsfvm {
+namespace  mpi {
+namespace cartesian {
+
+//! Computes the number of cells a processor gets in each direction when the
+//! cells are split as evenly as possible, that is, the number of cells
+//! differ by at most one between the processors. The first processors get
+//! the extra cells.
+//!
+//! @param numberOfCells the total number of cells in each direction
+//! @param numberOfProcessors the number of processors in each direction
+//! @param coordinates the position of the processor (see getCoordinates)
+//!
+//! @see getBlockStart
+inline ivec3 getBlockSize(const ivec3& numberOfCells,
+    const ivec3& numberOfProcessors,
+    const ivec3& coordinates) {
+    ivec3 blockSize;
+
+    for (int d = 0; d < 3; ++d) {
+        blockSize[d] = numberOfCells[d] / numberOfProcessors[d]
+            + (coordinates[d] < numberOfCells[d] % numberOfProcessors[d]);
+    }
+
+    return blockSize;
+}
+
+//! Computes the index of the first cell of the processor, see getBlockSize
+inline ivec3 getBlockStart(const ivec3& numberOfCells,
+    const ivec3& numberOfProcessors,
+    const ivec3& coordinates) {
+    ivec3 blockStart;
+
+    for (int d = 0; d < 3; ++d) {
+        const int remainder = numberOfCells[d] % numberOfProcessors[d];
+        blockStart[d] = coordinates[d] * (numberOfCells[d] / numberOfProcessors[d])
+            + std::min(coordinates[d], remainder);
+    }
+
+    return blockStart;
+}
+}
+}
+}
@@ -21,6 +21,13 @@ namespace mpi {
 namespace domain {
 
 //! Performs domain decomposition on a regular cartesian grid
+//!
+//! The cells are split as evenly as possible, so the number of cells in
+//! each direction differs by at most one between the processors (see
+//! cartesian::getBlockSize).
+//!
+//! The processors are arranged with MPI_Cart_create, and the cell exchanger
+//! communicates on the resulting cartesian communicator.
 class CartesianDecomposition : public DomainDecomposition {
 public:
 
@@ -36,7 +43,10 @@ public:
     //! @param nx number of cpus in x direction
     //! @param ny number of cpus in y direction
     //! @param nz number of cpus in z direction
-    CartesianDecomposition(int nx, int ny, int nz);
+    //! @param reorderRanks let MPI reorder the ranks (of the cartesian
+    //!                     communicator) to match the hardware, so that
+    //!                     neighbours are more likely to be on the same node
+    CartesianDecomposition(int nx, int ny, int nz, bool reorderRanks = false);
 
 
     //! Decomposes the domain
@@ -49,8 +59,28 @@ public:
         const grid::Grid& grid
     ) override;
 
+    //! Finds the number of processors in each direction that minimizes the
+    //! surface of the blocks, that is, the number of ghost cells each
+    //! processor has to fill.
+    //!
+    //! @param numberOfProcessors the total number of processors
+    //! @param grid the whole grid to decompose
+    //! @param evenBlocksOnly only consider splits where every processor
+    //!                       gets the same number of cells
+    //! @return the number of processors to use in each direction, the
+    //!         product is numberOfProcessors
+    static ivec3 findNumberOfProcessorsPerDirection(int numberOfProcessors,
+        const grid::Grid& grid, bool evenBlocksOnly = false);
+
+    //! If set, decompose throws unless every processor gets the same number
+    //! of cells. The functionals that write a reduced grid (see
+    //! functional::IntervalFunctionalWriter) assume equally sized blocks.
+    void setRequireEvenBlocks(bool requireEvenBlocks);
+
 private:
     const ivec3 numberOfProcessors;
+    const bool reorderRanks = false;
+    bool requireEvenBlocks = false;
 };
 } // namespace domain
 } // namespace mpi
@@ -30,6 +30,14 @@ namespace numflux {
 /// The template argument dimension is to choose the correct dimension
 /// (1 up to and including 3 is supported).
 ///
+/// If SimulatorParameters::getPrimitiveCache() is set (Euler with no
+/// reconstruction only), the extra variables (p and u) are computed once per
+/// cell per call to computeFlux and stored in an extra volume, and the
+/// fluxes read them from there instead of recomputing them for every face
+/// (twice per cell and direction for two point fluxes, four or six times
+/// for the TeCNO fluxes). This trades the divisions for reading nsd+1 more
+/// values per cell.
+///
 template<class Flux, class Equation, size_t dimension>
 class NumericalFluxCPU : public NumericalFlux {
 public:
@@ -73,6 +81,10 @@ private:
     void createVolumes(size_t nx, size_t ny, size_t nz, size_t ngc);
     volume::VolumeFactory volumeFactory;
     alsfvm::shared_ptr<reconstruction::Reconstruction> reconstruction;
+    const bool usePrimitiveCache;
+
+    // The cached extra variables, only used with usePrimitiveCache
+    alsfvm::shared_ptr<volume::Volume> extraVolume;
     alsfvm::shared_ptr<volume::Volume> left;
     alsfvm::shared_ptr<volume::Volume> right;
 
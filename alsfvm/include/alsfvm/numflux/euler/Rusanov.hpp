@@ -0,0 +1,66 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsfvm/equation/euler/ConservedVariables.hpp"
+#include "alsfvm/equation/euler/AllVariables.hpp"
+#include "alsfvm/equation/euler/Euler.hpp"
+#include <algorithm>
+
+namespace alsfvm {
+namespace numflux {
+namespace euler {
+
+///
+/// The Rusanov (local Lax-Friedrichs) flux for the Euler equations, ie.
+/// \f[F(u_l, u_r) = \frac{f(u_l)+f(u_r)}{2} - \frac{s}{2}(u_r-u_l)\f]
+/// where \f$s\f$ is the maximum of the wave speeds on each side.
+///
+/// The generic Rusanov flux only works for scalar equations, since it
+/// uses the eigenvalue of the scalar flux.
+///
+template<int nsd>
+class Rusanov {
+public:
+    ///
+    /// \brief name is "rusanov"
+    ///
+    static const std::string name;
+
+    template<int direction>
+    __device__ __host__ inline static real computeFlux(const
+        equation::euler::Euler<nsd>& eq,
+        const equation::euler::AllVariables<nsd>& left,
+        const equation::euler::AllVariables<nsd>& right,
+        equation::euler::ConservedVariables<nsd>& F) {
+
+        static_assert(direction < 3, "We only support three dimensions.");
+        equation::euler::ConservedVariables<nsd> fluxLeft, fluxRight;
+        eq.template computePointFlux<direction>(left, fluxLeft);
+        eq.template computePointFlux<direction>(right, fluxRight);
+
+        const real waveSpeed = fmax(eq.template computeWaveSpeed<direction>(left,
+                    left),
+                eq.template computeWaveSpeed<direction>(right, right));
+
+        F = 0.5 * (fluxLeft + fluxRight) - 0.5 * waveSpeed * (right.conserved() -
+                left.conserved());
+
+        return waveSpeed;
+    }
+};
+} // namespace euler
+} // namespace numflux
+} // namespace alsfvm
@@ -0,0 +1,101 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsfvm/numflux/euler/simd/flux_row_kernels.hpp"
+#include "alsfvm/numflux/euler/HLL.hpp"
+#include "alsfvm/numflux/euler/HLL3.hpp"
+#include "alsfvm/numflux/euler/Rusanov.hpp"
+#include "alsfvm/numflux/Central.hpp"
+#include "alsutils/simd/InstructionSet.hpp"
+#include <type_traits>
+
+namespace alsfvm {
+namespace numflux {
+namespace euler {
+namespace simd {
+
+//! Tells whether the flux has a vectorized implementation, and which
+template<class Flux>
+struct simd_flux_traits {
+    static constexpr bool available = false;
+    static constexpr int dimension = 0;
+};
+
+template<int nsd>
+struct simd_flux_traits<HLL<nsd>> {
+    static constexpr bool available = true;
+    static constexpr FluxKind kind = FluxKind::hll;
+    static constexpr int dimension = nsd;
+};
+
+template<int nsd>
+struct simd_flux_traits<HLL3<nsd>> {
+    static constexpr bool available = true;
+    static constexpr FluxKind kind = FluxKind::hll3;
+    static constexpr int dimension = nsd;
+};
+
+template<int nsd>
+struct simd_flux_traits<Rusanov<nsd>> {
+    static constexpr bool available = true;
+    static constexpr FluxKind kind = FluxKind::rusanov;
+    static constexpr int dimension = nsd;
+};
+
+template<int nsd>
+struct simd_flux_traits<Central<equation::euler::Euler<nsd>>> {
+    static constexpr bool available = true;
+    static constexpr FluxKind kind = FluxKind::central;
+    static constexpr int dimension = nsd;
+};
+
+//! True if computeFluxRow can compute the flux in the given direction
+template<class Flux, size_t direction>
+struct has_simd_flux_row : public std::integral_constant < bool,
+    simd_flux_traits<Flux>::available
+        && int(direction) < simd_flux_traits<Flux>::dimension > {};
+
+///
+/// Computes the (negated) numerical flux over count consecutive faces with
+/// the kernel compiled for the given instruction set. If the kernel for that
+/// instruction set was not built, the closest less capable one is used.
+///
+/// \param instructionSet the instruction set to use, must be supported by the
+///                       CPU (see alsutils::simd::getInstructionSet())
+/// \param gamma the adiabatic constant
+/// \param leftSide pointers to rho, m_0, ..., E for the values on the
+///                 left side of each face
+/// \param rightSide pointers to rho, m_0, ..., E for the values on the
+///                  right side of each face
+/// \param output pointers to rho, m_0, ..., E where -F is written
+/// \param first the linear index of the first face
+/// \param count the number of consecutive faces (along x) to compute
+/// \param offset the linear offset to add to get the right side value
+///               (1, nx or nx*ny depending on direction)
+/// \returns the maximum wave speed
+///
+template<FluxKind kind, int nsd, int direction>
+real computeFluxRow(alsutils::simd::InstructionSet instructionSet,
+    real gamma,
+    const real* const* leftSide,
+    const real* const* rightSide,
+    real* const* output,
+    size_t first, size_t count, size_t offset);
+
+} // namespace simd
+} // namespace euler
+} // namespace numflux
+} // namespace alsfvm
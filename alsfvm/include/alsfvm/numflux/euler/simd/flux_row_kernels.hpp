@@ -0,0 +1,61 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsfvm/types.hpp"
+
+///
+/// Declarations of the vectorized Euler flux kernels. Each instruction set
+/// gets its own namespace, compiled in its own translation unit with the
+/// matching compiler flags (see src/numflux/euler/simd/flux_row_*.cpp).
+///
+/// \note Only plain types may appear here, since this header is included
+///       in translation units compiled for instruction sets the running
+///       CPU might not support.
+///
+namespace alsfvm {
+namespace numflux {
+namespace euler {
+namespace simd {
+
+//! The Euler fluxes that have a vectorized implementation
+enum class FluxKind {
+    hll,
+    hll3,
+    rusanov,
+    central
+};
+
+#define ALSFVM_SIMD_DECLARE_FLUX_ROW(isa) \
+    namespace isa { \
+    template<FluxKind kind, int nsd, int direction> \
+    real computeFluxRow(real gamma, \
+        const real* const* leftSide, \
+        const real* const* rightSide, \
+        real* const* output, \
+        size_t first, size_t count, size_t offset); \
+    }
+
+ALSFVM_SIMD_DECLARE_FLUX_ROW(scalar)
+ALSFVM_SIMD_DECLARE_FLUX_ROW(sse)
+ALSFVM_SIMD_DECLARE_FLUX_ROW(avx2)
+ALSFVM_SIMD_DECLARE_FLUX_ROW(avx512)
+
+#undef ALSFVM_SIMD_DECLARE_FLUX_ROW
+
+} // namespace simd
+} // namespace euler
+} // namespace numflux
+} // namespace alsfvm
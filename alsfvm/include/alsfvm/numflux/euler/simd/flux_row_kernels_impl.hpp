@@ -0,0 +1,373 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+///
+/// Implementation of the vectorized Euler flux kernels.
+///
+/// This file is meant to be included exactly once per instruction set, from
+/// a translation unit that defines
+///
+///    ALSFVM_SIMD_ISA             the namespace to put the kernels in
+///    ALSFVM_SIMD_REGISTER_BYTES  the width of a vector register in bytes
+///
+/// The formulas mirror euler::HLL, euler::HLL3, euler::Rusanov and
+/// Central<Euler<nsd>> lane by lane, with the branches turned into selects.
+///
+/// \note Do not include any other headers with inline functions here, the
+///       instantiations would be compiled with the instruction set flags
+///       and could end up being used on CPUs that lack the instructions.
+///
+
+#ifndef ALSFVM_SIMD_ISA
+    #error "ALSFVM_SIMD_ISA must be defined before including flux_row_kernels_impl.hpp"
+#endif
+#ifndef ALSFVM_SIMD_REGISTER_BYTES
+    #error "ALSFVM_SIMD_REGISTER_BYTES must be defined before including flux_row_kernels_impl.hpp"
+#endif
+
+#include "alsfvm/numflux/euler/simd/flux_row_kernels.hpp"
+#include "alsutils/simd/batch.hpp"
+
+namespace alsfvm {
+namespace numflux {
+namespace euler {
+namespace simd {
+namespace ALSFVM_SIMD_ISA {
+namespace {
+
+//! Gives all batch instantiations in this translation unit internal linkage
+struct InstructionSetTag {};
+
+constexpr int batchWidth = ALSFVM_SIMD_REGISTER_BYTES / int(sizeof(real)) > 0 ?
+    ALSFVM_SIMD_REGISTER_BYTES / int(sizeof(real)) : 1;
+
+typedef alsutils::simd::batch<real, batchWidth, InstructionSetTag> rbatch;
+
+using alsutils::simd::select;
+using alsutils::simd::sqrt;
+using alsutils::simd::fabs;
+using alsutils::simd::fmin;
+using alsutils::simd::fmax;
+
+//! Batch variant of euler::ConservedVariables. The variables are stored in
+//! the same order as in the Views, ie. rho, m_0, ..., m_{nsd-1}, E.
+template<int nsd>
+struct ConservedBatch {
+    rbatch q[nsd + 2];
+
+    const rbatch& rho() const {
+        return q[0];
+    }
+    const rbatch& m(int d) const {
+        return q[1 + d];
+    }
+    const rbatch& E() const {
+        return q[nsd + 1];
+    }
+};
+
+//! Batch variant of euler::AllVariables
+template<int nsd>
+struct AllBatch : public ConservedBatch<nsd> {
+    rbatch u[nsd];
+    rbatch p;
+};
+
+//! Loads count <= batchWidth consecutive cells starting at index, and
+//! computes the extra variables as Euler::computeExtra does.
+template<int nsd>
+inline AllBatch<nsd> loadAllVariables(real gamma,
+    const real* const* variables, size_t index, int count) {
+    AllBatch<nsd> v;
+
+    for (int var = 0; var < nsd + 2; ++var) {
+        v.q[var] = count == batchWidth ?
+            rbatch::load(variables[var] + index) :
+            rbatch::loadPartial(variables[var] + index, count);
+    }
+
+    rbatch mSquared = v.m(0) * v.m(0);
+
+    for (int d = 1; d < nsd; ++d) {
+        mSquared += v.m(d) * v.m(d);
+    }
+
+    const rbatch ie = v.E() - real(0.5) * mSquared / v.rho();
+
+    for (int d = 0; d < nsd; ++d) {
+        v.u[d] = v.m(d) / v.rho();
+    }
+
+    v.p = (gamma - 1) * ie;
+    return v;
+}
+
+//! As Euler::computePointFlux
+template<int nsd, int direction>
+inline ConservedBatch<nsd> computePointFlux(const AllBatch<nsd>& v) {
+    ConservedBatch<nsd> F;
+    F.q[0] = v.m(direction);
+
+    for (int d = 0; d < nsd; ++d) {
+        F.q[1 + d] = v.u[direction] * v.m(d);
+    }
+
+    F.q[1 + direction] += v.p;
+    F.q[nsd + 1] = (v.E() + v.p) * v.u[direction];
+    return F;
+}
+
+//! As Euler::computeWaveSpeed
+template<int nsd, int direction>
+inline rbatch computeWaveSpeed(real gamma, const AllBatch<nsd>& v) {
+    return fabs(v.u[direction]) + sqrt(gamma * v.p / v.rho());
+}
+
+template<FluxKind kind, int nsd, int direction>
+struct BatchFlux;
+
+template<int nsd, int direction>
+struct BatchFlux<FluxKind::hll, nsd, direction> {
+    static rbatch computeFlux(real gamma, const AllBatch<nsd>& left,
+        const AllBatch<nsd>& right, ConservedBatch<nsd>& F) {
+        const rbatch waveLeft = sqrt(left.rho());
+        const rbatch waveRight = sqrt(right.rho());
+
+        const rbatch rho = (left.rho() + right.rho()) / real(2);
+        const rbatch u = (waveLeft * left.u[direction] + waveRight *
+                right.u[direction]) / (waveLeft + waveRight);
+        const rbatch p = (left.p * waveLeft + right.p * waveRight) /
+            (waveLeft + waveRight);
+
+        const rbatch cs = sqrt(gamma * p / rho);
+
+        const rbatch speedLeft = fmin(left.u[direction] - sqrt(gamma * left.p /
+                    left.rho()), u - cs);
+        const rbatch speedRight = fmax(right.u[direction] + sqrt(gamma * right.p /
+                    right.rho()), u + cs);
+
+        const auto fluxLeft = computePointFlux<nsd, direction>(left);
+        const auto fluxRight = computePointFlux<nsd, direction>(right);
+
+        const auto isZero = speedLeft == real(0);
+        const auto useLeft = speedLeft > real(0);
+        const auto useRight = speedRight < real(0);
+
+        for (int var = 0; var < nsd + 2; ++var) {
+            const rbatch middle = (speedRight * fluxLeft.q[var] - speedLeft *
+                    fluxRight.q[var] + speedRight * speedLeft *
+                    (right.q[var] - left.q[var])) / (speedRight - speedLeft);
+            F.q[var] = select(isZero, rbatch(0), select(useLeft, fluxLeft.q[var],
+                        select(useRight, fluxRight.q[var], middle)));
+        }
+
+        return fmax(fabs(speedLeft), fabs(speedRight));
+    }
+};
+
+template<int nsd, int direction>
+struct BatchFlux<FluxKind::hll3, nsd, direction> {
+    static rbatch computeFlux(real gamma, const AllBatch<nsd>& left,
+        const AllBatch<nsd>& right, ConservedBatch<nsd>& F) {
+        const rbatch waveLeft = sqrt(left.rho());
+        const rbatch waveRight = sqrt(right.rho());
+
+        const rbatch rho = (left.rho() + right.rho()) / real(2);
+        const rbatch u = (waveLeft * left.u[direction] + waveRight *
+                right.u[direction]) / (waveLeft + waveRight);
+        const rbatch p = (waveLeft * left.p + waveRight * right.p) /
+            (waveLeft + waveRight);
+
+        const rbatch cfLeft = sqrt(gamma * left.p / left.rho());
+        const rbatch cfRight = sqrt(gamma * right.p / right.rho());
+
+        const rbatch correct = real(0.5) * fmax(rbatch(0),
+                left.u[direction] - right.u[direction]);
+
+        const rbatch cs = sqrt(gamma * p / rho);
+        const rbatch speedLeft = fmin(left.u[direction] + correct - cfLeft, u - cs);
+        const rbatch speedRight = fmax(right.u[direction] - correct + cfRight,
+                u + cs);
+
+        const auto fluxLeft = computePointFlux<nsd, direction>(left);
+        const auto fluxRight = computePointFlux<nsd, direction>(right);
+
+        const rbatch udl = left.u[direction] - speedLeft;
+        const rbatch udr = right.u[direction] - speedRight;
+
+        const rbatch aa = udr * right.rho() - udl * left.rho();
+        const rbatch sm = (right.m(direction) * udr - left.m(direction) * udl +
+                right.p - left.p) / aa;
+
+        rbatch us[nsd];
+
+        for (int d = 0; d < nsd; ++d) {
+            us[d] = (fluxRight.q[1 + d] - fluxLeft.q[1 + d] - speedRight * right.m(d)
+                    + speedLeft * left.m(d)) / aa;
+        }
+
+        us[direction] = sm;
+
+        // The middle states on each side of the contact
+        ConservedBatch<nsd> middleLeft, middleRight;
+        middleLeft.q[0] = left.rho() * udl / (sm - speedLeft);
+        middleRight.q[0] = right.rho() * udr / (sm - speedRight);
+
+        for (int d = 0; d < nsd; ++d) {
+            middleLeft.q[1 + d] = middleLeft.q[0] * us[d];
+            middleRight.q[1 + d] = middleRight.q[0] * us[d];
+        }
+
+        const rbatch pLeft = left.p + left.rho() * (left.u[direction] - sm) * udl;
+        middleLeft.q[nsd + 1] = (udl * left.E() + left.p * left.u[direction] -
+                pLeft * sm) / (sm - speedLeft);
+
+        const rbatch pRight = right.p + right.rho() * (right.u[direction] - sm) *
+            udr;
+        middleRight.q[nsd + 1] = (udr * right.E() + right.p * right.u[direction] -
+                pRight * sm) / (sm - speedRight);
+
+        const auto isZero = speedLeft == real(0);
+        const auto useLeft = speedLeft > real(0);
+        const auto useRight = speedRight < real(0);
+        const auto useMiddleLeft = sm >= real(0);
+
+        for (int var = 0; var < nsd + 2; ++var) {
+            const rbatch starLeft = fluxLeft.q[var] + speedLeft * (middleLeft.q[var] -
+                    left.q[var]);
+            const rbatch starRight = fluxRight.q[var] + speedRight *
+                (middleRight.q[var] - right.q[var]);
+
+            F.q[var] = select(isZero, rbatch(0), select(useLeft, fluxLeft.q[var],
+                        select(useRight, fluxRight.q[var],
+                            select(useMiddleLeft, starLeft, starRight))));
+        }
+
+        return fmax(fabs(speedLeft), fabs(speedRight));
+    }
+};
+
+template<int nsd, int direction>
+struct BatchFlux<FluxKind::rusanov, nsd, direction> {
+    static rbatch computeFlux(real gamma, const AllBatch<nsd>& left,
+        const AllBatch<nsd>& right, ConservedBatch<nsd>& F) {
+        const auto fluxLeft = computePointFlux<nsd, direction>(left);
+        const auto fluxRight = computePointFlux<nsd, direction>(right);
+
+        const rbatch waveSpeed = fmax(computeWaveSpeed<nsd, direction>(gamma, left),
+                computeWaveSpeed<nsd, direction>(gamma, right));
+
+        for (int var = 0; var < nsd + 2; ++var) {
+            F.q[var] = real(0.5) * (fluxLeft.q[var] + fluxRight.q[var])
+                - real(0.5) * waveSpeed * (right.q[var] - left.q[var]);
+        }
+
+        return waveSpeed;
+    }
+};
+
+template<int nsd, int direction>
+struct BatchFlux<FluxKind::central, nsd, direction> {
+    static rbatch computeFlux(real gamma, const AllBatch<nsd>& left,
+        const AllBatch<nsd>& right, ConservedBatch<nsd>& F) {
+        const auto fluxLeft = computePointFlux<nsd, direction>(left);
+        const auto fluxRight = computePointFlux<nsd, direction>(right);
+
+        for (int var = 0; var < nsd + 2; ++var) {
+            F.q[var] = real(0.5) * (fluxLeft.q[var] + fluxRight.q[var]);
+        }
+
+        return fmax(computeWaveSpeed<nsd, direction>(gamma, left),
+                computeWaveSpeed<nsd, direction>(gamma, right));
+    }
+};
+} // anonymous namespace
+
+///
+/// Computes the numerical flux over count consecutive faces.
+///
+/// Face i (first <= i < first + count) has its left state stored at index i
+/// in leftSide and its right state at index i + offset in rightSide. The
+/// negated flux -F is written at index i in output, which is the layout
+/// NumericalFluxCPU keeps in its temporary volume.
+///
+/// \returns the maximum wave speed over all the faces
+///
+template<FluxKind kind, int nsd, int direction>
+real computeFluxRow(real gamma,
+    const real* const* leftSide,
+    const real* const* rightSide,
+    real* const* output,
+    size_t first, size_t count, size_t offset) {
+    static_assert(direction < nsd, "Direction must be less than the dimension");
+
+    rbatch maxWaveSpeed(0);
+
+    for (size_t i = 0; i < count; i += batchWidth) {
+        const size_t remaining = count - i;
+        const int lanes = remaining < size_t(batchWidth) ? int(remaining) :
+            batchWidth;
+        const size_t index = first + i;
+
+        const auto left = loadAllVariables<nsd>(gamma, leftSide, index, lanes);
+        const auto right = loadAllVariables<nsd>(gamma, rightSide, index + offset,
+                lanes);
+
+        ConservedBatch<nsd> F;
+        const rbatch waveSpeed = BatchFlux<kind, nsd, direction>::computeFlux(gamma,
+                left, right, F);
+
+        // The padded lanes repeat the first cell, so they do not change the
+        // maximum.
+        maxWaveSpeed = fmax(maxWaveSpeed, waveSpeed);
+
+        for (int var = 0; var < nsd + 2; ++var) {
+            if (lanes == batchWidth) {
+                (-F.q[var]).store(output[var] + index);
+            } else {
+                (-F.q[var]).storePartial(output[var] + index, lanes);
+            }
+        }
+    }
+
+    return alsutils::simd::horizontalMax(maxWaveSpeed);
+}
+
+#define ALSFVM_SIMD_INSTANTIATE_FLUX_ROW(kind, nsd, direction) \
+    template real computeFluxRow<kind, nsd, direction>(real, \
+        const real* const*, const real* const*, real* const*, \
+        size_t, size_t, size_t);
+
+#define ALSFVM_SIMD_INSTANTIATE_FLUX_ROW_KIND(kind) \
+    ALSFVM_SIMD_INSTANTIATE_FLUX_ROW(kind, 1, 0) \
+    ALSFVM_SIMD_INSTANTIATE_FLUX_ROW(kind, 2, 0) \
+    ALSFVM_SIMD_INSTANTIATE_FLUX_ROW(kind, 2, 1) \
+    ALSFVM_SIMD_INSTANTIATE_FLUX_ROW(kind, 3, 0) \
+    ALSFVM_SIMD_INSTANTIATE_FLUX_ROW(kind, 3, 1) \
+    ALSFVM_SIMD_INSTANTIATE_FLUX_ROW(kind, 3, 2)
+
+ALSFVM_SIMD_INSTANTIATE_FLUX_ROW_KIND(FluxKind::hll)
+ALSFVM_SIMD_INSTANTIATE_FLUX_ROW_KIND(FluxKind::hll3)
+ALSFVM_SIMD_INSTANTIATE_FLUX_ROW_KIND(FluxKind::rusanov)
+ALSFVM_SIMD_INSTANTIATE_FLUX_ROW_KIND(FluxKind::central)
+
+#undef ALSFVM_SIMD_INSTANTIATE_FLUX_ROW_KIND
+#undef ALSFVM_SIMD_INSTANTIATE_FLUX_ROW
+
+} // namespace ALSFVM_SIMD_ISA
+} // namespace simd
+} // namespace euler
+} // namespace numflux
+} // namespace alsfvm
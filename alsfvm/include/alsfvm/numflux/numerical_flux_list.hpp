@@ -18,6 +18,7 @@
 #include "alsfvm/equation/equation_list.hpp"
 #include "alsfvm/numflux/euler/HLL.hpp"
 #include "alsfvm/numflux/euler/HLL3.hpp"
+#include "alsfvm/numflux/euler/Rusanov.hpp"
 #include "alsfvm/numflux/burgers/Godunov.hpp"
 #include "alsfvm/numflux/buckleyleverett/Godunov.hpp"
 #include "alsfvm/numflux/Central.hpp"
@@ -44,6 +45,7 @@ boost::fusion::pair<equation::euler::Euler<1>,
       boost::fusion::vector<
       euler::HLL<1>,
       euler::HLL3<1>,
+      euler::Rusanov<1>,
       Central<equation::euler::Euler<1>>,
       euler::Tecno1<1>,
       TecnoCombined4<equation::euler::Euler<1>, euler::Tecno1<1> >,
@@ -55,6 +57,7 @@ boost::fusion::pair<equation::euler::Euler<1>,
       boost::fusion::vector<
       euler::HLL<2>,
       euler::HLL3<2>,
+      euler::Rusanov<2>,
       Central<equation::euler::Euler<2>>,
       euler::Tecno1<2>,
       TecnoCombined4<equation::euler::Euler<2>, euler::Tecno1<2> >,
@@ -66,6 +69,7 @@ boost::fusion::pair<equation::euler::Euler<1>,
       boost::fusion::vector<
       euler::HLL<3>,
       euler::HLL3<3>,
+      euler::Rusanov<3>,
       Central<equation::euler::Euler<3>>,
       euler::Tecno1<3>,
       TecnoCombined4<equation::euler::Euler<3>, euler::Tecno1<3> >,
@@ -146,6 +150,15 @@ void for_each_flux(Function f) {
     template class X< ::alsfvm::numflux::euler::HLL3<3>, ::alsfvm::equation::euler::Euler<3>, 1>; \
     template class X< ::alsfvm::numflux::euler::HLL3<3>, ::alsfvm::equation::euler::Euler<3>, 2>; \
     template class X< ::alsfvm::numflux::euler::HLL3<3>, ::alsfvm::equation::euler::Euler<3>, 3>; \
+    template class X< ::alsfvm::numflux::euler::Rusanov<1>, ::alsfvm::equation::euler::Euler<1>, 1>; \
+    template class X< ::alsfvm::numflux::euler::Rusanov<1>, ::alsfvm::equation::euler::Euler<1>, 2>; \
+    template class X< ::alsfvm::numflux::euler::Rusanov<1>, ::alsfvm::equation::euler::Euler<1>, 3>; \
+    template class X< ::alsfvm::numflux::euler::Rusanov<2>, ::alsfvm::equation::euler::Euler<2>, 1>; \
+    template class X< ::alsfvm::numflux::euler::Rusanov<2>, ::alsfvm::equation::euler::Euler<2>, 2>; \
+    template class X< ::alsfvm::numflux::euler::Rusanov<2>, ::alsfvm::equation::euler::Euler<2>, 3>; \
+    template class X< ::alsfvm::numflux::euler::Rusanov<3>, ::alsfvm::equation::euler::Euler<3>, 1>; \
+    template class X< ::alsfvm::numflux::euler::Rusanov<3>, ::alsfvm::equation::euler::Euler<3>, 2>; \
+    template class X< ::alsfvm::numflux::euler::Rusanov<3>, ::alsfvm::equation::euler::Euler<3>, 3>; \
     template class X< ::alsfvm::numflux::Central<equation::euler::Euler<1>>, ::alsfvm::equation::euler::Euler<1>, 1>; \
     template class X< ::alsfvm::numflux::Central<equation::euler::Euler<1>>, ::alsfvm::equation::euler::Euler<1>, 2>; \
     template class X< ::alsfvm::numflux::Central<equation::euler::Euler<1>>, ::alsfvm::equation::euler::Euler<1>, 3>; \
@@ -141,5 +141,68 @@ __device__ __host__ real computeFluxForStencil(const Equation& eq,
     return waveSpeed;
 }
 
+//! Computes the flux with piecewise constant values, reading the conserved
+//! variables from conserved and the precomputed extra variables (for Euler:
+//! p and u) from extra, instead of recomputing them from the conserved ones.
+template<class Flux, class Equation, size_t direction>
+__device__ __host__ real computeFluxForStencil(const Equation& eq,
+    ivec2 indices,
+    typename Equation::ConstViews& conserved,
+    typename Equation::ConstViewsExtra& extra,
+    typename Equation::ConservedVariables& out) {
+
+    typename Equation::AllVariables leftJpHf = eq.fetchAllVariables(conserved,
+            extra, indices[0]);
+    typename Equation::AllVariables rightJpHf = eq.fetchAllVariables(conserved,
+            extra, indices[1]);
+
+    return Flux::template computeFlux<direction>(eq, leftJpHf, rightJpHf, out);
+}
+
+//! As above, for the four point stencil of the higher order fluxes.
+template<class Flux, class Equation, size_t direction>
+__device__ __host__ real computeFluxForStencil(const Equation& eq,
+    ivec4 indices,
+    typename Equation::ConstViews& conserved,
+    typename Equation::ConstViewsExtra& extra,
+    typename Equation::ConservedVariables& out) {
+
+    typename Equation::AllVariables u0 = eq.fetchAllVariables(conserved, extra,
+            indices[0]);
+    typename Equation::AllVariables u1 = eq.fetchAllVariables(conserved, extra,
+            indices[1]);
+    typename Equation::AllVariables u2 = eq.fetchAllVariables(conserved, extra,
+            indices[2]);
+    typename Equation::AllVariables u3 = eq.fetchAllVariables(conserved, extra,
+            indices[3]);
+
+    return Flux::template computeFlux<direction>(eq, u0, u1, u2, u3, out);
+}
+
+//! As above, for the six point stencil of the higher order fluxes.
+template<class Flux, class Equation, size_t direction>
+__device__ __host__ real computeFluxForStencil(const Equation& eq,
+    ivec6 indices,
+    typename Equation::ConstViews& conserved,
+    typename Equation::ConstViewsExtra& extra,
+    typename Equation::ConservedVariables& out) {
+
+    typename Equation::AllVariables u0 = eq.fetchAllVariables(conserved, extra,
+            indices[0]);
+    typename Equation::AllVariables u1 = eq.fetchAllVariables(conserved, extra,
+            indices[1]);
+    typename Equation::AllVariables u2 = eq.fetchAllVariables(conserved, extra,
+            indices[2]);
+    typename Equation::AllVariables u3 = eq.fetchAllVariables(conserved, extra,
+            indices[3]);
+    typename Equation::AllVariables u4 = eq.fetchAllVariables(conserved, extra,
+            indices[4]);
+    typename Equation::AllVariables u5 = eq.fetchAllVariables(conserved, extra,
+            indices[5]);
+
+    return Flux::template computeFlux<direction>(eq, u0, u1, u2, u3, u4, u5,
+            out);
+}
+
 }
 }
@@ -50,6 +50,31 @@ public:
 
     }
 
+    ///
+    /// Reconstructs a single cell given the linear indices of its neighbours
+    /// along the reconstruction direction. Used by the fused flux engine,
+    /// which does not store the reconstructed values in full volumes.
+    ///
+    __device__ __host__ static void reconstructCell(const Equation& eq,
+        typename Equation::ConstViews& in,
+        size_t indexLeft, size_t indexMiddle, size_t indexRight,
+        typename Equation::ConservedVariables& leftOut,
+        typename Equation::ConservedVariables& rightOut) {
+
+        for (size_t var = 0; var < Equation::getNumberOfConservedVariables(); ++var) {
+            const real left = in.get(var).at(indexLeft);
+            const real middle = in.get(var).at(indexMiddle);
+            const real right = in.get(var).at(indexRight);
+
+            const real sigma = minmod(2 * (right - middle),
+                    (right - left) / 2,
+                    2 * (middle - left));
+
+            leftOut[var] = middle - sigma / 2;
+            rightOut[var] = middle + sigma / 2;
+        }
+    }
+
     __device__ __host__ static size_t getNumberOfGhostCells() {
         return 2;
     }
@@ -0,0 +1,45 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsfvm/types.hpp"
+
+namespace alsfvm {
+namespace reconstruction {
+
+///
+/// Piecewise constant (first order) reconstruction. This is the pointwise
+/// counterpart of NoReconstruction, and is meant to be used by the fused
+/// flux engine (see numflux::FusedNumericalFluxCPU).
+///
+template<class Equation>
+class PiecewiseConstant {
+public:
+
+    __device__ __host__ static void reconstructCell(const Equation& eq,
+        typename Equation::ConstViews& in,
+        size_t indexLeft, size_t indexMiddle, size_t indexRight,
+        typename Equation::ConservedVariables& leftOut,
+        typename Equation::ConservedVariables& rightOut) {
+        leftOut = eq.fetchConservedVariables(in, indexMiddle);
+        rightOut = leftOut;
+    }
+
+    __device__ __host__ static size_t getNumberOfGhostCells() {
+        return 1;
+    }
+};
+} // namespace reconstruction
+} // namespace alsfvm
@@ -90,6 +90,45 @@ public:
 #endif
     }
 
+    ///
+    /// Reconstructs a single cell given the linear indices of its neighbours
+    /// along the reconstruction direction. Used by the fused flux engine,
+    /// which does not store the reconstructed values in full volumes.
+    ///
+    __device__ __host__ static void reconstructCell(const Equation& eq,
+        typename Equation::ConstViews& in,
+        size_t indexLeft, size_t indexMiddle, size_t indexRight,
+        typename Equation::ConservedVariables& leftOut,
+        typename Equation::ConservedVariables& rightOut) {
+        const real i0 = eq.getWeight(in, indexMiddle);
+        const real b0 = square(eq.getWeight(in, indexRight) - i0);
+        const real b1 = square(i0 - eq.getWeight(in, indexLeft));
+
+        const real a0Left = 1 / (3 * (ALSFVM_WENO_EPSILON + b0) *
+                (ALSFVM_WENO_EPSILON + b0));
+        const real a1Left = 2 / (3 * (ALSFVM_WENO_EPSILON + b1) *
+                (ALSFVM_WENO_EPSILON + b1));
+        const real w0Left = a0Left / (a0Left + a1Left);
+        const real w1Left = a1Left / (a0Left + a1Left);
+
+        const real a0Right = 2 / (3 * (ALSFVM_WENO_EPSILON + b0) *
+                (ALSFVM_WENO_EPSILON + b0));
+        const real a1Right = 1 / (3 * (ALSFVM_WENO_EPSILON + b1) *
+                (ALSFVM_WENO_EPSILON + b1));
+        const real w0Right = a0Right / (a0Right + a1Right);
+        const real w1Right = a1Right / (a0Right + a1Right);
+
+        for (size_t var = 0; var < Equation::getNumberOfConservedVariables(); ++var) {
+            leftOut[var] = 0.5 * (w1Left * in.get(var).at(indexLeft) +
+                    (3 * w0Left + w1Left) * in.get(var).at(indexMiddle) -
+                    w0Left * in.get(var).at(indexRight));
+
+            rightOut[var] = 0.5 * (w0Right * in.get(var).at(indexRight) +
+                    (3 * w1Right + w0Right) * in.get(var).at(indexMiddle) -
+                    w1Right * in.get(var).at(indexLeft));
+        }
+    }
+
     __device__ __host__ static int getNumberOfGhostCells() {
         return 2;
     }
@@ -112,6 +112,75 @@ public:
 
     }
 
+    ///
+    /// Reconstructs a single cell given the linear indices of its neighbours
+    /// along the reconstruction direction. Used by the fused flux engine,
+    /// which does not store the reconstructed values in full volumes.
+    ///
+    __device__ __host__ static void reconstructCell(const Equation& eq,
+        typename Equation::ConstViews& in,
+        size_t indexLeft, size_t indexMiddle, size_t indexRight,
+        typename Equation::ConservedVariables& leftOut,
+        typename Equation::ConservedVariables& rightOut) {
+        const real BOUND = 1.9;
+        const real i0 = eq.getWeight(in, indexMiddle);
+        const real b0 = square(eq.getWeight(in, indexRight) - i0);
+        const real b1 = square(i0 - eq.getWeight(in, indexLeft));
+        const real a0Left = 1 / (3 * (ALSFVM_WENO_EPSILON + b0) *
+                (ALSFVM_WENO_EPSILON + b0));
+        const real a1Left = 2 / (3 * (ALSFVM_WENO_EPSILON + b1) *
+                (ALSFVM_WENO_EPSILON + b1));
+        const real w0Left = a0Left / (a0Left + a1Left);
+        const real w1Left = a1Left / (a0Left + a1Left);
+
+        const real a0Right = 2 / (3 * (ALSFVM_WENO_EPSILON + b0) *
+                (ALSFVM_WENO_EPSILON + b0));
+        const real a1Right = 1 / (3 * (ALSFVM_WENO_EPSILON + b1) *
+                (ALSFVM_WENO_EPSILON + b1));
+        const real w0Right = a0Right / (a0Right + a1Right);
+        const real w1Right = a1Right / (a0Right + a1Right);
+
+        typename Equation::PrimitiveVariables inLeft =
+            eq.computePrimitiveVariables(eq.fetchConservedVariables(in, indexLeft));
+
+        typename Equation::PrimitiveVariables inMiddle =
+            eq.computePrimitiveVariables(eq.fetchConservedVariables(in, indexMiddle));
+
+        typename Equation::PrimitiveVariables inRight =
+            eq.computePrimitiveVariables(eq.fetchConservedVariables(in, indexRight));
+
+        typename Equation::PrimitiveVariables dPLeft = w1Left * (inMiddle - inLeft) +
+            w0Left * (inRight - inMiddle);
+
+        dPLeft.rho = fmax(-BOUND * inMiddle.rho, fmin(BOUND * inMiddle.rho,
+                    dPLeft.rho));
+        dPLeft.p = fmax(-BOUND * inMiddle.p, fmin(BOUND * inMiddle.p, dPLeft.p));
+
+        real LLLeft = 0.125 * inMiddle.rho * (dPLeft.u.dot(dPLeft.u)) -
+            0.5 * fmin(real(0.0), dPLeft.rho * (inMiddle.u.dot(dPLeft.u))) +
+            0.5 * dPLeft.rho * dPLeft.rho * dPLeft.u.dot(dPLeft.u) / inMiddle.rho;
+
+        real R = inMiddle.p / (eq.getGamma() - 1);
+        real aijkLeft = 0.5 * std::sqrt(R / fmax(R, LLLeft));
+
+        leftOut = eq.computeConserved(inMiddle - aijkLeft * dPLeft);
+
+        typename Equation::PrimitiveVariables dPRight = w1Right * (inMiddle - inLeft) +
+            w0Right * (inRight - inMiddle);
+
+        dPRight.rho = fmax(-BOUND * inMiddle.rho, fmin(BOUND * inMiddle.rho,
+                    dPRight.rho));
+        dPRight.p = fmax(-BOUND * inMiddle.p, fmin(BOUND * inMiddle.p, dPRight.p));
+
+        real LLRight = 0.125 * inMiddle.rho * (dPRight.u.dot(dPRight.u)) -
+            0.5 * fmin(real(0.0), dPRight.rho * (inMiddle.u.dot(dPRight.u))) +
+            0.5 * dPRight.rho * dPRight.rho * dPRight.u.dot(dPRight.u) / inMiddle.rho;
+
+        real aijkRight = 0.5 * std::sqrt(R / fmax(R, LLRight));
+
+        rightOut = eq.computeConserved(inMiddle + aijkRight * dPRight);
+    }
+
     __device__ __host__ static int getNumberOfGhostCells() {
         return 2;
     }
@@ -18,6 +18,7 @@
 #include "alsfvm/numflux/NumericalFlux.hpp"
 #include "alsfvm/diffusion/NoDiffusion.hpp"
 #include "alsfvm/mpi/CellExchanger.hpp"
+#include "alsfvm/mpi/ProgressThread.hpp"
 namespace alsfvm {
 namespace simulator {
 
@@ -37,6 +38,11 @@ public:
     /// \param[out] output will at end of invocation contain the values of
     ///                    \f$F(\vec{u})\f$
     ///
+    /// With a cell exchanger, the interior is computed while the ghost cells
+    /// are exchanged, and the slab along each side is computed as soon as
+    /// the ghost cells of that side have arrived. The time spent waiting for
+    /// the exchange is timed as "alsvinn mpi exchange wait".
+    ///
     virtual void operator()( volume::Volume& conservedVariables,
         rvec3& waveSpeed, bool computeWaveSpeed,
         volume::Volume& output);
@@ -49,11 +55,55 @@ public:
     virtual size_t getNumberOfGhostCells() const ;
 
     void setCellExchanger(mpi::CellExchangerPtr cellExchanger);
+
+    //! Sets the number of substeps the ghost cells are exchanged for at
+    //! once (deep halo). With k stages, the volumes must have k times
+    //! getNumberOfGhostCells() ghost cells. The ghost cells are exchanged
+    //! in the first stage, and every stage also computes the ghost cells
+    //! that are needed by the remaining stages (redundantly, as they are
+    //! computed by the neighbour as well).
+    //!
+    //! Only supported without diffusion.
+    void setHaloStages(size_t haloStages);
+
+    //! Sets the substep the next call to operator() computes. Must be set
+    //! for every substep when the number of halo stages is more than one.
+    void setSubstep(size_t substep);
+
+    //! The number of cells computed redundantly in the ghost cells,
+    //! relative to the number of cells in the interior, for the calls so
+    //! far.
+    real getRedundantComputeFraction() const;
 private:
     alsfvm::shared_ptr<numflux::NumericalFlux> numericalFlux;
     alsfvm::shared_ptr<diffusion::DiffusionOperator> diffusionOperator;
 
     mpi::CellExchangerPtr cellExchanger{nullptr};
+
+    //! Does the halo exchange, made along with the cell exchanger
+    mpi::ProgressThreadPtr progressThread;
+
+    size_t haloStages{1};
+    size_t substep{0};
+
+    //! Counted in the deep halo mode, see getRedundantComputeFraction
+    size_t numberOfCellsComputed{0};
+    size_t numberOfInteriorCells{0};
+    bool redundantComputeFractionLogged{false};
+
+    //! operator() with more than one halo stage
+    void computeWithDeepHalo(volume::Volume& conservedVariables,
+        rvec3& waveSpeed, bool computeWaveSpeed,
+        volume::Volume& output);
+
+    //! The cells next to the given side that only need the ghost cells of
+    //! that side, as start and end for NumericalFlux::computeFlux.
+    static void getSideSlab(const volume::Volume& volume, int side,
+        ivec3& start, ivec3& end);
+
+    //! The cells next to both sides (which are in different directions)
+    static void getEdgeSlab(const volume::Volume& volume, int firstSide,
+        int secondSide, ivec3& start, ivec3& end);
 };
 } // namespace alsfvm
 } // namespace simulator
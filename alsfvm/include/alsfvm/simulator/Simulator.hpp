@@ -147,8 +147,23 @@ public:
 
     std::string getEquationName() const;
 
+    ///
+    /// Sets the initial value (of every member, if this simulator advances an
+    /// ensemble, see SimulatorParameters::setEnsembleSize).
+    ///
     void setInitialValue(alsfvm::shared_ptr<init::InitialData>& initialData);
 
+    ///
+    /// Sets the initial value of the given member of the ensemble, the other
+    /// members are left untouched.
+    ///
+    void setInitialValue(alsfvm::shared_ptr<init::InitialData>& initialData,
+        size_t member);
+
+    //! The number of samples advanced at once, see
+    //! SimulatorParameters::setEnsembleSize
+    size_t getEnsembleSize() const;
+
     const std::shared_ptr<grid::Grid>& getGrid() const override;
     std::shared_ptr<grid::Grid>& getGrid() override;
 
@@ -164,6 +179,16 @@ private:
 
 
     void checkConstraints();
+
+    //! Checks the constraints of a single ensemble member, the ghost layers
+    //! along the ensemble direction are never filled, so they are not checked.
+    void checkEnsembleMemberConstraints(const volume::Volume& memberVolume,
+        size_t member);
+
+    //! Evaluates the initial data on a volume of the size of a single member
+    //! (on the CPU), and copies it to conservedVolume.
+    void computeInitialValue(init::InitialData& initialData,
+        volume::Volume& conservedVolume);
     void incrementSolution();
     void doCellExchange(volume::Volume& volume);
 
@@ -172,8 +197,14 @@ private:
     TimestepInformation timestepInformation;
     alsfvm::shared_ptr<grid::Grid> grid;
     alsfvm::shared_ptr<numflux::NumericalFlux> numericalFlux;
+    alsfvm::shared_ptr<ConservedSystem> conservedSystem;
     alsfvm::shared_ptr<integrator::System> system;
     alsfvm::shared_ptr<integrator::Integrator> integrator;
+
+    //! The number of substeps the ghost cells are exchanged for at once,
+    //! see SimulatorParameters::setHaloStages
+    const size_t haloStages;
+    const size_t numberOfGhostCells;
     alsfvm::shared_ptr<boundary::Boundary> boundary;
     std::vector<alsfvm::shared_ptr<volume::Volume> > conservedVolumes;
     alsfvm::shared_ptr<equation::CellComputer> cellComputer;
@@ -193,6 +224,8 @@ private:
 #endif
 
     const std::string name;
+
+    const size_t ensembleSize;
 };
 } // namespace alsfvm
 } // namespace simulator
@@ -43,11 +43,75 @@ public:
 
     const std::string& getPlatform() const;
 
+    ///
+    /// Sets the flux engine to use on the CPU. Either "standard"
+    /// (reconstruction into full volumes followed by the flux computation)
+    /// or "fused" (reconstruction, flux and divergence in one tiled sweep).
+    ///
+    void setFluxEngine(const std::string& fluxEngine);
+
+    const std::string& getFluxEngine() const;
+
+    ///
+    /// Sets the number of integrator substeps the ghost cells are exchanged
+    /// for at once (deep halo). The volumes then get haloStages times as
+    /// many ghost cells, and the ghost cells are exchanged once every
+    /// haloStages substeps. 1 (default) exchanges before every substep,
+    /// 0 exchanges once per timestep.
+    ///
+    void setHaloStages(size_t haloStages);
+
+    size_t getHaloStages() const;
+
+    ///
+    /// Sets how often (in timesteps) the simulator checks that the solution
+    /// obeys the constraints of the equation (eg. positive density). The
+    /// last timestep is always checked. 1 (default) checks every timestep,
+    /// 0 only checks the last timestep.
+    ///
+    void setConstraintCheckInterval(size_t constraintCheckInterval);
+
+    size_t getConstraintCheckInterval() const;
+
+    ///
+    /// Enables the primitive variable cache of the standard CPU flux engine
+    /// (see numflux::NumericalFluxCPU): the extra variables are computed
+    /// once per cell per flux evaluation instead of for every face. Only
+    /// for the Euler equations without reconstruction. Default false.
+    ///
+    void setPrimitiveCache(bool primitiveCache);
+
+    bool getPrimitiveCache() const;
+
+    ///
+    /// Sets the number of samples the simulator advances at once, stored as
+    /// an ensemble (see volume/ensemble.hpp). They share the timestep, which
+    /// is the smallest of the timesteps of the members. Default 1, ie. an
+    /// ordinary simulation.
+    ///
+    void setEnsembleSize(size_t ensembleSize);
+
+    size_t getEnsembleSize() const;
+
+    ///
+    /// Whether the memory factories of the simulator (and its numerical
+    /// flux) take the memory areas from the memory pool, see
+    /// memory::MemoryFactory. Default true.
+    ///
+    void setMemoryPool(bool memoryPool);
+
+    bool getMemoryPool() const;
 
 private:
     real cflNumber;
     std::string equationName;
     std::string platform;
+    std::string fluxEngine = "standard";
+    size_t haloStages = 1;
+    size_t constraintCheckInterval = 1;
+    bool primitiveCache = false;
+    size_t ensembleSize = 1;
+    bool memoryPool = true;
     alsfvm::shared_ptr<equation::EquationParameters> equationParameters;
 
 };
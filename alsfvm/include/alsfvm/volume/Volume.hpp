@@ -17,6 +17,7 @@
 #include "alsfvm/types.hpp"
 #include "alsfvm/memory/MemoryFactory.hpp"
 #include "alsfvm/memory/Memory.hpp"
+#include "alsfvm/volume/VolumeLayout.hpp"
 #include <string>
 #include <vector>
 
@@ -29,6 +30,10 @@ namespace volume {
 ///
 class Volume : public std::enable_shared_from_this<Volume> {
 public:
+    //! A lazily evaluated linear combination of volumes,
+    //! see memory::LinearCombination
+    typedef memory::LinearCombination<Volume> LinearCombination;
+
     ///
     /// \brief Volume creates a new volume object
     /// \param variableNames a list of the used variable names.
@@ -42,6 +47,7 @@ public:
     /// \param ny the number of cells in y diretion
     /// \param nz the number of cells in z diretion
     /// \param numberOfGhostCells the number of ghost cells
+    /// \param layout how to store the variables, see VolumeLayout
     ///
     /// \note we deduce from ny and nz whether or not to added ghostcells
     ///       in that direction. Ie. if ny==1, then we do not add ghost cells in y direction
@@ -49,7 +55,8 @@ public:
     Volume(const std::vector<std::string>& variableNames,
         alsfvm::shared_ptr<memory::MemoryFactory> memoryFactory,
         size_t nx, size_t ny, size_t nz,
-        size_t numberOfGhostCells = 0);
+        size_t numberOfGhostCells = 0,
+        const VolumeLayout& layout = VolumeLayout());
 
     //! Make a volume as a view of another volume.
     //! @param volume the volume to make a view of
@@ -276,6 +283,14 @@ public:
     void addLinearCombination(real a1, real a2, const Volume& v2, real a3,
         const Volume& v3, real a4, const Volume& v4, real a5, const Volume& v5);
 
+    //! Evaluates the linear combination in one sweep over each variable
+    //! and stores the result in this volume, eg.
+    //! \code{.cpp}
+    //! output.assign(0.5 * U0 + 0.5 * U1 + 0.5 * dt * output);
+    //! \endcode
+    //! This volume may itself appear in the combination.
+    void assign(const LinearCombination& combination);
+
 
     //! Gets the total size in each dimension.
     //! Equivalent to calling
@@ -320,6 +335,11 @@ public:
     std::shared_ptr<volume::Volume> makeInstance(size_t nx, size_t ny, size_t nz,
         const std::string& platform = "default") const;
 
+    //! Makes a new volume with the same variables, number of ghost cells and
+    //! layout, but with the given number of (inner) cells. As always, there
+    //! are only ghost cells in the directions with more than one cell.
+    std::shared_ptr<volume::Volume> makeInstance(const ivec3& numberOfCells) const;
+
     //! If the volume is on the CPU, returns a pointer to the current volume,
     //! otherwise, make a new cpu copy, copy data from gpu, and then return
     std::shared_ptr<volume::Volume> getCopyOnCPU();
@@ -327,6 +347,12 @@ public:
     //! Returns true if the volume has the given variable, false otherwise
     bool hasVariable(const std::string& variableName) const;
 
+    //! Gets the layout of the variables.
+    //! \note A view of a contiguous volume (made with the components
+    //!       constructor) reports the separate layout, since the selected
+    //!       components need not be adjacent.
+    const VolumeLayout& getLayout() const;
+
 private:
     const std::vector<std::string> variableNames;
     alsfvm::shared_ptr<memory::MemoryFactory> memoryFactory;
@@ -340,8 +366,15 @@ private:
     size_t numberOfXGhostCells;
     size_t numberOfYGhostCells;
     size_t numberOfZGhostCells;
+
+    VolumeLayout layout;
 };
 
+//! Starts a linear combination of volumes, see Volume::assign
+inline Volume::LinearCombination operator*(real scalar, const Volume& volume) {
+    return Volume::LinearCombination(scalar, volume);
+}
+
 typedef alsfvm::shared_ptr<Volume> VolumePointer;
 }
 }
@@ -33,9 +33,11 @@ public:
     /// Constructs the factory.
     /// \param equation the equation name ("euler1", "euler2", "euler3", "sw", etc.)
     /// \param memoryFactory the memory factory to use
+    /// \param layout the layout of the volumes made, see VolumeLayout
     ///
     VolumeFactory(const std::string& equation,
-        alsfvm::shared_ptr<memory::MemoryFactory> memoryFactory);
+        alsfvm::shared_ptr<memory::MemoryFactory> memoryFactory,
+        const VolumeLayout& layout = VolumeLayout());
 
 
     ///
@@ -72,6 +74,7 @@ public:
 private:
     std::string equation;
     alsfvm::shared_ptr<alsfvm::memory::MemoryFactory> memoryFactory;
+    VolumeLayout layout;
 };
 } // namespace alsfvm
 } // namespace volume
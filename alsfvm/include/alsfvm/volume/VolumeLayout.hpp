@@ -0,0 +1,56 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <string>
+
+namespace alsfvm {
+namespace volume {
+
+//! Decides how the variables of a volume are stored.
+//!
+//! Say the volume has the variables rho, mx and E.
+//!
+//! * separate: every variable has its own allocation (the default).
+//! * contiguous: one allocation, variable after variable
+//!   (rho rho ... rho mx mx ... mx E E ... E), every variable padded to a
+//!   cache line. Each variable is still a normal contiguous memory area,
+//!   so every kernel works as for separate, but the whole volume can be
+//!   sent or copied in one go.
+//!
+//! The layout of the simulation volumes is set with
+//! <fvm><volumeLayout>, see config::SimulatorSetup.
+struct VolumeLayout {
+    enum Type {
+        separate,
+        contiguous
+    };
+
+    VolumeLayout() = default;
+
+    VolumeLayout(Type type)
+        : type(type) {
+    }
+
+    Type type = separate;
+};
+
+//! Parses "separate" or "contiguous"
+VolumeLayout volumeLayoutFromString(const std::string& name);
+
+//! The inverse of volumeLayoutFromString
+std::string toString(const VolumeLayout& layout);
+}
+}
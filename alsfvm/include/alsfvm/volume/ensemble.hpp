@@ -0,0 +1,73 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsfvm/volume/Volume.hpp"
+#include "alsfvm/grid/Grid.hpp"
+
+namespace alsfvm {
+namespace volume {
+
+//! An ensemble is a number of samples stored in a single volume, so that
+//! they can be advanced together by the same kernels. The members are
+//! stacked along the first direction the grid does not use (y for 1D grids,
+//! z for 2D grids): member m is row (or plane) m of that direction.
+//!
+//! The kernels only work along the directions of the grid, hence the
+//! members never see each other. The ensemble direction gets ghost layers
+//! like any other direction of a volume, they are never read.
+//!
+//! Every member is a contiguous block of each variable, so the functions
+//! below only need the host pointers of the volumes (CPU only).
+
+//! Gets the direction the members of an ensemble on the given grid are
+//! stacked along (1 for 1D grids, 2 for 2D grids).
+//!
+//! \note 3D grids can not be used with ensembles.
+size_t getEnsembleDirection(const grid::Grid& grid);
+
+//! Gets the number of (inner) cells of a volume holding ensembleSize members
+//! on the given grid. An ensemble of one member is an ordinary volume.
+ivec3 getEnsembleDimensions(const grid::Grid& grid, size_t ensembleSize);
+
+//! Gets the number of members of the given ensemble
+size_t getEnsembleSize(const Volume& ensemble, size_t direction);
+
+//! Gets the number of values (per variable) of one member, including the
+//! ghost cells of the other directions
+size_t getEnsembleMemberSize(const Volume& ensemble, size_t direction);
+
+//! Gets the position of the first value of the given member in each of the
+//! memory areas of the ensemble
+size_t getEnsembleMemberOffset(const Volume& ensemble, size_t direction,
+    size_t member);
+
+//! Makes a volume that can hold one member of the ensemble, that is a volume
+//! of the same size as the ensemble but with one cell in the ensemble
+//! direction.
+VolumePointer makeEnsembleMemberVolume(const Volume& ensemble,
+    size_t direction);
+
+//! Copies memberVolume (including its ghost cells) to the given member of the
+//! ensemble. memberVolume is typically made by makeEnsembleMemberVolume.
+void copyToEnsembleMember(const Volume& memberVolume, size_t direction,
+    size_t member, Volume& ensemble);
+
+//! Copies the given member of the ensemble (including its ghost cells) to
+//! memberVolume. memberVolume is typically made by makeEnsembleMemberVolume.
+void copyFromEnsembleMember(const Volume& ensemble, size_t direction,
+    size_t member, Volume& memberVolume);
+}
+}
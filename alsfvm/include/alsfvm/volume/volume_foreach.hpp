@@ -17,8 +17,15 @@
 #include "alsfvm/volume/Volume.hpp"
 #include <functional>
 #include <array>
+#include <vector>
 #include "alsutils/error/Exception.hpp"
 #include "alsfvm/grid/Grid.hpp"
+#include "alsutils/parallel/for_each_cell.hpp"
+#include <algorithm>
+
+#ifdef _OPENMP
+    #include <omp.h>
+#endif
 ///
 /// This file contains for_each functions for volumes
 ///
@@ -61,6 +68,43 @@ inline void for_each_cell_index(const Volume& in, const Function& function,
     }
 }
 
+// The loops over index boxes do not depend on the volume, they are shared
+// with the memory areas.
+using alsutils::parallel::TileDecomposition;
+using alsutils::parallel::for_each_cell_index_parallel;
+using alsutils::parallel::for_each_cell_reduce;
+namespace reductions = alsutils::parallel::reductions;
+#ifdef ALSVINN_USE_MPI
+using alsutils::parallel::for_each_cell_reduce_all;
+#endif
+
+///
+/// Same as for_each_cell_reduce, but function is called with the cell
+/// midpoint and the index of the cell in the volume, and only for the
+/// cells inside the domain (not the ghost cells). Same as for_each_midpoint.
+///
+template<class T, class Function, class Reduction>
+inline T for_each_midpoint_reduce(const Volume& volume,
+    const grid::Grid& grid,
+    const T& identity,
+    const Function& function,
+    const Reduction& reduction) {
+    const ivec3 ghostCells = volume.getNumberOfGhostCells();
+    const ivec3 totalSize = volume.getTotalDimensions();
+    const ivec3 gridSize = grid.getDimensions();
+    const auto& midpoints = grid.getCellMidpoints();
+
+    return for_each_cell_reduce(ghostCells, totalSize - ghostCells, identity,
+    [&](int x, int y, int z) {
+        const size_t index = (size_t(z) * totalSize.y + y) * totalSize.x + x;
+        const size_t midpointIndex = (size_t(z - ghostCells.z) * gridSize.y
+                + (y - ghostCells.y)) * gridSize.x + (x - ghostCells.x);
+        const auto& midpoint = midpoints[midpointIndex];
+
+        return function(midpoint.x, midpoint.y, midpoint.z, index);
+    }, reduction);
+}
+
 ///
 /// Loops through all possible cell indexes in a cache optimal manner.
 /// \param in the volume to loop over
@@ -68,10 +112,9 @@ inline void for_each_cell_index(const Volume& in, const Function& function,
 /// \param offsetStart the triple deciding the starting index
 /// \param offsetEnd the offset for end (must be non-negative!)
 ///
-template<size_t direction, bool parallel = false>
+template<size_t direction, bool parallel = false, class Function>
 inline void for_each_cell_index_with_neighbours(const Volume& in,
-    const std::function<void(size_t leftIndex, size_t middleIndex, size_t rightIndex)>&
-    function,
+    const Function& function,
     ivec3 offsetStart = {0, 0, 0},
     ivec3 offsetEnd = {0, 0, 0}) {
     static_assert(direction < 3, "Direction can be either 0, 1 or 2");
@@ -85,6 +128,16 @@ inline void for_each_cell_index_with_neighbours(const Volume& in,
     const size_t ny = in.getTotalNumberOfYCells() - offsetEnd[1];
     const size_t nz = in.getTotalNumberOfZCells() - offsetEnd[2];
 
+    if (parallel) {
+        for_each_cell_index_parallel(offsetStart, ivec3(nx, ny, nz),
+        [&](int x, int y, int z) {
+            function(view.index(x - xDir, y - yDir, z - zDir),
+                view.index(x, y, z),
+                view.index(x + xDir, y + yDir, z + zDir));
+        });
+        return;
+    }
+
     for (size_t z = offsetStart[2]; z < nz; z++) {
         for (size_t y = offsetStart[1]; y < ny; y++) {
             for (size_t x = offsetStart[0]; x < nx; x++) {
@@ -106,12 +159,13 @@ inline void for_each_cell_index_with_neighbours(const Volume& in,
 /// \param offsetStart the triple deciding the starting index
 /// \param offsetEnd the offset for end (must be non-negative!)
 /// \param direction the direction to use
-/// \note Untemplated version for ease of use, indirectly calls the template version
+/// \note Version with a runtime direction for ease of use, indirectly calls the
+///       version templated on the direction
 ///
+template<class Function>
 inline void for_each_cell_index_with_neighbours(size_t direction,
     const Volume& in,
-    const std::function<void(size_t leftIndex, size_t middleIndex, size_t rightIndex)>&
-    function,
+    const Function& function,
     ivec3 offsetStart = { 0, 0, 0 },
     ivec3 offsetEnd = { 0, 0, 0 }) {
     if (direction == 0) {
@@ -245,9 +299,11 @@ inline void saveVariableStruct(const VariableStruct& in, size_t index,
 /// });
 /// \endcode
 ///
-template<class VariableStructIn, class VariableStructOut>
+/// The cells are processed in parallel, so function must not have side effects.
+///
+template<class VariableStructIn, class VariableStructOut, class Function>
 inline void transform_volume(const Volume& in, Volume& out,
-    const std::function<VariableStructOut(const VariableStructIn&)>& function) {
+    const Function& function) {
 
     std::array < const real*, sizeof(VariableStructIn) / sizeof(real) > pointersIn;
     pointersIn.fill(nullptr);
@@ -269,10 +325,15 @@ inline void transform_volume(const Volume& in, Volume& out,
         pointersOut[i] = out.getScalarMemoryArea(i)->getPointer();
     }
 
-    for_each_cell_index(in, [&](size_t index) {
-        auto out = function(expandVariableStruct<VariableStructIn>(pointersIn, index));
-        saveVariableStruct(out, index, pointersOut);
+    const size_t nx = in.getTotalNumberOfXCells();
+    const size_t ny = in.getTotalNumberOfYCells();
 
+    for_each_cell_index_parallel({0, 0, 0}, {int(nx), int(ny), int(in.getTotalNumberOfZCells())},
+    [&](int x, int y, int z) {
+        const size_t index = z * nx * ny + y * nx + x;
+        VariableStructOut out = function(expandVariableStruct<VariableStructIn>
+                (pointersIn, index));
+        saveVariableStruct(out, index, pointersOut);
     });
 
 }
@@ -18,15 +18,75 @@
 #include <cassert>
 #include "alsfvm/boundary/Neumann.hpp"
 #include "alsfvm/boundary/Periodic.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <vector>
 
 namespace alsfvm {
 namespace boundary {
 namespace {
+// Below this many ghost values, the boundary is applied by the calling
+// thread only
+const size_t minimumValuesForParallelBoundary = 4096;
+
+// The contiguous rows of a face are split in chunks of this many values,
+// so that faces with few rows (eg. z in 3D) can still be done in parallel.
+const size_t chunkSize = 2048;
+
+//! Ghost layers (along one direction) that are copied from the source layers
+//! [sourceLayer, sourceLayer + numberOfLayers) in one block.
+struct LayerRun {
+    int ghostLayer;
+    int sourceLayer;
+    int numberOfLayers;
+};
+
+//! The ghost layers of one side, in the order the boundary conditions fill
+//! them (nearest the inner domain first). Consecutive layers with
+//! consecutive source layers are merged into one run, as long as the
+//! ghost and source layers of the run do not overlap (this is the periodic
+//! case).
+template<class BoundaryConditions>
+std::vector<LayerRun> makeLayerRuns(bool top, int numberOfGhostCells, int n) {
+    std::vector<LayerRun> runs;
+
+    for (int boundaryCell = 1; boundaryCell <= numberOfGhostCells; ++boundaryCell) {
+        const int layer = top ? n - numberOfGhostCells - 1 + boundaryCell
+            : numberOfGhostCells - boundaryCell;
+        const int source = BoundaryConditions::getSourceLayer(layer,
+                numberOfGhostCells, n);
+
+        if (!runs.empty()) {
+            auto& run = runs.back();
+            const int distance = std::abs(source - layer);
+            const bool sameShift = source - layer == run.sourceLayer - run.ghostLayer;
+            const bool disjoint = distance >= run.numberOfLayers + 1;
+
+            if (sameShift && disjoint && (layer == run.ghostLayer - 1
+                    || layer == run.ghostLayer + run.numberOfLayers)) {
+                run.ghostLayer = std::min(run.ghostLayer, layer);
+                run.sourceLayer = std::min(run.sourceLayer, source);
+                run.numberOfLayers++;
+                continue;
+            }
+        }
+
+        runs.push_back({layer, source, 1});
+    }
+
+    return runs;
+}
+
 ///
 /// small helper function
 /// \param volume the volume to apply neumann boundary conditions to
 /// \param dimensions the number of dimensions(1,2 or 3).
 ///
+/// Fills all variables and all ghost layers of the faces of one direction
+/// in a single parallel sweep. Along y and z the ghost layers are
+/// contiguous rows (or planes), and are filled with block copies.
+///
 template<class BoundaryConditions>
 void applyBoundary(volume::Volume& volume, const size_t dimensions,
     const size_t numberOfGhostCells,
@@ -49,57 +109,72 @@ void applyBoundary(volume::Volume& volume, const size_t dimensions,
     assert(nx * sizeof(real) == volume.getScalarMemoryArea(0)->getExtentXInBytes());
     assert(ny * sizeof(real) == volume.getScalarMemoryArea(0)->getExtentYInBytes());
 
-    // loop through variables
-    for (size_t var = 0; var < volume.getNumberOfVariables(); var++) {
-        auto view = volume.getScalarMemoryArea(var)->getView();
-
-        // loop through dimensions
-        for (size_t d = 0; d < dimensions; d++) {
-            // i=0 represents bottom, i=1 represents top
-            for (int i = 0; i < 2; i++) {
-                const int side = 2 * d + i;
+    const int numberOfVariables = int(volume.getNumberOfVariables());
+    std::vector<real*> variables;
 
-                if (grid.getBoundaryCondition(side) == MPI_BC) {
-
-                    continue;
-                }
-
-
-                const bool zDir = (d == 2);
-                const bool yDir = (d == 1);
-                const bool xDir = (d == 0);
-                // Either we start on the left (i == 0), or on the right(i==1)
-                const size_t zStart = zDir ?
-                    (i == 0 ? numberOfGhostCells : nz - numberOfGhostCells - 1) : 0;
+    for (int var = 0; var < numberOfVariables; ++var) {
+        variables.push_back(volume.getScalarMemoryArea(var)->getPointer());
+    }
 
-                const size_t zEnd = zDir ?
-                    (zStart + 1) : nz;
+    const std::array<size_t, 3> totalNumberOfCells = {nx, ny, nz};
 
-                const size_t yStart = yDir ?
-                    (i == 0 ? numberOfGhostCells : ny - numberOfGhostCells - 1) : 0;
+    // The directions are done one after the other, as the edges and corners
+    // are filled from the ghost cells of the previous directions.
+    for (size_t d = 0; d < dimensions; d++) {
+        std::vector<LayerRun> runs;
 
-                const size_t yEnd = yDir ?
-                    (yStart + 1) : ny;
+        // i=0 represents bottom, i=1 represents top
+        for (int i = 0; i < 2; i++) {
+            const int side = 2 * d + i;
 
-                const size_t xStart = xDir ?
-                    (i == 0 ? numberOfGhostCells : nx - numberOfGhostCells - 1) : 0;
+            if (grid.getBoundaryCondition(side) == MPI_BC) {
+                continue;
+            }
 
-                const size_t xEnd = xDir ?
-                    (xStart + 1) : nx;
+            const auto sideRuns = makeLayerRuns<BoundaryConditions>(i == 1,
+                    int(numberOfGhostCells), int(totalNumberOfCells[d]));
+            runs.insert(runs.end(), sideRuns.begin(), sideRuns.end());
+        }
 
-                for (size_t z = zStart; z < zEnd; z++) {
-                    for (size_t y = yStart; y < yEnd; y++) {
-                        for (size_t x = xStart; x < xEnd; x++) {
+        if (runs.empty()) {
+            continue;
+        }
 
-                            for (size_t ghostCell = 1; ghostCell <= numberOfGhostCells; ghostCell++) {
-                                BoundaryConditions::applyBoundary(view, x, y, z, ghostCell, numberOfGhostCells,
-                                    i == 1, xDir, yDir, zDir);
+        // The memory is viewed as lines along direction d: the cell at layer
+        // l of line k, position p is at k * lineLength + l * stride + p,
+        // where p is in [0, stride).
+        const size_t stride = d == 0 ? 1 : (d == 1 ? nx : nx * ny);
+        const size_t lineLength = stride * totalNumberOfCells[d];
+        const size_t numberOfLines = nx * ny * nz / lineLength;
+        const size_t numberOfChunks = (stride + chunkSize - 1) / chunkSize;
+        const size_t numberOfValues = numberOfVariables * numberOfLines * stride
+            * 2 * numberOfGhostCells;
+
+        #pragma omp parallel for collapse(3) if (numberOfValues > minimumValuesForParallelBoundary)
+
+        for (int var = 0; var < numberOfVariables; ++var) {
+            for (size_t line = 0; line < numberOfLines; ++line) {
+                for (size_t chunk = 0; chunk < numberOfChunks; ++chunk) {
+                    real* base = variables[var] + line * lineLength;
+                    const size_t begin = chunk * chunkSize;
+                    const size_t end = std::min(stride, begin + chunkSize);
+
+                    // The runs have to be done in order, the later ones may
+                    // read cells written by the earlier ones.
+                    for (const auto& run : runs) {
+                        if (numberOfChunks == 1) {
+                            const real* source = base + run.sourceLayer * stride;
+                            std::copy(source, source + run.numberOfLayers * stride,
+                                base + run.ghostLayer * stride);
+                        } else {
+                            for (int layer = 0; layer < run.numberOfLayers; ++layer) {
+                                const real* source = base + (run.sourceLayer + layer) * stride;
+                                std::copy(source + begin, source + end,
+                                    base + (run.ghostLayer + layer) * stride + begin);
                             }
                         }
                     }
                 }
-
-
             }
         }
     }
@@ -40,6 +40,7 @@
 
 #ifdef ALSVINN_USE_MPI
     #include "alsfvm/mpi/domain/CartesianDecomposition.hpp"
+    #include "alsfvm/mpi/CartesianCellExchanger.hpp"
     #include "alsfvm/io/MpiWriterFactory.hpp"
 #endif
 
@@ -56,8 +57,48 @@ namespace config {
 //   <endTime>1.0</endTime>
 //   <equation>euler</equation>
 //   <reconstruction>none</reconstruction>
+//   <!-- the forward Euler CFL number, auto is 0.9 without and 0.475 with
+//        reconstruction. The SSP integrators multiply it by their SSP
+//        coefficient, eg. ssprk104 takes timesteps with an effective CFL
+//        number of 6 * 0.475 = 2.85 (spread over ten stages). -->
 //   <cfl>auto</cfl>
+//   <!-- the strong stability preserving integrators are forwardeuler,
+//        rungekutta2, rungekutta3, ssprk43, ssprk93 and ssprk104 (the last
+//        three with low storage). The low storage williamson3 and
+//        carpenterkennedy4 are not SSP. -->
 //   <integrator>auto</integrator>
+//   <!-- optional, error tolerance for the adaptive integrators
+//        (eg. bogackishampine), default 1e-4 -->
+//   <integratorTolerance>1e-4</integratorTolerance>
+//   <!-- optional, either standard (default) or fused -->
+//   <fluxEngine>standard</fluxEngine>
+//   <!-- optional, with MPI: the number of integrator substeps to exchange
+//        the ghost cells for at once, 0 is once per timestep. Default 1,
+//        other values need cpu, no diffusion and no eno reconstruction -->
+//   <haloStages>1</haloStages>
+//   <!-- optional, check that the solution obeys the constraints (eg.
+//        positive density) every this many timesteps, and after the last
+//        timestep. Default 1, 0 only checks after the last timestep -->
+//   <constraintCheckInterval>1</constraintCheckInterval>
+//   <!-- optional, compute p and u once per cell per flux evaluation
+//        instead of at every face. Default false, needs cpu, euler, the
+//        standard flux engine and no reconstruction -->
+//   <primitiveCache>false</primitiveCache>
+//   <!-- optional, keep the memory of destroyed volumes in a pool and reuse
+//        it for volumes of the same size (eg. in the next sample). The pool
+//        never holds more than the peak memory in use. Default true -->
+//   <memoryPool>true</memoryPool>
+//   <!-- optional, separate (default) gives every variable of a volume its
+//        own allocation, contiguous keeps all variables of a volume in one
+//        allocation (see volume::VolumeLayout) -->
+//   <volumeLayout>separate</volumeLayout>
+//   <!-- optional, with MPI: either exact (default), waiting for the
+//        maximum wave speed over all processes every timestep, or lagged,
+//        estimating it from the previous timesteps (see
+//        mpi::LaggedWaveSpeedReduction) -->
+//   <waveSpeedReduction>exact</waveSpeedReduction>
+//   <!-- optional, only for lagged, the estimate is divided by this -->
+//   <waveSpeedSafetyFactor>0.9</waveSpeedSafetyFactor>
 //   <initialData>
 //     <python>riemann.py</python>
 //   </initialData>
@@ -122,7 +163,9 @@ const std::string& filename) {
     std::set<std::string> supportedNodes = {
         "name", "platform", "boundary", "flux", "endTime", "equation", "equationParameters",
         "reconstruction", "cfl", "integrator", "initialData", "writer", "grid", "diffusion",
-        "functionals"
+        "functionals", "fluxEngine", "integratorTolerance", "haloStages",
+        "waveSpeedReduction", "waveSpeedSafetyFactor", "constraintCheckInterval",
+        "primitiveCache", "memoryPool", "volumeLayout"
     };
 
     for (auto node : configuration.get_child("fvm")) {
@@ -131,18 +174,27 @@ const std::string& filename) {
         }
     }
 
+    if (ensembleSize > 1) {
+        checkEnsembleConfiguration(configuration);
+    }
+
     auto grid = createGrid(configuration);
     auto boundary = readBoundary(configuration);
 
 #ifdef ALSVINN_USE_MPI
     mpi::CellExchangerPtr cellExchangerPtr;
 
-    if (useMPI) {
+    // An ensemble is always on a single process (checked above), and the
+    // decomposition would not do anything but add a (no-op) cell exchanger
+    if (useMPI && ensembleSize == 1) {
         this->mpiConfiguration = alsfvm::make_shared<alsfvm::mpi::Configuration>
             (this->mpiConfiguration->getCommunicator(), readPlatform(configuration));
-        auto domainInformation = decomposeGrid(grid);
+        const auto& fvmNode = configuration.get_child("fvm");
+        auto domainInformation = decomposeGrid(grid,
+                fvmNode.find("functionals") != fvmNode.not_found());
         grid = domainInformation->getGrid();
         cellExchangerPtr = domainInformation->getCellExchanger();
+        setupWaveSpeedReduction(configuration, cellExchangerPtr);
     }
 
 #endif
@@ -166,17 +218,25 @@ const std::string& filename) {
     parameters(new simulator::SimulatorParameters(equation, platform));
     readEquationParameters(configuration, *parameters);
     parameters->setCFLNumber(cfl);
+    parameters->setFluxEngine(readFluxEngine(configuration));
+    parameters->setHaloStages(readHaloStages(configuration));
+    parameters->setConstraintCheckInterval(readConstraintCheckInterval(
+            configuration));
+    parameters->setPrimitiveCache(readPrimitiveCache(configuration));
+    parameters->setEnsembleSize(ensembleSize);
+    parameters->setMemoryPool(configuration.get<bool>("fvm.memoryPool", true));
 
     auto memoryFactory = alsfvm::make_shared<memory::MemoryFactory>
-        (deviceConfiguration);
+        (deviceConfiguration, parameters->getMemoryPool());
     auto volumeFactory = alsfvm::make_shared<volume::VolumeFactory>(equation,
-            memoryFactory);
+            memoryFactory, volume::volumeLayoutFromString(
+                configuration.get<std::string>("fvm.volumeLayout", "separate")));
     auto boundaryFactory = alsfvm::make_shared<boundary::BoundaryFactory>(boundary,
             deviceConfiguration);
     auto numericalFluxFactory = alsfvm::make_shared<numflux::NumericalFluxFactory>
         (equation, fluxname, reconstruction, parameters, deviceConfiguration);
     auto integratorFactory = alsfvm::make_shared<integrator::IntegratorFactory>
-        (integrator);
+        (integrator, readIntegratorTolerance(configuration));
 
     auto cellComputerFactory = alsfvm::make_shared<equation::CellComputerFactory>
         (parameters, deviceConfiguration);
@@ -201,7 +261,9 @@ const std::string& filename) {
             diffusionOperator,
             name);
 
-    simulator->setCellExchanger(cellExchangerPtr);
+    if (cellExchangerPtr) {
+        simulator->setCellExchanger(cellExchangerPtr);
+    }
 
     if (writer) {
         simulator->addWriter(writer);
@@ -235,6 +297,14 @@ void SimulatorSetup::setWriterFactory(std::shared_ptr<io::WriterFactory>
     this->writerFactory = writerFactory;
 }
 
+void SimulatorSetup::setEnsembleSize(size_t ensembleSize) {
+    if (ensembleSize == 0) {
+        THROW("The ensemble size has to be at least one");
+    }
+
+    this->ensembleSize = ensembleSize;
+}
+
 #ifdef ALSVINN_USE_MPI
 void SimulatorSetup::enableMPI(MPI_Comm communicator, int multiX, int multiY,
     int multiZ) {
@@ -242,9 +312,15 @@ void SimulatorSetup::enableMPI(MPI_Comm communicator, int multiX, int multiY,
         multiX, multiY, multiZ);
 }
 
+void SimulatorSetup::enableMPI(MPI_Comm communicator) {
+    this->enableMPI(communicator, 0, 0, 0);
+    automaticDecomposition = true;
+}
+
 void SimulatorSetup::enableMPI(alsutils::mpi::ConfigurationPtr configuration,
     int multiX, int multiY, int multiZ) {
     useMPI = true;
+    automaticDecomposition = false;
     this->mpiConfiguration = configuration;
     this->multiX = multiX;
     this->multiY = multiY;
@@ -325,8 +401,16 @@ std::string SimulatorSetup::readIntegrator(const SimulatorSetup::ptree&
     if (integratorString == "auto" ) {
         auto reconstruction = readReconstruciton(configuration);
 
+        // The CFL number is the forward Euler one, the integrators scale
+        // it by their SSP coefficient (see Integrator::getCFLMultiplier).
+        // For the higher order reconstructions we pick the many stage SSP
+        // methods, they allow the largest timestep per flux evaluation.
         if (reconstruction == "none") {
             return "forwardeuler";
+        } else if (reconstruction == "eno3") {
+            return "ssprk43";
+        } else if (reconstruction == "eno4" || reconstruction == "weno3") {
+            return "ssprk104";
         } else {
             return "rungekutta2";
         }
@@ -542,6 +626,142 @@ std::string SimulatorSetup::readName(const SimulatorSetup::ptree&
     return boost::algorithm::trim_copy(configuration.get<std::string>("fvm.name"));
 }
 
+std::string SimulatorSetup::readFluxEngine(const SimulatorSetup::ptree&
+    configuration) {
+    return boost::algorithm::trim_copy(configuration.get<std::string>("fvm.fluxEngine",
+                "standard"));
+}
+
+real SimulatorSetup::readIntegratorTolerance(const SimulatorSetup::ptree&
+    configuration) {
+    return configuration.get<real>("fvm.integratorTolerance", real(1e-4));
+}
+
+size_t SimulatorSetup::readHaloStages(const SimulatorSetup::ptree&
+    configuration) {
+    const int haloStages = configuration.get<int>("fvm.haloStages", 1);
+
+    if (haloStages < 0) {
+        THROW("haloStages can not be negative, was given " << haloStages);
+    }
+
+    if (haloStages != 1) {
+        const auto platform = readPlatform(configuration);
+        const auto reconstruction = readReconstruciton(configuration);
+        const auto diffusion = boost::algorithm::trim_copy(
+                configuration.get<std::string>("fvm.diffusion.name", "none"));
+
+        if (platform != "cpu" || diffusion != "none"
+            || boost::algorithm::starts_with(reconstruction, "eno")) {
+            THROW("haloStages other than 1 is only supported on the cpu, "
+                << "without diffusion and without eno reconstruction.\n"
+                << "Given platform = " << platform << ", diffusion = "
+                << diffusion << ", reconstruction = " << reconstruction);
+        }
+    }
+
+    return size_t(haloStages);
+}
+
+size_t SimulatorSetup::readConstraintCheckInterval(const SimulatorSetup::ptree&
+    configuration) {
+    const int interval = configuration.get<int>("fvm.constraintCheckInterval", 1);
+
+    if (interval < 0) {
+        THROW("constraintCheckInterval can not be negative, was given "
+            << interval);
+    }
+
+    return size_t(interval);
+}
+
+bool SimulatorSetup::readPrimitiveCache(const SimulatorSetup::ptree&
+    configuration) {
+    const bool primitiveCache = configuration.get<bool>("fvm.primitiveCache",
+            false);
+
+    if (primitiveCache) {
+        const auto platform = readPlatform(configuration);
+        const auto equation = readEquation(configuration);
+        const auto reconstruction = readReconstruciton(configuration);
+        const auto fluxEngine = readFluxEngine(configuration);
+
+        if (platform != "cpu" || !boost::algorithm::starts_with(equation, "euler")
+            || fluxEngine != "standard" || reconstruction != "none") {
+            THROW("primitiveCache is only supported on the cpu, for the euler "
+                << "equations, with the standard flux engine and without "
+                << "reconstruction.\n"
+                << "Given platform = " << platform << ", equation = " << equation
+                << ", fluxEngine = " << fluxEngine << ", reconstruction = "
+                << reconstruction);
+        }
+    }
+
+    return primitiveCache;
+}
+
+void SimulatorSetup::checkEnsembleConfiguration(const SimulatorSetup::ptree&
+    configuration) {
+    const auto platform = readPlatform(configuration);
+
+    if (platform != "cpu") {
+        THROW("Ensembles are only supported on the cpu, given platform = "
+            << platform);
+    }
+
+    // The writers and functionals would see all the members as one volume
+    const auto& fvmNode = configuration.get_child("fvm");
+
+    for (const std::string node : {
+            "writer", "functionals"
+        }) {
+        if (fvmNode.find(node) != fvmNode.not_found()) {
+            THROW("fvm." << node << " can not be used with an ensemble");
+        }
+    }
+
+    if (fvmNode.find("diffusion") != fvmNode.not_found()
+        && boost::algorithm::trim_copy(configuration.get<std::string>
+            ("fvm.diffusion.name")) != "none") {
+        THROW("Diffusion can not be used with an ensemble");
+    }
+
+#ifdef ALSVINN_USE_MPI
+
+    if (useMPI && mpiConfiguration->getNumberOfProcesses() > 1) {
+        THROW("An ensemble has to be computed on a single process, the spatial "
+            << "communicator has " << mpiConfiguration->getNumberOfProcesses()
+            << " processes");
+    }
+
+#endif
+}
+
+#ifdef ALSVINN_USE_MPI
+void SimulatorSetup::setupWaveSpeedReduction(const SimulatorSetup::ptree&
+    configuration, mpi::CellExchangerPtr cellExchanger) {
+    const auto waveSpeedReduction = boost::algorithm::trim_copy(
+            configuration.get<std::string>("fvm.waveSpeedReduction", "exact"));
+
+    if (waveSpeedReduction == "exact") {
+        return;
+    } else if (waveSpeedReduction != "lagged") {
+        THROW("Unknown waveSpeedReduction " << waveSpeedReduction
+            << ", expected exact or lagged");
+    }
+
+    auto cartesianCellExchanger =
+        alsfvm::dynamic_pointer_cast<mpi::CartesianCellExchanger>(cellExchanger);
+
+    if (!cartesianCellExchanger) {
+        THROW("The lagged wave speed reduction needs a CartesianCellExchanger");
+    }
+
+    cartesianCellExchanger->setLaggedWaveSpeedReduction(
+        configuration.get<real>("fvm.waveSpeedSafetyFactor", real(0.9)));
+}
+#endif
+
 std::vector<io::WriterPointer> SimulatorSetup::createFunctionals(
     const SimulatorSetup::ptree& configuration,
     volume::VolumeFactory& volumeFactory) {
@@ -645,10 +865,25 @@ std::string SimulatorSetup::readFlux(const SimulatorSetup::ptree&
 
 #ifdef ALSVINN_USE_MPI
 mpi::domain::DomainInformationPtr SimulatorSetup::decomposeGrid(
-    const alsfvm::shared_ptr<grid::Grid>& grid) {
+    const alsfvm::shared_ptr<grid::Grid>& grid, bool requireEvenBlocks) {
     // for now we assume we have a cartesian grid
+    if (automaticDecomposition) {
+        const auto numberOfProcessors =
+            mpi::domain::CartesianDecomposition::findNumberOfProcessorsPerDirection(
+                mpiConfiguration->getNumberOfProcesses(), *grid, requireEvenBlocks);
+
+        ALSVINN_LOG(INFO, "Automatic domain decomposition with "
+            << numberOfProcessors << " processors");
+
+        mpi::domain::CartesianDecomposition cartesianDecomposition(
+            numberOfProcessors.x, numberOfProcessors.y, numberOfProcessors.z, true);
+
+        return cartesianDecomposition.decompose(mpiConfiguration, *grid);
+    }
+
     mpi::domain::CartesianDecomposition cartesianDecomposition(multiX, multiY,
         multiZ);
+    cartesianDecomposition.setRequireEvenBlocks(requireEvenBlocks);
 
     return cartesianDecomposition.decompose(mpiConfiguration, *grid);
 
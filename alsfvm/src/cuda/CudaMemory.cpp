@@ -25,6 +25,7 @@
 #include "alsfvm/memory/HostMemory.hpp"
 #include "alsutils/log.hpp"
 #include "alsutils/config.hpp"
+#include "alsutils/memory/MemoryPool.hpp"
 
 #include <chrono>
 #include <thread>
@@ -40,18 +41,12 @@
 using namespace alsfvm::memory;
 namespace alsfvm {
 namespace cuda {
-
-template<class T> CudaMemory<T>::CudaMemory(size_t nx, size_t ny, size_t nz)
-    : memory::Memory<T>(nx, ny, nz) {
-#ifdef ALSVINN_PRINT_MEMORY_ALLOCATIONS
-    const size_t size = nx * ny * nz * sizeof(T);
-    const double sizeGb = size / 1000000000.0;
-    ALSVINN_LOG(INFO, "CUDA allocating " << size << " bytes (" << sizeGb <<
-        " GB), in " << alsutils::debug::getShortStacktrace());
-#endif
+namespace {
+void* allocateOnDevice(size_t bytes) {
+    void* pointer = nullptr;
 
     try {
-        CUDA_SAFE_CALL(cudaMalloc(&memoryPointer, nx * ny * nz * sizeof(T)));
+        CUDA_SAFE_CALL(cudaMalloc(&pointer, bytes));
     } catch (std::runtime_error& exception) {
         // allocation failed, but will will give it another go, since this
         // sometimes happens because the bus is busy.
@@ -60,34 +55,98 @@ template<class T> CudaMemory<T>::CudaMemory(size_t nx, size_t ny, size_t nz)
 
         CUDA_SAFE_CALL(cudaGetDevice(&currentCudaDevice));
         ALSVINN_LOG(WARNING, "Failed allocating "
-            << (nx * ny * nz * sizeof(T)) << " bytes, \n"
+            << bytes << " bytes, \n"
             << "Current CUDA device: " << currentCudaDevice << "\n"
             << "Error message was: " << exception.what() << "\n"
             << "Trying one more time in " << waitTimeInMilliseconds << " ms\n");
 
         // We usually give this one more shot, first we wait 50 milliseconds
         std::this_thread::sleep_for (std::chrono::milliseconds(waitTimeInMilliseconds));
-        CUDA_SAFE_CALL(cudaMalloc(&memoryPointer, nx * ny * nz * sizeof(T)));
+        CUDA_SAFE_CALL(cudaMalloc(&pointer, bytes));
+    }
+
+    return pointer;
+}
+
+void freeOnDevice(void* pointer) {
+    // This can be called when the pool is destroyed at exit, where the
+    // CUDA runtime may already be shut down, so we never throw.
+    try {
+        CUDA_SAFE_CALL(cudaFree(pointer));
+    } catch (std::runtime_error& e) {
+        ALSVINN_LOG(ERROR, "Could not free device memory, error message was\n\n"
+            << e.what());
+    }
+}
+
+//! Pooled device memory is recycled between samples and snapshots, since
+//! cudaMalloc/cudaFree synchronize the device.
+alsutils::memory::MemoryPool& getDevicePool() {
+    static alsutils::memory::MemoryPool devicePool("cuda", allocateOnDevice,
+        freeOnDevice, 4096);
+    return devicePool;
+}
+}
+
+template<class T> CudaMemory<T>::CudaMemory(size_t nx, size_t ny, size_t nz,
+    bool pooled)
+    : memory::Memory<T>(nx, ny, nz), pooled(pooled) {
+#ifdef ALSVINN_PRINT_MEMORY_ALLOCATIONS
+    const size_t size = nx * ny * nz * sizeof(T);
+    const double sizeGb = size / 1000000000.0;
+    ALSVINN_LOG(INFO, "CUDA allocating " << size << " bytes (" << sizeGb <<
+        " GB), in " << alsutils::debug::getShortStacktrace());
+#endif
+
+    if (pooled) {
+        memoryPointer = static_cast<T*>(getDevicePool().acquire(
+                    nx * ny * nz * sizeof(T)));
+    } else {
+        memoryPointer = static_cast<T*>(allocateOnDevice(nx * ny * nz * sizeof(T)));
     }
 
     CUDA_SAFE_CALL(cudaMemset(memoryPointer, 0, nx * ny * nz * sizeof(T)));
 }
 
+template<class T> CudaMemory<T>::CudaMemory(std::shared_ptr<CudaMemory<T> >
+    storage, size_t offset, size_t nx, size_t ny, size_t nz)
+    : memory::Memory<T>(nx, ny, nz), pooled(storage->isPooled()),
+      memoryPointer(storage->getPointer() + offset), storage(storage) {
+    if (offset + nx * ny * nz > storage->getSize()) {
+        THROW("Sub area [" << offset << ", " << offset + nx * ny * nz
+            << ") does not fit in storage of size " << storage->getSize());
+    }
+}
+
 template<class T>
 std::shared_ptr<memory::Memory<T> > CudaMemory<T>::makeInstance() const {
     std::shared_ptr<memory::Memory<T> > memoryArea;
-    memoryArea.reset(new CudaMemory<T>(this->nx, this->ny, this->nz));
+    memoryArea.reset(new CudaMemory<T>(this->nx, this->ny, this->nz, pooled));
 
     return memoryArea;
 }
 
+template<class T>
+bool CudaMemory<T>::isPooled() const {
+    return pooled;
+}
+
 // Note: Virtual distructor since we will inherit
 // from this.
 template<class T> CudaMemory<T>::~CudaMemory() {
     // We do not want to throw exceptions from a Destructor, see
     // http://en.cppreference.com/w/cpp/language/destructor#Exceptions
+    if (storage) {
+        return;
+    }
+
     try {
-        CUDA_SAFE_CALL(cudaFree(memoryPointer));
+        if (pooled) {
+            getDevicePool().release(memoryPointer,
+                this->nx * this->ny * this->nz * sizeof(T));
+        } else {
+            freeOnDevice(memoryPointer);
+        }
     } catch (std::runtime_error& e) {
         ALSVINN_LOG(ERROR, "Could not delete CudaMemory, error message was\n\n"
             << e.what());
@@ -314,6 +373,24 @@ void CudaMemory<T>::addLinearCombination(T a1,
 
 }
 
+template<class T>
+void CudaMemory<T>::assign(const memory::LinearCombination<memory::Memory<T>, T>&
+    combination) {
+    constexpr size_t maximumNumberOfTerms =
+        memory::LinearCombination<memory::Memory<T>, T>::maximumNumberOfTerms;
+    T coefficients[maximumNumberOfTerms];
+    const T* operands[maximumNumberOfTerms];
+
+    for (size_t term = 0; term < combination.getNumberOfTerms(); ++term) {
+        CHECK_SIZE_AND_HOST(combination.getOperand(term));
+        coefficients[term] = combination.getCoefficient(term);
+        operands[term] = combination.getOperand(term).getPointer();
+    }
+
+    linear_combination(getPointer(), coefficients, operands,
+        combination.getNumberOfTerms(), this->getSize());
+}
+
 template<class T>
 void CudaMemory<T>::addPower(const memory::Memory<T>& other, double power) {
     CHECK_SIZE_AND_HOST(other);
@@ -16,6 +16,7 @@
 #include "alsfvm/cuda/vector_operations.hpp"
 #include "alsfvm/types.hpp"
 #include "alsfvm/cuda/cuda_utils.hpp"
+#include "alsfvm/memory/LinearCombination.hpp"
 #include <cuda.h>
 #include <cuda_runtime.h>
 #include <thrust/device_vector.h>
@@ -108,6 +109,30 @@ __global__ void linear_combination_device(T a1, T* v1,
     }
 }
 
+//! The terms of a linear combination, passed by value to the kernel
+template<class T>
+struct LinearCombinationTerms {
+    T coefficients[alsfvm::memory::LinearCombination<alsfvm::memory::Memory<T>, T>::maximumNumberOfTerms];
+    const T* operands[alsfvm::memory::LinearCombination<alsfvm::memory::Memory<T>, T>::maximumNumberOfTerms];
+    int numberOfTerms;
+};
+
+template<class T>
+__global__ void linear_combination_device(T* result,
+    LinearCombinationTerms<T> terms,
+    size_t size) {
+    size_t index = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (index < size) {
+        T sum = terms.coefficients[0] * terms.operands[0][index];
+
+        for (int term = 1; term < terms.numberOfTerms; ++term) {
+            sum += terms.coefficients[term] * terms.operands[term][index];
+        }
+
+        result[index] = sum;
+    }
+}
 
 template<class T>
 __global__ void add_power_device(T* out, const T* a, double power,
@@ -346,6 +371,22 @@ void add_linear_combination(T a1, T* v1,
                               threadCount >> > (a1, v1, a2, v2, a3, v3, a4, v4, a5, v5, size);
 }
 
+template<class T>
+void linear_combination(T* result, const T* coefficients,
+    const T* const* operands, size_t numberOfTerms, size_t size) {
+    LinearCombinationTerms<T> terms;
+    terms.numberOfTerms = int(numberOfTerms);
+
+    for (size_t term = 0; term < numberOfTerms; ++term) {
+        terms.coefficients[term] = coefficients[term];
+        terms.operands[term] = operands[term];
+    }
+
+    const size_t threadCount = 1024;
+    linear_combination_device << < (size + threadCount - 1) / threadCount,
+                              threadCount >> > (result, terms, size);
+}
+
 template<class T>
 void add_power(T* a, const T* b, double power, size_t size) {
     const size_t threadCount = 1024;
@@ -440,6 +481,9 @@ template void add_linear_combination<real>(real a1, real* v1, real a2,
     real a5, const real* v5,
     size_t size);
 
+template void linear_combination<real>(real* result, const real* coefficients,
+    const real* const* operands, size_t numberOfTerms, size_t size);
+
 template void add_power<real>(real* a, const real* b, double power,
     size_t size);
 
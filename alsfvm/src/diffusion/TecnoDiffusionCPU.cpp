@@ -40,8 +40,8 @@ void applyDiffusionCPU(Equation equation, volume::Volume& outputVolume,
     typename Equation::ConstViews conservedView(conservedVolume);
     typename Equation::Views outputView(outputVolume);
 
-    volume::for_each_cell_index_with_neighbours(direction,
-    left, [&](size_t leftIndex, size_t middleIndex, size_t rightIndex) {
+    volume::for_each_cell_index_with_neighbours<direction, true>(
+        left, [&](size_t leftIndex, size_t middleIndex, size_t rightIndex) {
 
 
 
@@ -70,7 +70,7 @@ void applyDiffusionCPU(Equation equation, volume::Volume& outputVolume,
 
 
 
-    volume::for_each_cell_index_with_neighbours(direction,
+    volume::for_each_cell_index_with_neighbours<direction, true>(
         left, [&](size_t leftIndexOuter, size_t middleIndexOuter,
     size_t rightIndexOuter) {
         auto diffusion = [&](size_t leftIndex, size_t rightIndex) {
@@ -17,6 +17,7 @@
 #include "alsfvm/equation/euler/Euler.hpp"
 #include "alsfvm/volume/volume_foreach.hpp"
 #include "alsfvm/equation/equation_list.hpp"
+#include "alsutils/log.hpp"
 
 namespace alsfvm {
 namespace equation {
@@ -47,81 +48,66 @@ template<class Equation>
 real CPUCellComputer<Equation>::computeMaxWaveSpeed(const volume::Volume&
     conservedVariables, size_t direction) {
     Equation eq(parameters);
-    real maxWaveSpeed = 0;
     assert(direction < 3);
-    volume::for_each_cell<typename Equation::ConservedVariables>(conservedVariables,
-        [&maxWaveSpeed, direction,
-                   &eq](const typename Equation::ConservedVariables & conserved, size_t index) {
+    typename Equation::ConstViews conservedViews(conservedVariables);
+
+    const ivec3 end(conservedVariables.getTotalNumberOfXCells(),
+        conservedVariables.getTotalNumberOfYCells(),
+        conservedVariables.getTotalNumberOfZCells());
+
+    return volume::for_each_cell_reduce({0, 0, 0}, end, real(0),
+    [&](int x, int y, int z) {
+        const auto conserved = eq.fetchConservedVariables(conservedViews,
+                conservedViews.index(x, y, z));
         auto extra = eq.computeExtra(conserved);
 
         if (direction == 0) {
-            const real waveSpeedX = eq.template computeWaveSpeed<0>(conserved, extra);
-            maxWaveSpeed = std::max(maxWaveSpeed, waveSpeedX);
+            return eq.template computeWaveSpeed<0>(conserved, extra);
         } else if (direction == 1) {
-            const real waveSpeedY = eq.template computeWaveSpeed<1>(conserved, extra);
-            maxWaveSpeed = std::max(maxWaveSpeed, waveSpeedY);
-        }    else if (direction == 2) {
-            const real waveSpeedZ = eq.template computeWaveSpeed<2>(conserved, extra);
-            maxWaveSpeed = std::max(maxWaveSpeed, waveSpeedZ);
+            return eq.template computeWaveSpeed<1>(conserved, extra);
+        } else {
+            return eq.template computeWaveSpeed<2>(conserved, extra);
         }
-    });
-
-    return maxWaveSpeed;
+    }, volume::reductions::Max());
 }
 
 ///
 /// Checks if all the constraints for the equation are met
 /// \param conservedVariables the conserved variables (density, momentum, Energy for Euler)
-/// \param extraVariables the extra variables (pressure and velocity for Euler)
 /// \return true if it obeys the constraints, false otherwise
-/// \todo Tidy up the way we check for nan and inf
 ///
 template<class Equation>
 bool CPUCellComputer<Equation>::obeysConstraints(const volume::Volume&
     conservedVariables) {
+    const auto report = checkConstraints(conservedVariables);
 
-    bool obeys = true;
-    Equation eq(parameters);
+    if (!report.obeys()) {
+        ALSVINN_LOG(ERROR, report.toString());
+    }
 
-    volume::for_each_cell<typename Equation::ConservedVariables>(conservedVariables,
-        [&obeys,
-            &eq](const typename Equation::ConservedVariables & conserved,
-    size_t index) {
-        const auto extra = eq.computeExtra(conserved);
-        // Check for nan and inf:
-        const real* conservedAsRealPtr = (const real*)&conserved;
-
-        for (size_t i = 0; i < sizeof(conserved) / sizeof(real); i++) {
-            if (std::isnan(conservedAsRealPtr[i]) || std::isinf(conservedAsRealPtr[i])) {
-                obeys = false;
-                std::cerr << "Component (conserved)" << i << " isnan or inf" << " at index " <<
-                    index << std::endl;
-                std::cerr << "values are: " << std::endl;
-
-                for (size_t j = 0; j < sizeof(conserved) / sizeof(real); j++) {
-                    std::cout << conservedAsRealPtr[j] << std::endl;
-                }
-
-                std::cout << std::endl << std::endl;
-            }
-        }
+    return report.obeys();
+}
 
+template<class Equation>
+ConstraintReport CPUCellComputer<Equation>::checkConstraints(
+    const volume::Volume& conservedVariables) {
+    Equation eq(parameters);
+    typename Equation::ConstViews conservedViews(conservedVariables);
 
-        const real* extraAsRealPtr = (const real*)&extra;
+    const ivec3 end(conservedVariables.getTotalNumberOfXCells(),
+        conservedVariables.getTotalNumberOfYCells(),
+        conservedVariables.getTotalNumberOfZCells());
 
-        for (size_t i = 0; i < sizeof(extra) / sizeof(real); i++) {
-            if (std::isnan(extraAsRealPtr[i]) || std::isinf(extraAsRealPtr[i])) {
-                obeys = false;
-            }
-        }
+    return volume::for_each_cell_reduce({0, 0, 0}, end,
+            ConstraintReport(), [&](int x, int y, int z) {
+        const size_t index = conservedViews.index(x, y, z);
+        const auto conserved = eq.fetchConservedVariables(conservedViews, index);
 
-        if (!eq.obeysConstraints(conserved, extra)) {
-            std::cerr << "Does not obey constraint at" << index << std::endl;
-            obeys = false;
-        }
+        return checkCellConstraints(eq, conserved, eq.computeExtra(conserved),
+                index);
+    }, [](ConstraintReport a, const ConstraintReport & b) {
+        return a.merge(b);
     });
-
-    return obeys;
 }
 
 template<class Equation>
@@ -20,5 +20,16 @@ namespace equation {
 CellComputer::~CellComputer() {
     // empty
 }
+
+ConstraintReport CellComputer::checkConstraints(const volume::Volume&
+    conservedVariables) {
+    ConstraintReport report;
+
+    if (!obeysConstraints(conservedVariables)) {
+        report.violations = ConstraintReport::equationConstraints;
+    }
+
+    return report;
+}
 }
 }
@@ -0,0 +1,62 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "alsfvm/equation/ConstraintReport.hpp"
+#include <sstream>
+#include <vector>
+
+namespace alsfvm {
+namespace equation {
+
+std::string ConstraintReport::toString() const {
+    if (obeys()) {
+        return "All cells obey the constraints";
+    }
+
+    std::vector<std::string> descriptions;
+
+    if (violations & conservedNotFinite) {
+        descriptions.push_back("conserved variables not finite");
+    }
+
+    if (violations & extraNotFinite) {
+        descriptions.push_back("extra variables not finite");
+    }
+
+    if (violations & equationConstraints) {
+        descriptions.push_back("equation constraints");
+    }
+
+    std::stringstream ss;
+
+    if (numberOfViolatingCells > 0) {
+        ss << numberOfViolatingCells << " cells violate the constraints (";
+    } else {
+        ss << "Some cells violate the constraints (";
+    }
+
+    for (size_t i = 0; i < descriptions.size(); ++i) {
+        ss << (i > 0 ? ", " : "") << descriptions[i];
+    }
+
+    ss << ")";
+
+    if (firstViolatingIndex != std::numeric_limits<size_t>::max()) {
+        ss << ", the first at index " << firstViolatingIndex;
+    }
+
+    return ss.str();
+}
+}
+}
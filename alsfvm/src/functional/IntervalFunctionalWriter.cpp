@@ -44,6 +44,8 @@ void IntervalFunctionalWriter::write(const volume::Volume& conservedVariables,
         writer->write(*conservedVolume,  grid,
             timestepInformation);
     } else {
+        // The blocks are equally sized when there are functionals, see
+        // SimulatorSetup::decomposeGrid
         const ivec3 numberOfNodes = grid.getGlobalSize() / grid.getDimensions();
         grid::Grid modifiedGrid(grid.getOrigin(),
             grid.getTop(),
@@ -65,21 +65,21 @@ void Legendre::operator()(volume::Volume& conservedVolumeOut,
     for (const std::string& variableName : variables) {
         if (conservedVolumeIn.hasVariable(variableName)) {
 
-            real integral = 0.0;
+            const real* values = conservedVolumeIn.getScalarMemoryArea(
+                    variableName)->getPointer();
 
-            volume::for_each_midpoint(conservedVolumeIn, grid, [&](real x, real y, real,
-            size_t i) {
+            const real integral = volume::for_each_midpoint_reduce(conservedVolumeIn,
+                    grid, real(0), [&](real x, real y, real, size_t i) {
 
                 // Scale from -1 to 1
                 const auto xScaled =  2 * (x - origin.x) / sides.x - 1;
                 const auto yScaled =  2 * (y - origin.y) / sides.y - 1;
 
-                const real value = (conservedVolumeIn.getScalarMemoryArea(
-                            variableName)->getPointer()[i] - minValue) / (maxValue - minValue);
-                integral += boost::math::legendre_p(degree_k,
-                        xScaled) * boost::math::legendre_p(degree_n, yScaled)
-                    * boost::math::legendre_p(degree_m, value) * dxdydz;
-            });
+                const real value = (values[i] - minValue) / (maxValue - minValue);
+                return real(boost::math::legendre_p(degree_k,
+                            xScaled) * boost::math::legendre_p(degree_n, yScaled)
+                        * boost::math::legendre_p(degree_m, value) * dxdydz);
+            }, volume::reductions::Sum());
 
             conservedVolumeOut.getScalarMemoryArea(variableName)->getPointer()[0] += weight
                 * integral;
@@ -20,8 +20,6 @@ void LogEntropy::operator()(volume::Volume& conservedVolumeOut,
     const real dxdydz = lengths.x * lengths.y * lengths.z;
 
 
-    real integral = 0.0;
-
     const auto& densityView = conservedVolumeIn.getScalarMemoryArea(
             "rho")->getView();
 
@@ -51,8 +49,8 @@ void LogEntropy::operator()(volume::Volume& conservedVolumeOut,
 
 
 
-    volume::for_each_midpoint(conservedVolumeIn, grid, [&](real, real, real,
-    size_t i) {
+    const real integral = volume::for_each_midpoint_reduce(conservedVolumeIn,
+            grid, real(0), [&](real, real, real, size_t i) {
 
         const real density = densityView.at(i);
         const real energy = energyView.at(i);
@@ -71,8 +69,8 @@ void LogEntropy::operator()(volume::Volume& conservedVolumeOut,
         const real s = log(pressure) - gamma * log(density);
         const real E = (-density * s) / (gamma - 1);
 
-        integral += E * dxdydz;
-    });
+        return E * dxdydz;
+    }, volume::reductions::Sum());
 
     conservedVolumeOut.getScalarMemoryArea("E")->getPointer()[0] += weight
         * integral;
@@ -50,6 +50,8 @@ void TimeIntegrationFunctional::write(const volume::Volume& conservedVariables,
 
 void TimeIntegrationFunctional::finalize(const grid::Grid& grid,
     const simulator::TimestepInformation& timestepInformation) {
+    // The blocks are equally sized when there are functionals, see
+    // SimulatorSetup::decomposeGrid
     const ivec3 numberOfNodes = grid.getGlobalSize() / grid.getDimensions();
     grid::Grid smallerGrid(grid.getOrigin(),
         grid.getTop(),
@@ -0,0 +1,165 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "alsfvm/integrator/BogackiShampine.hpp"
+#include "alsfvm/volume/volume_foreach.hpp"
+#include "alsutils/error/Exception.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace alsfvm {
+namespace integrator {
+
+BogackiShampine::BogackiShampine(alsfvm::shared_ptr<System> system,
+    real tolerance)
+    : system(system), tolerance(tolerance),
+      proposedTimestep(std::numeric_limits<real>::max()) {
+    if (tolerance <= 0) {
+        THROW("The tolerance has to be positive, given " << tolerance);
+    }
+}
+
+size_t BogackiShampine::getNumberOfSubsteps() const {
+    return 4;
+}
+
+size_t BogackiShampine::getNumberOfRegisters() const {
+    return 5;
+}
+
+size_t BogackiShampine::getOutputRegister(size_t substep) const {
+    return substep < 2 ? 2 : 3;
+}
+
+size_t BogackiShampine::getSolutionRegister() const {
+    return 3;
+}
+
+bool BogackiShampine::isStepAccepted() const {
+    return accepted;
+}
+
+size_t BogackiShampine::getNumberOfRejectedSteps() const {
+    return numberOfRejectedSteps;
+}
+
+real BogackiShampine::performSubstep(
+    std::vector<alsfvm::shared_ptr<volume::Volume> >& inputConserved,
+    rvec3 spatialCellSizes, real dt, real cfl,
+    volume::Volume& output, size_t substep,
+    const simulator::TimestepInformation& timestepInformation) {
+
+    auto& solution = *inputConserved[0];
+    auto& flux = *inputConserved[1];
+    auto& stage = *inputConserved[2];
+    auto& newSolution = *inputConserved[3];
+    auto& error = *inputConserved[4];
+
+    if (&output != &(substep < 2 ? stage : newSolution)) {
+        THROW("BogackiShampine got the wrong output register in substep "
+            << substep);
+    }
+
+    rvec3 waveSpeeds(0, 0, 0);
+
+    if (substep == 0) {
+        (*system)(solution, waveSpeeds, true, flux);
+
+        const real cflTimestep = computeTimestep(waveSpeeds, spatialCellSizes, cfl,
+                timestepInformation);
+        dt = adjustTimestep(std::min(cflTimestep, proposedTimestep),
+                timestepInformation);
+    } else if (substep < 3) {
+        (*system)(stage, waveSpeeds, false, flux);
+    } else {
+        (*system)(newSolution, waveSpeeds, false, flux);
+    }
+
+    const real h = dt / spatialCellSizes.x;
+
+    if (substep == 0) {
+        stage.assign(1 * solution + (h / 2) * flux);
+        newSolution.assign(1 * solution + (2 * h / 9) * flux);
+        error.assign((-5 * h / 72) * flux);
+    } else if (substep == 1) {
+        stage.assign(1 * solution + (3 * h / 4) * flux);
+        newSolution.assign(1 * newSolution + (h / 3) * flux);
+        error.assign(1 * error + (h / 12) * flux);
+    } else if (substep == 2) {
+        newSolution.assign(1 * newSolution + (4 * h / 9) * flux);
+        error.assign(1 * error + (h / 9) * flux);
+    } else {
+        error.assign(1 * error - (h / 8) * flux);
+
+        const real errorNorm = reduceMaximum(computeErrorNorm(solution,
+                    newSolution, error));
+
+        accepted = errorNorm <= 1;
+
+        if (!accepted) {
+            numberOfRejectedSteps++;
+        }
+
+        const real maximumFactor = accepted ? 5 : 1;
+        const real factor = errorNorm > 0 ?
+            std::min(maximumFactor,
+                std::max(real(0.2), real(0.9 * std::pow(errorNorm, -1. / 3.))))
+            : maximumFactor;
+
+        proposedTimestep = dt * factor;
+    }
+
+    return dt;
+}
+
+real BogackiShampine::computeErrorNorm(const volume::Volume& solution,
+    const volume::Volume& newSolution,
+    const volume::Volume& error) const {
+
+    const ivec3 ghostCells = error.getNumberOfGhostCells();
+    const ivec3 start = ghostCells;
+    const ivec3 end = ivec3(int(error.getTotalNumberOfXCells()),
+            int(error.getTotalNumberOfYCells()),
+            int(error.getTotalNumberOfZCells())) - ghostCells;
+    const int nx = int(error.getTotalNumberOfXCells());
+    const int ny = int(error.getTotalNumberOfYCells());
+
+    real errorNorm = 0;
+
+    for (size_t var = 0; var < error.getNumberOfVariables(); ++var) {
+        auto errorMemory = error.getScalarMemoryArea(var)->getHostMemory();
+        auto solutionMemory = solution.getScalarMemoryArea(var)->getHostMemory();
+        auto newSolutionMemory = newSolution.getScalarMemoryArea(var)->getHostMemory();
+
+        const real* errorPointer = errorMemory->getPointer();
+        const real* solutionPointer = solutionMemory->getPointer();
+        const real* newSolutionPointer = newSolutionMemory->getPointer();
+
+        const real variableErrorNorm = volume::for_each_cell_reduce(
+                start, end, real(0), [&](int x, int y, int z) {
+            const size_t index = (size_t(z) * ny + y) * nx + x;
+            const real scale = tolerance * (1 + std::max(std::abs(solutionPointer[index]),
+                            std::abs(newSolutionPointer[index])));
+            return std::abs(errorPointer[index]) / scale;
+        }, volume::reductions::Max());
+
+        errorNorm = std::max(errorNorm, variableErrorNorm);
+    }
+
+    return errorNorm;
+}
+}
+}
@@ -43,8 +43,7 @@ real ForwardEuler::performSubstep(
         dt / spatialCellSizes.y,
         dt / spatialCellSizes.z);
 
-    output *= cellScaling.x;
-    output += *inputConserved[0];
+    output.assign(1 * *inputConserved[0] + cellScaling.x * output);
 
     return dt;
 
@@ -17,30 +17,52 @@
 
 namespace alsfvm {
 namespace integrator {
+
+size_t Integrator::getNumberOfRegisters() const {
+    return getNumberOfSubsteps() + 1;
+}
+
+size_t Integrator::getOutputRegister(size_t substep) const {
+    return substep + 1;
+}
+
+size_t Integrator::getSolutionRegister() const {
+    return getNumberOfRegisters() - 1;
+}
+
+real Integrator::getCFLMultiplier() const {
+    return 1;
+}
+
+bool Integrator::isStepAccepted() const {
+    return true;
+}
+
 real Integrator::computeTimestep(const rvec3& waveSpeeds,
     const rvec3& cellLengths, real cfl,
     const simulator::TimestepInformation& timestepInformation) const {
+    rvec3 adjustedWaveSpeeds = waveSpeeds;
+
+    // All directions at once, so that eg. MPI only needs one reduction
+    for (auto& adjuster : waveSpeedAdjusters) {
+        adjustedWaveSpeeds = adjuster->adjustWaveSpeeds(adjustedWaveSpeeds);
+    }
+
     real waveSpeedTotal = 0;
 
     for (size_t direction = 0; direction < 3; ++direction) {
-        real waveSpeed = waveSpeeds[direction];
-
         if (cellLengths[direction] == 0) {
             continue;
         }
 
-        for (auto& adjuster : waveSpeedAdjusters) {
-            waveSpeed = adjuster->adjustWaveSpeed(waveSpeed);
-        }
-
         const real cellLength = cellLengths[direction];
-        waveSpeedTotal += waveSpeed / cellLength;
+        waveSpeedTotal += adjustedWaveSpeeds[direction] / cellLength;
     }
 
 
 
 
-    const real dt = cfl / waveSpeedTotal;
+    const real dt = getCFLMultiplier() * cfl / waveSpeedTotal;
 
     return adjustTimestep(dt, timestepInformation);
 }
@@ -64,5 +86,15 @@ real Integrator::adjustTimestep(real dt,
 
     return newDt;
 }
+
+real Integrator::reduceMaximum(real value) const {
+    real reduced = value;
+
+    for (auto& adjuster : waveSpeedAdjusters) {
+        reduced = adjuster->adjustWaveSpeed(reduced);
+    }
+
+    return reduced;
+}
 }
 }
@@ -18,13 +18,18 @@
 #include "alsfvm/integrator/RungeKutta2.hpp"
 #include "alsfvm/integrator/RungeKutta3.hpp"
 #include "alsfvm/integrator/RungeKutta4.hpp"
+#include "alsfvm/integrator/LowStorageRungeKutta.hpp"
+#include "alsfvm/integrator/SSPRungeKutta3.hpp"
+#include "alsfvm/integrator/SSPRungeKutta104.hpp"
+#include "alsfvm/integrator/BogackiShampine.hpp"
 #include "alsutils/error/Exception.hpp"
 
 namespace alsfvm {
 namespace integrator {
 
-IntegratorFactory::IntegratorFactory(const std::string& integratorName)
-    : integratorName(integratorName) {
+IntegratorFactory::IntegratorFactory(const std::string& integratorName,
+    real tolerance)
+    : integratorName(integratorName), tolerance(tolerance) {
 
 }
 
@@ -38,6 +43,18 @@ alsfvm::shared_ptr<Integrator> IntegratorFactory::createIntegrator(
         return alsfvm::shared_ptr<Integrator>(new RungeKutta3(system));
     } else if (integratorName == "rungekutta4") {
         return alsfvm::shared_ptr<Integrator>(new RungeKutta4(system));
+    } else if (integratorName == "williamson3") {
+        return alsfvm::shared_ptr<Integrator>(new LowStorageRungeKutta(system, 3));
+    } else if (integratorName == "carpenterkennedy4") {
+        return alsfvm::shared_ptr<Integrator>(new LowStorageRungeKutta(system, 4));
+    } else if (integratorName == "ssprk43") {
+        return alsfvm::shared_ptr<Integrator>(new SSPRungeKutta3(system, 4));
+    } else if (integratorName == "ssprk93") {
+        return alsfvm::shared_ptr<Integrator>(new SSPRungeKutta3(system, 9));
+    } else if (integratorName == "ssprk104") {
+        return alsfvm::shared_ptr<Integrator>(new SSPRungeKutta104(system));
+    } else if (integratorName == "bogackishampine") {
+        return alsfvm::shared_ptr<Integrator>(new BogackiShampine(system, tolerance));
     } else {
         THROW("Unknown integrator " << integratorName);
     }
@@ -0,0 +1,104 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "alsfvm/integrator/LowStorageRungeKutta.hpp"
+#include "alsutils/error/Exception.hpp"
+
+namespace alsfvm {
+namespace integrator {
+
+LowStorageRungeKutta::LowStorageRungeKutta(alsfvm::shared_ptr<System> system,
+    size_t order)
+    : system(system) {
+    if (order == 3) {
+        // J. H. Williamson, Low-storage Runge-Kutta schemes,
+        // J. Comput. Phys. 35 (1980)
+        A = {0., -5. / 9., -153. / 128.};
+        B = {1. / 3., 15. / 16., 8. / 15.};
+    } else if (order == 4) {
+        // M. H. Carpenter and C. A. Kennedy, Fourth-order 2N-storage
+        // Runge-Kutta schemes, NASA TM-109112 (1994)
+        A = {0.,
+                -567301805773. / 1357537059087.,
+                -2404267990393. / 2016746695238.,
+                -3550918686646. / 2091501179385.,
+                -1275806237668. / 842570457699.
+            };
+        B = {1432997174477. / 9575080441755.,
+                5161836677717. / 13612068292357.,
+                1720146321549. / 2090206949498.,
+                3134564353537. / 4481467310338.,
+                2277821191437. / 14882151754819.
+            };
+    } else {
+        THROW("Low storage Runge-Kutta is only supported for order 3 and 4, given "
+            << order);
+    }
+}
+
+size_t LowStorageRungeKutta::getNumberOfSubsteps() const {
+    return A.size();
+}
+
+size_t LowStorageRungeKutta::getNumberOfRegisters() const {
+    return 3;
+}
+
+size_t LowStorageRungeKutta::getOutputRegister(size_t) const {
+    return 0;
+}
+
+size_t LowStorageRungeKutta::getSolutionRegister() const {
+    return 0;
+}
+
+real LowStorageRungeKutta::performSubstep(
+    std::vector<alsfvm::shared_ptr<volume::Volume> >& inputConserved,
+    rvec3 spatialCellSizes, real dt, real cfl,
+    volume::Volume& output, size_t substep,
+    const simulator::TimestepInformation& timestepInformation) {
+
+    auto& solution = *inputConserved[0];
+    auto& increment = *inputConserved[1];
+    auto& flux = *inputConserved[2];
+
+    if (&output != &solution) {
+        THROW("LowStorageRungeKutta updates the solution in place, output "
+            "has to be the first register.");
+    }
+
+    rvec3 waveSpeeds(0, 0, 0);
+    (*system)(solution, waveSpeeds, true, flux);
+
+    if (substep == 0) {
+        dt = computeTimestep(waveSpeeds, spatialCellSizes, cfl, timestepInformation);
+    }
+
+    const real cellScaling = dt / spatialCellSizes.x;
+
+    // A[0] is zero, and the increment holds garbage from the previous
+    // timestep, so we can not multiply it by zero (it could be nan).
+    if (substep == 0) {
+        increment.assign(cellScaling * flux);
+    } else {
+        increment.assign(A[substep] * increment + cellScaling * flux);
+    }
+
+    solution.assign(1 * solution + B[substep] * increment);
+
+    return dt;
+}
+}
+}
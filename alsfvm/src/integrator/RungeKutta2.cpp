@@ -54,13 +54,13 @@ real RungeKutta2::performSubstep(
         dt / spatialCellSizes.y,
         dt / spatialCellSizes.z);
 
-    output *= cellScaling.x;
-    output += *inputConserved[substep];
-
-    if (substep == 1) {
+    if (substep == 0) {
+        output.assign(1 * *inputConserved[0] + cellScaling.x * output);
+    } else {
         // 0.5 * (U+U')
-        output += *inputConserved[0];
-        output *= 0.5;
+        output.assign(0.5 * *inputConserved[0]
+            + 0.5 * *inputConserved[1]
+            + (0.5 * cellScaling.x) * output);
     }
 
     return dt;
@@ -66,20 +66,16 @@ real RungeKutta3::performSubstep(
         dt / spatialCellSizes.y,
         dt / spatialCellSizes.z);
 
-    output *= cellScaling.x;
-
-    output += *inputConserved[substep];
-
-
-
-    if (substep == 1) {
-        output *= 1. / 3.;
-        output += *inputConserved[0];
-        output *= 3. / 4.;
+    if (substep == 0) {
+        output.assign(1 * *inputConserved[0] + cellScaling.x * output);
+    } else if (substep == 1) {
+        output.assign(3. / 4. * *inputConserved[0]
+            + 1. / 4. * *inputConserved[1]
+            + (cellScaling.x / 4.) * output);
     } else if (substep == 2) {
-        output *= 2;
-        output += *inputConserved[0];
-        output *= 1. / 3.;
+        output.assign(1. / 3. * *inputConserved[0]
+            + 2. / 3. * *inputConserved[2]
+            + (2. * cellScaling.x / 3.) * output);
     }
 
     return dt;
@@ -69,27 +69,16 @@ real RungeKutta4::performSubstep(
         dt / spatialCellSizes.y,
         dt / spatialCellSizes.z);
 
-    if (substep < 3) {
-        output *= cellScaling.x;
-    }
-
     if (substep < 2) {
-        output *= 0.5;
-
-    }
-
-    if (substep < 3) {
-        output += *inputConserved[0];
-    }
-
-
-    if (substep == 3) {
-        output.addLinearCombination((1.0 / 6.0)*cellScaling.x,
-            1.0 / 3.0, *inputConserved[1],
-            2.0 / 3.0, *inputConserved[2],
-            1.0 / 3.0, *inputConserved[3],
-            -1.0 / 3.0, *inputConserved[0]);
-
+        output.assign(1 * *inputConserved[0] + (0.5 * cellScaling.x) * output);
+    } else if (substep == 2) {
+        output.assign(1 * *inputConserved[0] + cellScaling.x * output);
+    } else {
+        output.assign(1.0 / 3.0 * *inputConserved[1]
+            + 2.0 / 3.0 * *inputConserved[2]
+            + 1.0 / 3.0 * *inputConserved[3]
+            - 1.0 / 3.0 * *inputConserved[0]
+            + (1.0 / 6.0 * cellScaling.x) * output);
     }
 
     return dt;
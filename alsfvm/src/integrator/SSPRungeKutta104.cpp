@@ -0,0 +1,89 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "alsfvm/integrator/SSPRungeKutta104.hpp"
+#include "alsutils/error/Exception.hpp"
+
+namespace alsfvm {
+namespace integrator {
+
+SSPRungeKutta104::SSPRungeKutta104(alsfvm::shared_ptr<System> system)
+    : system(system) {
+
+}
+
+size_t SSPRungeKutta104::getNumberOfSubsteps() const {
+    return 10;
+}
+
+size_t SSPRungeKutta104::getNumberOfRegisters() const {
+    return 3;
+}
+
+size_t SSPRungeKutta104::getOutputRegister(size_t) const {
+    return 0;
+}
+
+size_t SSPRungeKutta104::getSolutionRegister() const {
+    return 0;
+}
+
+real SSPRungeKutta104::getCFLMultiplier() const {
+    return 6;
+}
+
+real SSPRungeKutta104::performSubstep(
+    std::vector<alsfvm::shared_ptr<volume::Volume> >& inputConserved,
+    rvec3 spatialCellSizes, real dt, real cfl,
+    volume::Volume& output, size_t substep,
+    const simulator::TimestepInformation& timestepInformation) {
+
+    auto& solution = *inputConserved[0];
+    auto& saved = *inputConserved[1];
+    auto& flux = *inputConserved[2];
+
+    if (&output != &solution) {
+        THROW("SSPRungeKutta104 updates the solution in place, output "
+            "has to be the first register.");
+    }
+
+    if (substep == 0) {
+        saved.assign(1 * solution);
+    }
+
+    rvec3 waveSpeeds(0, 0, 0);
+    (*system)(solution, waveSpeeds, true, flux);
+
+    if (substep == 0) {
+        dt = computeTimestep(waveSpeeds, spatialCellSizes, cfl, timestepInformation);
+    }
+
+    const real cellScaling = dt / spatialCellSizes.x;
+
+    if (substep < 9) {
+        solution.assign(1 * solution + (cellScaling / 6) * flux);
+
+        if (substep == 4) {
+            saved.assign(1. / 25. * saved + 9. / 25. * solution);
+            solution.assign(15 * saved - 5 * solution);
+        }
+    } else {
+        solution.assign(1 * saved + 3. / 5. * solution + (cellScaling / 10) * flux);
+    }
+
+    return dt;
+}
+}
+}
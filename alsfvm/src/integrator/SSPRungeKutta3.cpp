@@ -0,0 +1,97 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "alsfvm/integrator/SSPRungeKutta3.hpp"
+#include "alsutils/error/Exception.hpp"
+#include <cmath>
+
+namespace alsfvm {
+namespace integrator {
+
+SSPRungeKutta3::SSPRungeKutta3(alsfvm::shared_ptr<System> system,
+    size_t numberOfStages)
+    : system(system), n(size_t(std::round(std::sqrt(double(numberOfStages))))) {
+    if (n < 2 || n * n != numberOfStages) {
+        THROW("SSPRK(s,3) needs a square number of stages greater than one, given "
+            << numberOfStages);
+    }
+}
+
+size_t SSPRungeKutta3::getNumberOfSubsteps() const {
+    return n * n;
+}
+
+size_t SSPRungeKutta3::getNumberOfRegisters() const {
+    return 3;
+}
+
+size_t SSPRungeKutta3::getOutputRegister(size_t) const {
+    return 0;
+}
+
+size_t SSPRungeKutta3::getSolutionRegister() const {
+    return 0;
+}
+
+real SSPRungeKutta3::getCFLMultiplier() const {
+    return real(n * n - n);
+}
+
+real SSPRungeKutta3::performSubstep(
+    std::vector<alsfvm::shared_ptr<volume::Volume> >& inputConserved,
+    rvec3 spatialCellSizes, real dt, real cfl,
+    volume::Volume& output, size_t substep,
+    const simulator::TimestepInformation& timestepInformation) {
+
+    auto& solution = *inputConserved[0];
+    auto& saved = *inputConserved[1];
+    auto& flux = *inputConserved[2];
+
+    if (&output != &solution) {
+        THROW("SSPRungeKutta3 updates the solution in place, output "
+            "has to be the first register.");
+    }
+
+    // The solution is saved after the first (n-1)(n-2)/2 stages, and
+    // combined with the solution in stage n(n+1)/2.
+    const size_t saveStage = (n - 1) * (n - 2) / 2;
+    const size_t combineStage = n * (n + 1) / 2 - 1;
+
+    if (substep == saveStage) {
+        saved.assign(1 * solution);
+    }
+
+    rvec3 waveSpeeds(0, 0, 0);
+    (*system)(solution, waveSpeeds, true, flux);
+
+    if (substep == 0) {
+        dt = computeTimestep(waveSpeeds, spatialCellSizes, cfl, timestepInformation);
+    }
+
+    const real cellScaling = dt / spatialCellSizes.x / getCFLMultiplier();
+
+    if (substep == combineStage) {
+        const real savedWeight = real(n) / real(2 * n - 1);
+        const real solutionWeight = real(n - 1) / real(2 * n - 1);
+        solution.assign(savedWeight * saved + solutionWeight * solution
+            + (solutionWeight * cellScaling) * flux);
+    } else {
+        solution.assign(1 * solution + cellScaling * flux);
+    }
+
+    return dt;
+}
+}
+}
@@ -14,6 +14,7 @@
  */
 
 #include "alsfvm/io/Writer.hpp"
+#include "alsfvm/volume/ensemble.hpp"
 #include "alsutils/error/Exception.hpp"
 
 namespace alsfvm {
@@ -28,6 +29,19 @@ void Writer::addAttributes(const std::string& nameOfAttributes,
     attributesMap[nameOfAttributes] = attributes;
 }
 
+void Writer::writeEnsemble(const volume::Volume& conservedVariables,
+    const grid::Grid& grid,
+    const simulator::TimestepInformation& timestepInformation) {
+    const size_t direction = volume::getEnsembleDirection(grid);
+    auto member = volume::makeEnsembleMemberVolume(conservedVariables, direction);
+
+    for (size_t m = 0; m < volume::getEnsembleSize(conservedVariables, direction);
+        ++m) {
+        volume::copyFromEnsembleMember(conservedVariables, direction, m, *member);
+        write(*member, grid, timestepInformation);
+    }
+}
+
 
 } // namespace io
 } // namespace alsfvm
@@ -17,10 +17,12 @@
 #include "alsfvm/memory/memory_utils.hpp"
 #include <cassert>
 #include <algorithm>
+#include <array>
 #include "alsutils/error/Exception.hpp"
 #include "alsutils/log.hpp"
 #include "alsutils/debug/stacktrace.hpp"
 #include "alsutils/config.hpp"
+#include "alsutils/parallel/for_each_cell.hpp"
 
 #define CHECK_SIZE_AND_HOST(x) { \
     if (!x.isOnHost()) {\
@@ -33,8 +35,30 @@
 namespace alsfvm {
 namespace memory {
 
-template<class T> HostMemory<T>::HostMemory(size_t nx, size_t ny, size_t nz)
-    : Memory<T>(nx, ny, nz), data(nx * ny * nz, 42) {
+template<class T> HostMemory<T>::HostMemory(size_t nx, size_t ny, size_t nz,
+    bool pooled)
+    : Memory<T>(nx, ny, nz), pooled(pooled), ownedData(nx * ny * nz,
+          alsutils::memory::AlignedAllocator<T>(pooled ?
+              &alsutils::memory::MemoryPool::getHostPool() : nullptr)),
+      data(ownedData.data()) {
+    // First touch, this decides which NUMA node the pages end up on. The
+    // cells are touched tile by tile (see alsutils::parallel::TileDecomposition),
+    // as in the loops going through volume_foreach.hpp, so that each page
+    // is placed near the thread that will later stream it.
+    if (alsutils::memory::getAllocationPolicy().parallelFirstTouch) {
+        T* pointer = data;
+        const size_t rowSize = nx;
+        const size_t planeSize = nx * ny;
+
+        alsutils::parallel::for_each_cell_index_parallel({0, 0, 0},
+            ivec3(int(nx), int(ny), int(nz)),
+        [pointer, rowSize, planeSize](int x, int y, int z) {
+            pointer[size_t(z) * planeSize + size_t(y) * rowSize + size_t(x)] = T(0);
+        });
+    } else {
+        std::fill(ownedData.begin(), ownedData.end(), T(0));
+    }
+
 #ifdef ALSVINN_PRINT_MEMORY_ALLOCATIONS
     const  size_t size = nx * ny * nz * sizeof(T);
     const double sizeGb = size / 1000000000.;
@@ -44,15 +68,30 @@ template<class T> HostMemory<T>::HostMemory(size_t nx, size_t ny, size_t nz)
 
 }
 
+template<class T> HostMemory<T>::HostMemory(std::shared_ptr<HostMemory<T> >
+    storage, size_t offset, size_t nx, size_t ny, size_t nz)
+    : Memory<T>(nx, ny, nz), pooled(storage->isPooled()),
+      data(storage->getPointer() + offset), storage(storage) {
+    if (offset + nx * ny * nz > storage->getSize()) {
+        THROW("Sub area [" << offset << ", " << offset + nx * ny * nz
+            << ") does not fit in storage of size " << storage->getSize());
+    }
+}
+
 template<class T>
 std::shared_ptr<Memory<T> > HostMemory<T>::makeInstance() const {
     std::shared_ptr<Memory<T>> memoryArea;
 
-    memoryArea.reset(new HostMemory(this->nx, this->ny, this->nz));
+    memoryArea.reset(new HostMemory(this->nx, this->ny, this->nz, pooled));
 
     return memoryArea;
 }
 
+template<class T>
+bool HostMemory<T>::isPooled() const {
+    return pooled;
+}
+
 template<class T>
 bool HostMemory<T>::isOnHost() const {
     return true;
@@ -62,29 +101,29 @@ template<class T>
 void HostMemory<T>::copyFrom(const Memory<T>& other) {
     CHECK_SIZE_AND_HOST(other);
 
-    std::copy(other.data(), other.data() + this->getSize(), data.begin());
+    std::copy(other.data(), other.data() + this->getSize(), data);
 }
 
 template<class T>
 T* HostMemory<T>::getPointer() {
-    return data.data();
+    return data;
 }
 
 template<class T>
 const T* HostMemory<T>::getPointer() const {
-    return data.data();
+    return data;
 }
 
 template<class T>
 void HostMemory<T>::copyToHost(T* bufferPointer, size_t bufferLength) const {
     assert(bufferLength >= Memory<T>::getSize());
-    std::copy(data.begin(), data.end(), bufferPointer);
+    std::copy(data, data + this->getSize(), bufferPointer);
 }
 
 template<class T>
 void HostMemory<T>::copyFromHost(const T* bufferPointer, size_t bufferLength) {
     const size_t sizeToCopy = std::min(bufferLength, Memory<T>::getSize());
-    std::copy(bufferPointer, bufferPointer + sizeToCopy, data.begin());
+    std::copy(bufferPointer, bufferPointer + sizeToCopy, data);
 }
 
 
@@ -102,7 +141,7 @@ void HostMemory<T>::operator+=(const Memory<T>& other) {
     auto pointer = other.getPointer();
     #pragma omp parallel for simd
 
-    for (int i = 0; i < int(data.size()); ++i) {
+    for (int i = 0; i < int(this->getSize()); ++i) {
         data[i] += pointer[i];
     }
 }
@@ -124,7 +163,7 @@ void HostMemory<T>::operator*=(const Memory<T>& other) {
     auto pointer = other.getPointer();
     #pragma omp parallel for simd
 
-    for (int i = 0; i < int(data.size()); ++i) {
+    for (int i = 0; i < int(this->getSize()); ++i) {
         data[i] *= pointer[i];
     }
 }
@@ -146,7 +185,7 @@ void HostMemory<T>::operator-=(const Memory<T>& other) {
     auto pointer = other.getPointer();
     #pragma omp parallel for simd
 
-    for (int i = 0; i < int(data.size()); ++i) {
+    for (int i = 0; i < int(this->getSize()); ++i) {
         data[i] -= pointer[i];
     }
 }
@@ -168,7 +207,7 @@ void HostMemory<T>::operator/=(const Memory<T>& other) {
     auto pointer = other.getPointer();
     #pragma omp parallel for simd
 
-    for (int i = 0; i < int(data.size()); ++i) {
+    for (int i = 0; i < int(this->getSize()); ++i) {
         data[i] /= pointer[i];
     }
 }
@@ -182,7 +221,7 @@ void HostMemory<T>::operator+=(real scalar) {
 
     #pragma omp parallel for simd
 
-    for (int i = 0; i < int(data.size()); ++i) {
+    for (int i = 0; i < int(this->getSize()); ++i) {
         data[i] += scalar;
     }
 }
@@ -195,7 +234,7 @@ template <class T>
 void HostMemory<T>::operator*=(real scalar) {
     #pragma omp parallel for simd
 
-    for (int i = 0; i < int(data.size()); ++i) {
+    for (int i = 0; i < int(this->getSize()); ++i) {
         data[i] *= scalar;
     }
 }
@@ -208,7 +247,7 @@ template <class T>
 void HostMemory<T>::operator-=(real scalar) {
     #pragma omp parallel for simd
 
-    for (int i = 0; i < int(data.size()); ++i) {
+    for (int i = 0; i < int(this->getSize()); ++i) {
         data[i] -= scalar;
     }
 }
@@ -221,7 +260,7 @@ template <class T>
 void HostMemory<T>::operator/=(real scalar) {
     #pragma omp parallel for simd
 
-    for (int i = 0; i < int(data.size()); ++i) {
+    for (int i = 0; i < int(this->getSize()); ++i) {
         data[i] /= scalar;
     }
 }
@@ -230,7 +269,7 @@ template <class T>
 void HostMemory<T>::makeZero() {
     #pragma omp parallel for simd
 
-    for (int i = 0; i < int(data.size()); ++i) {
+    for (int i = 0; i < int(this->getSize()); ++i) {
         data[i] = 0;
     }
 }
@@ -267,24 +306,100 @@ void HostMemory<T>::addLinearCombination(T a1,
     CHECK_SIZE_AND_HOST(v3);
     CHECK_SIZE_AND_HOST(v4);
     CHECK_SIZE_AND_HOST(v5);
-    const auto& d1 = data;
+    const T* d1 = data;
     auto d2 = v2.getPointer();
     auto d3 = v3.getPointer();
     auto d4 = v4.getPointer();
     auto d5 = v5.getPointer();
     #pragma omp parallel for
 
-    for (size_t i = 0; i < data.size(); ++i) {
+    for (size_t i = 0; i < this->getSize(); ++i) {
         data[i] = a1 * d1[i] + a2 * d2[i] + a3 * d3[i] + a4 * d4[i] + a5 * d5[i];
     }
 }
 
+namespace {
+//! Computes output = sum_{term < numberOfTerms} coefficients[term]*operands[term]
+//! with the number of terms known at compile time, so that the inner sum is
+//! unrolled and the loop vectorizes.
+template<size_t numberOfTerms, class T, class Coefficients, class Operands>
+void evaluateLinearCombination(T* output, const Coefficients& coefficients,
+    const Operands& operands, size_t size) {
+    #pragma omp parallel for simd
+
+    for (int i = 0; i < int(size); ++i) {
+        T sum = coefficients[0] * operands[0][i];
+
+        for (size_t term = 1; term < numberOfTerms; ++term) {
+            sum += coefficients[term] * operands[term][i];
+        }
+
+        output[i] = sum;
+    }
+}
+}
+
+template<class T>
+void HostMemory<T>::assign(const LinearCombination<Memory<T>, T>& combination) {
+    constexpr size_t maximumNumberOfTerms =
+        LinearCombination<Memory<T>, T>::maximumNumberOfTerms;
+    std::array<T, maximumNumberOfTerms> coefficients;
+    std::array<const T*, maximumNumberOfTerms> operands;
+
+    for (size_t term = 0; term < combination.getNumberOfTerms(); ++term) {
+        CHECK_SIZE_AND_HOST(combination.getOperand(term));
+        coefficients[term] = combination.getCoefficient(term);
+        operands[term] = combination.getOperand(term).getPointer();
+    }
+
+    static_assert(maximumNumberOfTerms == 8,
+        "Update the switch below when changing the number of terms");
+
+    switch (combination.getNumberOfTerms()) {
+    case 1:
+        evaluateLinearCombination<1>(data, coefficients, operands, this->getSize());
+        break;
+
+    case 2:
+        evaluateLinearCombination<2>(data, coefficients, operands, this->getSize());
+        break;
+
+    case 3:
+        evaluateLinearCombination<3>(data, coefficients, operands, this->getSize());
+        break;
+
+    case 4:
+        evaluateLinearCombination<4>(data, coefficients, operands, this->getSize());
+        break;
+
+    case 5:
+        evaluateLinearCombination<5>(data, coefficients, operands, this->getSize());
+        break;
+
+    case 6:
+        evaluateLinearCombination<6>(data, coefficients, operands, this->getSize());
+        break;
+
+    case 7:
+        evaluateLinearCombination<7>(data, coefficients, operands, this->getSize());
+        break;
+
+    case 8:
+        evaluateLinearCombination<8>(data, coefficients, operands, this->getSize());
+        break;
+
+    default:
+        THROW("Unsupported number of terms in linear combination: "
+            << combination.getNumberOfTerms());
+    }
+}
+
 template<class T>
 void HostMemory<T>::addPower(const Memory<T>& other, double power) {
     CHECK_SIZE_AND_HOST(other);
     #pragma omp parallel for
 
-    for (size_t i = 0; i < data.size(); ++i) {
+    for (size_t i = 0; i < this->getSize(); ++i) {
         data[i] += std::pow(other[i], power);
     }
 }
@@ -295,7 +410,7 @@ void HostMemory<T>::addPower(const Memory<T>& other, double power,
     CHECK_SIZE_AND_HOST(other);
     #pragma omp parallel for
 
-    for (size_t i = 0; i < data.size(); ++i) {
+    for (size_t i = 0; i < this->getSize(); ++i) {
         data[i] += factor * std::pow(other[i], power);
     }
 }
@@ -305,7 +420,7 @@ void HostMemory<T>::subtractPower(const Memory<T>& other, double power) {
     CHECK_SIZE_AND_HOST(other);
     #pragma omp parallel for
 
-    for (size_t i = 0; i < data.size(); ++i) {
+    for (size_t i = 0; i < this->getSize(); ++i) {
         data[i] -= std::pow(other[i], power);
     }
 }
@@ -334,28 +449,23 @@ real HostMemory<T>::getTotalVariation(int p, const ivec3& start,
         THROW("Not supported for 3d yet");
     }
 
-    const size_t startX = start.x + 1;
-    const size_t startY = start.y + (ny > 1 ? 1 : 0);
-    T bv = 0;
+    const int startX = start.x + 1;
+    const int startY = start.y + (ny > 1 ? 1 : 0);
 
-    for (int z = 0; z < end.z; z++) {
-        for (int y = startY; y < end.y; y++) {
-            for (int x = startX; x < end.x; x++) {
-                int index = z * nx * ny + y * nx + x;
-                int indexXLeft = z * nx * ny + y * nx + (x - 1);
+    const T bv = alsutils::parallel::for_each_cell_reduce(
+            ivec3(startX, startY, 0), end, T(0),
+    [&](int x, int y, int z) {
+        const size_t index = z * nx * ny + y * nx + x;
+        const size_t indexXLeft = z * nx * ny + y * nx + (x - 1);
 
-                int yBottom = ny > 1 ? y - 1 : 0;
+        const int yBottom = ny > 1 ? y - 1 : 0;
 
+        const size_t indexYLeft = z * nx * ny + yBottom * nx + x;
 
-                int indexYLeft = z * nx * ny + yBottom * nx + x;
-
-
-                bv += std::pow(std::sqrt(std::pow(data[index]
-                                - data[indexYLeft], 2) + std::pow(data[index]
-                                - data[indexXLeft], 2)), p);
-            }
-        }
-    }
+        return T(std::pow(std::sqrt(std::pow(data[index]
+                            - data[indexYLeft], 2) + std::pow(data[index]
+                            - data[indexXLeft], 2)), p));
+    }, alsutils::parallel::reductions::Sum());
 
     return bv;
 
@@ -379,22 +489,17 @@ real HostMemory<T>::getTotalVariation(int direction, int p, const ivec3& start,
     const int startX = start.x + directionVector.x;
     const int startY = start.y + directionVector.y;
     const int startZ = start.z + directionVector.z;
-    T bv = 0;
 
     const auto view = this->getView();
 
+    const T bv = alsutils::parallel::for_each_cell_reduce(
+            ivec3(startX, startY, startZ), end,
+            T(0), [&](int x, int y, int z) {
+        const auto positionLeft = ivec3(x, y, z) - directionVector;
 
-    for (int z = startZ; z < end.z; z++) {
-        for (int y = startY; y < end.y; y++) {
-            for (int x = startX; x < end.x; x++) {
-
-                auto positionLeft = ivec3(x, y, z) - directionVector;
-
-                bv += std::pow(std::abs(view.at(x, y, z) - view.at(positionLeft.x,
-                                positionLeft.y, positionLeft.z)), p);
-            }
-        }
-    }
+        return T(std::pow(std::abs(view.at(x, y, z) - view.at(positionLeft.x,
+                            positionLeft.y, positionLeft.z)), p));
+    }, alsutils::parallel::reductions::Sum());
 
     return bv;
 
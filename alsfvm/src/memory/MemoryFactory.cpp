@@ -16,6 +16,7 @@
 #include "alsfvm/memory/MemoryFactory.hpp"
 #include "alsutils/error/Exception.hpp"
 #include "alsfvm/memory/HostMemory.hpp"
+#include "alsutils/memory/AllocationPolicy.hpp"
 #ifdef  ALSVINN_HAVE_CUDA
     #include "alsfvm/cuda/CudaMemory.hpp"
 #endif
@@ -27,8 +28,8 @@ namespace memory {
 /// \param deviceConfiguration the deviceConfiguration to use (this is mostly only relevant for GPU, on CPU it can be empty)
 ///
 MemoryFactory::MemoryFactory(alsfvm::shared_ptr<DeviceConfiguration>&
-    deviceConfiguration)
-    : deviceConfiguration(deviceConfiguration) {
+    deviceConfiguration, bool useMemoryPool)
+    : deviceConfiguration(deviceConfiguration), useMemoryPool(useMemoryPool) {
 }
 
 ///
@@ -42,11 +43,12 @@ MemoryFactory::MemoryFactory(alsfvm::shared_ptr<DeviceConfiguration>&
 alsfvm::shared_ptr<Memory<real> > MemoryFactory::createScalarMemory(size_t nx,
     size_t ny, size_t nz) {
     if (deviceConfiguration->getPlatform() == "cpu") {
-        return alsfvm::shared_ptr<Memory<real> >(new HostMemory<real>(nx, ny, nz));
+        return alsfvm::shared_ptr<Memory<real> >(new HostMemory<real>(nx, ny, nz,
+                    useMemoryPool));
     } else if (deviceConfiguration->getPlatform() == "cuda") {
 #ifdef ALSVINN_HAVE_CUDA
         return alsfvm::shared_ptr<Memory<real> >(new cuda::CudaMemory<real>(nx, ny,
-                    nz));
+                    nz, useMemoryPool));
 #else
         THROW("CUDA is not enabled for this build");
 #endif
@@ -55,8 +57,53 @@ alsfvm::shared_ptr<Memory<real> > MemoryFactory::createScalarMemory(size_t nx,
     }
 }
 
+std::vector<alsfvm::shared_ptr<Memory<real> > >
+MemoryFactory::createContiguousScalarMemory(size_t nx, size_t ny, size_t nz,
+    size_t numberOfAreas) {
+    const size_t stride = getContiguousStride(nx, ny, nz);
+    std::vector<alsfvm::shared_ptr<Memory<real> > > areas;
+
+    if (deviceConfiguration->getPlatform() == "cpu") {
+        auto storage = alsfvm::make_shared<HostMemory<real> >(stride * numberOfAreas,
+                1, 1, useMemoryPool);
+
+        for (size_t area = 0; area < numberOfAreas; ++area) {
+            areas.push_back(alsfvm::make_shared<HostMemory<real> >(storage,
+                    area * stride, nx, ny, nz));
+        }
+    } else if (deviceConfiguration->getPlatform() == "cuda") {
+#ifdef ALSVINN_HAVE_CUDA
+        auto storage = alsfvm::make_shared<cuda::CudaMemory<real> >(stride *
+                numberOfAreas, 1, 1, useMemoryPool);
+
+        for (size_t area = 0; area < numberOfAreas; ++area) {
+            areas.push_back(alsfvm::make_shared<cuda::CudaMemory<real> >(storage,
+                    area * stride, nx, ny, nz));
+        }
+
+#else
+        THROW("CUDA is not enabled for this build");
+#endif
+    } else {
+        THROW("Unknown memory type " << deviceConfiguration->getPlatform());
+    }
+
+    return areas;
+}
+
+size_t MemoryFactory::getContiguousStride(size_t nx, size_t ny, size_t nz) {
+    const size_t elementsPerCacheLine = alsutils::memory::minimumAlignment /
+        sizeof(real);
+    return (nx * ny * nz + elementsPerCacheLine - 1) / elementsPerCacheLine *
+        elementsPerCacheLine;
+}
+
 const std::string& MemoryFactory::getPlatform() const {
     return deviceConfiguration->getPlatform();
 }
+
+bool MemoryFactory::getUseMemoryPool() const {
+    return useMemoryPool;
+}
 }
 }
@@ -19,15 +19,61 @@
 #include "alsfvm/mpi/cartesian/displacements.hpp"
 #include "alsfvm/mpi/cartesian/lengths.hpp"
 #include "alsutils/log.hpp"
+#include "alsutils/error/Exception.hpp"
+#include <boost/algorithm/string.hpp>
+#include <array>
+#include <cstdlib>
 
 
 namespace alsfvm {
 namespace mpi {
+namespace {
+int oppositeSide(int side) {
+    const int d = side / 2;
+    const int i = side % 2;
+
+    return (i + 1) % 2 + d * 2;
+}
+
+// Below this many values, packing is done by the calling thread only
+const int minimumValuesForParallelPacking = 4096;
+}
+
+CartesianCellExchanger::ExchangeMode
+CartesianCellExchanger::getDefaultExchangeMode() {
+    const char* fromEnvironment = std::getenv("ALSVINN_MPI_HALO_EXCHANGE");
+
+    if (fromEnvironment == nullptr || std::string(fromEnvironment) == "") {
+        return ExchangeMode::datatypes;
+    }
+
+    const auto mode = boost::algorithm::to_lower_copy(boost::trim_copy(
+                std::string(fromEnvironment)));
+
+    if (mode == "datatypes") {
+        return ExchangeMode::datatypes;
+    } else if (mode == "packed") {
+        return ExchangeMode::packed;
+    } else if (mode == "shared") {
+        return ExchangeMode::sharedMemory;
+    }
+
+    THROW("Unknown value ALSVINN_MPI_HALO_EXCHANGE=" << fromEnvironment
+        << ", expected datatypes, packed or shared");
+}
 
 CartesianCellExchanger::CartesianCellExchanger(ConfigurationPtr& configuration,
-    const ivec6& neighbours)
-    : configuration(configuration), neighbours(neighbours) {
+    const ivec6& neighbours, ExchangeMode exchangeMode)
+    : configuration(configuration), neighbours(neighbours),
+      exchangeMode(exchangeMode) {
+    if (exchangeMode == ExchangeMode::sharedMemory) {
+        sharedMemoryHalo.reset(new SharedMemoryHalo(configuration, neighbours));
+    }
+}
 
+CartesianCellExchanger::ExchangeMode CartesianCellExchanger::getExchangeMode()
+const {
+    return exchangeMode;
 }
 
 bool CartesianCellExchanger::hasSide(int side) const {
@@ -35,6 +81,11 @@ bool CartesianCellExchanger::hasSide(int side) const {
     return neighbours[side] > -1;
 }
 
+bool CartesianCellExchanger::hasMessageSide(int side) const {
+    return hasSide(side) && !(sharedMemoryHalo
+            && sharedMemoryHalo->isOnNode(side));
+}
+
 real CartesianCellExchanger::max(real value) {
     real maximum;
     MPI_Allreduce(&value, &maximum, 1, alsutils::mpi::MpiTypes<real>::MPI_Real,
@@ -44,6 +95,29 @@ real CartesianCellExchanger::max(real value) {
 
 }
 
+rvec3 CartesianCellExchanger::componentwiseMax(const rvec3& values) {
+    const std::array<real, 3> local = {values.x, values.y, values.z};
+    std::array<real, 3> maximum;
+    MPI_Allreduce(local.data(), maximum.data(), 3,
+        alsutils::mpi::MpiTypes<real>::MPI_Real, MPI_MAX,
+        configuration->getCommunicator());
+
+    return {maximum[0], maximum[1], maximum[2]};
+}
+
+void CartesianCellExchanger::setLaggedWaveSpeedReduction(real safetyFactor) {
+    laggedWaveSpeedReduction.reset(new LaggedWaveSpeedReduction(configuration,
+            safetyFactor));
+}
+
+rvec3 CartesianCellExchanger::adjustWaveSpeeds(const rvec3& waveSpeeds) {
+    if (laggedWaveSpeedReduction) {
+        return laggedWaveSpeedReduction->estimateMaximum(waveSpeeds);
+    }
+
+    return componentwiseMax(waveSpeeds);
+}
+
 ivec6 CartesianCellExchanger::getNeighbours() const {
     return neighbours;
 }
@@ -51,15 +125,49 @@ ivec6 CartesianCellExchanger::getNeighbours() const {
 RequestContainer CartesianCellExchanger::exchangeCells(volume::Volume&
     outputVolume,
     const volume::Volume& inputVolume) {
+    return exchangeSides(outputVolume, inputVolume, 0,
+            2 * outputVolume.getDimensions());
+}
+
+RequestContainer CartesianCellExchanger::exchangeCellsInDirection(
+    volume::Volume& outputVolume,
+    const volume::Volume& inputVolume, int direction) {
+    if (direction < 0 || direction >= int(outputVolume.getDimensions())) {
+        THROW("Direction " << direction << " out of range for a volume of "
+            << "dimension " << outputVolume.getDimensions());
+    }
+
+    return exchangeSides(outputVolume, inputVolume, 2 * direction,
+            2 * direction + 2);
+}
+
+RequestContainer CartesianCellExchanger::exchangeSides(volume::Volume&
+    outputVolume,
+    const volume::Volume& inputVolume, int firstSide, int endSide) {
     if (datatypesReceive.size() == 0) {
         createDataTypes(outputVolume);
     }
 
-    const int dimensions = outputVolume.getDimensions();
+    if (exchangeMode == ExchangeMode::sharedMemory) {
+        // The messages to the other nodes are in flight while we copy
+        auto container = exchangeCellsPacked(outputVolume, inputVolume, firstSide,
+                endSide);
+        exchangeCellsSharedMemory(outputVolume, inputVolume, firstSide, endSide);
+        return container;
+    } else if (exchangeMode == ExchangeMode::packed) {
+        return exchangeCellsPacked(outputVolume, inputVolume, firstSide, endSide);
+    } else {
+        return exchangeCellsWithDatatypes(outputVolume, inputVolume, firstSide,
+                endSide);
+    }
+}
 
+RequestContainer CartesianCellExchanger::exchangeCellsWithDatatypes(
+    volume::Volume& outputVolume,
+    const volume::Volume& inputVolume, int firstSide, int endSide) {
     RequestContainer container;
 
-    for (int side = 0; side < 2 * dimensions; ++side) {
+    for (int side = firstSide; side < endSide; ++side) {
 
 
         for (size_t var = 0; var < inputVolume.getNumberOfVariables(); ++ var) {
@@ -91,7 +199,7 @@ RequestContainer CartesianCellExchanger::exchangeCells(volume::Volume&
                         neighbours[opposite_side(side)],
                         side + var * 6,
                         *configuration
-                    ));
+                    ), opposite_side(side));
             }
 
 
@@ -103,6 +211,124 @@ RequestContainer CartesianCellExchanger::exchangeCells(volume::Volume&
 
 }
 
+RequestContainer CartesianCellExchanger::exchangeCellsPacked(
+    volume::Volume& outputVolume,
+    const volume::Volume& inputVolume, int firstSide, int endSide) {
+    RequestContainer container;
+
+    // Post the receives first, so the messages can go straight into the
+    // buffers
+    for (int side = firstSide; side < endSide; ++side) {
+        if (hasMessageSide(side)) {
+            persistentReceives[side]->start();
+            container.addRequest(persistentReceives[side], side);
+        }
+    }
+
+    for (int side = firstSide; side < endSide; ++side) {
+        if (hasMessageSide(side)) {
+            if (buffersSend[side].size() != size_t(inputVolume.getNumberOfVariables()
+                    * segmentsSend[side].numberOfCells)) {
+                THROW("The volume does not match the one the buffers were made for");
+            }
+
+            pack(side, inputVolume, buffersSend[side].data());
+            persistentSends[side]->start();
+            container.addRequest(persistentSends[side]);
+        }
+    }
+
+    for (int side = firstSide; side < endSide; ++side) {
+        if (hasMessageSide(side)) {
+            container.addCompletionHandler([this, &outputVolume, side]() {
+                unpack(side, buffersReceive[side].data(), outputVolume);
+            }, side);
+        }
+    }
+
+    return container;
+}
+
+void CartesianCellExchanger::exchangeCellsSharedMemory(
+    volume::Volume& outputVolume, const volume::Volume& inputVolume,
+    int firstSide, int endSide) {
+    const size_t numberOfVariables = inputVolume.getNumberOfVariables();
+
+    for (int side = firstSide; side < endSide; ++side) {
+        if (hasSide(side) && sharedMemoryHalo->isOnNode(side)) {
+            pack(side, inputVolume, sharedMemoryHalo->beginSend(side));
+            sharedMemoryHalo->endSend(side);
+        }
+    }
+
+    for (int side = firstSide; side < endSide; ++side) {
+        if (hasSide(side) && sharedMemoryHalo->isOnNode(side)) {
+            const real* buffer = sharedMemoryHalo->beginReceive(side,
+                    numberOfVariables * segmentsReceive[side].numberOfCells);
+            unpack(side, buffer, outputVolume);
+            sharedMemoryHalo->endReceive(side);
+        }
+    }
+}
+
+void CartesianCellExchanger::pack(int side,
+    const volume::Volume& inputVolume, real* buffer) {
+    const auto& segments = segmentsSend[side];
+    const int numberOfVariables = int(inputVolume.getNumberOfVariables());
+    const int numberOfSegments = int(segments.lengths.size());
+
+    std::vector<const real*> variables;
+
+    for (int var = 0; var < numberOfVariables; ++var) {
+        variables.push_back(inputVolume.getScalarMemoryArea(var)->getPointer());
+    }
+
+    const int numberOfCells = segments.numberOfCells;
+
+    #pragma omp parallel for collapse(2) if (numberOfVariables * numberOfCells > minimumValuesForParallelPacking)
+
+    for (int var = 0; var < numberOfVariables; ++var) {
+        for (int segment = 0; segment < numberOfSegments; ++segment) {
+            const real* source = variables[var] + segments.displacements[segment];
+            real* destination = buffer + var * numberOfCells +
+                segments.packedOffsets[segment];
+
+            for (int i = 0; i < segments.lengths[segment]; ++i) {
+                destination[i] = source[i];
+            }
+        }
+    }
+}
+
+void CartesianCellExchanger::unpack(int side, const real* buffer,
+    volume::Volume& outputVolume) {
+    const auto& segments = segmentsReceive[side];
+    const int numberOfVariables = int(outputVolume.getNumberOfVariables());
+    const int numberOfSegments = int(segments.lengths.size());
+
+    std::vector<real*> variables;
+
+    for (int var = 0; var < numberOfVariables; ++var) {
+        variables.push_back(outputVolume.getScalarMemoryArea(var)->getPointer());
+    }
+
+    const int numberOfCells = segments.numberOfCells;
+
+    #pragma omp parallel for collapse(2) if (numberOfVariables * numberOfCells > minimumValuesForParallelPacking)
+
+    for (int var = 0; var < numberOfVariables; ++var) {
+        for (int segment = 0; segment < numberOfSegments; ++segment) {
+            const real* source = buffer + var * numberOfCells +
+                segments.packedOffsets[segment];
+            real* destination = variables[var] + segments.displacements[segment];
+
+            for (int i = 0; i < segments.lengths[segment]; ++i) {
+                destination[i] = source[i];
+            }
+        }
+    }
+}
+
 void CartesianCellExchanger::createDataTypeSend(int side,
     const volume::Volume& volume) {
     const int ghostCells = volume.getNumberOfGhostCells()[side / 2];
@@ -127,6 +353,17 @@ void CartesianCellExchanger::createDataTypeSend(int side,
     datatypesSend.push_back(MpiIndexType::makeInstance(numberOfSegments, lengths,
             displacements,
             alsutils::mpi::MpiTypes<real>::MPI_Real));
+
+    Segments segments;
+    segments.displacements = displacements;
+    segments.lengths = lengths;
+
+    for (int length : lengths) {
+        segments.packedOffsets.push_back(segments.numberOfCells);
+        segments.numberOfCells += length;
+    }
+
+    segmentsSend.push_back(segments);
 }
 
 void CartesianCellExchanger::createDataTypeReceive(int side,
@@ -152,6 +389,17 @@ void CartesianCellExchanger::createDataTypeReceive(int side,
     datatypesReceive.push_back(MpiIndexType::makeInstance(numberOfSegments, lengths,
             displacements,
             alsutils::mpi::MpiTypes<real>::MPI_Real));
+
+    Segments segments;
+    segments.displacements = displacements;
+    segments.lengths = lengths;
+
+    for (int length : lengths) {
+        segments.packedOffsets.push_back(segments.numberOfCells);
+        segments.numberOfCells += length;
+    }
+
+    segmentsReceive.push_back(segments);
 }
 
 void CartesianCellExchanger::createDataTypes(const volume::Volume& volume) {
@@ -162,8 +410,62 @@ void CartesianCellExchanger::createDataTypes(const volume::Volume& volume) {
         createDataTypeReceive(side, volume);
     }
 
+    if (exchangeMode == ExchangeMode::packed
+        || exchangeMode == ExchangeMode::sharedMemory) {
+        createPersistentRequests(volume);
+    }
+
+    if (exchangeMode == ExchangeMode::sharedMemory) {
+        createSharedMemoryHalo(volume);
+    }
+}
+
+void CartesianCellExchanger::createPersistentRequests(const volume::Volume&
+    volume) {
+    const int dimensions = volume.getDimensions();
+    const size_t numberOfVariables = volume.getNumberOfVariables();
+
+    buffersSend.resize(2 * dimensions);
+    buffersReceive.resize(2 * dimensions);
+    persistentSends.resize(2 * dimensions);
+    persistentReceives.resize(2 * dimensions);
+
+    for (int side = 0; side < dimensions * 2; ++side) {
+        if (!hasMessageSide(side)) {
+            continue;
+        }
 
+        buffersSend[side].resize(numberOfVariables * segmentsSend[side].numberOfCells);
+        buffersReceive[side].resize(numberOfVariables *
+            segmentsReceive[side].numberOfCells);
+
+        // We send our side to the neighbour on that side, where it arrives
+        // on the opposite side, hence the tags.
+        persistentSends[side] = Request::sendInit(buffersSend[side].data(),
+                int(buffersSend[side].size()),
+                alsutils::mpi::MpiTypes<real>::MPI_Real,
+                neighbours[side], side, *configuration);
+
+        persistentReceives[side] = Request::receiveInit(buffersReceive[side].data(),
+                int(buffersReceive[side].size()),
+                alsutils::mpi::MpiTypes<real>::MPI_Real,
+                neighbours[side], oppositeSide(side), *configuration);
+    }
 }
 
+void CartesianCellExchanger::createSharedMemoryHalo(const volume::Volume&
+    volume) {
+    std::array<size_t, 6> sendSizes;
+    sendSizes.fill(0);
+
+    for (size_t side = 0; side < volume.getDimensions() * 2; ++side) {
+        if (hasSide(side) && sharedMemoryHalo->isOnNode(side)) {
+            sendSizes[side] = volume.getNumberOfVariables() *
+                segmentsSend[side].numberOfCells;
+        }
+    }
+
+    sharedMemoryHalo->allocate(sendSizes);
+}
 }
 }
@@ -14,14 +14,28 @@
  */
 
 #include "alsfvm/mpi/CellExchanger.hpp"
+#include "alsutils/error/Exception.hpp"
 
 namespace alsfvm {
 namespace mpi {
 
+rvec3 CellExchanger::componentwiseMax(const rvec3& values) {
+    return {this->max(values.x), this->max(values.y), this->max(values.z)};
+}
+
 real CellExchanger::adjustWaveSpeed(real waveSpeed) {
     return this->max(waveSpeed);
 }
 
+rvec3 CellExchanger::adjustWaveSpeeds(const rvec3& waveSpeeds) {
+    return this->componentwiseMax(waveSpeeds);
+}
+
+RequestContainer CellExchanger::exchangeCellsInDirection(volume::Volume&,
+    const volume::Volume&, int) {
+    THROW("This cell exchanger can not exchange one direction at a time.");
+}
+
 
 }
 }
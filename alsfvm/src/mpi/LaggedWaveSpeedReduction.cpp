@@ -0,0 +1,97 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "alsfvm/mpi/LaggedWaveSpeedReduction.hpp"
+#include "alsutils/mpi/mpi_types.hpp"
+#include "alsutils/error/Exception.hpp"
+#include "alsutils/log.hpp"
+#include <algorithm>
+
+namespace alsfvm {
+namespace mpi {
+
+LaggedWaveSpeedReduction::LaggedWaveSpeedReduction(ConfigurationPtr
+    configuration, real safetyFactor)
+    : configuration(configuration), safetyFactor(safetyFactor) {
+    if (safetyFactor <= 0 || safetyFactor > 1) {
+        THROW("The safety factor must be in (0, 1], was given " << safetyFactor);
+    }
+}
+
+rvec3 LaggedWaveSpeedReduction::estimateMaximum(const rvec3&
+    localWaveSpeeds) {
+    bool underestimated = false;
+
+    if (reduction) {
+        const rvec3 maximum = finishReduction();
+
+        for (int d = 0; d < 3; ++d) {
+            underestimated = underestimated || maximum[d] > lastEstimate[d];
+        }
+
+        if (underestimated) {
+            ++numberOfUnderestimates;
+            ALSVINN_LOG(WARNING, "The lagged wave speed estimate was too low "
+                << "(estimated " << lastEstimate[0] << ", " << lastEstimate[1]
+                << ", " << lastEstimate[2] << ", was " << maximum[0] << ", "
+                << maximum[1] << ", " << maximum[2] << "), using the exact "
+                << "maximum for this timestep.");
+        }
+    }
+
+    for (int d = 0; d < 3; ++d) {
+        localBuffer[d] = localWaveSpeeds[d];
+    }
+
+    reduction = Request::iallreduce(localBuffer.data(), globalBuffer.data(), 3,
+            alsutils::mpi::MpiTypes<real>::MPI_Real, MPI_MAX, *configuration);
+
+    if (numberOfMaxima == 0 || underestimated) {
+        lastEstimate = finishReduction();
+        return lastEstimate;
+    }
+
+    for (int d = 0; d < 3; ++d) {
+        real estimate = lastMaximum[d];
+
+        if (numberOfMaxima > 1) {
+            estimate += std::max(real(0), lastMaximum[d] - secondLastMaximum[d]);
+        }
+
+        lastEstimate[d] = estimate / safetyFactor;
+    }
+
+    return lastEstimate;
+}
+
+size_t LaggedWaveSpeedReduction::getNumberOfUnderestimates() const {
+    return numberOfUnderestimates;
+}
+
+real LaggedWaveSpeedReduction::getSafetyFactor() const {
+    return safetyFactor;
+}
+
+rvec3 LaggedWaveSpeedReduction::finishReduction() {
+    reduction->wait();
+    reduction.reset();
+
+    secondLastMaximum = lastMaximum;
+    lastMaximum = {globalBuffer[0], globalBuffer[1], globalBuffer[2]};
+    ++numberOfMaxima;
+
+    return lastMaximum;
+}
+}
+}
@@ -0,0 +1,113 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "alsfvm/mpi/ProgressThread.hpp"
+
+namespace alsfvm {
+namespace mpi {
+
+ProgressThread::ProgressThread(bool runOnThread)
+    : runOnThread(runOnThread) {
+    if (runOnThread) {
+        thread = std::thread([this]() {
+            run();
+        });
+    }
+}
+
+ProgressThread::~ProgressThread() {
+    if (!runOnThread) {
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        jobChanged.wait(lock, [this]() {
+            return !hasJob;
+        });
+        stop = true;
+    }
+
+    jobChanged.notify_all();
+    thread.join();
+}
+
+void ProgressThread::submit(std::function<void()> newJob) {
+    wait();
+
+    if (!runOnThread) {
+        try {
+            newJob();
+        } catch (...) {
+            exception = std::current_exception();
+        }
+
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        job = newJob;
+        hasJob = true;
+    }
+
+    jobChanged.notify_all();
+}
+
+void ProgressThread::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    jobChanged.wait(lock, [this]() {
+        return !hasJob;
+    });
+
+    if (exception) {
+        auto jobException = exception;
+        exception = nullptr;
+        std::rethrow_exception(jobException);
+    }
+}
+
+void ProgressThread::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while (true) {
+        jobChanged.wait(lock, [this]() {
+            return hasJob || stop;
+        });
+
+        if (stop) {
+            return;
+        }
+
+        lock.unlock();
+
+        std::exception_ptr jobException;
+
+        try {
+            job();
+        } catch (...) {
+            jobException = std::current_exception();
+        }
+
+        lock.lock();
+        exception = jobException;
+        job = nullptr;
+        hasJob = false;
+        jobChanged.notify_all();
+    }
+}
+
+}
+}
@@ -25,13 +25,79 @@ Request::Request() {
 
 }
 
+RequestPtr Request::sendInit(const void* buffer, int count,
+    MPI_Datatype datatype, int destination, int tag,
+    Configuration& configuration) {
+    std::shared_ptr<Request> requestPointer(new Request());
+    requestPointer->persistent = true;
+
+    MPI_SAFE_CALL(MPI_Send_init(buffer, count, datatype, destination, tag,
+            configuration.getCommunicator(), &requestPointer->request));
+
+    return requestPointer;
+}
+
+RequestPtr Request::receiveInit(void* buffer, int count,
+    MPI_Datatype datatype, int source, int tag,
+    Configuration& configuration) {
+    std::shared_ptr<Request> requestPointer(new Request());
+    requestPointer->persistent = true;
+
+    MPI_SAFE_CALL(MPI_Recv_init(buffer, count, datatype, source, tag,
+            configuration.getCommunicator(), &requestPointer->request));
+
+    return requestPointer;
+}
+
+RequestPtr Request::iallreduce(const void* sendBuffer, void* receiveBuffer,
+    int count, MPI_Datatype datatype, MPI_Op operation,
+    Configuration& configuration) {
+    std::shared_ptr<Request> requestPointer(new Request());
+
+    MPI_SAFE_CALL(MPI_Iallreduce(sendBuffer, receiveBuffer, count, datatype,
+            operation, configuration.getCommunicator(),
+            &requestPointer->request));
+
+    return requestPointer;
+}
+
+void Request::start() {
+    MPI_SAFE_CALL(MPI_Start(&request));
+}
+
 void Request::wait() {
     MPI_SAFE_CALL(MPI_Wait(&request, MPI_STATUS_IGNORE));
 }
 
+int Request::waitAny(const std::vector<RequestPtr>& requests) {
+    std::vector<MPI_Request> handles;
+
+    for (const auto& request : requests) {
+        handles.push_back(request->request);
+    }
+
+    int index = MPI_UNDEFINED;
+    MPI_SAFE_CALL(MPI_Waitany(int(handles.size()), handles.data(), &index,
+            MPI_STATUS_IGNORE));
+
+    if (index == MPI_UNDEFINED) {
+        return -1;
+    }
+
+    // MPI_Waitany deactivates (or nulls) the handle that finished
+    requests[index]->request = handles[index];
+
+    return index;
+}
+
 Request::~Request() {
     if (request != NULL) {
+        // Waiting for an inactive persistent request returns immediately
         this->wait();
+
+        if (persistent) {
+            MPI_Request_free(&request);
+        }
     }
 }
 
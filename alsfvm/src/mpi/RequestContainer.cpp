@@ -18,14 +18,127 @@
 namespace alsfvm {
 namespace mpi {
 
-void RequestContainer::addRequest(RequestPtr request) {
+void RequestContainer::addRequest(RequestPtr request, int group) {
     requests.push_back(request);
+    requestGroups.push_back(group);
+    requestsDone.push_back(false);
+}
+
+void RequestContainer::addCompletionHandler(std::function<void()> handler,
+    int group) {
+    completionHandlers[group].push_back(handler);
 }
 
 void RequestContainer::waitForAll() {
-    for (auto& request : requests) {
-        request->wait();
+    for (size_t i = 0; i < requests.size(); ++i) {
+        if (!requestsDone[i]) {
+            requests[i]->wait();
+            requestsDone[i] = true;
+        }
+    }
+
+    // The groups first, then the ungrouped handlers (group -1 is first in
+    // the map)
+    while (completionHandlers.size() > 0) {
+        callCompletionHandlers(completionHandlers.rbegin()->first);
+    }
+}
+
+bool RequestContainer::hasGroup(int group) const {
+    return getRemainingGroups().count(group) > 0;
+}
+
+int RequestContainer::waitForAnyGroup() {
+    while (true) {
+        if (getRemainingGroups().size() == 0) {
+            waitForAll();
+            return -1;
+        }
+
+        const int completedGroup = findCompletedGroup();
+
+        if (completedGroup >= 0) {
+            callCompletionHandlers(completedGroup);
+            return completedGroup;
+        }
+
+        // We also wait for the ungrouped requests, so that they progress
+        std::vector<RequestPtr> waitingRequests;
+        std::vector<size_t> waitingIndices;
+
+        for (size_t i = 0; i < requests.size(); ++i) {
+            if (!requestsDone[i]) {
+                waitingRequests.push_back(requests[i]);
+                waitingIndices.push_back(i);
+            }
+        }
+
+        const int finished = Request::waitAny(waitingRequests);
+
+        if (finished < 0) {
+            // None of them were active, so there is nothing to wait for
+            for (size_t i : waitingIndices) {
+                requestsDone[i] = true;
+            }
+        } else {
+            requestsDone[waitingIndices[finished]] = true;
+        }
+    }
+}
+
+std::set<int> RequestContainer::getRemainingGroups() const {
+    std::set<int> groups;
+
+    for (int group : requestGroups) {
+        if (group >= 0) {
+            groups.insert(group);
+        }
     }
+
+    for (const auto& handlers : completionHandlers) {
+        if (handlers.first >= 0) {
+            groups.insert(handlers.first);
+        }
+    }
+
+    for (int group : completedGroups) {
+        groups.erase(group);
+    }
+
+    return groups;
+}
+
+int RequestContainer::findCompletedGroup() const {
+    for (int group : getRemainingGroups()) {
+        bool done = true;
+
+        for (size_t i = 0; i < requests.size(); ++i) {
+            if (requestGroups[i] == group && !requestsDone[i]) {
+                done = false;
+            }
+        }
+
+        if (done) {
+            return group;
+        }
+    }
+
+    return -1;
+}
+
+void RequestContainer::callCompletionHandlers(int group) {
+    completedGroups.insert(group);
+    auto handlers = completionHandlers.find(group);
+
+    if (handlers == completionHandlers.end()) {
+        return;
+    }
+
+    for (auto& handler : handlers->second) {
+        handler();
+    }
+
+    completionHandlers.erase(handlers);
 }
 
 }
@@ -0,0 +1,179 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "alsfvm/mpi/SharedMemoryHalo.hpp"
+#include "alsutils/mpi/safe_call.hpp"
+#include "alsutils/error/Exception.hpp"
+#include <thread>
+
+namespace alsfvm {
+namespace mpi {
+namespace {
+int oppositeSide(int side) {
+    return side % 2 == 0 ? side + 1 : side - 1;
+}
+}
+
+SharedMemoryHalo::SharedMemoryHalo(ConfigurationPtr configuration,
+    const ivec6& neighbours)
+    : configuration(configuration), neighbours(neighbours) {
+    MPI_Comm communicator = configuration->getCommunicator();
+
+    MPI_SAFE_CALL(MPI_Comm_split_type(communicator, MPI_COMM_TYPE_SHARED,
+            configuration->getRank(), MPI_INFO_NULL, &nodeCommunicator));
+
+    MPI_Group group, nodeGroup;
+    MPI_SAFE_CALL(MPI_Comm_group(communicator, &group));
+    MPI_SAFE_CALL(MPI_Comm_group(nodeCommunicator, &nodeGroup));
+
+    for (int side = 0; side < 6; ++side) {
+        nodeNeighbours[side] = -1;
+        numberOfSends[side] = 0;
+        numberOfReceives[side] = 0;
+        neighbourHeaders[side] = nullptr;
+
+        if (neighbours[side] < 0) {
+            continue;
+        }
+
+        int nodeRank = MPI_UNDEFINED;
+        const int neighbour = neighbours[side];
+        MPI_SAFE_CALL(MPI_Group_translate_ranks(group, 1, &neighbour, nodeGroup,
+                &nodeRank));
+
+        if (nodeRank != MPI_UNDEFINED) {
+            nodeNeighbours[side] = nodeRank;
+        }
+    }
+
+    MPI_Group_free(&group);
+    MPI_Group_free(&nodeGroup);
+}
+
+SharedMemoryHalo::~SharedMemoryHalo() {
+    if (window != MPI_WIN_NULL) {
+        MPI_Win_unlock_all(window);
+        MPI_Win_free(&window);
+    }
+
+    if (nodeCommunicator != MPI_COMM_NULL) {
+        MPI_Comm_free(&nodeCommunicator);
+    }
+}
+
+bool SharedMemoryHalo::isOnNode(int side) const {
+    return nodeNeighbours[side] > -1;
+}
+
+void SharedMemoryHalo::allocate(const std::array<size_t, 6>& sendSizes) {
+    if (isAllocated()) {
+        THROW("The shared memory window is already allocated");
+    }
+
+    size_t totalSize = 0;
+
+    for (int side = 0; side < 6; ++side) {
+        totalSize += sendSizes[side];
+    }
+
+    void* base = nullptr;
+    MPI_SAFE_CALL(MPI_Win_allocate_shared(MPI_Aint(sizeof(Header) + totalSize *
+                sizeof(real)), 1, MPI_INFO_NULL, nodeCommunicator, &base,
+            &window));
+
+    header = static_cast<Header*>(base);
+    size_t offset = 0;
+
+    for (int side = 0; side < 6; ++side) {
+        header->sent[side] = 0;
+        header->received[side] = 0;
+        header->offsets[side] = int64_t(offset);
+        header->sizes[side] = int64_t(sendSizes[side]);
+        offset += sendSizes[side];
+    }
+
+    // We only read and write the window directly, and use MPI_Win_sync to
+    // see the changes of the others
+    MPI_SAFE_CALL(MPI_Win_lock_all(MPI_MODE_NOCHECK, window));
+    MPI_SAFE_CALL(MPI_Win_sync(window));
+    MPI_SAFE_CALL(MPI_Barrier(nodeCommunicator));
+    MPI_SAFE_CALL(MPI_Win_sync(window));
+
+    for (int side = 0; side < 6; ++side) {
+        if (!isOnNode(side)) {
+            continue;
+        }
+
+        MPI_Aint size;
+        int displacementUnit;
+        void* neighbourBase = nullptr;
+        MPI_SAFE_CALL(MPI_Win_shared_query(window, nodeNeighbours[side], &size,
+                &displacementUnit, &neighbourBase));
+        neighbourHeaders[side] = static_cast<Header*>(neighbourBase);
+    }
+}
+
+bool SharedMemoryHalo::isAllocated() const {
+    return window != MPI_WIN_NULL;
+}
+
+real* SharedMemoryHalo::beginSend(int side) {
+    // The neighbour receives our cells on the opposite side
+    waitFor(&neighbourHeaders[side]->received[oppositeSide(side)],
+        numberOfSends[side]);
+
+    return getBuffer(header, side);
+}
+
+void SharedMemoryHalo::endSend(int side) {
+    ++numberOfSends[side];
+    __atomic_store_n(&header->sent[side], numberOfSends[side], __ATOMIC_RELEASE);
+    MPI_SAFE_CALL(MPI_Win_sync(window));
+}
+
+const real* SharedMemoryHalo::beginReceive(int side, size_t receiveSize) {
+    Header* neighbourHeader = neighbourHeaders[side];
+    const int neighbourSide = oppositeSide(side);
+
+    if (size_t(neighbourHeader->sizes[neighbourSide]) != receiveSize) {
+        THROW("Expected " << receiveSize << " reals from the neighbour on side "
+            << side << ", its buffer has " << neighbourHeader->sizes[neighbourSide]);
+    }
+
+    waitFor(&neighbourHeader->sent[neighbourSide], numberOfReceives[side] + 1);
+
+    return getBuffer(neighbourHeader, neighbourSide);
+}
+
+void SharedMemoryHalo::endReceive(int side) {
+    ++numberOfReceives[side];
+    __atomic_store_n(&header->received[side], numberOfReceives[side],
+        __ATOMIC_RELEASE);
+    MPI_SAFE_CALL(MPI_Win_sync(window));
+}
+
+real* SharedMemoryHalo::getBuffer(Header* bufferHeader, int side) const {
+    return reinterpret_cast<real*>(bufferHeader + 1) + bufferHeader->offsets[side];
+}
+
+void SharedMemoryHalo::waitFor(const int64_t* counter, int64_t value) {
+    while (__atomic_load_n(counter, __ATOMIC_ACQUIRE) < value) {
+        MPI_SAFE_CALL(MPI_Win_sync(window));
+
+        // We may share the core with the processor we wait for
+        std::this_thread::yield();
+    }
+}
+}
+}
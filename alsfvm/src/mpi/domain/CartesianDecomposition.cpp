@@ -20,8 +20,9 @@
     #include "alsfvm/mpi/CudaCartesianCellExchanger.hpp"
 #endif
 #include "alsutils/log.hpp"
-#include "alsfvm/mpi/cartesian/rank_index.hpp"
-#include "alsfvm/mpi/cartesian/rank_component.hpp"
+#include "alsfvm/mpi/cartesian/block_size.hpp"
+#include "alsutils/mpi/safe_call.hpp"
+#include <limits>
 
 namespace alsfvm {
 namespace mpi {
@@ -35,8 +36,9 @@ CartesianDecomposition::CartesianDecomposition(const
 
 }
 
-CartesianDecomposition::CartesianDecomposition(int nx, int ny, int nz)
-    : numberOfProcessors(nx, ny, nz) {
+CartesianDecomposition::CartesianDecomposition(int nx, int ny, int nz,
+    bool reorderRanks)
+    : numberOfProcessors(nx, ny, nz), reorderRanks(reorderRanks) {
 
 }
 
@@ -46,25 +48,67 @@ DomainInformationPtr CartesianDecomposition::decompose(ConfigurationPtr
 
     auto dimensions = grid.getDimensions();
 
-    // Make sure we can evenly divide the dimensions. ie that
-    // the number of processors to use in the x direction divides the number
-    // of cells in the x direction, and so on.
+    // Make sure every processor gets at least one cell in every direction
     for (size_t i = 0; i < dimensions.size(); ++i) {
-        if (dimensions[i] % numberOfProcessors[i] != 0) {
+        if (dimensions[i] < numberOfProcessors[i]) {
             THROW("Error in domain decompositon. In direction " << i << "\n"
                 << "\tnumberOfProcessors assigned: " << numberOfProcessors[i] << "\n"
                 << "\tnumberOfCells assigned      : " << dimensions[i] << "\n");
         }
     }
 
+    if (requireEvenBlocks) {
+        for (int i = 0; i < 3; ++i) {
+            if (dimensions[i] % numberOfProcessors[i] != 0) {
+                THROW("The grid of size " << dimensions << " can not be split "
+                    << "evenly over " << numberOfProcessors << " processors, "
+                    << "which is needed by the functionals.");
+            }
+        }
+    }
+
+    if (numberOfProcessors.x * numberOfProcessors.y * numberOfProcessors.z !=
+        configuration->getNumberOfProcesses()) {
+        THROW("The total number of processors required is: "
+            << numberOfProcessors.x * numberOfProcessors.y * numberOfProcessors.z
+            << "\n" << "The total number given was: "
+            << configuration->getNumberOfProcesses());
+    }
+
+    // MPI_Cart_create numbers the processors with the last direction
+    // running fastest, we want x to run fastest, hence the reversed order.
+    int cartesianDimensions[3] = {numberOfProcessors.z, numberOfProcessors.y,
+            numberOfProcessors.x
+        };
+    int periodic[3];
+
+    for (int d = 0; d < 3; ++d) {
+        periodic[2 - d] = grid.getBoundaryCondition(2 * d) == boundary::Type::PERIODIC;
+    }
+
+    MPI_Comm cartesianCommunicator;
+    MPI_SAFE_CALL(MPI_Cart_create(configuration->getCommunicator(), 3,
+            cartesianDimensions, periodic, reorderRanks, &cartesianCommunicator));
 
-    int nodeNumber = configuration->getRank();
-    // Find the x,y, z position of the nodeNumber.
-    ivec3 nodePosition = cartesian::getCoordinates(nodeNumber, numberOfProcessors);
+    // The configuration frees the communicator when the cell exchanger is
+    // done with it
+    auto cartesianConfiguration = alsfvm::make_shared<Configuration>
+        (cartesianCommunicator, configuration->getPlatform(), true);
 
-    ivec3 numberOfCellsPerProcessors = dimensions / numberOfProcessors;
+    int cartesianCoordinates[3];
+    MPI_SAFE_CALL(MPI_Cart_coords(cartesianCommunicator,
+            cartesianConfiguration->getRank(), 3, cartesianCoordinates));
+
+    // Find the x,y, z position of this processor.
+    ivec3 nodePosition = {cartesianCoordinates[2], cartesianCoordinates[1],
+            cartesianCoordinates[0]
+        };
+
+    ivec3 numberOfCellsPerProcessors = cartesian::getBlockSize(dimensions,
+            numberOfProcessors, nodePosition);
     // startIndex for the grid
-    ivec3 startIndex = numberOfCellsPerProcessors * nodePosition;
+    ivec3 startIndex = cartesian::getBlockStart(dimensions, numberOfProcessors,
+            nodePosition);
 
 
     // Geometrical position
@@ -117,8 +161,12 @@ DomainInformationPtr CartesianDecomposition::decompose(ConfigurationPtr
 
 
 
-        int neighbourIndex = cartesian::getRankIndex(neighbourPosition,
-                numberOfProcessors);
+        int neighbourCoordinates[3] = {neighbourPosition.z, neighbourPosition.y,
+                neighbourPosition.x
+            };
+        int neighbourIndex;
+        MPI_SAFE_CALL(MPI_Cart_rank(cartesianCommunicator, neighbourCoordinates,
+                &neighbourIndex));
 
         if (neighbourIndex < 0) {
             THROW("NeighbourIndex got negative, this should not happen");
@@ -143,12 +191,14 @@ DomainInformationPtr CartesianDecomposition::decompose(ConfigurationPtr
     alsfvm::shared_ptr<CellExchanger> cellExchanger;
 
     if (configuration->getPlatform() == "cpu") {
-        cellExchanger.reset(new CartesianCellExchanger(configuration, neighbours));
+        cellExchanger.reset(new CartesianCellExchanger(cartesianConfiguration,
+                neighbours));
     }
 
 #ifdef ALSVINN_HAVE_CUDA
     else {
-        cellExchanger.reset(new CudaCartesianCellExchanger(configuration, neighbours));
+        cellExchanger.reset(new CudaCartesianCellExchanger(cartesianConfiguration,
+                neighbours));
     }
 
 #else
@@ -165,6 +215,66 @@ DomainInformationPtr CartesianDecomposition::decompose(ConfigurationPtr
 
 }
 
+ivec3 CartesianDecomposition::findNumberOfProcessorsPerDirection(
+    int numberOfProcessors,
+    const grid::Grid& grid, bool evenBlocksOnly) {
+    const ivec3 dimensions = grid.getDimensions();
+    const int activeDimensions = grid.getActiveDimension();
+
+    ivec3 best = {0, 0, 0};
+    long bestNumberOfExchangedCells = std::numeric_limits<long>::max();
+
+    for (int nx = 1; nx <= numberOfProcessors; ++nx) {
+        for (int ny = 1; nx * ny <= numberOfProcessors; ++ny) {
+            if (numberOfProcessors % (nx * ny) != 0) {
+                continue;
+            }
+
+            const ivec3 candidate = {nx, ny, numberOfProcessors / (nx * ny)};
+
+            bool possible = true;
+
+            for (int d = 0; d < 3; ++d) {
+                possible = possible && candidate[d] <= dimensions[d]
+                    && (d < activeDimensions || candidate[d] == 1)
+                    && (!evenBlocksOnly || dimensions[d] % candidate[d] == 0);
+            }
+
+            if (!possible) {
+                continue;
+            }
+
+            // The surface of the largest block, which is what has to be
+            // exchanged (or filled by the boundary conditions).
+            const ivec3 largestBlock = cartesian::getBlockSize(dimensions,
+                    candidate, {0, 0, 0});
+            long numberOfExchangedCells = 0;
+
+            for (int d = 0; d < activeDimensions; ++d) {
+                numberOfExchangedCells += 2L * largestBlock[(d + 1) % 3] *
+                    largestBlock[(d + 2) % 3];
+            }
+
+            if (numberOfExchangedCells < bestNumberOfExchangedCells) {
+                best = candidate;
+                bestNumberOfExchangedCells = numberOfExchangedCells;
+            }
+        }
+    }
+
+    if (best.x == 0) {
+        THROW("Could not split the grid of size " << dimensions << " over "
+            << numberOfProcessors << " processors"
+            << (evenBlocksOnly ? " evenly." : "."));
+    }
+
+    return best;
+}
+
+void CartesianDecomposition::setRequireEvenBlocks(bool requireEvenBlocks) {
+    this->requireEvenBlocks = requireEvenBlocks;
+}
+
 }
 }
 }
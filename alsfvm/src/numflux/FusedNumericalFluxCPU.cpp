@@ -0,0 +1,321 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "alsfvm/numflux/FusedNumericalFluxCPU.hpp"
+#include "alsfvm/numflux/numerical_flux_list.hpp"
+#include "alsfvm/numflux/numflux_util.hpp"
+#include "alsfvm/reconstruction/PiecewiseConstant.hpp"
+#include "alsfvm/reconstruction/WENO2.hpp"
+#include "alsfvm/reconstruction/WENOF2.hpp"
+#include "alsfvm/reconstruction/MC.hpp"
+#include "alsfvm/reconstruction/MM.hpp"
+#include "alsutils/error/Exception.hpp"
+#include "alsutils/timer/Timer.hpp"
+#include <algorithm>
+#include <type_traits>
+
+namespace alsfvm {
+namespace numflux {
+
+namespace {
+
+//! Number of consecutive x-cells that are advanced together when sweeping
+//! in the y- or z-direction. The per tile state (the last reconstructed
+//! value and the last face flux per column) then stays in L1.
+const int fusedTileWidth = 32;
+
+///
+/// Computes the net flux in the given direction for all interior cells
+/// within [start, end) in one sweep. If accumulate is false, the output is
+/// overwritten, otherwise the net flux is added to it.
+///
+/// \returns the maximum wave speed over all faces
+///
+template<class Flux, class ReconstructionType, class Equation, size_t direction>
+real computeFusedNetFlux(const Equation& eq,
+    const volume::Volume& conservedVariables,
+    volume::Volume& output,
+    bool accumulate,
+    const ivec3& start, const ivec3& end) {
+
+    typename Equation::ConstViews in(conservedVariables);
+    typename Equation::Views out(output);
+
+    const int nx = output.getTotalNumberOfXCells();
+    const int ny = output.getTotalNumberOfYCells();
+    const int ngx = output.getNumberOfXGhostCells();
+    const int ngy = output.getNumberOfYGhostCells();
+    const int ngz = output.getNumberOfZGhostCells();
+
+    // first and one past the last interior cell we write to
+    const ivec3 first(ngx + start.x, ngy + start.y, ngz + start.z);
+    const ivec3 last(nx - ngx + end.x, ny - ngy + end.y,
+        output.getTotalNumberOfZCells() - ngz + end.z);
+
+    const long stride = direction == 0 ? 1 : (direction == 1 ? long(nx) :
+            long(nx) * long(ny));
+    const int width = direction == 0 ? 1 : fusedTileWidth;
+    const int length = last[direction] - first[direction];
+
+    const int numberOfXBlocks = direction == 0 ? 1 :
+        (last.x - first.x + width - 1) / width;
+    const int tilesA = direction == 0 ? last.y - first.y : numberOfXBlocks;
+    const int tilesB = direction == 2 ? last.y - first.y : last.z - first.z;
+
+    real waveSpeed = 0;
+
+    #pragma omp parallel for reduction(max: waveSpeed)
+
+    for (int tile = 0; tile < tilesA * tilesB; ++tile) {
+        const int a = tile % tilesA;
+        const int b = tile / tilesA;
+
+        ivec3 origin = first;
+
+        if (direction == 0) {
+            origin.y += a;
+            origin.z += b;
+        } else {
+            origin.x += a * width;
+
+            if (direction == 1) {
+                origin.z += b;
+            } else {
+                origin.y += b;
+            }
+        }
+
+        const int lanes = std::min(width, last.x - origin.x);
+        const long originIndex = long(out.index(origin.x, origin.y, origin.z));
+
+        typename Equation::ConservedVariables previousRight[fusedTileWidth];
+        typename Equation::ConservedVariables previousFlux[fusedTileWidth];
+
+        // We start one cell before the first interior cell, so that we
+        // have the flux on the left face of the first interior cell, and
+        // end one cell after, for the flux on the right face of the last.
+        for (int cell = -1; cell <= length; ++cell) {
+            for (int lane = 0; lane < lanes; ++lane) {
+                const long index = originIndex + cell * stride + lane;
+
+                typename Equation::ConservedVariables left, right;
+                ReconstructionType::reconstructCell(eq, in, size_t(index - stride),
+                    size_t(index), size_t(index + stride), left, right);
+
+                if (cell >= 0) {
+                    // F(U_r of the previous cell, U_l of this cell)
+                    typename Equation::AllVariables leftFace(previousRight[lane],
+                        eq.computeExtra(previousRight[lane]));
+                    typename Equation::AllVariables rightFace(left,
+                        eq.computeExtra(left));
+
+                    typename Equation::ConservedVariables flux;
+                    waveSpeed = std::max(waveSpeed,
+                            Flux::template computeFlux<direction>(eq, leftFace,
+                                rightFace, flux));
+
+                    if (cell >= 1) {
+                        const auto netFlux = (-1.0) * flux + previousFlux[lane];
+
+                        if (accumulate) {
+                            eq.addToViewAt(out, size_t(index - stride), netFlux);
+                        } else {
+                            eq.setViewAt(out, size_t(index - stride), netFlux);
+                        }
+                    }
+
+                    previousFlux[lane] = flux;
+                }
+
+                previousRight[lane] = right;
+            }
+        }
+    }
+
+    return waveSpeed;
+}
+
+//! Sweeps the directions [direction, numberOfDirections) one after the
+//! other, the first direction overwrites the output, the others add to it.
+//! The direction is a template parameter, so the directions that are not
+//! swept are never instantiated.
+template<class Flux, class ReconstructionType, class Equation,
+    size_t direction, size_t numberOfDirections>
+struct FusedSweep {
+    static void compute(const Equation& eq,
+        const volume::Volume& conservedVariables,
+        volume::Volume& output,
+        rvec3& waveSpeed,
+        const ivec3& start, const ivec3& end) {
+        waveSpeed[direction] = computeFusedNetFlux<Flux, ReconstructionType,
+                  Equation, direction>(eq, conservedVariables, output, direction > 0,
+                      start, end);
+
+        FusedSweep < Flux, ReconstructionType, Equation, direction + 1,
+                   numberOfDirections >::compute(eq, conservedVariables, output,
+                       waveSpeed, start, end);
+    }
+};
+
+template<class Flux, class ReconstructionType, class Equation,
+    size_t numberOfDirections>
+struct FusedSweep<Flux, ReconstructionType, Equation, numberOfDirections,
+           numberOfDirections> {
+    static void compute(const Equation&, const volume::Volume&, volume::Volume&,
+        rvec3&, const ivec3&, const ivec3&) {
+    }
+};
+
+//! The number of directions to sweep. For the Euler equations this is
+//! never more than the number of velocity components (Euler<1> is also
+//! instantiated for two and three dimensional grids, but never used there).
+template<class Equation, size_t dimension>
+struct number_of_fused_directions : std::integral_constant<size_t, dimension> {};
+
+template<int nsd, size_t dimension>
+struct number_of_fused_directions<equation::euler::Euler<nsd>, dimension>
+    : std::integral_constant < size_t, (size_t(nsd) < dimension ? size_t(nsd) :
+        dimension) > {};
+
+template<class Equation>
+struct is_euler : std::false_type {};
+
+template<int nsd>
+struct is_euler<equation::euler::Euler<nsd>> : std::true_type {};
+
+//! The pointwise reconstructions are (as for ReconstructionCPU) available
+//! for the Euler equations and Burgers.
+template<class Equation>
+struct supports_pointwise_reconstruction : std::integral_constant < bool,
+    is_euler<Equation>::value
+        || std::is_same<Equation, equation::burgers::Burgers>::value > {};
+
+template<class Flux, class Equation, size_t dimension,
+    template<class> class ReconstructionType>
+alsfvm::shared_ptr<NumericalFlux> makeFused(const
+    simulator::SimulatorParameters& simulatorParameters) {
+    return alsfvm::shared_ptr<NumericalFlux>(
+            new FusedNumericalFluxCPU<Flux, Equation, dimension, ReconstructionType<Equation>>
+            (simulatorParameters));
+}
+
+template<class Flux, class Equation, size_t dimension>
+alsfvm::shared_ptr<NumericalFlux> makeFusedWENOF2(const
+    simulator::SimulatorParameters& simulatorParameters, std::true_type) {
+    return makeFused<Flux, Equation, dimension, reconstruction::WENOF2>
+        (simulatorParameters);
+}
+
+template<class Flux, class Equation, size_t dimension>
+alsfvm::shared_ptr<NumericalFlux> makeFusedWENOF2(const
+    simulator::SimulatorParameters&, std::false_type) {
+    THROW("wenof2 is only supported for the Euler equations.");
+}
+
+template<class Flux, class Equation, size_t dimension>
+alsfvm::shared_ptr<NumericalFlux> makeFusedPointwise(
+    const std::string& reconstruction,
+    const simulator::SimulatorParameters& simulatorParameters, std::true_type) {
+    if (reconstruction == "weno2") {
+        return makeFused<Flux, Equation, dimension, reconstruction::WENO2>
+            (simulatorParameters);
+    } else if (reconstruction == "mc") {
+        return makeFused<Flux, Equation, dimension, reconstruction::MC>
+            (simulatorParameters);
+    } else if (reconstruction == "mm") {
+        return makeFused<Flux, Equation, dimension, reconstruction::MM>
+            (simulatorParameters);
+    } else if (reconstruction == "wenof2") {
+        return makeFusedWENOF2<Flux, Equation, dimension>(simulatorParameters,
+                is_euler<Equation>());
+    }
+
+    THROW("The fused flux engine does not support the reconstruction \""
+        << reconstruction << "\". Supported are: none, weno2, wenof2, mc and mm.");
+}
+
+template<class Flux, class Equation, size_t dimension>
+alsfvm::shared_ptr<NumericalFlux> makeFusedPointwise(
+    const std::string& reconstruction,
+    const simulator::SimulatorParameters&, std::false_type) {
+    THROW("The fused flux engine only supports reconstruction \"none\" for "
+        << Equation::getName() << ", given \"" << reconstruction << "\"");
+}
+
+template<class Flux, class Equation, size_t dimension>
+alsfvm::shared_ptr<NumericalFlux> createFused(
+    const std::string& reconstruction,
+    const simulator::SimulatorParameters& simulatorParameters,
+    std::false_type /* hasStencil */) {
+    if (reconstruction == "none") {
+        return makeFused<Flux, Equation, dimension, reconstruction::PiecewiseConstant>
+            (simulatorParameters);
+    }
+
+    return makeFusedPointwise<Flux, Equation, dimension>(reconstruction,
+            simulatorParameters, supports_pointwise_reconstruction<Equation>());
+}
+
+template<class Flux, class Equation, size_t dimension>
+alsfvm::shared_ptr<NumericalFlux> createFused(
+    const std::string&,
+    const simulator::SimulatorParameters&,
+    std::true_type /* hasStencil */) {
+    THROW("The fused flux engine only supports fluxes with a two point stencil, "
+        "use the standard flux engine for " << Flux::name);
+}
+}
+
+template<class Flux, class Equation, size_t dimension, class ReconstructionType>
+FusedNumericalFluxCPU<Flux, Equation, dimension, ReconstructionType>::FusedNumericalFluxCPU(
+    const simulator::SimulatorParameters& simulatorParameters)
+    : parameters(static_cast<const typename Equation::Parameters&>
+          (simulatorParameters.getEquationParameters())) {
+    static_assert(dimension > 0, "We only support positive dimension!");
+    static_assert(dimension < 4, "We only support dimension up to 3");
+}
+
+template<class Flux, class Equation, size_t dimension, class ReconstructionType>
+void FusedNumericalFluxCPU<Flux, Equation, dimension, ReconstructionType>::computeFlux(
+    const volume::Volume& conservedVariables,
+    rvec3& waveSpeed, bool computeWaveSpeed,
+    volume::Volume& output, const ivec3& start,
+    const ivec3& end) {
+    ALSVINN_TIME_BLOCK(alsvinn, fvm, numflux, fused);
+    Equation eq(parameters);
+
+    FusedSweep<Flux, ReconstructionType, Equation, 0,
+               number_of_fused_directions<Equation, dimension>::value>::compute(eq,
+                   conservedVariables, output, waveSpeed, start, end);
+}
+
+template<class Flux, class Equation, size_t dimension, class ReconstructionType>
+size_t FusedNumericalFluxCPU<Flux, Equation, dimension, ReconstructionType>::getNumberOfGhostCells() {
+    return std::max(size_t(1), size_t(ReconstructionType::getNumberOfGhostCells()));
+}
+
+template<class Flux, class Equation, size_t dimension>
+alsfvm::shared_ptr<NumericalFlux>
+FusedNumericalFluxCPUCreator<Flux, Equation, dimension>::create(
+    const std::string& reconstruction,
+    const simulator::SimulatorParameters& simulatorParameters) {
+    return createFused<Flux, Equation, dimension>(reconstruction,
+            simulatorParameters,
+            std::integral_constant<bool, has_stencil<Flux>::value>());
+}
+
+ALSFVM_FLUX_INSTANTIATE(FusedNumericalFluxCPUCreator)
+}
+}
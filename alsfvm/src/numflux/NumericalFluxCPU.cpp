@@ -16,10 +16,13 @@
 #include "alsfvm/numflux/NumericalFluxCPU.hpp"
 #include "alsfvm/numflux/numerical_flux_list.hpp"
 #include "alsfvm/numflux/numflux_util.hpp"
+#include "alsfvm/numflux/euler/simd/flux_row.hpp"
+#include "alsfvm/reconstruction/NoReconstruction.hpp"
 #include <cassert>
 #include "alsfvm/numflux/numflux_util.hpp"
 #include "alsfvm/volume/VolumeFactory.hpp"
 #include "alsfvm/volume/volume_foreach.hpp"
+#include "alsutils/error/Exception.hpp"
 #include "alsutils/timer/Timer.hpp"
 #include <fstream>
 
@@ -29,22 +32,147 @@ namespace alsfvm {
 namespace numflux {
 
 
+//! Computes -F at every face from fluxStart to fluxEnd and stores it in
+//! temporaryViews, one cell at a time.
+//! \returns the maximum wave speed
 template<class Flux, class Equation, size_t direction>
-void computeNetFlux(const Equation& eq, const volume::Volume& left,
-    const volume::Volume& right,
-    volume::Volume& out,
-    volume::Volume& temporaryVolume,
-    real& waveSpeed, size_t numberOfGhostCells,
-    const ivec3 start, const ivec3 end) {
+typename std::enable_if < !euler::simd::has_simd_flux_row<Flux, direction>::value,
+         real >::type computeFluxes(
+    const Equation& eq,
+    typename Equation::ConstViews& leftViews,
+    typename Equation::ConstViews& rightViews,
+    typename Equation::Views& temporaryViews,
+    const ivec3& fluxStart, const ivec3& fluxEnd) {
 
-    ALSVINN_TIME_BLOCK(alsvinn, fvm, numflux);
-    // We will automate the creation of these pointer arrays soon,
-    // for now we keep them to keep things simple.
+    const bool xDir = direction == 0;
+    const bool yDir = direction == 1;
+    const bool zDir = direction == 2;
 
-    typename Equation::ConstViews leftViews(left);
+    auto stencil = getStencil<Flux>(Flux());
 
+    return volume::for_each_cell_reduce(fluxStart, fluxEnd,
+            real(0), [&](int x, int y, int z) {
 
-    typename Equation::ConstViews rightViews(right);
+        // Now we need to build up the stencil for this set of indices
+        decltype(stencil) indices;
+
+        for (size_t index = 0; index < stencil.size(); ++index) {
+
+            indices[index] = temporaryViews.index(
+                    x + xDir * stencil[index],
+                    y + yDir * stencil[index],
+                    z + zDir * stencil[index]);
+        }
+
+        typename Equation::ConservedVariables flux;
+        const real waveSpeedLocal = computeFluxForStencil<Flux, Equation, direction>(
+                eq,
+                indices,
+                leftViews,
+                rightViews,
+                flux);
+        auto outIndex = temporaryViews.index(x, y, z);
+        eq.setViewAt(temporaryViews, outIndex, (-1.0)*flux);
+        return waveSpeedLocal;
+    }, volume::reductions::Max());
+}
+
+//! Computes -F at every face from fluxStart to fluxEnd and stores it in
+//! temporaryViews, one x-row at a time with the vectorized kernels for the
+//! instruction set selected at runtime.
+//! \returns the maximum wave speed
+template<class Flux, class Equation, size_t direction>
+typename std::enable_if<euler::simd::has_simd_flux_row<Flux, direction>::value,
+         real>::type computeFluxes(
+    const Equation& eq,
+    typename Equation::ConstViews& leftViews,
+    typename Equation::ConstViews& rightViews,
+    typename Equation::Views& temporaryViews,
+    const ivec3& fluxStart, const ivec3& fluxEnd) {
+
+    constexpr int nsd = euler::simd::simd_flux_traits<Flux>::dimension;
+    const auto instructionSet = alsutils::simd::getInstructionSet();
+
+    // The flux at a face is computed from the right extrapolated value of
+    // the cell to the left, and the left extrapolated value of the cell to
+    // the right.
+    std::array<const real*, nsd + 2> leftSide;
+    std::array<const real*, nsd + 2> rightSide;
+    std::array<real*, nsd + 2> output;
+
+    for (int var = 0; var < nsd + 2; ++var) {
+        leftSide[var] = &rightViews.get(var).at(0);
+        rightSide[var] = &leftViews.get(var).at(0);
+        output[var] = &temporaryViews.get(var).at(0);
+    }
+
+    const size_t offset = temporaryViews.index(direction == 0, direction == 1,
+            direction == 2);
+    const size_t rowLength = fluxEnd.x - fluxStart.x;
+
+    return volume::for_each_cell_reduce(fluxStart,
+            ivec3(fluxStart.x + 1, fluxEnd.y, fluxEnd.z),
+            real(0), [&](int x, int y, int z) {
+        return euler::simd::computeFluxRow < euler::simd::simd_flux_traits<Flux>::kind,
+               nsd, direction > (instructionSet, eq.getGamma(), leftSide.data(),
+                   rightSide.data(), output.data(), temporaryViews.index(x, y, z),
+                   rowLength, offset);
+    }, volume::reductions::Max());
+}
+
+//! Computes -F at every face from fluxStart to fluxEnd from the cell
+//! averages and the cached extra variables, one cell at a time.
+//! \returns the maximum wave speed
+template<class Flux, class Equation, size_t direction>
+real computeCachedFluxes(const Equation& eq,
+    typename Equation::ConstViews& conservedViews,
+    typename Equation::ConstViewsExtra& extraViews,
+    typename Equation::Views& temporaryViews,
+    const ivec3& fluxStart, const ivec3& fluxEnd) {
+
+    const bool xDir = direction == 0;
+    const bool yDir = direction == 1;
+    const bool zDir = direction == 2;
+
+    auto stencil = getStencil<Flux>(Flux());
+
+    return volume::for_each_cell_reduce(fluxStart, fluxEnd,
+            real(0), [&](int x, int y, int z) {
+        decltype(stencil) indices;
+
+        for (size_t index = 0; index < stencil.size(); ++index) {
+
+            indices[index] = temporaryViews.index(
+                    x + xDir * stencil[index],
+                    y + yDir * stencil[index],
+                    z + zDir * stencil[index]);
+        }
+
+        typename Equation::ConservedVariables flux;
+        const real waveSpeedLocal = computeFluxForStencil<Flux, Equation, direction>(
+                eq,
+                indices,
+                conservedViews,
+                extraViews,
+                flux);
+        auto outIndex = temporaryViews.index(x, y, z);
+        eq.setViewAt(temporaryViews, outIndex, (-1.0)*flux);
+        return waveSpeedLocal;
+    }, volume::reductions::Max());
+}
+
+//! Computes the face fluxes in the given direction with computeFluxes
+//! (called as computeFluxes(temporaryViews, fluxStart, fluxEnd), returning
+//! the maximum wave speed) and adds the net flux to every cell of out.
+template<class Equation, size_t direction, class ComputeFluxes>
+void addNetFlux(const Equation& eq,
+    volume::Volume& out,
+    volume::Volume& temporaryVolume,
+    real& waveSpeed,
+    const ivec3 start, const ivec3 end,
+    const ComputeFluxes& computeFluxes) {
+
+    ALSVINN_TIME_BLOCK(alsvinn, fvm, numflux);
 
     typename Equation::Views outViews(out);
 
@@ -61,62 +189,146 @@ void computeNetFlux(const Equation& eq, const volume::Volume& left,
     const int ngy = out.getNumberOfYGhostCells();
     const int ngz = out.getNumberOfZGhostCells();
 
-    real waveSpeedComputed = 0;
-    auto stencil = getStencil<Flux>(Flux());
+    const ivec3 directionVector(xDir, yDir, zDir);
+    const ivec3 fluxStart = ivec3(ngx + start.x, ngy + start.y,
+            ngz + start.z) - directionVector;
+    const ivec3 fluxEnd(nx - ngx + end.x, ny - ngy + end.y, nz - ngz + end.z);
 
-    for (int z = ngz - zDir + start.z; z < nz - ngz + end.z; ++z) {
-        #pragma omp parallel for reduction(max: waveSpeedComputed)
-
-        for (int y = ngy - yDir + start.y; y < ny - ngy + end.y; ++y) {
-            for (int x = int(ngx) - xDir + start.x; x < int(nx) - int(ngx) + end.x; ++x) {
-
-                // Now we need to build up the stencil for this set of indices
-                decltype(stencil) indices;
-
-                for (size_t index = 0; index < stencil.size(); ++index) {
-
-                    indices[index] = outViews.index(
-                            x + xDir * stencil[index],
-                            y + yDir * stencil[index],
-                            z + zDir * stencil[index]);
-                }
-
-                typename Equation::ConservedVariables flux;
-                const real waveSpeedLocal = computeFluxForStencil<Flux, Equation, direction>(
-                        eq,
-                        indices,
-                        leftViews,
-                        rightViews,
-                        flux);
-                auto outIndex = outViews.index(x, y, z);
-                eq.setViewAt(temporaryViews, outIndex, (-1.0)*flux);
-                waveSpeedComputed = std::max(waveSpeedComputed, waveSpeedLocal);
-            }
-        }
+    waveSpeed = computeFluxes(temporaryViews, fluxStart, fluxEnd);
+
+    volume::for_each_cell_index_parallel(fluxStart, fluxEnd - directionVector,
+    [&](int x, int y, int z) {
+        const size_t rightIndex = outViews.index(x + xDir, y + yDir, z + zDir);
+        const size_t middleIndex = outViews.index(x, y, z);
+        auto fluxMiddleRight = eq.fetchConservedVariables(temporaryViews, rightIndex);
+        auto fluxLeftMiddle = (-1.0) * eq.fetchConservedVariables(temporaryViews,
+                middleIndex);
+
+        eq.addToViewAt(outViews, rightIndex, fluxMiddleRight + fluxLeftMiddle);
+    });
+}
+
+//! Reconstructs (into left and right) and adds the net flux in the given
+//! direction to out
+template<class Flux, class Equation, size_t direction>
+void computeNetFlux(const Equation& eq,
+    reconstruction::Reconstruction& reconstruction,
+    const volume::Volume& conservedVariables,
+    volume::Volume& left,
+    volume::Volume& right,
+    volume::Volume& out,
+    volume::Volume& temporaryVolume,
+    real& waveSpeed,
+    const ivec3 start, const ivec3 end) {
+
+    reconstruction.performReconstruction(conservedVariables, direction, 0,
+        left, right, start, end);
+
+    typename Equation::ConstViews leftViews(left);
+    typename Equation::ConstViews rightViews(right);
+
+    addNetFlux<Equation, direction>(eq, out, temporaryVolume, waveSpeed,
+        start, end, [&](typename Equation::Views & temporaryViews,
+    const ivec3 & fluxStart, const ivec3 & fluxEnd) {
+        return computeFluxes<Flux, Equation, direction>(eq, leftViews,
+                rightViews, temporaryViews, fluxStart, fluxEnd);
+    });
+}
+
+template<class Equation>
+struct supports_primitive_cache : std::false_type {};
+
+template<int nsd>
+struct supports_primitive_cache<equation::euler::Euler<nsd>> : std::true_type {};
+
+//! Computes the extra variables of every cell that is within the stencil
+//! of some face between start and end, and writes them to extra.
+template<class Equation>
+void computeCachedExtraVariables(const Equation& eq,
+    const volume::Volume& conservedVariables,
+    volume::Volume& extra,
+    const ivec3& start, const ivec3& end) {
+
+    ALSVINN_TIME_BLOCK(alsvinn, fvm, numflux, primitivecache);
+
+    typename Equation::ConstViews conservedViews(conservedVariables);
+    typename Equation::ViewsExtra extraViews(extra);
+
+    const ivec3 totalNumberOfCells(int(extra.getTotalNumberOfXCells()),
+        int(extra.getTotalNumberOfYCells()),
+        int(extra.getTotalNumberOfZCells()));
+
+    // The faces start (at most) one cell in, the stencil extends at most
+    // the number of ghost cells from the face.
+    ivec3 first, last;
+
+    for (int d = 0; d < 3; ++d) {
+        first[d] = std::max(start[d], 0);
+        last[d] = std::min(totalNumberOfCells[d] + end[d], totalNumberOfCells[d]);
     }
 
-    waveSpeed = waveSpeedComputed;
+    volume::for_each_cell_index_parallel(first, last, [&](int x, int y, int z) {
+        const size_t index = extraViews.index(x, y, z);
+        eq.setExtraViewAt(extraViews, index, eq.computeExtra(
+                eq.fetchConservedVariables(conservedViews, index)));
+    });
+}
 
-    for (int z = ngz - zDir + start.z; z < nz - ngz + end.z - zDir; ++z) {
-        #pragma omp parallel for
+//! Adds the net flux in the given direction to out, reading the cell
+//! averages from conservedVariables and the extra variables from extra.
+template<class Flux, class Equation, size_t direction>
+void computeCachedNetFlux(const Equation& eq,
+    const volume::Volume& conservedVariables,
+    const volume::Volume& extra,
+    volume::Volume& out,
+    volume::Volume& temporaryVolume,
+    real& waveSpeed,
+    const ivec3 start, const ivec3 end) {
 
-        for (int y = ngy - yDir + start.y; y < ny - ngy + end.y - yDir; ++y) {
+    typename Equation::ConstViews conservedViews(conservedVariables);
+    typename Equation::ConstViewsExtra extraViews(extra);
 
-            for (int x = int(ngx) - xDir + start.x; x < int(nx - ngx) + end.x - xDir; ++x) {
+    addNetFlux<Equation, direction>(eq, out, temporaryVolume, waveSpeed,
+        start, end, [&](typename Equation::Views & temporaryViews,
+    const ivec3 & fluxStart, const ivec3 & fluxEnd) {
+        return computeCachedFluxes<Flux, Equation, direction>(eq, conservedViews,
+                extraViews, temporaryViews, fluxStart, fluxEnd);
+    });
+}
 
-                const size_t rightIndex = outViews.index(x + xDir, y + yDir, z + zDir);
-                const size_t middleIndex = outViews.index(x, y, z);
-                auto fluxMiddleRight = eq.fetchConservedVariables(temporaryViews, rightIndex);
-                auto fluxLeftMiddle = (-1.0) * eq.fetchConservedVariables(temporaryViews,
-                        middleIndex);
+//! Computes the extra variables once and the net flux in every direction
+//! from them, see NumericalFluxCPU
+template<class Flux, class Equation, size_t dimension>
+void computeCachedFlux(const Equation& eq,
+    const volume::Volume& conservedVariables,
+    volume::Volume& extra,
+    volume::Volume& output,
+    volume::Volume& temporaryVolume,
+    rvec3& waveSpeed,
+    const ivec3& start, const ivec3& end, std::true_type) {
 
-                eq.addToViewAt(outViews, rightIndex, fluxMiddleRight + fluxLeftMiddle);
+    computeCachedExtraVariables(eq, conservedVariables, extra, start, end);
 
-            }
-        }
+    computeCachedNetFlux<Flux, Equation, 0>(eq, conservedVariables, extra,
+        output, temporaryVolume, waveSpeed.x, start, end);
+
+    if (dimension > 1) {
+        computeCachedNetFlux<Flux, Equation, 1>(eq, conservedVariables, extra,
+            output, temporaryVolume, waveSpeed.y, start, end);
+    }
+
+    if (dimension > 2) {
+        computeCachedNetFlux<Flux, Equation, 2>(eq, conservedVariables, extra,
+            output, temporaryVolume, waveSpeed.z, start, end);
     }
 }
 
+template<class Flux, class Equation, size_t dimension>
+void computeCachedFlux(const Equation&, const volume::Volume&,
+    volume::Volume&, volume::Volume&, volume::Volume&, rvec3&,
+    const ivec3&, const ivec3&, std::false_type) {
+    THROW("The primitive variable cache is only available for the Euler equations.");
+}
 
 template<class Equation>
 void makeZero(Equation& equation, volume::Volume& out,
@@ -131,17 +343,12 @@ void makeZero(Equation& equation, volume::Volume& out,
 
     typename Equation::Views outViews(out);
 
-    for (int z = ngz + start.z; z < nz - ngz + end.z; ++z) {
-        #pragma omp parallel for
-
-        for (int y = ngy + start.y; y < ny - ngy + end.y; ++y) {
-
-            for (int x = int(ngx) + start.x; x < int(nx - ngx) + end.x; ++x) {
-                typename Equation::ConservedVariables zero;
-                equation.setViewAt(outViews, outViews.index(x, y, z), zero);
-            }
-        }
-    }
+    volume::for_each_cell_index_parallel(ivec3(ngx, ngy, ngz) + start,
+        ivec3(nx - ngx, ny - ngy, nz - ngz) + end,
+    [&](int x, int y, int z) {
+        typename Equation::ConservedVariables zero;
+        equation.setViewAt(outViews, outViews.index(x, y, z), zero);
+    });
 
 }
 
@@ -152,13 +359,28 @@ NumericalFluxCPU<Flux, Equation, dimension>::NumericalFluxCPU(
     const alsfvm::shared_ptr<simulator::SimulatorParameters>& simulatorParameters,
     alsfvm::shared_ptr<DeviceConfiguration>& deviceConfiguration)
     : volumeFactory(Equation::getName(),
-          alsfvm::make_shared<memory::MemoryFactory>(deviceConfiguration)),
+          alsfvm::make_shared<memory::MemoryFactory>(deviceConfiguration,
+              simulatorParameters->getMemoryPool())),
       reconstruction(reconstruction),
+      usePrimitiveCache(simulatorParameters->getPrimitiveCache()),
       parameters(static_cast<typename Equation::Parameters&>
           (simulatorParameters->getEquationParameters())) {
     static_assert(dimension > 0, "We only support positive dimension!");
     static_assert(dimension < 4, "We only support dimension up to 3");
 
+    if (usePrimitiveCache) {
+        if (!supports_primitive_cache<Equation>::value) {
+            THROW("The primitive variable cache is only available for the Euler "
+                << "equations, given " << Equation::getName());
+        }
+
+        // The cached values are the cell averages, which are only the face
+        // values if we do not reconstruct.
+        if (!dynamic_cast<reconstruction::NoReconstruction*>(reconstruction.get())) {
+            THROW("The primitive variable cache can only be used without "
+                << "reconstruction (reconstruction \"none\").");
+        }
+    }
 
     createVolumes(grid.getDimensions().x,
         grid.getDimensions().y,
@@ -180,10 +402,11 @@ void NumericalFluxCPU<Flux, Equation, dimension>::computeFlux(
 
     // Make sure we have the correct size.
     if (conservedVariables.getTotalNumberOfXCells() !=
-        left->getTotalNumberOfXCells()
-        || conservedVariables.getTotalNumberOfYCells() != left->getTotalNumberOfYCells()
+        temporaryVolume->getTotalNumberOfXCells()
+        || conservedVariables.getTotalNumberOfYCells() !=
+        temporaryVolume->getTotalNumberOfYCells()
         || conservedVariables.getTotalNumberOfZCells() !=
-        left->getTotalNumberOfZCells()) {
+        temporaryVolume->getTotalNumberOfZCells()) {
 
         createVolumes(conservedVariables.getNumberOfXCells(),
             conservedVariables.getNumberOfYCells(),
@@ -193,29 +416,25 @@ void NumericalFluxCPU<Flux, Equation, dimension>::computeFlux(
 
     makeZero(eq, output, start, end);
 
-    reconstruction->performReconstruction(conservedVariables, 0, 0,
-        *left, *right, start, end);
-    computeNetFlux<Flux, Equation, 0>(eq, *left, *right, output,
-        *temporaryVolume, waveSpeed.x,
-        getNumberOfGhostCells(), start, end);
+    if (usePrimitiveCache) {
+        computeCachedFlux<Flux, Equation, dimension>(eq, conservedVariables,
+            *extraVolume, output, *temporaryVolume, waveSpeed, start, end,
+            supports_primitive_cache<Equation>());
+        return;
+    }
+
+    computeNetFlux<Flux, Equation, 0>(eq, *reconstruction, conservedVariables,
+        *left, *right, output, *temporaryVolume, waveSpeed.x, start, end);
 
     if (dimension > 1) {
-        reconstruction->performReconstruction(conservedVariables, 1, 0,
-            *left, *right, start, end);
-        computeNetFlux<Flux, Equation, 1>(eq, *left, *right, output,
-            *temporaryVolume,
-            waveSpeed.y, getNumberOfGhostCells(),
-            start, end);
+        computeNetFlux<Flux, Equation, 1>(eq, *reconstruction, conservedVariables,
+            *left, *right, output, *temporaryVolume, waveSpeed.y, start, end);
     }
 
 
     if (dimension > 2) {
-        reconstruction->performReconstruction(conservedVariables, 2, 0,
-            *left, *right, start, end);
-        computeNetFlux<Flux, Equation, 2>(eq, *left, *right, output,
-            *temporaryVolume, waveSpeed.z,
-            getNumberOfGhostCells(),
-            start, end);
+        computeNetFlux<Flux, Equation, 2>(eq, *reconstruction, conservedVariables,
+            *left, *right, output, *temporaryVolume, waveSpeed.z, start, end);
     }
 
 }
@@ -233,6 +452,17 @@ size_t NumericalFluxCPU<Flux, Equation, dimension>::getNumberOfGhostCells() {
 template<class Flux, class Equation, size_t dimension>
 void NumericalFluxCPU<Flux, Equation, dimension>::createVolumes(size_t nx,
     size_t ny, size_t nz, size_t ngc) {
+    temporaryVolume = volumeFactory.createConservedVolume(nx,
+            ny,
+            nz,
+            ngc);
+
+    if (usePrimitiveCache) {
+        // No reconstruction, the fluxes read the input directly
+        extraVolume = volumeFactory.createExtraVolume(nx, ny, nz, ngc);
+        return;
+    }
+
     left = volumeFactory.createConservedVolume(nx,
             ny,
             nz,
@@ -245,11 +475,6 @@ void NumericalFluxCPU<Flux, Equation, dimension>::createVolumes(size_t nx,
             ngc);
 
     right->makeZero();
-
-    temporaryVolume = volumeFactory.createConservedVolume(nx,
-            ny,
-            nz,
-            ngc);
 }
 
 ALSFVM_FLUX_INSTANTIATE(NumericalFluxCPU)
@@ -15,6 +15,7 @@
 #include "alsutils/config.hpp"
 #include "alsfvm/numflux/NumericalFluxFactory.hpp"
 #include "alsfvm/numflux/NumericalFluxCPU.hpp"
+#include "alsfvm/numflux/FusedNumericalFluxCPU.hpp"
 
 #include "alsfvm/reconstruction/ReconstructionFactory.hpp"
 #include "alsfvm/numflux/euler/HLL.hpp"
@@ -43,12 +44,14 @@ namespace {
 template<class Equation>
 struct FluxFunctor {
     FluxFunctor(const std::string& fluxName,
+        const std::string& reconstructionName,
         alsfvm::shared_ptr<reconstruction::Reconstruction>& reconstruction,
         const alsfvm::shared_ptr<simulator::SimulatorParameters>& simulatorParameters,
         alsfvm::shared_ptr<DeviceConfiguration>& deviceConfiguration,
         const grid::Grid& grid,
         alsfvm::shared_ptr<NumericalFlux>& numericalFlux)
         : fluxName(fluxName),
+          reconstructionName(reconstructionName),
           reconstruction(reconstruction),
           simulatorParameters(simulatorParameters),
           deviceConfiguration(deviceConfiguration),
@@ -60,7 +63,26 @@ struct FluxFunctor {
     template<class NumericalFlux>
     void operator()(const NumericalFlux& flux) const {
         if (NumericalFlux::name == boost::to_lower_copy(fluxName)) {
-            if (deviceConfiguration->getPlatform() == "cpu") {
+            if (deviceConfiguration->getPlatform() == "cpu"
+                && simulatorParameters->getFluxEngine() == "fused") {
+                if (grid.getActiveDimension() == 3) {
+                    numericalFlux = FusedNumericalFluxCPUCreator<NumericalFlux, Equation, 3>::create(
+                            reconstructionName, *simulatorParameters);
+                } else if (grid.getActiveDimension() == 2) {
+                    numericalFlux = FusedNumericalFluxCPUCreator<NumericalFlux, Equation, 2>::create(
+                            reconstructionName, *simulatorParameters);
+                } else if (grid.getActiveDimension() == 1) {
+                    numericalFlux = FusedNumericalFluxCPUCreator<NumericalFlux, Equation, 1>::create(
+                            reconstructionName, *simulatorParameters);
+                } else {
+                    THROW("Unsupported dimension " << grid.getActiveDimension());
+                }
+            } else if (deviceConfiguration->getPlatform() == "cpu") {
+                if (simulatorParameters->getFluxEngine() != "standard") {
+                    THROW("Unknown flux engine " << simulatorParameters->getFluxEngine()
+                        << ", supported are \"standard\" and \"fused\".");
+                }
+
                 if (grid.getActiveDimension() == 3) {
                     numericalFlux.reset(new NumericalFluxCPU<NumericalFlux, Equation, 3>(grid,
                             reconstruction, simulatorParameters, deviceConfiguration));
@@ -98,6 +120,7 @@ struct FluxFunctor {
         }
     }
     const std::string& fluxName;
+    const std::string& reconstructionName;
     alsfvm::shared_ptr<reconstruction::Reconstruction>& reconstruction;
     const alsfvm::shared_ptr<simulator::SimulatorParameters>& simulatorParameters;
     alsfvm::shared_ptr<DeviceConfiguration>& deviceConfiguration;
@@ -113,6 +136,7 @@ struct FluxFunctor {
 struct EquationFunctor {
     EquationFunctor(const std::string& equationName,
         const std::string& fluxName,
+        const std::string& reconstructionName,
         alsfvm::shared_ptr<reconstruction::Reconstruction>& reconstruction,
         const alsfvm::shared_ptr<simulator::SimulatorParameters>& simulatorParameters,
         alsfvm::shared_ptr<DeviceConfiguration>& deviceConfiguration,
@@ -120,6 +144,7 @@ struct EquationFunctor {
         alsfvm::shared_ptr<NumericalFlux>& numericalFlux)
         : equationName(equationName),
           fluxName(fluxName),
+          reconstructionName(reconstructionName),
           reconstruction(reconstruction),
           simulatorParameters(simulatorParameters),
           deviceConfiguration(deviceConfiguration),
@@ -132,7 +157,7 @@ struct EquationFunctor {
     void operator()(const EquationInfo& info) const {
         if (info.getName() == equationName) {
             FluxFunctor<typename EquationInfo::EquationType> fluxFunctor(fluxName,
-                reconstruction, simulatorParameters,
+                reconstructionName, reconstruction, simulatorParameters,
                 deviceConfiguration, grid, numericalFlux);
             for_each_flux<typename EquationInfo::EquationType> (fluxFunctor);
         }
@@ -140,6 +165,7 @@ struct EquationFunctor {
 
     const std::string& equationName;
     const std::string& fluxName;
+    const std::string& reconstructionName;
     alsfvm::shared_ptr<reconstruction::Reconstruction>& reconstruction;
     const alsfvm::shared_ptr<simulator::SimulatorParameters>& simulatorParameters;
     alsfvm::shared_ptr<DeviceConfiguration>& deviceConfiguration;
@@ -174,7 +200,7 @@ NumericalFluxFactory::NumericalFluxPtr NumericalFluxFactory::createNumericalFlux
     const grid::Grid& grid) {
 
     auto memoryFactory = alsfvm::make_shared<memory::MemoryFactory>
-        (deviceConfiguration);
+        (deviceConfiguration, simulatorParameters->getMemoryPool());
 
     alsfvm::reconstruction::ReconstructionFactory reconstructionFactory;
     auto reconstructor = reconstructionFactory.createReconstruction(reconstruction,
@@ -185,7 +211,8 @@ NumericalFluxFactory::NumericalFluxPtr NumericalFluxFactory::createNumericalFlux
             deviceConfiguration);
 
     alsfvm::shared_ptr<NumericalFlux> numericalFlux;
-    EquationFunctor equationFunctor(equation, fluxname, reconstructor,
+    EquationFunctor equationFunctor(equation, fluxname, reconstruction,
+        reconstructor,
         simulatorParameters,
         deviceConfiguration, grid, numericalFlux);
 
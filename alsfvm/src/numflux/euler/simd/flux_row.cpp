@@ -0,0 +1,83 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "alsfvm/numflux/euler/simd/flux_row.hpp"
+
+namespace alsfvm {
+namespace numflux {
+namespace euler {
+namespace simd {
+
+// The ALSVINN_HAVE_SIMD_* definitions are set in alsfvm/CMakeLists.txt
+// depending on which kernels the compiler could build.
+template<FluxKind kind, int nsd, int direction>
+real computeFluxRow(alsutils::simd::InstructionSet instructionSet,
+    real gamma,
+    const real* const* leftSide,
+    const real* const* rightSide,
+    real* const* output,
+    size_t first, size_t count, size_t offset) {
+    using alsutils::simd::InstructionSet;
+#ifdef ALSVINN_HAVE_SIMD_AVX512
+
+    if (int(instructionSet) >= int(InstructionSet::avx512)) {
+        return avx512::computeFluxRow<kind, nsd, direction>(gamma, leftSide,
+                rightSide, output, first, count, offset);
+    }
+
+#endif
+#ifdef ALSVINN_HAVE_SIMD_AVX2
+
+    if (int(instructionSet) >= int(InstructionSet::avx2)) {
+        return avx2::computeFluxRow<kind, nsd, direction>(gamma, leftSide,
+                rightSide, output, first, count, offset);
+    }
+
+#endif
+#ifdef ALSVINN_HAVE_SIMD_SSE
+
+    if (int(instructionSet) >= int(InstructionSet::sse)) {
+        return sse::computeFluxRow<kind, nsd, direction>(gamma, leftSide,
+                rightSide, output, first, count, offset);
+    }
+
+#endif
+    return scalar::computeFluxRow<kind, nsd, direction>(gamma, leftSide,
+            rightSide, output, first, count, offset);
+}
+
+#define ALSFVM_SIMD_INSTANTIATE_FLUX_ROW(kind, nsd, direction) \
+    template real computeFluxRow<kind, nsd, direction>( \
+        alsutils::simd::InstructionSet, real, \
+        const real* const*, const real* const*, real* const*, \
+        size_t, size_t, size_t);
+
+#define ALSFVM_SIMD_INSTANTIATE_FLUX_ROW_KIND(kind) \
+    ALSFVM_SIMD_INSTANTIATE_FLUX_ROW(kind, 1, 0) \
+    ALSFVM_SIMD_INSTANTIATE_FLUX_ROW(kind, 2, 0) \
+    ALSFVM_SIMD_INSTANTIATE_FLUX_ROW(kind, 2, 1) \
+    ALSFVM_SIMD_INSTANTIATE_FLUX_ROW(kind, 3, 0) \
+    ALSFVM_SIMD_INSTANTIATE_FLUX_ROW(kind, 3, 1) \
+    ALSFVM_SIMD_INSTANTIATE_FLUX_ROW(kind, 3, 2)
+
+ALSFVM_SIMD_INSTANTIATE_FLUX_ROW_KIND(FluxKind::hll)
+ALSFVM_SIMD_INSTANTIATE_FLUX_ROW_KIND(FluxKind::hll3)
+ALSFVM_SIMD_INSTANTIATE_FLUX_ROW_KIND(FluxKind::rusanov)
+ALSFVM_SIMD_INSTANTIATE_FLUX_ROW_KIND(FluxKind::central)
+
+} // namespace simd
+} // namespace euler
+} // namespace numflux
+} // namespace alsfvm
@@ -0,0 +1,19 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Kernels for AVX-512, compiled with the flags set in alsfvm/CMakeLists.txt.
+#define ALSFVM_SIMD_ISA avx512
+#define ALSFVM_SIMD_REGISTER_BYTES 64
+#include "alsfvm/numflux/euler/simd/flux_row_kernels_impl.hpp"
@@ -121,67 +121,56 @@ void ENOCPU<order>::performReconstruction(const volume::Volume& inputVariables,
         real* pointerOutLeft = leftOut.getScalarMemoryArea(var)->getPointer();
         real* pointerOutRight = rightOut.getScalarMemoryArea(var)->getPointer();
 
-        for (int z = startZ; z < endZ; z++) {
-            #pragma omp parallel for
-
-            for (int y = startY; y < endY; y++) {
-                #pragma omp simd
-
-                for (int x = startX; x < int(endX); x++) {
-
-
-                    const size_t indexRight = z * nx * ny + y * nx + x;
-                    const size_t indexLeft = (z - directionVector.z) * nx * ny
-                        + (y - directionVector.y) * nx
-                        + (x - directionVector.x);
-
-                    // First we determine the shift
-                    // We do this by looping through the levels of the divided
-                    // differences, and each time we go left, we increment the shift.
-                    int shift = 0;
-
-                    for (size_t level = 0; level < order - 1; level++) {
-                        real dividedDifferenceRight = dividedDifferencesPointers[level][indexRight];
-                        real dividedDifferenceLeft = dividedDifferencesPointers[level][indexLeft];
-
-                        if (std::fabs(dividedDifferenceLeft) < std::fabs(dividedDifferenceRight)) {
-                            // Now we choose the left stencil
-                            shift++;
-                        }
-
-
-                    }
-
-                    // Now we have the stencil enabled. We need to find the correct
-                    // coefficients.
+        volume::for_each_cell_index_parallel({startX, startY, startZ},
+            {endX, endY, endZ}, [&](int x, int y, int z) {
+            const size_t indexRight = z * nx * ny + y * nx + x;
+            const size_t indexLeft = (z - directionVector.z) * nx * ny
+                + (y - directionVector.y) * nx
+                + (x - directionVector.x);
+
+            // First we determine the shift
+            // We do this by looping through the levels of the divided
+            // differences, and each time we go left, we increment the shift.
+            int shift = 0;
+
+            for (size_t level = 0; level < order - 1; level++) {
+                real dividedDifferenceRight = dividedDifferencesPointers[level][indexRight];
+                real dividedDifferenceLeft = dividedDifferencesPointers[level][indexLeft];
+
+                if (std::fabs(dividedDifferenceLeft) < std::fabs(dividedDifferenceRight)) {
+                    // Now we choose the left stencil
+                    shift++;
+                }
 
-                    auto coefficientsRight = ENOCoeffiecients<order>::coefficients[shift + 1];
-                    auto coefficientsLeft = ENOCoeffiecients<order>::coefficients[shift];
-                    real leftValue = 0.0;
-                    real rightValue = 0.0;
 
-                    for (int j = 0; j < order; j++) {
+            }
 
-                        const size_t index = (z - (shift - j) * directionVector.z) * nx * ny
-                            + (y - (shift - j) * directionVector.y) * nx
-                            + (x - (shift - j) * directionVector.x);
+            // Now we have the stencil enabled. We need to find the correct
+            // coefficients.
 
+            auto coefficientsRight = ENOCoeffiecients<order>::coefficients[shift + 1];
+            auto coefficientsLeft = ENOCoeffiecients<order>::coefficients[shift];
+            real leftValue = 0.0;
+            real rightValue = 0.0;
 
-                        const real value = pointerIn[index];
-                        leftValue += coefficientsLeft[j] * value;
-                        rightValue += coefficientsRight[j] * value;
+            for (int j = 0; j < order; j++) {
 
-                    }
+                const size_t index = (z - (shift - j) * directionVector.z) * nx * ny
+                    + (y - (shift - j) * directionVector.y) * nx
+                    + (x - (shift - j) * directionVector.x);
 
-                    pointerOutLeft[indexRight] = leftValue;
-                    pointerOutRight[indexRight] = rightValue;
-                    assert(!std::isnan(leftValue));
-                    assert(!std::isnan(rightValue));
 
+                const real value = pointerIn[index];
+                leftValue += coefficientsLeft[j] * value;
+                rightValue += coefficientsRight[j] * value;
 
-                }
             }
-        }
+
+            pointerOutLeft[indexRight] = leftValue;
+            pointerOutRight[indexRight] = rightValue;
+            assert(!std::isnan(leftValue));
+            assert(!std::isnan(rightValue));
+        });
     }
 
 }
@@ -251,19 +240,15 @@ void ENOCPU<order>::computeDividedDifferences(const memory::Memory<real>& input,
 
     real* pointerOut = output.getPointer();
 
-    for (int z = startZ; z < endZ; z++) {
-        for (int y = startY; y < endY; y++) {
-            for (int x = startX; x < endX; x++) {
-                const size_t indexRight = z * nx * ny + y * nx + x;
-                const size_t indexLeft = (z - direction.z) * nx * ny
-                    + (y - direction.y) * nx
-                    + (x - direction.x);
-
-                pointerOut[indexLeft] = pointerIn[indexRight] - pointerIn[indexLeft];
+    volume::for_each_cell_index_parallel({startX, startY, startZ},
+        {endX, endY, endZ}, [&](int x, int y, int z) {
+        const size_t indexRight = z * nx * ny + y * nx + x;
+        const size_t indexLeft = (z - direction.z) * nx * ny
+            + (y - direction.y) * nx
+            + (x - direction.x);
 
-            }
-        }
-    }
+        pointerOut[indexLeft] = pointerIn[indexRight] - pointerIn[indexLeft];
+    });
 }
 
 template class ENOCPU<1>;
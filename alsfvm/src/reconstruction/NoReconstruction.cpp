@@ -16,6 +16,7 @@
 #include "alsfvm/reconstruction/NoReconstruction.hpp"
 #include "alsfvm/volume/volume_foreach.hpp"
 #include "alsutils/timer/Timer.hpp"
+#include <algorithm>
 
 namespace alsfvm {
 namespace reconstruction {
@@ -48,14 +49,31 @@ void NoReconstruction::performReconstruction(const volume::Volume&
     const ivec3& end) {
     ALSVINN_TIME_BLOCK(alsvinn, fvm, reconstruction);
 
+    // Only the cells in [start, end) (relative to the inner domain) and
+    // the ghost cells in the given direction are needed (the stencil of
+    // the higher order fluxes may extend over all of them).
+    const ivec3 directionVector(direction == 0, direction == 1, direction == 2);
+    const ivec3 ghostCells = inputVariables.getNumberOfGhostCells();
+    const ivec3 totalSize = inputVariables.getTotalDimensions();
+    const ivec3 stencilWidth = ghostCells * directionVector;
+    ivec3 first = ghostCells - stencilWidth + start;
+    ivec3 last = totalSize - ghostCells + stencilWidth + end;
+
+    for (int d = 0; d < 3; ++d) {
+        first[d] = std::max(first[d], 0);
+        last[d] = std::min(last[d], totalSize[d]);
+    }
+    const size_t nx = totalSize.x;
+    const size_t ny = totalSize.y;
+
     for (size_t var = 0; var < inputVariables.getNumberOfVariables(); var++) {
         auto pointerIn = inputVariables.getScalarMemoryArea(var)->getPointer();
         auto pointerLeft = leftOut.getScalarMemoryArea(var)->getPointer();
         auto pointerRight = rightOut.getScalarMemoryArea(var)->getPointer();
 
-        volume::for_each_cell_index(inputVariables,
-        [&](size_t index) {
-
+        volume::for_each_cell_index_parallel(first, last,
+        [&](int x, int y, int z) {
+            const size_t index = (z * ny + y) * nx + x;
             pointerLeft[index] = pointerIn[index];
             pointerRight[index] = pointerIn[index];
         });
@@ -20,8 +20,10 @@
 #include "alsfvm/reconstruction/WENOF2.hpp"
 #include "alsfvm/reconstruction/MC.hpp"
 #include "alsfvm/reconstruction/MM.hpp"
+#include "alsfvm/volume/volume_foreach.hpp"
 #include "alsutils/error/Exception.hpp"
 #include "alsutils/timer/Timer.hpp"
+#include <algorithm>
 
 namespace alsfvm {
 namespace reconstruction {
@@ -58,9 +60,14 @@ void ReconstructionCPU<ReconstructionType, Equation>::performReconstruction(
     const int nz = inputVariables.getTotalNumberOfZCells();
 
     const int dimension = inputVariables.getDimensions();
-    const int ngx = this->getNumberOfGhostCells();
-    const int ngy = (dimension > 1) * this->getNumberOfGhostCells();
-    const int ngz = (dimension > 2) * this->getNumberOfGhostCells();
+    const int ghostCells = int(this->getNumberOfGhostCells());
+    const ivec3 volumeGhostCells = inputVariables.getNumberOfGhostCells();
+
+    // start and end are relative to the inner domain of the volume, which
+    // may have more ghost cells than we need (eg. with a deep halo)
+    const int ngx = std::max(ghostCells, volumeGhostCells.x);
+    const int ngy = (dimension > 1) * std::max(ghostCells, volumeGhostCells.y);
+    const int ngz = (dimension > 2) * std::max(ghostCells, volumeGhostCells.z);
 
 
     // Sanity check, we need at least ONE point in the interior.
@@ -83,17 +90,12 @@ void ReconstructionCPU<ReconstructionType, Equation>::performReconstruction(
 
     Equation eq(parameters);
 
-    for (int z = startZ; z < endZ; z++) {
-        #pragma omp parallel for
-
-        for (int y = startY; y < endY; y++) {
-            for (int x = startX; x < int(endX); x++) {
-                ReconstructionType::reconstruct(eq, viewIn, x, y, z, viewLeft, viewRight,
-                    directionVector.x, directionVector.y,
-                    directionVector.z);
-            }
-        }
-    }
+    volume::for_each_cell_index_parallel({startX, startY, startZ},
+    {endX, endY, endZ}, [&](int x, int y, int z) {
+        ReconstructionType::reconstruct(eq, viewIn, x, y, z, viewLeft, viewRight,
+            directionVector.x, directionVector.y,
+            directionVector.z);
+    });
 }
 
 template<class ReconstructionType, class Equation>
@@ -21,6 +21,7 @@
 #include "alsutils/error/Exception.hpp"
 #include <cassert>
 #include <type_traits>
+#include "alsfvm/volume/volume_foreach.hpp"
 
 
 
@@ -122,76 +123,71 @@ void WENOCPU<order>::performReconstruction(const volume::Volume& inputVariables,
     const real* pointerInWeight = inputVariables.getScalarMemoryArea(
             indicatorVariable)->getPointer();
 
-    for (size_t z = startZ; z < endZ; z++) {
-        for (size_t y = startY; y < endY; y++) {
-            #pragma omp parallel for
+    volume::for_each_cell_index_parallel({int(startX), int(startY), int(startZ)},
+        {int(endX), int(endY), int(endZ)}, [&](int x, int y, int z) {
+        const size_t outIndex = z * nx * ny + y * nx + x;
 
-            for (int x = startX; x < int(endX); x++) {
-                const size_t outIndex = z * nx * ny + y * nx + x;
 
 
 
+        // First we need to find alpha and beta.
+        std::array < real, 2 * order - 1 > stencil;
 
-                // First we need to find alpha and beta.
-                std::array < real, 2 * order - 1 > stencil;
+        for (int i = -order + 1; i < order; i++) {
+            const size_t index = (z + i * directionVector.z) * nx * ny
+                + (y + i * directionVector.y) * nx
+                + (x + i * directionVector.x);
 
-                for (int i = -order + 1; i < order; i++) {
-                    const size_t index = (z + i * directionVector.z) * nx * ny
-                        + (y + i * directionVector.y) * nx
-                        + (x + i * directionVector.x);
-
-                    stencil[i + order - 1] = pointerInWeight[index];
-                }
+            stencil[i + order - 1] = pointerInWeight[index];
+        }
 
-                std::array<real, order> alphaRight;
-                std::array<real, order> alphaLeft;
-                real alphaRightSum = 0.0;
-                real alphaLeftSum = 0.0;
+        std::array<real, order> alphaRight;
+        std::array<real, order> alphaLeft;
+        real alphaRightSum = 0.0;
+        real alphaLeftSum = 0.0;
 
-                static_assert(order < 4
-                    && order > 1, "So far, we only support order = 2 or order = 3");
+        static_assert(order < 4
+            && order > 1, "So far, we only support order = 2 or order = 3");
 
-                computeAlpha < int(order) - 1, int(order) > (stencil,
-                    alphaLeftSum,
-                    alphaRightSum,
-                    alphaLeft,
-                    alphaRight);
+        computeAlpha < int(order) - 1, int(order) > (stencil,
+            alphaLeftSum,
+            alphaRightSum,
+            alphaLeft,
+            alphaRight);
 
-                for (size_t var = 0; var < numberOfVariables; var++) {
-                    real leftWenoValue = 0.0;
-                    real rightWenoValue = 0.0;
+        for (size_t var = 0; var < numberOfVariables; var++) {
+            real leftWenoValue = 0.0;
+            real rightWenoValue = 0.0;
 
-                    // Loop through all stencils (shift = r)
-                    for (int shift = 0; shift < order; shift++) {
+            // Loop through all stencils (shift = r)
+            for (int shift = 0; shift < order; shift++) {
 
-                        auto coefficientsRight = ENOCoeffiecients<order>::coefficients[shift + 1];
-                        auto coefficientsLeft = ENOCoeffiecients<order>::coefficients[shift];
-                        real leftValue = 0.0;
-                        real rightValue = 0.0;
+                auto coefficientsRight = ENOCoeffiecients<order>::coefficients[shift + 1];
+                auto coefficientsLeft = ENOCoeffiecients<order>::coefficients[shift];
+                real leftValue = 0.0;
+                real rightValue = 0.0;
 
-                        for (int j = 0; j < order; j++) {
+                for (int j = 0; j < order; j++) {
 
-                            const size_t index = (z - (shift - j) * directionVector.z) * nx * ny
-                                + (y - (shift - j) * directionVector.y) * nx
-                                + (x - (shift - j) * directionVector.x);
+                    const size_t index = (z - (shift - j) * directionVector.z) * nx * ny
+                        + (y - (shift - j) * directionVector.y) * nx
+                        + (x - (shift - j) * directionVector.x);
 
 
-                            const real value = pointersIn[var][index];
-                            leftValue += coefficientsLeft[j] * value;
-                            rightValue += coefficientsRight[j] * value;
-                        }
+                    const real value = pointersIn[var][index];
+                    leftValue += coefficientsLeft[j] * value;
+                    rightValue += coefficientsRight[j] * value;
+                }
 
-                        leftWenoValue += leftValue * (alphaLeft[shift] / alphaLeftSum);
-                        rightWenoValue += rightValue * (alphaRight[shift] / alphaRightSum);
-                    }
+                leftWenoValue += leftValue * (alphaLeft[shift] / alphaLeftSum);
+                rightWenoValue += rightValue * (alphaRight[shift] / alphaRightSum);
+            }
 
-                    pointersOutLeft[var][outIndex] = leftWenoValue;
-                    pointersOutRight[var][outIndex] = rightWenoValue;
+            pointersOutLeft[var][outIndex] = leftWenoValue;
+            pointersOutRight[var][outIndex] = rightWenoValue;
 
-                }
-            }
         }
-    }
+    });
 
 }
 
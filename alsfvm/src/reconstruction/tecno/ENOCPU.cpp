@@ -15,6 +15,7 @@
 
 #include "alsfvm/reconstruction/tecno/ENOCPU.hpp"
 #include "alsfvm/reconstruction/ENOCoefficients.hpp"
+#include "alsfvm/volume/volume_foreach.hpp"
 
 namespace alsfvm {
 namespace reconstruction {
@@ -106,72 +107,60 @@ void ENOCPU<order>::performReconstruction(const volume::Volume& leftInput,
         real* pointerOutLeft = leftOut.getScalarMemoryArea(var)->getPointer();
         real* pointerOutRight = rightOut.getScalarMemoryArea(var)->getPointer();
 
-        for (size_t z = startZ; z < endZ; z++) {
-            #pragma omp parallel for
-
-            for (size_t y = startY; y < endY; y++) {
-                #pragma omp simd
-
-                for (int x = startX; x < int(endX); x++) {
-
-
-
-                    const size_t indexRight =  leftView.index(x, y, z);
-                    const size_t indexLeft = leftView.index((x - directionVector.x),
-                            (y - directionVector.y),
-                            (z - directionVector.z));
-
-                    // First we determine the shift
-                    // We do this by looping through the levels of the divided
-                    // differences, and each time we go left, we increment the shift.
-                    int shift = 0;
-
-                    for (size_t level = 0; level < order - 1; level++) {
-                        real dividedDifferenceRight = dividedDifferencesPointers[level][indexRight];
-                        real dividedDifferenceLeft = dividedDifferencesPointers[level][indexLeft];
-
-                        if (std::fabs(dividedDifferenceLeft) < std::fabs(dividedDifferenceRight)) {
-                            // Now we choose the left stencil
-                            shift++;
-                        }
-
-
-                    }
-
-                    // Now we have the stencil enabled. We need to find the correct
-                    // coefficients.
+        volume::for_each_cell_index_parallel({int(startX), int(startY), int(startZ)},
+            {int(endX), int(endY), int(endZ)}, [&](int x, int y, int z) {
+            const size_t indexRight =  leftView.index(x, y, z);
+            const size_t indexLeft = leftView.index((x - directionVector.x),
+                    (y - directionVector.y),
+                    (z - directionVector.z));
+
+            // First we determine the shift
+            // We do this by looping through the levels of the divided
+            // differences, and each time we go left, we increment the shift.
+            int shift = 0;
+
+            for (size_t level = 0; level < order - 1; level++) {
+                real dividedDifferenceRight = dividedDifferencesPointers[level][indexRight];
+                real dividedDifferenceLeft = dividedDifferencesPointers[level][indexLeft];
+
+                if (std::fabs(dividedDifferenceLeft) < std::fabs(dividedDifferenceRight)) {
+                    // Now we choose the left stencil
+                    shift++;
+                }
 
-                    auto coefficientsRight = ENOCoeffiecients<order>::coefficients[shift + 1];
-                    auto coefficientsLeft = ENOCoeffiecients<order>::coefficients[shift];
 
-                    std::array < real, 2 * order - 1 > wCur;
-                    wCur[order - 1] = leftView.at(indexRight);
+            }
 
-                    for (int l = 0; l < order - 1; ++l) {
-                        wCur[order + l]   = wCur[order + l - 1] +
-                            dividedDifferencesPointers[0][indexRight + l];
-                        wCur[order - l - 2] = wCur[order - l - 1] -
-                            dividedDifferencesPointers[0][indexRight - l - 1];
-                    }
+            // Now we have the stencil enabled. We need to find the correct
+            // coefficients.
 
-                    // Calculate wlR, wrR
-                    real uli = 0, uri = 0;
+            auto coefficientsRight = ENOCoeffiecients<order>::coefficients[shift + 1];
+            auto coefficientsLeft = ENOCoeffiecients<order>::coefficients[shift];
 
-                    for (int l = 0; l < order; ++l) {
-                        uli += coefficientsLeft[l] * wCur[order - 1 - shift + l];
-                        uri += coefficientsRight[l] * wCur[order - 1 - shift + l];
-                    }
+            std::array < real, 2 * order - 1 > wCur;
+            wCur[order - 1] = leftView.at(indexRight);
 
-                    pointerOutLeft[indexRight] = uli;
-                    pointerOutRight[indexRight] = uri + (rightView.at(indexRight) - leftView.at(
-                                indexRight));
-                    assert(!std::isnan(uli));
-                    assert(!std::isnan(uri));
+            for (int l = 0; l < order - 1; ++l) {
+                wCur[order + l]   = wCur[order + l - 1] +
+                    dividedDifferencesPointers[0][indexRight + l];
+                wCur[order - l - 2] = wCur[order - l - 1] -
+                    dividedDifferencesPointers[0][indexRight - l - 1];
+            }
 
+            // Calculate wlR, wrR
+            real uli = 0, uri = 0;
 
-                }
+            for (int l = 0; l < order; ++l) {
+                uli += coefficientsLeft[l] * wCur[order - 1 - shift + l];
+                uri += coefficientsRight[l] * wCur[order - 1 - shift + l];
             }
-        }
+
+            pointerOutLeft[indexRight] = uli;
+            pointerOutRight[indexRight] = uri + (rightView.at(indexRight) - leftView.at(
+                        indexRight));
+            assert(!std::isnan(uli));
+            assert(!std::isnan(uri));
+        });
     }
 
 }
@@ -225,21 +214,15 @@ void ENOCPU<order>::computeDividedDifferences(const memory::Memory<real>&
     real* pointerOut = output.getPointer();
 
 
-    for (size_t z = startZ; z < endZ; z++) {
-        for (size_t y = startY; y < endY; y++) {
-            #pragma omp parallel for
+    volume::for_each_cell_index_parallel({int(startX), int(startY), int(startZ)},
+        {int(endX), int(endY), int(endZ)}, [&](int x, int y, int z) {
+        const size_t indexRight = z * nx * ny + y * nx + x;
+        const size_t indexLeft = (z - direction.z) * nx * ny
+            + (y - direction.y) * nx
+            + (x - direction.x);
 
-            for (size_t x = startX; x < endX; x++) {
-                const size_t indexRight = z * nx * ny + y * nx + x;
-                const size_t indexLeft = (z - direction.z) * nx * ny
-                    + (y - direction.y) * nx
-                    + (x - direction.x);
-
-                pointerOut[indexLeft] = leftView.at(indexRight) - rightView.at(indexLeft);
-
-            }
-        }
-    }
+        pointerOut[indexLeft] = leftView.at(indexRight) - rightView.at(indexLeft);
+    });
 }
 
 template class ENOCPU<1>;
@@ -15,11 +15,121 @@
 
 #include "alsfvm/simulator/ConservedSystem.hpp"
 #include <algorithm>
-#include <thread>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include "alsfvm/volume/volume_foreach.hpp"
+#include "alsutils/error/Exception.hpp"
+#include "alsutils/log.hpp"
+#include "alsutils/mpi/safe_call.hpp"
 #include "alsutils/timer/Timer.hpp"
 
 namespace alsfvm {
 namespace simulator {
+namespace {
+
+//! The sides whose ghost cells have arrived, in the order they arrived.
+class ReadySides {
+public:
+    void push(int side) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            sides.push_back(side);
+        }
+        changed.notify_all();
+    }
+
+    //! No more sides will be pushed
+    void close() {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            closed = true;
+        }
+        changed.notify_all();
+    }
+
+    //! Waits for the next side, returns -1 when the list is closed and empty
+    int pop() {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [this]() {
+            return closed || sides.size() > 0;
+        });
+
+        if (sides.size() == 0) {
+            return -1;
+        }
+
+        const int side = sides.front();
+        sides.pop_front();
+        return side;
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<int> sides;
+    bool closed{false};
+};
+
+//! Waits for the job on the progress thread when it goes out of scope.
+//! The jobs capture our locals by reference, so they have to be done
+//! before we leave the scope, also when an exception is thrown.
+class WaitForJob {
+public:
+    WaitForJob(mpi::ProgressThread& progressThread)
+        : progressThread(progressThread) {
+
+    }
+
+    ~WaitForJob() {
+        if (!waited) {
+            try {
+                progressThread.wait();
+            } catch (...) {
+                // We are already unwinding from another exception
+            }
+        }
+    }
+
+    //! Waits for the job, rethrows the exception of the job (if any)
+    void wait() {
+        waited = true;
+        progressThread.wait();
+    }
+
+private:
+    mpi::ProgressThread& progressThread;
+    bool waited{false};
+};
+
+void maxInto(rvec3& waveSpeed, const rvec3& other) {
+    for (int k = 0; k < 3; ++k) {
+        waveSpeed[k] = std::max(waveSpeed[k], other[k]);
+    }
+}
+
+//! Sets all variables to zero in [start, end) (counting the ghost cells)
+void makeZero(volume::Volume& volume, const ivec3& start, const ivec3& end) {
+    const size_t nx = volume.getTotalNumberOfXCells();
+    const size_t ny = volume.getTotalNumberOfYCells();
+
+    for (size_t var = 0; var < volume.getNumberOfVariables(); ++var) {
+        real* pointer = volume.getScalarMemoryArea(var)->getPointer();
+
+        volume::for_each_cell_index_parallel(start, end,
+        [&](int x, int y, int z) {
+            pointer[(z * ny + y) * nx + x] = 0;
+        });
+    }
+}
+
+size_t numberOfCellsIn(const ivec3& size, const ivec3& start,
+    const ivec3& end) {
+    const ivec3 extent = size + end - start;
+    return size_t(std::max(extent.x, 0)) * size_t(std::max(extent.y, 0))
+        * size_t(std::max(extent.z, 0));
+}
+}
 
 ConservedSystem::ConservedSystem(alsfvm::shared_ptr<numflux::NumericalFlux>
     numericalFlux,
@@ -32,74 +142,272 @@ void ConservedSystem::operator()( volume::Volume& conservedVariables,
     rvec3& waveSpeed,
     bool computeWaveSpeed,
     volume::Volume& output) {
-    // We do this a bit "weird". In one thread we do the halo exchange
-    // AND compute the sides, in the other thread, we compute the inner region.
 
+    if (!cellExchanger) {
+        numericalFlux->computeFlux(conservedVariables, waveSpeed, computeWaveSpeed,
+            output, {0, 0, 0}, {0, 0, 0});
+        diffusionOperator->applyDiffusion(output, conservedVariables);
+        return;
+    }
+
+    if (haloStages > 1) {
+        computeWithDeepHalo(conservedVariables, waveSpeed, computeWaveSpeed,
+            output);
+        return;
+    }
 
+    // The progress thread posts the halo exchange and completes the sides
+    // one at a time as their messages arrive. Meanwhile we compute the
+    // interior (which does not need any ghost cells), then the boundary
+    // slab of each side in the order the sides arrive, and finally the
+    // edges and corners, which need the ghost cells of more than one side.
+    //
+    // The slabs are computed on this thread, as the numerical flux keeps
+    // its temporary volumes as members, and can not be called concurrently.
     const auto ghostCells = output.getNumberOfGhostCells();
-    const auto size = output.getTotalDimensions();
     const int dimensions = output.getDimensions();
-    rvec3 waveSpeedSides({0, 0, 0});
 
+    ReadySides readySides;
 
-    std::thread cellExchangeThread([&]() {
-        if (cellExchanger) {
-
-            ALSVINN_TIME_BLOCK(alsvinn, mpi, exchange);
-            auto request = cellExchanger->exchangeCells(conservedVariables,
+    progressThread->submit([&]() {
+        try {
+            auto requests = cellExchanger->exchangeCells(conservedVariables,
                     conservedVariables);
-            {
-                ALSVINN_TIME_BLOCK(alsvinn, mpi, exchange, wait);
-                request.waitForAll();
+
+            // Sides that are not exchanged (eg. physical boundaries) are
+            // ready straight away
+            for (int side = 0; side < 2 * dimensions; ++side) {
+                if (!requests.hasGroup(side)) {
+                    readySides.push(side);
+                }
             }
 
+            int side;
+
+            while ((side = requests.waitForAnyGroup()) >= 0) {
+                readySides.push(side);
+            }
+        } catch (...) {
+            readySides.close();
+            throw;
         }
+
+        readySides.close();
     });
+    WaitForJob exchange(*progressThread);
 
     numericalFlux->computeFlux(conservedVariables, waveSpeed, computeWaveSpeed,
         output, ghostCells, -1 * ghostCells);
 
+    while (true) {
+        int side;
+        {
+            ALSVINN_TIME_BLOCK(alsvinn, mpi, exchange, wait);
+            side = readySides.pop();
+        }
+
+        if (side < 0) {
+            break;
+        }
+
+        ivec3 start, end;
+        getSideSlab(output, side, start, end);
+
+        rvec3 waveSpeedSide = 0;
+        numericalFlux->computeFlux(conservedVariables, waveSpeedSide,
+            computeWaveSpeed, output, start, end);
+        maxInto(waveSpeed, waveSpeedSide);
+    }
+
+    {
+        ALSVINN_TIME_BLOCK(alsvinn, mpi, exchange, wait);
+        exchange.wait();
+    }
+
+    for (int d = 0; d < dimensions; ++d) {
+        for (int e = d + 1; e < dimensions; ++e) {
+            for (int sideD = 2 * d; sideD < 2 * d + 2; ++sideD) {
+                for (int sideE = 2 * e; sideE < 2 * e + 2; ++sideE) {
+                    ivec3 start, end;
+                    getEdgeSlab(output, sideD, sideE, start, end);
+
+                    rvec3 waveSpeedEdge = 0;
+                    numericalFlux->computeFlux(conservedVariables, waveSpeedEdge,
+                        computeWaveSpeed, output, start, end);
+                    maxInto(waveSpeed, waveSpeedEdge);
+                }
+            }
+        }
+    }
+
+    diffusionOperator->applyDiffusion(output, conservedVariables);
+}
 
-    cellExchangeThread.join();
+void ConservedSystem::computeWithDeepHalo(volume::Volume& conservedVariables,
+    rvec3& waveSpeed, bool computeWaveSpeed, volume::Volume& output) {
+    const int stage = int(substep % haloStages);
+    const int ghostCells = int(getNumberOfGhostCells());
+    const int dimensions = output.getDimensions();
+    const ivec3 innerSize = output.getInnerSize();
+    const ivec3 volumeGhostCells = output.getNumberOfGhostCells();
+    const auto neighbours = cellExchanger->getNeighbours();
+
+    // The remaining stages each need ghostCells more cells on the sides that
+    // come from the neighbours, so we compute that far into the ghost cells.
+    // start and end are relative to the inner domain, see
+    // NumericalFlux::computeFlux.
+    const int margin = int(haloStages - 1 - stage) * ghostCells;
+    ivec3 start = {0, 0, 0};
+    ivec3 end = {0, 0, 0};
 
-    // Now compute the sides
     for (int d = 0; d < dimensions; ++d) {
+        if (volumeGhostCells[d] < int(haloStages) * ghostCells) {
+            THROW("Need " << haloStages * ghostCells << " ghost cells for "
+                << haloStages << " halo stages, the volume has "
+                << volumeGhostCells[d]);
+        }
 
-        ivec3 startBottom = {0, 0, 0};
-        ivec3 endBottom = {0, 0, 0};
+        start[d] = neighbours[2 * d] > -1 ? -margin : 0;
+        end[d] = neighbours[2 * d + 1] > -1 ? margin : 0;
+    }
 
+    if (stage > 0) {
+        numericalFlux->computeFlux(conservedVariables, waveSpeed,
+            computeWaveSpeed, output, start, end);
+    } else {
+        // The directions are exchanged one after the other, that way the
+        // corners are filled as well. Meanwhile we compute the cells that
+        // do not need any ghost cells, then the bands along each direction,
+        // out to the margin.
+        progressThread->submit([&]() {
+            for (int d = 0; d < dimensions; ++d) {
+                cellExchanger->exchangeCellsInDirection(conservedVariables,
+                    conservedVariables, d).waitForAll();
+            }
+        });
+        WaitForJob exchange(*progressThread);
 
-        endBottom [d] = -size[d] + 3 * ghostCells[d];
-        rvec3 waveSpeedBottom = 0;
-        numericalFlux->computeFlux(conservedVariables, waveSpeedBottom,
-            computeWaveSpeed,
-            output,
-            startBottom, endBottom);
+        ivec3 coreStart = {0, 0, 0};
+        ivec3 coreEnd = {0, 0, 0};
 
-        for (int k = 0; k < 3; ++k) {
-            waveSpeedSides[k] = std::max(waveSpeedSides[k], waveSpeedBottom[k]);
+        for (int d = 0; d < dimensions; ++d) {
+            coreStart[d] = ghostCells;
+            coreEnd[d] = -ghostCells;
         }
 
-        ivec3 startTop = {0, 0, 0};
-        startTop[d] = size[d] - 3 * ghostCells[d];
+        numericalFlux->computeFlux(conservedVariables, waveSpeed,
+            computeWaveSpeed, output, coreStart, coreEnd);
+
+        {
+            ALSVINN_TIME_BLOCK(alsvinn, mpi, exchange, wait);
+            exchange.wait();
+        }
+
+        // The bands in direction d are in the core in the directions before
+        // d, and span the whole range in the directions after d, so that
+        // they do not overlap.
+        for (int d = 0; d < dimensions; ++d) {
+            ivec3 bandStart = start;
+            ivec3 bandEnd = end;
+
+            for (int e = 0; e < d; ++e) {
+                bandStart[e] = coreStart[e];
+                bandEnd[e] = coreEnd[e];
+            }
 
-        ivec3 endTop = {0, 0, 0};
-        rvec3 waveSpeedTop = 0;
-        numericalFlux->computeFlux(conservedVariables, waveSpeedTop, computeWaveSpeed,
-            output,
-            startTop,
-            endTop);
+            for (int side = 0; side < 2; ++side) {
+                if (side == 0) {
+                    bandStart[d] = start[d];
+                    bandEnd[d] = ghostCells - innerSize[d];
+                } else {
+                    bandStart[d] = innerSize[d] - ghostCells;
+                    bandEnd[d] = end[d];
+                }
 
-        for (int k = 0; k < 3; ++k) {
-            waveSpeedSides[k] = std::max(waveSpeedSides[k], waveSpeedTop[k]);
+                rvec3 waveSpeedBand = 0;
+                numericalFlux->computeFlux(conservedVariables, waveSpeedBand,
+                    computeWaveSpeed, output, bandStart, bandEnd);
+                maxInto(waveSpeed, waveSpeedBand);
+            }
         }
     }
 
-    for (int k = 0; k < 3; ++k) {
-        waveSpeed[k] = std::max(waveSpeed[k], waveSpeedSides[k]);
+    // The ghost cells we did not compute are never read by the remaining
+    // stages, but the integrator combines them into the next state, so
+    // we make sure they hold something sensible.
+    const ivec3 totalSize = output.getTotalDimensions();
+
+    for (int d = 0; d < dimensions; ++d) {
+        ivec3 zeroStart = {0, 0, 0};
+        ivec3 zeroEnd = totalSize;
+
+        if (start[d] < 0) {
+            zeroEnd[d] = volumeGhostCells[d] + start[d];
+            makeZero(output, zeroStart, zeroEnd);
+        }
+
+        if (end[d] > 0) {
+            zeroStart[d] = totalSize[d] - volumeGhostCells[d] + end[d];
+            zeroEnd[d] = totalSize[d];
+            makeZero(output, zeroStart, zeroEnd);
+        }
     }
 
-    diffusionOperator->applyDiffusion(output, conservedVariables);
+    numberOfCellsComputed += numberOfCellsIn(innerSize, start, end);
+    numberOfInteriorCells += numberOfCellsIn(innerSize, {0, 0, 0}, {0, 0, 0});
+
+    if (stage + 1 == int(haloStages) && !redundantComputeFractionLogged) {
+        ALSVINN_LOG(INFO, "Exchanging ghost cells every " << haloStages
+            << " substeps, the fraction of redundantly computed cells is "
+            << getRedundantComputeFraction());
+        redundantComputeFractionLogged = true;
+    }
+}
+
+void ConservedSystem::getSideSlab(const volume::Volume& volume, int side,
+    ivec3& start, ivec3& end) {
+    const auto ghostCells = volume.getNumberOfGhostCells();
+    const auto size = volume.getTotalDimensions();
+    const int dimensions = volume.getDimensions();
+
+    // start and end are relative to the inner domain, see
+    // NumericalFlux::computeFlux. In the other directions, we stay away from
+    // the cells that need the ghost cells of other sides.
+    start = {0, 0, 0};
+    end = {0, 0, 0};
+
+    for (int d = 0; d < dimensions; ++d) {
+        start[d] = ghostCells[d];
+        end[d] = -ghostCells[d];
+    }
+
+    const int d = side / 2;
+
+    if (side % 2 == 0) {
+        start[d] = 0;
+        end[d] = -size[d] + 3 * ghostCells[d];
+    } else {
+        start[d] = size[d] - 3 * ghostCells[d];
+        end[d] = 0;
+    }
+}
+
+void ConservedSystem::getEdgeSlab(const volume::Volume& volume, int firstSide,
+    int secondSide, ivec3& start, ivec3& end) {
+    ivec3 firstStart, firstEnd, secondStart, secondEnd;
+    getSideSlab(volume, firstSide, firstStart, firstEnd);
+    getSideSlab(volume, secondSide, secondStart, secondEnd);
+
+    // Across the two sides, and all the way in the remaining direction
+    start = {0, 0, 0};
+    end = {0, 0, 0};
+
+    const int firstDirection = firstSide / 2;
+    const int secondDirection = secondSide / 2;
+    start[firstDirection] = firstStart[firstDirection];
+    end[firstDirection] = firstEnd[firstDirection];
+    start[secondDirection] = secondStart[secondDirection];
+    end[secondDirection] = secondEnd[secondDirection];
 }
 
 
@@ -113,8 +421,49 @@ size_t ConservedSystem::getNumberOfGhostCells() const {
             diffusionOperator->getNumberOfGhostCells());
 }
 
+void ConservedSystem::setHaloStages(size_t haloStages) {
+    if (haloStages == 0) {
+        THROW("The number of halo stages must be positive.");
+    }
+
+    if (haloStages > 1 && diffusionOperator->getNumberOfGhostCells() > 0) {
+        THROW("More than one halo stage is not supported with diffusion.");
+    }
+
+    this->haloStages = haloStages;
+}
+
+void ConservedSystem::setSubstep(size_t substep) {
+    this->substep = substep;
+}
+
+real ConservedSystem::getRedundantComputeFraction() const {
+    if (numberOfInteriorCells == 0) {
+        return 0;
+    }
+
+    return real(numberOfCellsComputed - numberOfInteriorCells)
+        / real(numberOfInteriorCells);
+}
+
 void ConservedSystem::setCellExchanger(mpi::CellExchangerPtr cellExchanger) {
     this->cellExchanger = cellExchanger;
+
+    if (cellExchanger && !progressThread) {
+        // The progress thread calls MPI while we compute, which needs
+        // MPI_THREAD_MULTIPLE. Otherwise the exchange is done on this
+        // thread, before the computation.
+        int threadSupport = MPI_THREAD_SINGLE;
+        MPI_SAFE_CALL(MPI_Query_thread(&threadSupport));
+        const bool overlap = threadSupport >= MPI_THREAD_MULTIPLE;
+
+        if (!overlap) {
+            ALSVINN_LOG(WARNING, "MPI does not provide MPI_THREAD_MULTIPLE, "
+                << "the halo exchange will not overlap the computation.");
+        }
+
+        progressThread.reset(new mpi::ProgressThread(overlap));
+    }
 }
 
 
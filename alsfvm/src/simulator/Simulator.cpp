@@ -14,6 +14,7 @@
  */
 
 #include "alsfvm/simulator/Simulator.hpp"
+#include "alsfvm/volume/ensemble.hpp"
 #include "alsutils/error/Exception.hpp"
 #include <iostream>
 #include "alsutils/log.hpp"
@@ -22,6 +23,18 @@
 #include <boost/date_time/posix_time/posix_time.hpp>
 namespace alsfvm {
 namespace simulator {
+namespace {
+size_t getNumberOfHaloStages(const SimulatorParameters& simulatorParameters,
+    const integrator::Integrator& integrator) {
+    const size_t haloStages = simulatorParameters.getHaloStages();
+
+    if (haloStages == 0 || haloStages > integrator.getNumberOfSubsteps()) {
+        return integrator.getNumberOfSubsteps();
+    }
+
+    return haloStages;
+}
+}
 
 Simulator::Simulator(const SimulatorParameters& simulatorParameters,
     alsfvm::shared_ptr<grid::Grid>& grid,
@@ -40,9 +53,12 @@ Simulator::Simulator(const SimulatorParameters& simulatorParameters,
            volumeFactory(volumeFactory),
            grid(grid),
            numericalFlux(numericalFluxFactory.createNumericalFlux(*grid)),
-           system(new ConservedSystem(numericalFlux, diffusionOperator)),
+           conservedSystem(new ConservedSystem(numericalFlux, diffusionOperator)),
+           system(conservedSystem),
            integrator(integratorFactory.createIntegrator(system)),
-           boundary(boundaryFactory.createBoundary(system->getNumberOfGhostCells())),
+           haloStages(getNumberOfHaloStages(simulatorParameters, *integrator)),
+           numberOfGhostCells(haloStages * system->getNumberOfGhostCells()),
+           boundary(boundaryFactory.createBoundary(numberOfGhostCells)),
            cellComputer(cellComputerFactory.createComputer()),
            diffusionOperator(diffusionOperator),
            cflNumber(simulatorParameters.getCFLNumber()),
@@ -50,16 +66,33 @@ Simulator::Simulator(const SimulatorParameters& simulatorParameters,
            equationName(equationName),
            platformName(deviceConfiguration->getPlatform()),
            deviceConfiguration(deviceConfiguration),
-           name(name) {
-    const size_t nx = grid->getDimensions().x;
-    const size_t ny = grid->getDimensions().y;
-    const size_t nz = grid->getDimensions().z;
+           name(name),
+           ensembleSize(simulatorParameters.getEnsembleSize()) {
+    if (ensembleSize > 1 && platformName != "cpu") {
+        THROW("Ensembles are only supported on the CPU, given platform "
+            << platformName);
+    }
+
+    // With an ensemble, the members are stacked along an extra direction
+    const auto dimensions = volume::getEnsembleDimensions(*grid, ensembleSize);
+    const size_t nx = dimensions.x;
+    const size_t ny = dimensions.y;
+    const size_t nz = dimensions.z;
     ALSVINN_LOG(INFO, "Dimensions are " << nx << ", " << ny << ", " << nz);
 
-    for (size_t i = 0; i < integrator->getNumberOfSubsteps() + 1; ++i) {
+    if (integrator->getCFLMultiplier() != 1) {
+        ALSVINN_LOG(INFO, "The integrator multiplies the CFL number by its SSP "
+            << "coefficient " << integrator->getCFLMultiplier()
+            << ", the effective CFL number is "
+            << integrator->getCFLMultiplier() * cflNumber);
+    }
+
+    conservedSystem->setHaloStages(haloStages);
+
+    for (size_t i = 0; i < integrator->getNumberOfRegisters(); ++i) {
         conservedVolumes.push_back(
             volumeFactory.createConservedVolume(nx, ny, nz,
-                system->getNumberOfGhostCells()));
+                numberOfGhostCells));
     }
 }
 
@@ -80,7 +113,14 @@ bool Simulator::atEnd() {
 
 void Simulator::performStep() {
     incrementSolution();
-    checkConstraints();
+
+    const size_t interval = simulatorParameters.getConstraintCheckInterval();
+    const size_t steps = timestepInformation.getNumberOfStepsPerformed();
+
+    if (atEnd() || (interval > 0 && steps % interval == 0)) {
+        checkConstraints();
+    }
+
     callWriters();
 }
 
@@ -116,8 +156,51 @@ std::string Simulator::getEquationName() const {
 
 void Simulator::setInitialValue(alsfvm::shared_ptr<init::InitialData>&
     initialData) {
+    if (ensembleSize == 1) {
+        computeInitialValue(*initialData, *conservedVolumes[0]);
+    } else {
+        // Every member gets the same initial value, it is only evaluated once
+        const size_t direction = volume::getEnsembleDirection(*grid);
+        auto memberVolume = volume::makeEnsembleMemberVolume(*conservedVolumes[0],
+                direction);
+        computeInitialValue(*initialData, *memberVolume);
+
+        for (size_t member = 0; member < ensembleSize; ++member) {
+            volume::copyToEnsembleMember(*memberVolume, direction, member,
+                *conservedVolumes[0]);
+        }
+    }
+
+    boundary->applyBoundaryConditions(*conservedVolumes[0], *grid);
+}
+
+void Simulator::setInitialValue(alsfvm::shared_ptr<init::InitialData>&
+    initialData, size_t member) {
+    if (member >= ensembleSize) {
+        THROW("Member " << member << " out of range, the ensemble size is "
+            << ensembleSize);
+    }
 
+    if (ensembleSize == 1) {
+        computeInitialValue(*initialData, *conservedVolumes[0]);
+    } else {
+        const size_t direction = volume::getEnsembleDirection(*grid);
+        auto memberVolume = volume::makeEnsembleMemberVolume(*conservedVolumes[0],
+                direction);
+        computeInitialValue(*initialData, *memberVolume);
+        volume::copyToEnsembleMember(*memberVolume, direction, member,
+            *conservedVolumes[0]);
+    }
+
+    boundary->applyBoundaryConditions(*conservedVolumes[0], *grid);
+}
+
+size_t Simulator::getEnsembleSize() const {
+    return ensembleSize;
+}
 
+void Simulator::computeInitialValue(init::InitialData& initialData,
+    volume::Volume& conservedVolume) {
     const size_t nx = grid->getDimensions().x;
     const size_t ny = grid->getDimensions().y;
     const size_t nz = grid->getDimensions().z;
@@ -132,9 +215,9 @@ void Simulator::setInitialValue(alsfvm::shared_ptr<init::InitialData>&
             (deviceConfigurationCPU);
         volume::VolumeFactory volumeFactoryCPU(equationName, memoryFactoryCPU);
         auto primitiveVolume = volumeFactoryCPU.createPrimitiveVolume(nx, ny, nz,
-                system->getNumberOfGhostCells());
+                numberOfGhostCells);
         auto conservedVolumeCPU = volumeFactoryCPU.createConservedVolume(nx, ny, nz,
-                system->getNumberOfGhostCells());
+                numberOfGhostCells);
 
 
         auto simulatorParametersCPU = alsfvm::make_shared<SimulatorParameters>
@@ -144,21 +227,17 @@ void Simulator::setInitialValue(alsfvm::shared_ptr<init::InitialData>&
             deviceConfigurationCPU);
         auto cellComputerCPU = cellComputerFactoryCPU.createComputer();
 
-        initialData->setInitialData(*conservedVolumeCPU,
+        initialData.setInitialData(*conservedVolumeCPU,
             *primitiveVolume, *cellComputerCPU, *grid);
 
-        conservedVolumeCPU->copyTo(*conservedVolumes[0]);
+        conservedVolumeCPU->copyTo(conservedVolume);
 
     } else {
         auto primitiveVolume = volumeFactory.createPrimitiveVolume(nx, ny, nz,
-                system->getNumberOfGhostCells());
-        initialData->setInitialData(*conservedVolumes[0],
+                numberOfGhostCells);
+        initialData.setInitialData(conservedVolume,
             *primitiveVolume, *cellComputer, *grid);
     }
-
-
-    boundary->applyBoundaryConditions(*conservedVolumes[0], *grid);
-
 }
 
 const std::shared_ptr<grid::Grid>& Simulator::getGrid() const {
@@ -171,18 +250,50 @@ std::shared_ptr<grid::Grid>& Simulator::getGrid() {
 
 void Simulator::callWriters() {
     for (auto writer : writers) {
-        writer->write(*conservedVolumes[0],
-            *grid,
-            timestepInformation);
+        if (ensembleSize > 1) {
+            writer->writeEnsemble(*conservedVolumes[0],
+                *grid,
+                timestepInformation);
+        } else {
+            writer->write(*conservedVolumes[0],
+                *grid,
+                timestepInformation);
+        }
     }
 }
 
 void Simulator::checkConstraints() {
-    const bool obeys = cellComputer->obeysConstraints(*conservedVolumes[0]);
+    if (ensembleSize > 1) {
+        const size_t direction = volume::getEnsembleDirection(*grid);
+        auto memberVolume = volume::makeEnsembleMemberVolume(*conservedVolumes[0],
+                direction);
+
+        for (size_t member = 0; member < ensembleSize; ++member) {
+            volume::copyFromEnsembleMember(*conservedVolumes[0], direction, member,
+                *memberVolume);
+            checkEnsembleMemberConstraints(*memberVolume, member);
+        }
+
+        return;
+    }
+
+    const auto report = cellComputer->checkConstraints(*conservedVolumes[0]);
 
-    if (!obeys) {
+    if (!report.obeys()) {
         THROW("Simulation state does not obey constraints! "
-            << " At time " << timestepInformation.getCurrentTime()
+            << report.toString() << ". At time " << timestepInformation.getCurrentTime()
+            << ", number of timesteps performed " <<
+            timestepInformation.getNumberOfStepsPerformed());
+    }
+}
+
+void Simulator::checkEnsembleMemberConstraints(const volume::Volume&
+    memberVolume, size_t member) {
+    const auto report = cellComputer->checkConstraints(memberVolume);
+
+    if (!report.obeys()) {
+        THROW("Ensemble member " << member << " does not obey constraints! "
+            << report.toString() << ". At time " << timestepInformation.getCurrentTime()
             << ", number of timesteps performed " <<
             timestepInformation.getNumberOfStepsPerformed());
     }
@@ -191,24 +302,34 @@ void Simulator::checkConstraints() {
 void Simulator::incrementSolution() {
     real dt = 0;
 
-    for (size_t substep = 0; substep < integrator->getNumberOfSubsteps();
-        ++substep) {
+    // Adaptive integrators may reject the step, register 0 is left
+    // untouched and the step is redone with a smaller timestep.
+    do {
+        for (size_t substep = 0; substep < integrator->getNumberOfSubsteps();
+            ++substep) {
 
-        auto& conservedNext = conservedVolumes[substep + 1];
-        dt = integrator->performSubstep(conservedVolumes,
-                grid->getCellLengths(),
-                dt,
-                cflNumber,
-                *conservedNext,
-                substep,
-                timestepInformation);
+            auto& conservedNext =
+                conservedVolumes[integrator->getOutputRegister(substep)];
+            conservedSystem->setSubstep(substep);
+            dt = integrator->performSubstep(conservedVolumes,
+                    grid->getCellLengths(),
+                    dt,
+                    cflNumber,
+                    *conservedNext,
+                    substep,
+                    timestepInformation);
 
 
 
-        boundary->applyBoundaryConditions(*conservedNext, *grid);
-    }
+            boundary->applyBoundaryConditions(*conservedNext, *grid);
+        }
+    } while (!integrator->isStepAccepted());
+
+    const size_t solutionRegister = integrator->getSolutionRegister();
 
-    conservedVolumes[0].swap(conservedVolumes.back());
+    if (solutionRegister != 0) {
+        conservedVolumes[0].swap(conservedVolumes[solutionRegister]);
+    }
 
     timestepInformation.incrementTime(dt);
 }
@@ -64,5 +64,54 @@ const std::string& SimulatorParameters::getPlatform() const {
     return platform;
 }
 
+void SimulatorParameters::setFluxEngine(const std::string& fluxEngine) {
+    this->fluxEngine = fluxEngine;
+}
+
+const std::string& SimulatorParameters::getFluxEngine() const {
+    return fluxEngine;
+}
+
+void SimulatorParameters::setHaloStages(size_t haloStages) {
+    this->haloStages = haloStages;
+}
+
+size_t SimulatorParameters::getHaloStages() const {
+    return haloStages;
+}
+
+void SimulatorParameters::setConstraintCheckInterval(size_t
+    constraintCheckInterval) {
+    this->constraintCheckInterval = constraintCheckInterval;
+}
+
+size_t SimulatorParameters::getConstraintCheckInterval() const {
+    return constraintCheckInterval;
+}
+
+void SimulatorParameters::setPrimitiveCache(bool primitiveCache) {
+    this->primitiveCache = primitiveCache;
+}
+
+bool SimulatorParameters::getPrimitiveCache() const {
+    return primitiveCache;
+}
+
+void SimulatorParameters::setEnsembleSize(size_t ensembleSize) {
+    this->ensembleSize = ensembleSize;
+}
+
+size_t SimulatorParameters::getEnsembleSize() const {
+    return ensembleSize;
+}
+
+void SimulatorParameters::setMemoryPool(bool memoryPool) {
+    this->memoryPool = memoryPool;
+}
+
+bool SimulatorParameters::getMemoryPool() const {
+    return memoryPool;
+}
+
 }
 }
@@ -44,18 +44,32 @@ namespace volume {
 Volume::Volume(const std::vector<std::string>& variableNames,
     alsfvm::shared_ptr<memory::MemoryFactory> memoryFactory,
     size_t nx, size_t ny, size_t nz,
-    size_t numberOfGhostCells)
+    size_t numberOfGhostCells,
+    const VolumeLayout& layout)
     :  variableNames(variableNames),
        memoryFactory(memoryFactory),
        nx(nx), ny(ny), nz(nz),
        numberOfXGhostCells(numberOfGhostCells),
        numberOfYGhostCells(ny > 1 ? numberOfGhostCells : 0),
-       numberOfZGhostCells(nz > 1 ? numberOfGhostCells : 0) {
-    for (size_t i = 0; i < variableNames.size(); i++) {
-        memoryAreas.push_back(memoryFactory->createScalarMemory(
-                nx + 2 * numberOfXGhostCells,
-                ny + 2 * numberOfYGhostCells,
-                nz + 2 * numberOfZGhostCells));
+       numberOfZGhostCells(nz > 1 ? numberOfGhostCells : 0),
+       layout(layout) {
+    const size_t totalX = nx + 2 * numberOfXGhostCells;
+    const size_t totalY = ny + 2 * numberOfYGhostCells;
+    const size_t totalZ = nz + 2 * numberOfZGhostCells;
+
+    switch (layout.type) {
+    case VolumeLayout::separate:
+        for (size_t i = 0; i < variableNames.size(); i++) {
+            memoryAreas.push_back(memoryFactory->createScalarMemory(
+                    totalX, totalY, totalZ));
+        }
+
+        break;
+
+    case VolumeLayout::contiguous:
+        memoryAreas = memoryFactory->createContiguousScalarMemory(totalX,
+                totalY, totalZ, variableNames.size());
+        break;
     }
 }
 
@@ -68,7 +82,8 @@ Volume::Volume(Volume& volume, const std::vector<size_t>& components,
       nx(volume.nx), ny(volume.ny), nz(volume.nz),
       numberOfXGhostCells(volume.numberOfXGhostCells),
       numberOfYGhostCells(volume.numberOfYGhostCells),
-      numberOfZGhostCells(volume.numberOfZGhostCells) {
+      numberOfZGhostCells(volume.numberOfZGhostCells),
+      layout(VolumeLayout::separate) {
     for (size_t component : components) {
         memoryAreas.push_back(volume.memoryAreas[component]);
     }
@@ -369,6 +384,24 @@ void Volume::addLinearCombination(real a1, real a2, const Volume& v2, real a3,
     }
 }
 
+void Volume::assign(const LinearCombination& combination) {
+    for (size_t term = 0; term < combination.getNumberOfTerms(); ++term) {
+        CHECK_SIZE_THIS(combination.getOperand(term));
+    }
+
+    for (size_t i = 0; i < memoryAreas.size(); ++i) {
+        memory::LinearCombination<memory::Memory<real> > memoryCombination(
+            combination.getCoefficient(0), *combination.getOperand(0)[i]);
+
+        for (size_t term = 1; term < combination.getNumberOfTerms(); ++term) {
+            memoryCombination += combination.getCoefficient(term)
+                * *combination.getOperand(term)[i];
+        }
+
+        this->getScalarMemoryArea(i)->assign(memoryCombination);
+    }
+}
+
 ivec3 Volume::getTotalDimensions() const {
     return {int(getTotalNumberOfXCells()),
             int(getTotalNumberOfYCells()),
@@ -401,19 +434,26 @@ void Volume::subtractPower(const Volume& other, real power) {
 
 std::shared_ptr<Volume> Volume::makeInstance() const {
     return std::make_shared<Volume>(variableNames, memoryFactory,
-            nx, ny, nz, numberOfXGhostCells);
+            nx, ny, nz, numberOfXGhostCells, layout);
+}
+
+std::shared_ptr<Volume> Volume::makeInstance(const ivec3& numberOfCells) const {
+    return std::make_shared<Volume>(variableNames, memoryFactory,
+            numberOfCells.x, numberOfCells.y, numberOfCells.z,
+            numberOfXGhostCells, layout);
 }
 
 std::shared_ptr<Volume> Volume::makeInstance(size_t nxNew, size_t nyNew,
     size_t nzNew, const std::string& platform) const {
     if (platform == "default" || platform == memoryFactory->getPlatform()) {
         return std::make_shared<Volume>(variableNames, memoryFactory,
-                nxNew, nyNew, nzNew, 0);
+                nxNew, nyNew, nzNew, 0, layout);
     } else {
         alsfvm::shared_ptr<DeviceConfiguration> deviceConfiguraiton(
             new DeviceConfiguration(platform));
         alsfvm::shared_ptr<memory::MemoryFactory>
-        memoryFactoryForPlatform(new memory::MemoryFactory(deviceConfiguraiton));
+        memoryFactoryForPlatform(new memory::MemoryFactory(deviceConfiguraiton,
+                memoryFactory->getUseMemoryPool()));
 
         return std::make_shared<Volume>(variableNames, memoryFactoryForPlatform, nxNew,
                 nyNew, nzNew, 0);
@@ -428,7 +468,8 @@ std::shared_ptr<Volume> Volume::getCopyOnCPU() {
         alsfvm::shared_ptr<DeviceConfiguration> deviceConfiguraiton(
             new DeviceConfiguration("cpu"));
         alsfvm::shared_ptr<memory::MemoryFactory>
-        memoryFactoryForPlatform(new memory::MemoryFactory(deviceConfiguraiton));
+        memoryFactoryForPlatform(new memory::MemoryFactory(deviceConfiguraiton,
+                memoryFactory->getUseMemoryPool()));
 
         auto cpu =  std::make_shared<Volume>(variableNames,
                 memoryFactoryForPlatform,
@@ -440,6 +481,10 @@ std::shared_ptr<Volume> Volume::getCopyOnCPU() {
     }
 }
 
+const VolumeLayout& Volume::getLayout() const {
+    return layout;
+}
+
 bool Volume::hasVariable(const std::string& variableName) const {
     for (const auto name : variableNames) {
         if (name == variableName) {
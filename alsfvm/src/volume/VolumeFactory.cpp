@@ -38,6 +38,7 @@ struct EquationFunctor {
         size_t ny,
         size_t nz,
         size_t numberOfGhostCells,
+        const VolumeLayout& layout,
         alsfvm::shared_ptr<Volume>& volumePointer)
         : equationName(equationName),
           type(type),
@@ -46,6 +47,7 @@ struct EquationFunctor {
           ny(ny),
           nz(nz),
           numberOfGhostCells(numberOfGhostCells),
+          layout(layout),
           volumePointer(volumePointer) {
 
     }
@@ -74,7 +76,8 @@ struct EquationFunctor {
             volumePointer.reset(new Volume(names,
                     memoryFactory,
                     nx, ny, nz,
-                    numberOfGhostCells));
+                    numberOfGhostCells,
+                    layout));
         }
 
 
@@ -88,6 +91,7 @@ struct EquationFunctor {
     size_t ny;
     size_t nz;
     size_t numberOfGhostCells;
+    VolumeLayout layout;
     alsfvm::shared_ptr<Volume>& volumePointer;
 };
 }
@@ -97,10 +101,12 @@ struct EquationFunctor {
 /// Constructs the factory.
 /// \param equation the equation name ("euler1", "euler2", "euler3",  "sw", etc.)
 /// \param memoryFactory the memory factory to use
+/// \param layout the layout of the volumes made, see VolumeLayout
 ///
 VolumeFactory::VolumeFactory(const std::string& equation,
-    alsfvm::shared_ptr<memory::MemoryFactory> memoryFactory)
-    : equation(equation), memoryFactory(memoryFactory) {
+    alsfvm::shared_ptr<memory::MemoryFactory> memoryFactory,
+    const VolumeLayout& layout)
+    : equation(equation), memoryFactory(memoryFactory), layout(layout) {
 
 }
 
@@ -115,7 +121,7 @@ alsfvm::shared_ptr<Volume> VolumeFactory::createConservedVolume(size_t nx,
     size_t ny, size_t nz, size_t numberOfGhostCells) {
     alsfvm::shared_ptr<Volume> volumePointer;
     EquationFunctor functor(equation, EquationFunctor::CONSERVED, memoryFactory, nx,
-        ny, nz, numberOfGhostCells, volumePointer);
+        ny, nz, numberOfGhostCells, layout, volumePointer);
 
     equation::for_each_equation(functor);
 
@@ -137,7 +143,7 @@ alsfvm::shared_ptr<Volume> VolumeFactory::createExtraVolume(size_t nx,
     size_t ny, size_t nz, size_t numberOfGhostCells) {
     alsfvm::shared_ptr<Volume> volumePointer;
     EquationFunctor functor(equation, EquationFunctor::EXTRA, memoryFactory, nx, ny,
-        nz, numberOfGhostCells, volumePointer);
+        nz, numberOfGhostCells, layout, volumePointer);
     equation::for_each_equation(functor);
 
     if (!volumePointer) {
@@ -151,7 +157,7 @@ alsfvm::shared_ptr<Volume> VolumeFactory::createPrimitiveVolume(size_t nx,
     size_t ny, size_t nz, size_t numberOfGhostCells) {
     alsfvm::shared_ptr<Volume> volumePointer;
     EquationFunctor functor(equation, EquationFunctor::PRIMITIVE, memoryFactory, nx,
-        ny, nz, numberOfGhostCells, volumePointer);
+        ny, nz, numberOfGhostCells, layout, volumePointer);
 
     equation::for_each_equation(functor);
 
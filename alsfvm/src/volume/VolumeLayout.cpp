@@ -0,0 +1,49 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "alsfvm/volume/VolumeLayout.hpp"
+#include "alsutils/error/Exception.hpp"
+#include <boost/algorithm/string.hpp>
+
+namespace alsfvm {
+namespace volume {
+
+VolumeLayout volumeLayoutFromString(const std::string& name) {
+    const auto lowerCaseName = boost::algorithm::to_lower_copy(
+            boost::trim_copy(name));
+
+    if (lowerCaseName == "separate") {
+        return VolumeLayout(VolumeLayout::separate);
+    } else if (lowerCaseName == "contiguous") {
+        return VolumeLayout(VolumeLayout::contiguous);
+    }
+
+    THROW("Unknown volume layout " << name
+        << ", supported are separate and contiguous.");
+}
+
+std::string toString(const VolumeLayout& layout) {
+    switch (layout.type) {
+    case VolumeLayout::separate:
+        return "separate";
+
+    case VolumeLayout::contiguous:
+        return "contiguous";
+    }
+
+    THROW("Unknown volume layout " << int(layout.type));
+}
+}
+}
@@ -0,0 +1,130 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "alsfvm/volume/ensemble.hpp"
+#include "alsutils/error/Exception.hpp"
+#include <algorithm>
+
+namespace alsfvm {
+namespace volume {
+namespace {
+void checkMemberVolume(const Volume& ensemble, size_t direction,
+    size_t member, const Volume& memberVolume) {
+    if (member >= getEnsembleSize(ensemble, direction)) {
+        THROW("Member " << member << " out of range, the ensemble has "
+            << getEnsembleSize(ensemble, direction) << " members");
+    }
+
+    if (memberVolume.getNumberOfVariables() != ensemble.getNumberOfVariables()) {
+        THROW("The member has " << memberVolume.getNumberOfVariables()
+            << " variables, the ensemble has " << ensemble.getNumberOfVariables());
+    }
+
+    const auto memberSize = memberVolume.getTotalDimensions();
+    const auto ensembleSize = ensemble.getTotalDimensions();
+
+    for (size_t d = 0; d < 3; ++d) {
+        const int expected = d == direction ? 1 : ensembleSize[d];
+
+        if (memberSize[d] != expected) {
+            THROW("The member volume does not match the ensemble, got "
+                << memberSize << " cells (with ghost cells), expected "
+                << expected << " in direction " << d);
+        }
+    }
+
+    if (!ensemble.getScalarMemoryArea(0)->isOnHost()
+        || !memberVolume.getScalarMemoryArea(0)->isOnHost()) {
+        THROW("Ensembles are only supported on the CPU");
+    }
+}
+}
+
+size_t getEnsembleDirection(const grid::Grid& grid) {
+    const size_t dimension = grid.getActiveDimension();
+
+    if (dimension > 2) {
+        THROW("Ensembles are only supported for 1D and 2D grids");
+    }
+
+    return dimension;
+}
+
+ivec3 getEnsembleDimensions(const grid::Grid& grid, size_t ensembleSize) {
+    auto dimensions = grid.getDimensions();
+
+    if (ensembleSize > 1) {
+        dimensions[getEnsembleDirection(grid)] = int(ensembleSize);
+    }
+
+    return dimensions;
+}
+
+size_t getEnsembleSize(const Volume& ensemble, size_t direction) {
+    return ensemble.getInnerSize()[direction];
+}
+
+size_t getEnsembleMemberSize(const Volume& ensemble, size_t direction) {
+    const auto size = ensemble.getTotalDimensions();
+    size_t memberSize = 1;
+
+    for (size_t d = 0; d < direction; ++d) {
+        memberSize *= size[d];
+    }
+
+    return memberSize;
+}
+
+size_t getEnsembleMemberOffset(const Volume& ensemble, size_t direction,
+    size_t member) {
+    return (ensemble.getNumberOfGhostCells()[direction] + member)
+        * getEnsembleMemberSize(ensemble, direction);
+}
+
+VolumePointer makeEnsembleMemberVolume(const Volume& ensemble,
+    size_t direction) {
+    auto dimensions = ensemble.getInnerSize();
+    dimensions[direction] = 1;
+    return ensemble.makeInstance(dimensions);
+}
+
+void copyToEnsembleMember(const Volume& memberVolume, size_t direction,
+    size_t member, Volume& ensemble) {
+    checkMemberVolume(ensemble, direction, member, memberVolume);
+    const size_t memberSize = getEnsembleMemberSize(ensemble, direction);
+    const size_t offset = getEnsembleMemberOffset(ensemble, direction, member);
+
+    for (size_t var = 0; var < ensemble.getNumberOfVariables(); ++var) {
+        const real* source = memberVolume.getScalarMemoryArea(var)->getPointer();
+        std::copy(source, source + memberSize,
+            ensemble.getScalarMemoryArea(var)->getPointer() + offset);
+    }
+}
+
+void copyFromEnsembleMember(const Volume& ensemble, size_t direction,
+    size_t member, Volume& memberVolume) {
+    checkMemberVolume(ensemble, direction, member, memberVolume);
+    const size_t memberSize = getEnsembleMemberSize(ensemble, direction);
+    const size_t offset = getEnsembleMemberOffset(ensemble, direction, member);
+
+    for (size_t var = 0; var < ensemble.getNumberOfVariables(); ++var) {
+        const real* source = ensemble.getScalarMemoryArea(var)->getPointer()
+            + offset;
+        std::copy(source, source + memberSize,
+            memberVolume.getScalarMemoryArea(var)->getPointer());
+    }
+}
+}
+}
@@ -17,6 +17,7 @@
 #include <boost/property_tree/ptree.hpp>
 #include "alsuq/samples/SampleGenerator.hpp"
 #include "alsuq/mpi/Configuration.hpp"
+#include "alsuq/mpi/SampleScheduler.hpp"
 #include "alsuq/run/Runner.hpp"
 #include "alsuq/stats/Statistics.hpp"
 namespace alsuq {
@@ -40,6 +41,7 @@ public:
     //! \code{.cpp}
     //!   multiSamples*multiSpatial.x*multiSpatial.y*multiSpatial.z == mpiConfigurationWorld.getNumberOfProcesses();
     //! \endcode
+    //! and at least multiSamples samples.
     std::shared_ptr<run::Runner> makeRunner(const std::string& inputFilename,
         mpi::ConfigurationPtr mpiConfigurationWorld,
         int multiSample, ivec3 multiSpatial);
@@ -64,6 +66,14 @@ private:
         mpi::ConfigurationPtr worldConfiguration);
     size_t readNumberOfSamples(ptree& configuration);
     size_t readSampleStart(ptree& configuration);
+
+    //! Creates the scheduler given by uq.sampleScheduler (static or dynamic)
+    mpi::SampleSchedulerPtr makeSampleScheduler(ptree& configuration,
+        const std::vector<size_t>& samples,
+        const std::vector<size_t>& samplesForProcess,
+        mpi::ConfigurationPtr worldConfiguration,
+        mpi::ConfigurationPtr statisticalConfiguration,
+        mpi::ConfigurationPtr spatialConfiguration);
 };
 } // namespace config
 } // namespace alsuq
@@ -0,0 +1,96 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsuq/mpi/SampleScheduler.hpp"
+#include "alsuq/mpi/Configuration.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace alsuq {
+namespace mpi {
+
+//! Hands out the samples in chunks, on demand. Sample groups that finish
+//! early simply take more chunks, so that differences in the runtime of
+//! the samples (eg. number of timesteps) even out.
+//!
+//! The position of the next free sample is a counter on rank 0 of the
+//! world communicator, which the first process of each group increments
+//! with MPI_Fetch_and_op (passive target). Every group first gets one chunk
+//! without asking, so every group computes at least one sample.
+//!
+//! Rank 0 computes samples as well, and many MPI libraries only serve a
+//! passive target operation while the target itself is inside MPI. So rank
+//! 0 runs a thread that calls into MPI every progressInterval until the
+//! counter is freed. This needs MPI_THREAD_MULTIPLE; without it a warning
+//! is logged, and the other groups may have to wait for rank 0 to finish
+//! its chunk (unless the MPI library has asynchronous progress).
+//!
+//! The samples are handed out in increasing order, also within each
+//! group, so generators that can only skip forward keep working.
+class DynamicSampleScheduler : public SampleScheduler {
+public:
+    //! How often rank 0 calls into MPI while it owns the counter
+    static constexpr std::chrono::milliseconds progressInterval{1};
+
+    //! \note Collective over worldConfiguration
+    //!
+    //! \param samples all samples, in order
+    //! \param chunkSize the (maximum) number of samples to take at once
+    //! \param worldConfiguration the configuration of all processes
+    //! \param statisticalConfiguration the configuration between the groups
+    //! \param spatialConfiguration the configuration within this group
+    DynamicSampleScheduler(const std::vector<size_t>& samples,
+        size_t chunkSize,
+        ConfigurationPtr worldConfiguration,
+        ConfigurationPtr statisticalConfiguration,
+        ConfigurationPtr spatialConfiguration);
+
+    ~DynamicSampleScheduler();
+
+    //! \note Collective over the spatial communicator. Once no samples are
+    //!       left, this also frees the counter, which waits for the other
+    //!       groups to run out of samples as well.
+    std::vector<size_t> nextSamples() override;
+
+    //! The number of samples this group has taken so far
+    size_t getNumberOfSamplesTaken() const;
+
+private:
+    //! Stops the progress thread (if any) and frees the counter
+    void freeCounter();
+
+    //! Runs on rank 0, calls into MPI until stopProgress is set
+    void makeProgress();
+
+    const std::vector<size_t> samples;
+    const size_t chunkSize;
+    ConfigurationPtr spatialConfiguration;
+
+    long firstChunkSize;
+    long firstChunkStart;
+    bool firstChunk = true;
+    size_t numberOfSamplesTaken = 0;
+
+    MPI_Win counterWindow = MPI_WIN_NULL;
+    long* counter = nullptr;
+
+    MPI_Comm progressCommunicator = MPI_COMM_NULL;
+    std::atomic<bool> stopProgress{false};
+    std::thread progressThread;
+};
+} // namespace mpi
+} // namespace alsuq
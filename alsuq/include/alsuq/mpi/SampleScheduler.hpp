@@ -0,0 +1,40 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsuq/types.hpp"
+#include <memory>
+#include <vector>
+
+namespace alsuq {
+namespace mpi {
+
+//! Hands out the samples to a sample group (the processes computing one
+//! sample together, ie. one spatial communicator).
+class SampleScheduler {
+public:
+    virtual ~SampleScheduler() {}
+
+    //! Returns the next samples this group should compute, an empty list
+    //! when all samples are taken.
+    //!
+    //! \note Collective over the spatial communicator of the group, every
+    //!       process in the group gets the same samples.
+    virtual std::vector<size_t> nextSamples() = 0;
+};
+
+typedef std::shared_ptr<SampleScheduler> SampleSchedulerPtr;
+} // namespace mpi
+} // namespace alsuq
@@ -33,6 +33,8 @@ public:
     //! \code{.cpp}
     //!   multiSample*multiSpatial.x*multiSpatial.y*multiSpatial.z == mpiConfigurationWorld.getNumberOfProcesses();
     //! \endcode
+    //! and at least multiSample samples. The samples are split into
+    //! contiguous blocks, whose sizes differ by at most one.
     //!
     //! @param mpiConfig the relevant mpiConfig
     //!
@@ -0,0 +1,34 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsuq/mpi/SampleScheduler.hpp"
+
+namespace alsuq {
+namespace mpi {
+
+//! Hands out a fixed list of samples, all at once.
+class StaticSampleScheduler : public SampleScheduler {
+public:
+    StaticSampleScheduler(const std::vector<size_t>& samples);
+
+    std::vector<size_t> nextSamples() override;
+
+private:
+    std::vector<size_t> samples;
+    bool handedOut = false;
+};
+} // namespace mpi
+} // namespace alsuq
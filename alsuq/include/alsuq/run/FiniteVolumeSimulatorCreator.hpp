@@ -32,13 +32,19 @@ public:
         mpi::ConfigurationPtr mpiConfigurationSpatial,
         mpi::ConfigurationPtr mpiConfigurationStatistical,
         mpi::ConfigurationPtr mpiConfigurationWorld,
-        ivec3 multiSpatial
+        ivec3 multiSpatial,
+        bool writeSamples = true
     );
 
     alsfvm::shared_ptr<alsfvm::simulator::AbstractSimulator>
     createSimulator(const alsfvm::init::Parameters& initialDataParameters,
         size_t sampleNumber) override;
 
+    alsfvm::shared_ptr<alsfvm::simulator::AbstractSimulator>
+    createEnsembleSimulator(const std::vector<alsfvm::init::Parameters>&
+        initialDataParameters,
+        const std::vector<size_t>& sampleNumbers) override;
+
 private:
     mpi::ConfigurationPtr mpiConfigurationSpatial;
     mpi::ConfigurationPtr mpiConfigurationStatistical;
@@ -46,6 +52,12 @@ private:
 
     ivec3 multiSpatial;
 
+    //! Whether the simulators write output for each sample (fvm.writer or
+    //! fvm.functionals). This output is written collectively over the
+    //! statistical communicator, so every sample group must create the
+    //! same number of simulators.
+    const bool writeSamples;
+
     //! Gathers all the current samples from all current mpi procs
     //! and creates a list of names of the samples now being computed
     std::vector<std::string> makeGroupNames(size_t sampleNumber);
@@ -17,6 +17,7 @@
 #include "alsuq/samples/SampleGenerator.hpp"
 #include "alsuq/run/SimulatorCreator.hpp"
 #include "alsuq/stats/Statistics.hpp"
+#include "alsuq/mpi/SampleScheduler.hpp"
 
 namespace alsuq {
 namespace run {
@@ -29,7 +30,13 @@ public:
         mpi::ConfigurationPtr mpiConfig,
         const std::string& name);
 
-
+    //! Runs the samples handed out by sampleScheduler, until it has no
+    //! samples left.
+    Runner(std::shared_ptr<SimulatorCreator> simulatorCreator,
+        std::shared_ptr<samples::SampleGenerator> sampleGenerator,
+        mpi::SampleSchedulerPtr sampleScheduler,
+        mpi::ConfigurationPtr mpiConfig,
+        const std::string& name);
 
 
     void run();
@@ -42,15 +49,35 @@ public:
 
     size_t getTimestepsPerformedTotal() const;
 
+    //! Sets the number of samples to advance at once in a single simulator
+    //! (see SimulatorCreator::createEnsembleSimulator). Each chunk of samples
+    //! from the scheduler is split into ensembles of at most this size.
+    //! Default 1, ie. one simulator per sample.
+    void setEnsembleSize(size_t ensembleSize);
+
+    //! Set if the statistics are scattered over the statistical communicator
+    //! (see stats::StatisticsParameters::setScatterStatistics), then every
+    //! process finalizes and writes its part of them, not only rank 0.
+    void setScatterStatistics(bool scatterStatistics);
+
 private:
+    //! Creates the simulator for the given samples (one sample, unless
+    //! ensembles are used)
+    alsfvm::shared_ptr<alsfvm::simulator::AbstractSimulator> createSimulator(
+        const std::vector<size_t>& samples);
+
+    alsfvm::init::Parameters makeParameters(size_t sample);
+
     std::shared_ptr<SimulatorCreator> simulatorCreator;
     std::shared_ptr<samples::SampleGenerator> sampleGenerator;
     std::vector<std::string> parameterNames;
-    std::vector<size_t> sampleNumbers;
+    mpi::SampleSchedulerPtr sampleScheduler;
     std::vector<std::shared_ptr<stats::Statistics> > statistics;
 
     mpi::ConfigurationPtr mpiConfig;
     const std::string name;
+    size_t ensembleSize = 1;
+    bool scatterStatistics = false;
     size_t timestepsPerformedTotal = 0;
 };
 } // namespace run
@@ -20,6 +20,7 @@
 #include "alsuq/mpi/Configuration.hpp"
 #include <mpi.h>
 #include "alsuq/types.hpp"
+#include "alsutils/error/Exception.hpp"
 
 namespace alsuq {
 namespace run {
@@ -34,6 +35,18 @@ public:
     createSimulator(const alsfvm::init::Parameters& initialDataParameters,
         size_t sampleNumber) = 0;
 
+    //! Creates a simulator that advances all the given samples at once, as
+    //! an ensemble (see alsfvm::simulator::SimulatorParameters::setEnsembleSize).
+    //! Takes the initial data parameters and the sample number of each sample.
+    //!
+    //! The default implementation throws, creators that do not support
+    //! ensembles can only be used with an ensemble size of one.
+    virtual alsfvm::shared_ptr<alsfvm::simulator::AbstractSimulator>
+    createEnsembleSimulator(const std::vector<alsfvm::init::Parameters>&,
+        const std::vector<size_t>&) {
+        THROW("This simulator creator does not support ensembles");
+    }
+
 };
 } // namespace run
 } // namespace alsuq
@@ -62,12 +62,23 @@ public:
     //! through M_2-mean^2 or any other postprocessing needed
     virtual void finalizeStatistics() override;
 
+    virtual bool supportsScatteredStatistics() const override;
+
 protected:
     virtual void computeStatistics(const alsfvm::volume::Volume& conservedVariables,
         const alsfvm::grid::Grid& grid,
         const alsfvm::simulator::TimestepInformation& timestepInformation) override;
 
+    virtual void computeStatisticsEnsemble(const alsfvm::volume::Volume&
+        conservedVariables,
+        const alsfvm::grid::Grid& grid,
+        const alsfvm::simulator::TimestepInformation& timestepInformation) override;
+
 private:
+    //! Returns true if the statistics should be computed at the current time
+    bool isSaveTime(const alsfvm::simulator::TimestepInformation&
+        timestepInformation);
+
     alsfvm::shared_ptr<Statistics> statistics;
     const real timeInterval;
     const real endTime;
@@ -20,6 +20,16 @@
 namespace alsuq {
 namespace stats {
 
+//! Computes the mean and the variance of the samples.
+//!
+//! Every snapshot keeps the running mean in "mean" and the sum of squared
+//! deviations from the mean (M2) in "variance", updated with Welford's
+//! algorithm, so that a variance that is small compared to the mean squared
+//! keeps its significant digits (see WelfordState). The variance is M2
+//! divided by the number of samples (not the number of samples minus one).
+//!
+//! The snapshots are stored as real, like all volumes, so they only take
+//! less memory in builds with ALSVINN_USE_FLOAT.
 class MeanVariance : public StatisticsHelper {
 public:
     MeanVariance(const StatisticsParameters& parameters);
@@ -32,7 +42,34 @@ public:
         const alsfvm::grid::Grid& grid,
         const alsfvm::simulator::TimestepInformation& timestepInformation) override;
 
+    //! Computes the mean and M2 of the members of the ensemble block by
+    //! block, and merges them into the snapshots, instead of adding every
+    //! member to them.
+    virtual void computeStatisticsEnsemble(const alsfvm::volume::Volume&
+        conservedVariables,
+        const alsfvm::grid::Grid& grid,
+        const alsfvm::simulator::TimestepInformation& timestepInformation) override;
+
+    //! Merges the means and M2 of all sample groups onto rank 0 with a
+    //! custom MPI reduction (see getWelfordMpiOperation), all snapshots
+    //! packed together (see PackedReduction). When scattering, every
+    //! process gets its slab instead (see ScatteredReduction).
+    virtual void combineStatistics() override;
+
     virtual void finalizeStatistics() override;
+
+    //! The mean and variance are computed cell by cell, so they can be
+    //! scattered
+    virtual bool supportsScatteredStatistics() const override;
+
+private:
+    void scatterSnapshots();
+
+    //! The number of samples added to the snapshot at each time
+    std::map<real, size_t> numberOfSamples;
+
+    //! Scratch space for the deviation from the mean
+    std::shared_ptr<alsfvm::volume::Volume> deviation;
 };
 } // namespace stats
 } // namespace alsuq
@@ -20,6 +20,13 @@
 namespace alsuq {
 namespace stats {
 
+//! Computes the p-th raw moment E[u^p] of the samples.
+//!
+//! Every snapshot keeps the running mean of u^p, so that it stays of the
+//! size of the moment instead of growing with the number of samples, and
+//! does not lose its last digits when many samples are added (this matters
+//! most with ALSVINN_USE_FLOAT). The sample groups are merged by weighing
+//! their means with their number of samples.
 class OnePointMoment : public StatisticsHelper {
 public:
     OnePointMoment(const StatisticsParameters& parameters);
@@ -34,9 +41,20 @@ public:
         const alsfvm::simulator::TimestepInformation& timestepInformation) override;
 
     virtual void finalizeStatistics() override;
+
+    //! The moments are computed cell by cell, so they can be scattered
+    virtual bool supportsScatteredStatistics() const override;
+
+protected:
+    //! The number of samples this group has added at the given time
+    virtual real getCombineWeight(real time) const override;
+
 private:
     const int p;
     const std::string statisticsName;
+
+    //! The number of samples added to the snapshot at each time
+    std::map<real, size_t> numberOfSamples;
 };
 } // namespace stats
 } // namespace alsuq
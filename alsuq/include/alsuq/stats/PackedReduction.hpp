@@ -0,0 +1,171 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsuq/types.hpp"
+#include "alsuq/mpi/utils.hpp"
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <vector>
+#include <mpi.h>
+
+namespace alsuq {
+namespace stats {
+
+//! Reduces many host buffers onto the root with a few large non-blocking
+//! reductions (MPI_Ireduce), instead of one blocking reduction per buffer.
+//!
+//! Every buffer is added as a segment, given by its size, a function packing
+//! a range of it into the send buffer, and a function unpacking the reduced
+//! range (only called on the root). The segments are laid out one after the
+//! other and cut into chunks of at most chunkSize elements. While a chunk is
+//! being reduced the next one is packed, and the previous one is unpacked.
+//! The chunk size is capped at INT_MAX, the largest count MPI takes.
+//!
+//! \note Every process of the communicator has to add the same segments (in
+//!       the same order and with the same sizes) before calling reduce.
+template<class T>
+class PackedReduction {
+public:
+    typedef std::function<void(size_t begin, size_t count, T* buffer)> Pack;
+    typedef std::function<void(size_t begin, size_t count, const T* buffer)>
+    Unpack;
+
+    //! The default chunk size, 32 MB
+    static constexpr size_t defaultChunkSize = (size_t(32) << 20) / sizeof(T);
+
+    //! The number of reductions that may be in flight at the same time
+    static constexpr size_t maximumChunksInFlight = 2;
+
+    PackedReduction(MPI_Datatype datatype, MPI_Op operation, int root,
+        MPI_Comm communicator, size_t chunkSize = defaultChunkSize)
+        : datatype(datatype), operation(operation), root(root),
+          communicator(communicator),
+          chunkSize(std::min(std::max(chunkSize, size_t(1)),
+                  size_t(std::numeric_limits<int>::max()))) {
+        MPI_SAFE_CALL(MPI_Comm_rank(communicator, &rank));
+    }
+
+    void addSegment(size_t size, const Pack& pack, const Unpack& unpack) {
+        segments.push_back({size, pack, unpack});
+    }
+
+    //! Reduces all the segments, on the root they are unpacked on return
+    void reduce() {
+        std::deque<Chunk> chunksInFlight;
+        size_t segment = 0;
+        size_t begin = 0;
+
+        while (true) {
+            Chunk chunk;
+            size_t chunkLength = 0;
+
+            while (segment < segments.size() && chunkLength < chunkSize) {
+                const size_t count = std::min(segments[segment].size - begin,
+                        chunkSize - chunkLength);
+
+                if (count > 0) {
+                    chunk.pieces.push_back({segment, begin, count, chunkLength});
+                    chunkLength += count;
+                    begin += count;
+                }
+
+                if (begin == segments[segment].size) {
+                    ++segment;
+                    begin = 0;
+                }
+            }
+
+            if (chunkLength == 0) {
+                break;
+            }
+
+            chunk.send.resize(chunkLength);
+
+            for (const auto& piece : chunk.pieces) {
+                segments[piece.segment].pack(piece.begin, piece.count,
+                    chunk.send.data() + piece.offset);
+            }
+
+            if (rank == root) {
+                chunk.receive.resize(chunkLength);
+            }
+
+            // Make room before starting the next reduction, so that there
+            // are never more than maximumChunksInFlight
+            if (chunksInFlight.size() == maximumChunksInFlight) {
+                finish(chunksInFlight.front());
+                chunksInFlight.pop_front();
+            }
+
+            chunksInFlight.push_back(std::move(chunk));
+            auto& started = chunksInFlight.back();
+            MPI_SAFE_CALL(MPI_Ireduce(started.send.data(),
+                    rank == root ? started.receive.data() : nullptr,
+                    int(chunkLength), datatype, operation, root, communicator,
+                    &started.request));
+        }
+
+        for (auto& chunk : chunksInFlight) {
+            finish(chunk);
+        }
+    }
+
+private:
+    struct Segment {
+        size_t size;
+        Pack pack;
+        Unpack unpack;
+    };
+
+    //! A range of a segment, and where it is in the chunk
+    struct Piece {
+        size_t segment;
+        size_t begin;
+        size_t count;
+        size_t offset;
+    };
+
+    struct Chunk {
+        std::vector<Piece> pieces;
+        std::vector<T> send;
+        std::vector<T> receive;
+        MPI_Request request = MPI_REQUEST_NULL;
+    };
+
+    void finish(Chunk& chunk) {
+        MPI_SAFE_CALL(MPI_Wait(&chunk.request, MPI_STATUS_IGNORE));
+
+        if (rank == root) {
+            for (const auto& piece : chunk.pieces) {
+                segments[piece.segment].unpack(piece.begin, piece.count,
+                    chunk.receive.data() + piece.offset);
+            }
+        }
+    }
+
+    const MPI_Datatype datatype;
+    const MPI_Op operation;
+    const int root;
+    const MPI_Comm communicator;
+    const size_t chunkSize;
+    int rank = 0;
+
+    std::vector<Segment> segments;
+};
+} // namespace stats
+} // namespace alsuq
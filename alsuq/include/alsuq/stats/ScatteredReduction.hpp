@@ -0,0 +1,223 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsuq/types.hpp"
+#include "alsuq/mpi/utils.hpp"
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <mpi.h>
+
+namespace alsuq {
+namespace stats {
+
+//! Reduces buffers that all have the same layout over a communicator, such
+//! that every process only gets the reduced values of its own range of each
+//! buffer (MPI_Ireduce_scatter).
+//!
+//! Buffers are added with a function packing a range of the buffer into
+//! the send buffer, and a function unpacking a reduced part of the range
+//! owned by this process. The buffers added since the last call to
+//! reduceBuffers are reduced together: the ranges of each process are laid
+//! out one buffer after the other, and cut into chunks such that a reduction
+//! holds at most chunkSize elements (and at least one per process). While a
+//! chunk is being reduced the next one is packed. At most two reductions are
+//! in flight.
+//!
+//! \note Every process of the communicator has to add the same number of
+//!       buffers, and call reduceBuffers the same number of times.
+template<class T>
+class ScatteredReduction {
+public:
+    typedef std::function<void(size_t begin, size_t count, T* buffer)> Pack;
+    typedef std::function<void(size_t begin, size_t count, const T* buffer)>
+    Unpack;
+
+    //! The default chunk size, 32 MB
+    static constexpr size_t defaultChunkSize = (size_t(32) << 20) / sizeof(T);
+
+    //! The number of reductions that may be in flight at the same time
+    static constexpr size_t maximumReductionsInFlight = 2;
+
+    //! @param begins the start of the range owned by each process
+    //! @param counts the length of the range owned by each process
+    //! @param chunkSize the largest number of elements in one reduction,
+    //!                  capped at INT_MAX (the largest count MPI takes)
+    ScatteredReduction(MPI_Datatype datatype, MPI_Op operation,
+        MPI_Comm communicator, const std::vector<size_t>& begins,
+        const std::vector<size_t>& counts, size_t chunkSize = defaultChunkSize)
+        : datatype(datatype), operation(operation), communicator(communicator),
+          begins(begins), counts(counts) {
+        MPI_SAFE_CALL(MPI_Comm_rank(communicator, &rank));
+        int numberOfProcesses = 0;
+        MPI_SAFE_CALL(MPI_Comm_size(communicator, &numberOfProcesses));
+
+        if (begins.size() != size_t(numberOfProcesses)
+            || counts.size() != size_t(numberOfProcesses)) {
+            THROW("Expected a range for each of the " << numberOfProcesses
+                << " processes, got " << begins.size() << " and " << counts.size());
+        }
+
+        chunkSize = std::min(chunkSize, size_t(std::numeric_limits<int>::max()));
+        chunkSizePerProcess = std::max(chunkSize / size_t(numberOfProcesses),
+                size_t(1));
+    }
+
+    void addBuffer(const Pack& pack, const Unpack& unpack) {
+        packs.push_back(pack);
+        unpacks.push_back(unpack);
+    }
+
+    //! Packs the buffers added since the last call and starts reducing them.
+    //! When this returns, the pack functions have been called.
+    void reduceBuffers() {
+        if (packs.empty()) {
+            return;
+        }
+
+        auto bufferUnpacks = std::make_shared<std::vector<Unpack> >();
+        bufferUnpacks->swap(unpacks);
+        const size_t numberOfBuffers = packs.size();
+
+        size_t longestRange = 0;
+
+        for (size_t count : counts) {
+            longestRange = std::max(longestRange, numberOfBuffers * count);
+        }
+
+        for (size_t first = 0; first < longestRange; first += chunkSizePerProcess) {
+            Reduction reduction;
+            reduction.unpacks = bufferUnpacks;
+            reduction.first = first;
+
+            size_t totalCount = 0;
+
+            for (size_t process = 0; process < counts.size(); ++process) {
+                const size_t length = getChunkLength(process, numberOfBuffers, first);
+                reduction.receiveCounts.push_back(int(length));
+                totalCount += length;
+            }
+
+            reduction.send.resize(totalCount);
+            reduction.receive.resize(size_t(reduction.receiveCounts[rank]));
+
+            T* sendPointer = reduction.send.data();
+
+            for (size_t process = 0; process < counts.size(); ++process) {
+                forEachPiece(process, first, size_t(reduction.receiveCounts[process]),
+                [&](size_t buffer, size_t offset, size_t count) {
+                    packs[buffer](begins[process] + offset, count, sendPointer);
+                    sendPointer += count;
+                });
+            }
+
+            // Make room before starting the next reduction, so that there
+            // are never more than maximumReductionsInFlight
+            if (reductionsInFlight.size() == maximumReductionsInFlight) {
+                finish(reductionsInFlight.front());
+                reductionsInFlight.pop_front();
+            }
+
+            reductionsInFlight.push_back(std::move(reduction));
+            auto& started = reductionsInFlight.back();
+            MPI_SAFE_CALL(MPI_Ireduce_scatter(started.send.data(),
+                    started.receive.data(), started.receiveCounts.data(), datatype,
+                    operation, communicator, &started.request));
+        }
+
+        packs.clear();
+    }
+
+    //! Reduces the remaining buffers and waits for all reductions, the
+    //! reduced ranges are unpacked on return.
+    void finish() {
+        reduceBuffers();
+
+        for (auto& reduction : reductionsInFlight) {
+            finish(reduction);
+        }
+
+        reductionsInFlight.clear();
+    }
+
+private:
+    struct Reduction {
+        std::shared_ptr<std::vector<Unpack> > unpacks;
+        //! Where the chunk starts in the buffers of each process, laid out
+        //! one after the other
+        size_t first = 0;
+        std::vector<T> send;
+        std::vector<T> receive;
+        std::vector<int> receiveCounts;
+        MPI_Request request = MPI_REQUEST_NULL;
+    };
+
+    void finish(Reduction& reduction) {
+        MPI_SAFE_CALL(MPI_Wait(&reduction.request, MPI_STATUS_IGNORE));
+        // The send buffer is no longer needed
+        std::vector<T>().swap(reduction.send);
+
+        const T* receivePointer = reduction.receive.data();
+        forEachPiece(size_t(rank), reduction.first, reduction.receive.size(),
+        [&](size_t buffer, size_t offset, size_t count) {
+            (*reduction.unpacks)[buffer](begins[rank] + offset, count,
+                receivePointer);
+            receivePointer += count;
+        });
+    }
+
+    //! The number of elements of the given process in the chunk starting at
+    //! first
+    size_t getChunkLength(size_t process, size_t numberOfBuffers,
+        size_t first) const {
+        const size_t length = numberOfBuffers * counts[process];
+        return first < length ? std::min(length - first, chunkSizePerProcess) : 0;
+    }
+
+    //! Calls function(buffer, offset, count) for every piece of a buffer in
+    //! [first, first + length) of the ranges of the given process, laid out
+    //! one buffer after the other. The offset is relative to the range.
+    template<class Function>
+    void forEachPiece(size_t process, size_t first, size_t length,
+        const Function& function) const {
+        const size_t count = counts[process];
+
+        for (size_t position = first; position < first + length;) {
+            const size_t offset = position % count;
+            const size_t pieceLength = std::min(count - offset,
+                    first + length - position);
+            function(position / count, offset, pieceLength);
+            position += pieceLength;
+        }
+    }
+
+    const MPI_Datatype datatype;
+    const MPI_Op operation;
+    const MPI_Comm communicator;
+    const std::vector<size_t> begins;
+    const std::vector<size_t> counts;
+    size_t chunkSizePerProcess = 1;
+    int rank = 0;
+
+    std::vector<Pack> packs;
+    std::vector<Unpack> unpacks;
+    std::deque<Reduction> reductionsInFlight;
+};
+} // namespace stats
+} // namespace alsuq
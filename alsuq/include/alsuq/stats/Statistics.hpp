@@ -33,6 +33,13 @@ public:
         const alsfvm::grid::Grid& grid,
         const alsfvm::simulator::TimestepInformation& timestepInformation) override;
 
+    ///
+    /// Passes the information onto computeStatisticsEnsemble
+    ///
+    virtual void writeEnsemble(const alsfvm::volume::Volume& conservedVariables,
+        const alsfvm::grid::Grid& grid,
+        const alsfvm::simulator::TimestepInformation& timestepInformation) override;
+
 
     //! To be called when the statistics should be combined.
     virtual void combineStatistics() = 0;
@@ -53,12 +60,28 @@ public:
         const alsfvm::grid::Grid& grid,
         const alsfvm::simulator::TimestepInformation& timestepInformation) = 0;
 
+    //! Computes the statistics of every member of an ensemble (see
+    //! alsfvm/volume/ensemble.hpp). The default implementation calls
+    //! computeStatistics for one member at a time.
+    virtual void computeStatisticsEnsemble(const alsfvm::volume::Volume&
+        conservedVariables,
+        const alsfvm::grid::Grid& grid,
+        const alsfvm::simulator::TimestepInformation& timestepInformation);
+
     //! To be called in the end, this could be to eg compute the variance
     //! through M_2-mean^2 or any other postprocessing needed
     virtual void finalizeStatistics() = 0;
 
     virtual void writeStatistics(const alsfvm::grid::Grid& grid) = 0;
 
+    //! Whether the statistics can be scattered over the statistical
+    //! communicator (see StatisticsParameters::setScatterStatistics). Then
+    //! finalizeStatistics and writeStatistics have to be called on every
+    //! process, and the writers have to write collectively.
+    virtual bool supportsScatteredStatistics() const {
+        return false;
+    }
+
 };
 } // namespace stats
 } // namespace alsuq
@@ -36,11 +36,24 @@ public:
         std::shared_ptr<alsfvm::io::Writer>& writer) override;
 
     //! Should be called at the end of the simulation
+    //!
+    //! Sums the snapshots onto rank 0 of the statistical communicator, or,
+    //! if scattering (see StatisticsParameters::setScatterStatistics), leaves
+    //! every process with its slab of the summed snapshots. The sums are
+    //! divided by the number of samples. Each snapshot is multiplied by
+    //! getCombineWeight before it is summed.
+    //!
+    //! \note Without scattering only rank 0 gets the result. The snapshots of
+    //!       the other processes keep their local, undivided sums, and should
+    //!       not be written.
     virtual void combineStatistics() override;
 
 
 
     //! Writes the statistics to file
+    //!
+    //! If the snapshots have been scattered, only the slab of this process
+    //! is written, with a grid describing where the slab is.
     virtual void writeStatistics(const alsfvm::grid::Grid& grid) override;
 
 
@@ -48,6 +61,12 @@ public:
 protected:
     std::map<real, std::map<std::string, StatisticsSnapshot> > snapshots;
 
+    //! What the snapshots at the given time are multiplied by before they
+    //! are summed over the sample groups in combineStatistics. The default
+    //! is one, for snapshots holding sums over the samples. Snapshots holding
+    //! running means return the number of samples they have seen.
+    virtual real getCombineWeight(real time) const;
+
     //! Utility function.
     //!
     //! If the given timstep is already created, return that timestep,
@@ -68,14 +87,56 @@ protected:
         size_t nx, size_t ny, size_t nz, const std::string& platform = "default");
 
     void makeOwnGrid(size_t nx, size_t ny, size_t nz);
+
+    //! How the snapshots are cut into slabs, one per process of the
+    //! statistical communicator, when they are scattered.
+    struct SlabLayout {
+        //! The direction the snapshots are cut along, the last direction
+        //! with more than one cell
+        size_t direction = 0;
+
+        //! The number of values (including ghost cells) in one plane
+        //! orthogonal to the direction
+        size_t planeSize = 0;
+
+        //! The first cell (not counting ghost cells) and the number of cells
+        //! along the direction of each process
+        std::vector<int> firstCells;
+        std::vector<int> numberOfCells;
+
+        //! The range of each process in the storage of a snapshot
+        std::vector<size_t> begins;
+        std::vector<size_t> counts;
+    };
+
+    //! Cuts snapshots of the shape of the given volume into slabs, and
+    //! remembers the layout for writeStatistics
+    const SlabLayout& makeSlabLayout(const alsfvm::volume::Volume& volume);
+
+    //! Makes a volume for the slab of this process, with the same ghost cells
+    std::shared_ptr<alsfvm::volume::Volume> makeSlabVolume(
+        const alsfvm::volume::Volume& volume) const;
+
+    //! Where the range of this process starts in the storage of a volume
+    //! made by makeSlabVolume
+    size_t getSlabOffset(const alsfvm::volume::Volume& slabVolume) const;
+
+    //! The statistical communicator, the snapshots are combined over it
+    alsuq::mpi::ConfigurationPtr mpiConfig;
+
+    //! Whether combineStatistics should scatter the snapshots
+    const bool scatterStatistics;
 private:
+    //! Sums the snapshots and scatters them over the statistical communicator
+    void scatterSnapshots();
+
+    std::unique_ptr<SlabLayout> slabLayout;
+
     size_t samples;
 
     std::map<std::string, std::vector<std::shared_ptr<alsfvm::io::Writer>  > >
     writers;
 
-    alsuq::mpi::ConfigurationPtr mpiConfig;
-
     std::unique_ptr<alsfvm::grid::Grid> ownGrid{{nullptr}};
 };
 } // namespace stats
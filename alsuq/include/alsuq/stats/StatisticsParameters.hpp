@@ -33,6 +33,12 @@ public:
 
     void setPlatform(const std::string& platform);
     std::string getPlatform() const;
+
+    //! If set, combineStatistics leaves every process of the statistical
+    //! communicator with a slab of the statistics instead of reducing
+    //! everything onto rank 0 (see Statistics::supportsScatteredStatistics)
+    void setScatterStatistics(bool scatterStatistics);
+    bool getScatterStatistics() const;
 private:
 
     size_t samples =  0;
@@ -40,6 +46,8 @@ private:
     mpi::ConfigurationPtr mpiConfiguration = nullptr;
 
     std::string platform = "cpu";
+
+    bool scatterStatistics = false;
 };
 } // namespace stats
 } // namespace alsuq
@@ -50,6 +50,8 @@ public:
     //! through M_2-mean^2 or any other postprocessing needed
     virtual void finalizeStatistics() override;
 
+    virtual bool supportsScatteredStatistics() const override;
+
     virtual void writeStatistics(const alsfvm::grid::Grid& grids) override;
 
 private:
@@ -57,11 +57,18 @@ public:
     //! through M_2-mean^2 or any other postprocessing needed
     virtual void finalizeStatistics() override;
 
+    virtual bool supportsScatteredStatistics() const override;
+
 protected:
     virtual void computeStatistics(const alsfvm::volume::Volume& conservedVariables,
         const alsfvm::grid::Grid& grid,
         const alsfvm::simulator::TimestepInformation& timestepInformation) override;
 
+    virtual void computeStatisticsEnsemble(const alsfvm::volume::Volume&
+        conservedVariables,
+        const alsfvm::grid::Grid& grid,
+        const alsfvm::simulator::TimestepInformation& timestepInformation) override;
+
 private:
     alsfvm::shared_ptr<Statistics> statistics;
 
@@ -0,0 +1,70 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsuq/types.hpp"
+#include <mpi.h>
+
+namespace alsuq {
+namespace stats {
+
+//! The number of values, their mean and the sum of the squared deviations
+//! from the mean (M2, so the variance is m2 / count) of a stream of values.
+//!
+//! Unlike accumulating the sum and the sum of squares, this does not lose
+//! all significant digits of the variance when it is small compared to the
+//! mean squared, see
+//!
+//!   B. P. Welford, Note on a method for calculating corrected sums of
+//!   squares and products, Technometrics 4(3), 1962.
+//!
+//!   T. F. Chan, G. H. Golub and R. J. LeVeque, Updating formulae and a
+//!   pairwise algorithm for computing sample variances, 1979.
+template<class T>
+struct WelfordState {
+    T count = 0;
+    T mean = 0;
+    T m2 = 0;
+
+    //! Adds a single value (Welford's update)
+    void add(T value) {
+        count += 1;
+        const T deviation = value - mean;
+        mean += deviation / count;
+        m2 += deviation * (value - mean);
+    }
+
+    //! Merges the values of other into this (Chan et al.)
+    void merge(const WelfordState& other) {
+        if (other.count == 0) {
+            return;
+        }
+
+        const T totalCount = count + other.count;
+        const T deviation = other.mean - mean;
+        mean += deviation * (other.count / totalCount);
+        m2 += other.m2 + deviation * deviation * (count * other.count / totalCount);
+        count = totalCount;
+    }
+};
+
+//! The MPI datatype of WelfordState<real>
+MPI_Datatype getWelfordMpiType();
+
+//! An MPI operation that merges WelfordState<real> elementwise, to be used
+//! with getWelfordMpiType() in MPI_Reduce and friends.
+MPI_Op getWelfordMpiOperation();
+} // namespace stats
+} // namespace alsuq
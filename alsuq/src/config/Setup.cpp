@@ -18,6 +18,8 @@
 #include "alsuq/generator/GeneratorFactory.hpp"
 #include "alsuq/distribution/DistributionFactory.hpp"
 #include "alsuq/mpi/SimpleLoadBalancer.hpp"
+#include "alsuq/mpi/StaticSampleScheduler.hpp"
+#include "alsuq/mpi/DynamicSampleScheduler.hpp"
 #include <boost/property_tree/xml_parser.hpp>
 #include <sstream>
 #include "alsutils/io/TextFileCache.hpp"
@@ -35,6 +37,20 @@ namespace alsuq {
 namespace config {
 // example:
 // <samples>1024</samples>
+// <!-- optional, either static (default), each sample group gets a fixed
+//      share of the samples, or dynamic, the groups take sampleChunkSize
+//      samples at a time when they are done with the previous ones -->
+// <sampleScheduler>static</sampleScheduler>
+// <sampleChunkSize>1</sampleChunkSize>
+// <!-- optional, the number of samples each process advances at once in a
+//      single simulator (an ensemble, 1D and 2D on the cpu only, without
+//      spatial decomposition). Default 1 -->
+// <ensembleSize>1</ensembleSize>
+// <!-- optional, if true every process keeps a slab of the statistics
+//      instead of reducing them onto rank 0, and they are written
+//      collectively (meanvar and onepointmoment with the netcdf writer
+//      only). Default false -->
+// <scatterStatistics>false</scatterStatistics>
 // <generator>auto</generator>
 // <parameters>
 //   <parameter>
@@ -84,6 +100,47 @@ std::shared_ptr<run::Runner> Setup::makeRunner(const std::string& inputFilename,
     auto statisticalConfiguration = std::get<1>(loadBalanceConfiguration);
     auto spatialConfiguration = std::get<2>(loadBalanceConfiguration);
 
+    auto sampleScheduler = makeSampleScheduler(configuration, samples,
+            samplesForProc, mpiConfigurationWorld, statisticalConfiguration,
+            spatialConfiguration);
+
+    // The output of each sample is written collectively by all sample
+    // groups, so they need to run the same number of samples.
+    const auto& fvmNode = configuration.get_child("fvm");
+    const bool writeSamples = fvmNode.find("writer") != fvmNode.not_found()
+        || fvmNode.find("functionals") != fvmNode.not_found();
+
+    const int ensembleSize = configuration.get<int>("uq.ensembleSize", 1);
+
+    if (ensembleSize < 1) {
+        THROW("ensembleSize must be positive, was given " << ensembleSize);
+    }
+
+    if (ensembleSize > 1) {
+        if (multiSpatial.x * multiSpatial.y * multiSpatial.z != 1) {
+            THROW("ensembleSize can not be used with spatial decomposition, "
+                << "given multiSpatial = " << multiSpatial);
+        }
+
+        if (writeSamples) {
+            THROW("fvm.writer and fvm.functionals can not be used with "
+                << "ensembleSize > 1");
+        }
+    }
+
+    if (writeSamples) {
+        if (!std::dynamic_pointer_cast<mpi::StaticSampleScheduler>(sampleScheduler)) {
+            THROW("fvm.writer and fvm.functionals can only be used with the "
+                << "static sample scheduler");
+        }
+
+        if (numberOfSamples % multiSample != 0) {
+            THROW("fvm.writer and fvm.functionals require the number of samples ("
+                << numberOfSamples << ") to be divisible by multiSample ("
+                << multiSample << ")");
+        }
+    }
+
 
     auto simulatorCreator = std::dynamic_pointer_cast<run::SimulatorCreator>
         (std::make_shared<run::FiniteVolumeSimulatorCreator>
@@ -91,16 +148,20 @@ std::shared_ptr<run::Runner> Setup::makeRunner(const std::string& inputFilename,
                 spatialConfiguration,
                 statisticalConfiguration,
                 mpiConfigurationWorld,
-                multiSpatial));
+                multiSpatial,
+                writeSamples));
 
     auto name = boost::algorithm::trim_copy(
             configuration.get<std::string>("fvm.name"));
     auto runner = std::make_shared<run::Runner>(simulatorCreator, sampleGenerator,
-            samplesForProc,
+            sampleScheduler,
             statisticalConfiguration, name);
     auto statistics  = createStatistics(configuration, statisticalConfiguration,
             spatialConfiguration, mpiConfigurationWorld);
     runner->setStatistics(statistics);
+    runner->setEnsembleSize(size_t(ensembleSize));
+    runner->setScatterStatistics(configuration.get<bool>("uq.scatterStatistics",
+            false));
 
     // We want to make sure everything is created before going further
     MPI_Barrier(mpiConfigurationWorld->getCommunicator());
@@ -227,9 +288,13 @@ std::vector<std::shared_ptr<stats::Statistics> > Setup::createStatistics(
     auto statisticsNodes = configuration.get_child("uq.stats");
     stats::StatisticsFactory statisticsFactory;
     std::shared_ptr<alsfvm::io::WriterFactory> writerFactory;
+    const bool scatterStatistics = configuration.get<bool>("uq.scatterStatistics",
+            false);
 
-
-    writerFactory.reset(new alsfvm::io::MpiWriterFactory(spatialConfiguration));
+    // Scattered statistics are written by every process (each its own slab),
+    // otherwise by rank 0 of every statistical communicator
+    writerFactory.reset(new alsfvm::io::MpiWriterFactory(scatterStatistics ?
+            worldConfiguration : spatialConfiguration));
 
     auto platform = configuration.get<std::string>("fvm.platform");
     std::vector<std::shared_ptr<stats::Statistics> > statisticsVector;
@@ -241,6 +306,7 @@ std::vector<std::shared_ptr<stats::Statistics> > Setup::createStatistics(
         parameters.setMpiConfiguration(statisticalConfiguration);
         parameters.setNumberOfSamples(readNumberOfSamples(configuration));
         parameters.setPlatform(platform);
+        parameters.setScatterStatistics(scatterStatistics);
         auto statistics = statisticsFactory.makeStatistics(platform, name, parameters);
 
 
@@ -251,6 +317,17 @@ std::vector<std::shared_ptr<stats::Statistics> > Setup::createStatistics(
         std::string basename =
             statisticsNode.second.get<std::string>("writer.basename");
 
+        if (scatterStatistics) {
+            if (!statistics->supportsScatteredStatistics()) {
+                THROW("The statistics " << name << " can not be used with "
+                    << "scatterStatistics");
+            }
+
+            if (boost::trim_copy(type) != "netcdf") {
+                THROW("scatterStatistics needs the netcdf writer, given " << type);
+            }
+        }
+
         for (auto statisticsName : statistics->getStatisticsNames()) {
 
             auto outputname = basename + "_" + statisticsName;
@@ -301,6 +378,36 @@ size_t Setup::readNumberOfSamples(Setup::ptree& configuration) {
     return configuration.get<real>("uq.samples");
 }
 
+mpi::SampleSchedulerPtr Setup::makeSampleScheduler(Setup::ptree&
+    configuration,
+    const std::vector<size_t>& samples,
+    const std::vector<size_t>& samplesForProcess,
+    mpi::ConfigurationPtr worldConfiguration,
+    mpi::ConfigurationPtr statisticalConfiguration,
+    mpi::ConfigurationPtr spatialConfiguration) {
+    const auto scheduler = boost::algorithm::trim_copy(
+            configuration.get<std::string>("uq.sampleScheduler", "static"));
+
+    if (scheduler == "static") {
+        return std::make_shared<mpi::StaticSampleScheduler>(samplesForProcess);
+    } else if (scheduler == "dynamic") {
+        const int chunkSize = configuration.get<int>("uq.sampleChunkSize", 1);
+
+        if (chunkSize < 1) {
+            THROW("sampleChunkSize must be positive, was given " << chunkSize);
+        }
+
+        ALSVINN_LOG(INFO, "Dynamic sample scheduling, sampleChunkSize = "
+            << chunkSize);
+        return std::make_shared<mpi::DynamicSampleScheduler>(samples,
+                size_t(chunkSize), worldConfiguration, statisticalConfiguration,
+                spatialConfiguration);
+    }
+
+    THROW("Unknown sampleScheduler " << scheduler
+        << ", expected static or dynamic");
+}
+
 size_t Setup::readSampleStart(Setup::ptree& configuration) {
     auto& uq = configuration.get_child("uq");
 
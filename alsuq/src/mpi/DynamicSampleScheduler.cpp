@@ -0,0 +1,157 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "alsuq/mpi/DynamicSampleScheduler.hpp"
+#include "alsuq/mpi/utils.hpp"
+#include "alsutils/log.hpp"
+#include <algorithm>
+
+namespace alsuq {
+namespace mpi {
+
+constexpr std::chrono::milliseconds DynamicSampleScheduler::progressInterval;
+
+DynamicSampleScheduler::DynamicSampleScheduler(const std::vector<size_t>&
+    samples,
+    size_t chunkSize,
+    ConfigurationPtr worldConfiguration,
+    ConfigurationPtr statisticalConfiguration,
+    ConfigurationPtr spatialConfiguration)
+    : samples(samples), chunkSize(chunkSize),
+      spatialConfiguration(spatialConfiguration) {
+
+    if (chunkSize == 0) {
+        THROW("The sample chunk size must be positive.");
+    }
+
+    const size_t numberOfGroups = statisticalConfiguration->getNumberOfProcesses();
+
+    if (samples.size() < numberOfGroups) {
+        THROW("Every sample group needs at least one sample, we were given "
+            << samples.size() << " samples for " << numberOfGroups << " groups.");
+    }
+
+    // The first chunk of every group is fixed, the counter starts after them
+    firstChunkSize = long(std::min(chunkSize, samples.size() / numberOfGroups));
+    firstChunkStart = long(statisticalConfiguration->getRank()) * firstChunkSize;
+
+    const bool isCounterOwner = worldConfiguration->getRank() == 0;
+    MPI_SAFE_CALL(MPI_Win_allocate(isCounterOwner ? sizeof(long) : 0,
+            sizeof(long), MPI_INFO_NULL, worldConfiguration->getCommunicator(),
+            &counter, &counterWindow));
+
+    if (isCounterOwner) {
+        MPI_SAFE_CALL(MPI_Win_lock(MPI_LOCK_EXCLUSIVE, 0, 0, counterWindow));
+        *counter = long(numberOfGroups) * firstChunkSize;
+        MPI_SAFE_CALL(MPI_Win_unlock(0, counterWindow));
+
+        int threadSupport = MPI_THREAD_SINGLE;
+        MPI_SAFE_CALL(MPI_Query_thread(&threadSupport));
+
+        if (threadSupport == MPI_THREAD_MULTIPLE) {
+            // A communicator of its own, so the probing never sees the
+            // messages of the simulation
+            MPI_SAFE_CALL(MPI_Comm_dup(MPI_COMM_SELF, &progressCommunicator));
+            progressThread = std::thread([this]() {
+                makeProgress();
+            });
+        } else {
+            ALSVINN_LOG(WARNING, "MPI does not provide MPI_THREAD_MULTIPLE, so "
+                "the sample counter on rank 0 is only served while rank 0 is "
+                "inside MPI. Other sample groups may wait for rank 0 to finish "
+                "its chunk, consider a smaller sampleChunkSize.");
+        }
+    }
+
+    // Nobody may increment the counter before it is initialized
+    MPI_SAFE_CALL(MPI_Barrier(worldConfiguration->getCommunicator()));
+}
+
+DynamicSampleScheduler::~DynamicSampleScheduler() {
+    int finalized = 0;
+    MPI_Finalized(&finalized);
+
+    if (!finalized) {
+        freeCounter();
+    } else if (progressThread.joinable()) {
+        stopProgress = true;
+        progressThread.join();
+    }
+}
+
+std::vector<size_t> DynamicSampleScheduler::nextSamples() {
+    if (counterWindow == MPI_WIN_NULL) {
+        return {};
+    }
+
+    long first = firstChunkStart;
+    long count = long(chunkSize);
+
+    if (firstChunk) {
+        firstChunk = false;
+        count = firstChunkSize;
+    } else {
+        if (spatialConfiguration->getRank() == 0) {
+            MPI_SAFE_CALL(MPI_Win_lock(MPI_LOCK_SHARED, 0, 0, counterWindow));
+            MPI_SAFE_CALL(MPI_Fetch_and_op(&count, &first, MPI_LONG, 0, 0, MPI_SUM,
+                    counterWindow));
+            MPI_SAFE_CALL(MPI_Win_unlock(0, counterWindow));
+        }
+
+        MPI_SAFE_CALL(MPI_Bcast(&first, 1, MPI_LONG, 0,
+                spatialConfiguration->getCommunicator()));
+    }
+
+    const long last = std::min(first + count, long(samples.size()));
+
+    if (first >= last) {
+        ALSVINN_LOG(INFO, "No samples left, this group computed "
+            << numberOfSamplesTaken << " samples");
+        freeCounter();
+        return {};
+    }
+
+    numberOfSamplesTaken += size_t(last - first);
+    return std::vector<size_t>(samples.begin() + first, samples.begin() + last);
+}
+
+size_t DynamicSampleScheduler::getNumberOfSamplesTaken() const {
+    return numberOfSamplesTaken;
+}
+
+void DynamicSampleScheduler::freeCounter() {
+    if (progressThread.joinable()) {
+        stopProgress = true;
+        progressThread.join();
+        MPI_Comm_free(&progressCommunicator);
+    }
+
+    if (counterWindow != MPI_WIN_NULL) {
+        MPI_Win_free(&counterWindow);
+        counter = nullptr;
+    }
+}
+
+void DynamicSampleScheduler::makeProgress() {
+    while (!stopProgress) {
+        int flag = 0;
+        MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, progressCommunicator, &flag,
+            MPI_STATUS_IGNORE);
+        std::this_thread::sleep_for(progressInterval);
+    }
+}
+
+}
+}
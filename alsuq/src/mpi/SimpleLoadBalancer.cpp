@@ -15,6 +15,7 @@
 
 #include "alsuq/mpi/SimpleLoadBalancer.hpp"
 #include "alsutils/error/Exception.hpp"
+#include <algorithm>
 
 namespace alsuq {
 namespace mpi {
@@ -43,25 +44,20 @@ ConfigurationPtr, ConfigurationPtr> SimpleLoadBalancer::loadBalance(
             "\tmultiSample * multiSpatial.x * multiSpatial.y  * multiSpatial.z == totalNumberOfProcesses");
     }
 
-    if (totalNumberOfSamples % multiSample != 0) {
-        THROW("The number of processors must be a divisor of the numberOfSamples.\n"
-            << "ie. totalNumberOfSamples = N * numberOfProcesses     for some integer N"
-            << "\n\n"
+    if (totalNumberOfSamples < size_t(multiSample)) {
+        THROW("Every sample group needs at least one sample.\n"
             << "We were given:"
             << "\n\ttotalNumberOfSamples = " << totalNumberOfSamples
             << "\n\tmultiSample = " << multiSample
             << "\n\nThis can be changed in the config file by editing"
-            << "\n\t<samples>NUMBER OF SAMPLES</samples>"
-            << "\n\n"
-            << "and as a parameter to mpirun (-np) eg."
-            << "\n\tmpirun -np 48 alsuq <path to xml>"
-            << "\n\n\nNOTE:This is a strict requirement, otherwise we have to start"
-            << "\nreconfiguring the communicator when the last process runs out of samples.");
+            << "\n\t<samples>NUMBER OF SAMPLES</samples>");
     }
 
 
     int globalRank = mpiConfig.getRank();
-    size_t numberOfSamplesPerProcess = (totalNumberOfSamples) / multiSample;
+    // The first (totalNumberOfSamples % multiSample) groups get one extra
+    const size_t numberOfSamplesPerProcess = totalNumberOfSamples / multiSample;
+    const size_t remainingSamples = totalNumberOfSamples % multiSample;
 
     int numberOfProcessorsPerSample = multiSpatial.x * multiSpatial.y *
         multiSpatial.z;
@@ -74,13 +70,16 @@ ConfigurationPtr, ConfigurationPtr> SimpleLoadBalancer::loadBalance(
     auto spatialConfiguration = mpiConfig.makeSubConfiguration(statisticalRank,
             spatialRank);
 
-    int rank = statisticalConfiguration->getRank();
+    const size_t rank = statisticalConfiguration->getRank();
+    const size_t firstSample = numberOfSamplesPerProcess * rank
+        + std::min(rank, remainingSamples);
+    const size_t numberOfSamplesForProcess = numberOfSamplesPerProcess
+        + (rank < remainingSamples ? 1 : 0);
     std::vector<size_t> samplesForProcess;
-    samplesForProcess.reserve(numberOfSamplesPerProcess);
+    samplesForProcess.reserve(numberOfSamplesForProcess);
 
 
-    for (size_t i = numberOfSamplesPerProcess * rank;
-        i < numberOfSamplesPerProcess * (rank + 1);
+    for (size_t i = firstSample; i < firstSample + numberOfSamplesForProcess;
         ++i) {
 
         if (i >= totalNumberOfSamples) {
@@ -27,11 +27,13 @@ FiniteVolumeSimulatorCreator::FiniteVolumeSimulatorCreator(
     mpi::ConfigurationPtr mpiConfigurationSpatial,
     mpi::ConfigurationPtr mpiConfigurationStatistical,
     alsutils::mpi::ConfigurationPtr mpiConfigurationWorld,
-    ivec3 multiSpatial)
+    ivec3 multiSpatial,
+    bool writeSamples)
     : mpiConfigurationSpatial(mpiConfigurationSpatial),
       mpiConfigurationStatistical(mpiConfigurationStatistical),
       mpiConfigurationWorld(mpiConfigurationWorld),
       multiSpatial(multiSpatial),
+      writeSamples(writeSamples),
       filename(configurationFile) {
 
 }
@@ -40,7 +42,14 @@ alsfvm::shared_ptr<alsfvm::simulator::AbstractSimulator> FiniteVolumeSimulatorCr
     const alsfvm::init::Parameters& initialDataParameters,
     size_t sampleNumber) {
 
-    auto groupNames = makeGroupNames(sampleNumber);
+    // The group names are only used by the sample writers, and gathering
+    // them is collective over the statistical communicator.
+    std::vector<std::string> groupNames;
+
+    if (writeSamples) {
+        groupNames = makeGroupNames(sampleNumber);
+    }
+
     std::shared_ptr<alsfvm::io::WriterFactory> writerFactory(
         new io::MPIWriterFactory(groupNames, mpiConfigurationStatistical->getRank(),
             firstCall, mpiConfigurationWorld->getCommunicator(),
@@ -65,6 +74,38 @@ alsfvm::shared_ptr<alsfvm::simulator::AbstractSimulator> FiniteVolumeSimulatorCr
         (simulator);
 }
 
+alsfvm::shared_ptr<alsfvm::simulator::AbstractSimulator>
+FiniteVolumeSimulatorCreator::createEnsembleSimulator(
+    const std::vector<alsfvm::init::Parameters>& initialDataParameters,
+    const std::vector<size_t>& sampleNumbers) {
+
+    if (initialDataParameters.size() != sampleNumbers.size()) {
+        THROW("Got " << initialDataParameters.size() << " sets of parameters for "
+            << sampleNumbers.size() << " samples");
+    }
+
+    // An ensemble can not have writers of its own (checked by the setup),
+    // so there are no group names to gather
+    alsfvm::config::SimulatorSetup simulatorSetup;
+
+    simulatorSetup.enableMPI(mpiConfigurationSpatial, multiSpatial.x,
+        multiSpatial.y,
+        multiSpatial.z);
+    simulatorSetup.setEnsembleSize(sampleNumbers.size());
+    auto simulatorPair = simulatorSetup.readSetupFromFile(filename);
+
+    auto simulator = simulatorPair.first;
+    auto initialData = simulatorPair.second;
+
+    for (size_t member = 0; member < sampleNumbers.size(); ++member) {
+        initialData->setParameters(initialDataParameters[member]);
+        simulator->setInitialValue(initialData, member);
+    }
+
+    return std::dynamic_pointer_cast<alsfvm::simulator::AbstractSimulator>
+        (simulator);
+}
+
 std::vector<std::string> FiniteVolumeSimulatorCreator::makeGroupNames(
     size_t sampleNumber) {
     std::vector<size_t> samples(
@@ -14,8 +14,11 @@
  */
 
 #include "alsuq/run/Runner.hpp"
+#include "alsuq/mpi/StaticSampleScheduler.hpp"
 
 #include "alsutils/log.hpp"
+#include "alsutils/error/Exception.hpp"
+#include <algorithm>
 
 namespace alsuq {
 namespace run {
@@ -28,7 +31,7 @@ Runner::Runner(std::shared_ptr<SimulatorCreator> simulatorCreator,
     : simulatorCreator(simulatorCreator),
       sampleGenerator(sampleGenerator),
       parameterNames(sampleGenerator->getParameterList()),
-      sampleNumbers(sampleNumbers),
+      sampleScheduler(std::make_shared<mpi::StaticSampleScheduler>(sampleNumbers)),
       mpiConfig(mpiConfig),
       name(name)
 
@@ -36,51 +39,62 @@ Runner::Runner(std::shared_ptr<SimulatorCreator> simulatorCreator,
 
 }
 
+Runner::Runner(std::shared_ptr<SimulatorCreator> simulatorCreator,
+    std::shared_ptr<samples::SampleGenerator> sampleGenerator,
+    mpi::SampleSchedulerPtr sampleScheduler,
+    alsutils::mpi::ConfigurationPtr mpiConfig,
+    const std::string& name)
+    : simulatorCreator(simulatorCreator),
+      sampleGenerator(sampleGenerator),
+      parameterNames(sampleGenerator->getParameterList()),
+      sampleScheduler(sampleScheduler),
+      mpiConfig(mpiConfig),
+      name(name) {
+
+}
+
 void Runner::run() {
     std::shared_ptr<alsfvm::grid::Grid> grid;
 
-    for (size_t sample : sampleNumbers) {
-        ALSVINN_LOG(INFO, "Running sample: " << sample << std::endl);
-        alsfvm::init::Parameters parameters;
+    for (auto sampleNumbers = sampleScheduler->nextSamples();
+        !sampleNumbers.empty(); sampleNumbers = sampleScheduler->nextSamples()) {
+        for (size_t first = 0; first < sampleNumbers.size(); first += ensembleSize) {
+            const std::vector<size_t> samples(sampleNumbers.begin() + first,
+                sampleNumbers.begin() + std::min(first + ensembleSize,
+                    sampleNumbers.size()));
 
-        for (auto parameterName : parameterNames) {
-            auto samples = sampleGenerator->generate(parameterName, sample);
-            parameters.addParameter(parameterName,
-                samples);
+            auto simulator = createSimulator(samples);
 
-        }
+            for ( auto& statisticWriter : statistics) {
+                simulator->addWriter(std::dynamic_pointer_cast<alsfvm::io::Writer>
+                    (statisticWriter));
 
-        auto simulator = simulatorCreator->createSimulator(parameters, sample);
+                auto timestepAdjuster =
+                    alsfvm::dynamic_pointer_cast<alsfvm::integrator::TimestepAdjuster>
+                    (statisticWriter);
 
-        for ( auto& statisticWriter : statistics) {
-            simulator->addWriter(std::dynamic_pointer_cast<alsfvm::io::Writer>
-                (statisticWriter));
+                if (timestepAdjuster) {
+                    simulator->addTimestepAdjuster(timestepAdjuster);
+                }
+            }
 
-            auto timestepAdjuster =
-                alsfvm::dynamic_pointer_cast<alsfvm::integrator::TimestepAdjuster>
-                (statisticWriter);
+            simulator->callWriters();
 
-            if (timestepAdjuster) {
-                simulator->addTimestepAdjuster(timestepAdjuster);
+            while (!simulator->atEnd()) {
+                simulator->performStep();
+                timestepsPerformedTotal += samples.size();
             }
-        }
 
-        simulator->callWriters();
+            simulator->finalize();
+            grid = simulator->getGrid();
 
-        while (!simulator->atEnd()) {
-            simulator->performStep();
-            timestepsPerformedTotal++;
         }
-
-        simulator->finalize();
-        grid = simulator->getGrid();
-
     }
 
     for (auto& statisticsWriter : statistics) {
         statisticsWriter->combineStatistics();
 
-        if (mpiConfig->getRank() == 0) {
+        if (scatterStatistics || mpiConfig->getRank() == 0) {
             statisticsWriter->finalizeStatistics();
             statisticsWriter->writeStatistics(*grid);
         }
@@ -103,5 +117,49 @@ size_t Runner::getTimestepsPerformedTotal() const {
     return timestepsPerformedTotal;
 }
 
+void Runner::setEnsembleSize(size_t ensembleSize) {
+    if (ensembleSize == 0) {
+        THROW("The ensemble size has to be at least one");
+    }
+
+    this->ensembleSize = ensembleSize;
+}
+
+void Runner::setScatterStatistics(bool scatterStatistics) {
+    this->scatterStatistics = scatterStatistics;
+}
+
+alsfvm::shared_ptr<alsfvm::simulator::AbstractSimulator>
+Runner::createSimulator(const std::vector<size_t>& samples) {
+    if (ensembleSize == 1) {
+        ALSVINN_LOG(INFO, "Running sample: " << samples[0] << std::endl);
+        return simulatorCreator->createSimulator(makeParameters(samples[0]),
+                samples[0]);
+    }
+
+    ALSVINN_LOG(INFO, "Running samples " << samples.front() << " to "
+        << samples.back() << " as an ensemble" << std::endl);
+    std::vector<alsfvm::init::Parameters> parameters;
+
+    for (size_t sample : samples) {
+        parameters.push_back(makeParameters(sample));
+    }
+
+    return simulatorCreator->createEnsembleSimulator(parameters, samples);
+}
+
+alsfvm::init::Parameters Runner::makeParameters(size_t sample) {
+    alsfvm::init::Parameters parameters;
+
+    for (auto parameterName : parameterNames) {
+        auto samples = sampleGenerator->generate(parameterName, sample);
+        parameters.addParameter(parameterName,
+            samples);
+
+    }
+
+    return parameters;
+}
+
 }
 }
@@ -61,12 +61,34 @@ void FixedIntervalStatistics::finalizeStatistics() {
     statistics->finalizeStatistics();
 }
 
+bool FixedIntervalStatistics::supportsScatteredStatistics() const {
+    return statistics->supportsScatteredStatistics();
+}
+
 void FixedIntervalStatistics::computeStatistics(const alsfvm::volume::Volume&
     conservedVariables,
     const alsfvm::grid::Grid& grid,
     const alsfvm::simulator::TimestepInformation& timestepInformation) {
+    if (isSaveTime(timestepInformation)) {
+        statistics->computeStatistics(conservedVariables, grid,
+            timestepInformation);
+        numberSaved++;
+    }
+}
 
+void FixedIntervalStatistics::computeStatisticsEnsemble(
+    const alsfvm::volume::Volume& conservedVariables,
+    const alsfvm::grid::Grid& grid,
+    const alsfvm::simulator::TimestepInformation& timestepInformation) {
+    if (isSaveTime(timestepInformation)) {
+        statistics->computeStatisticsEnsemble(conservedVariables, grid,
+            timestepInformation);
+        numberSaved++;
+    }
+}
 
+bool FixedIntervalStatistics::isSaveTime(const
+    alsfvm::simulator::TimestepInformation& timestepInformation) {
     const real currentTime = timestepInformation.getCurrentTime();
 
     // First check if we have restarted
@@ -79,10 +101,10 @@ void FixedIntervalStatistics::computeStatistics(const alsfvm::volume::Volume&
             << "\n\tnumberSaves = " << numberSaved
             << "\n\ttimeInterval = " << timeInterval
             << "\n\tendTime = " << endTime);
-        statistics->computeStatistics(conservedVariables, grid,
-            timestepInformation);
-        numberSaved++;
+        return true;
     }
+
+    return false;
 }
 
 }
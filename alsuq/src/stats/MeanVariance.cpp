@@ -15,8 +15,19 @@
 
 #include "alsuq/stats/MeanVariance.hpp"
 #include "alsuq/stats/stats_util.hpp"
+#include "alsuq/stats/Welford.hpp"
+#include "alsuq/stats/PackedReduction.hpp"
+#include "alsuq/stats/ScatteredReduction.hpp"
+#include "alsfvm/volume/ensemble.hpp"
+#include <algorithm>
+#include <array>
+
 namespace alsuq {
 namespace stats {
+namespace {
+// The mean and M2 over the members are kept for this many values at a time
+const size_t ensembleBlockSize = 256;
+}
 
 MeanVariance::MeanVariance(const StatisticsParameters& parameters)
     : StatisticsHelper(parameters) {
@@ -41,29 +52,262 @@ void MeanVariance::computeStatistics(const alsfvm::volume::Volume&
             timestepInformation,
             conservedVariables);
 
+    const real count = real(++numberOfSamples[timestepInformation.getCurrentTime()]);
+
+    if (!deviation
+        || !(deviation->getTotalDimensions() == conservedVariables.getTotalDimensions())) {
+        deviation = conservedVariables.makeInstance();
+    }
+
+    auto& meanVolume = *mean.getVolumes().getConservedVolume();
+    auto& m2Volume = *variance.getVolumes().getConservedVolume();
+
+    // Welford's update, written with the memory operations so that it runs
+    // on every platform
+    for (size_t var = 0; var < conservedVariables.getNumberOfVariables(); ++var) {
+        auto& deviationMemory = *deviation->getScalarMemoryArea(var);
+        auto& meanMemory = *meanVolume.getScalarMemoryArea(var);
+
+        deviationMemory.copyFrom(*conservedVariables.getScalarMemoryArea(var));
+        deviationMemory -= meanMemory;
+        meanMemory.assign(real(1) * meanMemory + (1 / count) * deviationMemory);
+        m2Volume.getScalarMemoryArea(var)->addPower(deviationMemory, 2,
+            (count - 1) / count);
+    }
+}
 
+void MeanVariance::computeStatisticsEnsemble(const alsfvm::volume::Volume&
+    conservedVariables,
+    const alsfvm::grid::Grid& grid,
+    const alsfvm::simulator::TimestepInformation& timestepInformation) {
+    namespace volume = alsfvm::volume;
+    const size_t direction = volume::getEnsembleDirection(grid);
+    const size_t ensembleSize = volume::getEnsembleSize(conservedVariables,
+            direction);
+    const size_t memberSize = volume::getEnsembleMemberSize(conservedVariables,
+            direction);
+    const size_t firstMember = volume::getEnsembleMemberOffset(conservedVariables,
+            direction, 0);
 
-    *mean.getVolumes().getConservedVolume() += conservedVariables;
+    // The snapshots have the size of a single member
+    auto member = volume::makeEnsembleMemberVolume(conservedVariables, direction);
 
+    auto& mean = findOrCreateSnapshot("mean",
+            timestepInformation,
+            *member);
 
-    variance.getVolumes().getConservedVolume()->addPower(conservedVariables, 2);
+    auto& variance = findOrCreateSnapshot("variance",
+            timestepInformation,
+            *member);
 
+    auto& count = numberOfSamples[timestepInformation.getCurrentTime()];
+    const real previousCount = real(count);
+    count += ensembleSize;
 
+    auto& meanVolume = *mean.getVolumes().getConservedVolume();
+    auto& m2Volume = *variance.getVolumes().getConservedVolume();
+    const size_t numberOfBlocks = (memberSize + ensembleBlockSize - 1)
+        / ensembleBlockSize;
 
+    for (size_t var = 0; var < conservedVariables.getNumberOfVariables(); ++var) {
+        const real* values = conservedVariables.getScalarMemoryArea(
+                var)->getPointer() + firstMember;
+        real* meanValues = meanVolume.getScalarMemoryArea(var)->getPointer();
+        real* m2Values = m2Volume.getScalarMemoryArea(var)->getPointer();
+
+        #pragma omp parallel for
+
+        for (size_t block = 0; block < numberOfBlocks; ++block) {
+            const size_t begin = block * ensembleBlockSize;
+            const size_t length = std::min(ensembleBlockSize, memberSize - begin);
+            std::array<WelfordState<real>, ensembleBlockSize> batch;
+
+            for (size_t m = 0; m < ensembleSize; ++m) {
+                const real* memberValues = values + m * memberSize + begin;
+
+                for (size_t i = 0; i < length; ++i) {
+                    batch[i].add(memberValues[i]);
+                }
+            }
+
+            for (size_t i = 0; i < length; ++i) {
+                WelfordState<real> snapshot;
+                snapshot.count = previousCount;
+                snapshot.mean = meanValues[begin + i];
+                snapshot.m2 = m2Values[begin + i];
+                snapshot.merge(batch[i]);
+
+                meanValues[begin + i] = snapshot.mean;
+                m2Values[begin + i] = snapshot.m2;
+            }
+        }
+    }
 }
 
-void MeanVariance::finalizeStatistics() {
+void MeanVariance::combineStatistics() {
+    if (scatterStatistics) {
+        scatterSnapshots();
+        return;
+    }
+
+    PackedReduction<WelfordState<real> > reduction(getWelfordMpiType(),
+        getWelfordMpiOperation(), 0, mpiConfig->getCommunicator());
+
+    std::vector<std::pair<std::shared_ptr<alsfvm::memory::Memory<real> >,
+        std::shared_ptr<alsfvm::memory::Memory<real> > > > stagedOnHost;
+
+    for (auto& snapshot : this->snapshots) {
+        auto& meanVolume = *snapshot.second["mean"].getVolumes().getConservedVolume();
+        auto& m2Volume = *snapshot.second["variance"].getVolumes().getConservedVolume();
+        // The count is overwritten with the total on rank 0 as soon as the
+        // first variable is unpacked, so the packing uses a copy
+        size_t* count = &numberOfSamples[snapshot.first];
+        const real localCount = real(*count);
+
+        for (size_t var = 0; var < meanVolume.getNumberOfVariables(); ++var) {
+            auto meanMemory = meanVolume.getScalarMemoryArea(var);
+            auto m2Memory = m2Volume.getScalarMemoryArea(var);
+            auto meanOnHost = meanMemory->getHostMemory();
+            auto m2OnHost = m2Memory->getHostMemory();
+
+            if (!meanMemory->isOnHost()) {
+                stagedOnHost.push_back({meanMemory, meanOnHost});
+                stagedOnHost.push_back({m2Memory, m2OnHost});
+            }
+
+            real* mean = meanOnHost->getPointer();
+            real* m2 = m2OnHost->getPointer();
+
+            reduction.addSegment(meanOnHost->getSize(),
+            [mean, m2, localCount](size_t begin, size_t length,
+            WelfordState<real>* buffer) {
+                for (size_t i = 0; i < length; ++i) {
+                    buffer[i].count = localCount;
+                    buffer[i].mean = mean[begin + i];
+                    buffer[i].m2 = m2[begin + i];
+                }
+            },
+            [mean, m2, count](size_t begin, size_t length,
+            const WelfordState<real>* buffer) {
+                for (size_t i = 0; i < length; ++i) {
+                    mean[begin + i] = buffer[i].mean;
+                    m2[begin + i] = buffer[i].m2;
+                }
+
+                if (length > 0) {
+                    *count = size_t(buffer[0].count);
+                }
+            });
+        }
+    }
+
+    reduction.reduce();
+
+    if (mpiConfig->getRank() == 0) {
+        for (auto& staged : stagedOnHost) {
+            staged.first->copyFrom(*staged.second);
+        }
+    }
+}
+
+void MeanVariance::scatterSnapshots() {
+    if (this->snapshots.empty()) {
+        return;
+    }
+
+    const auto& layout = makeSlabLayout(
+            *this->snapshots.begin()->second["mean"].getVolumes().getConservedVolume());
+
+    ScatteredReduction<WelfordState<real> > reduction(getWelfordMpiType(),
+        getWelfordMpiOperation(), mpiConfig->getCommunicator(), layout.begins,
+        layout.counts);
+
+    std::vector<std::pair<std::shared_ptr<alsfvm::memory::Memory<real> >,
+        std::shared_ptr<alsfvm::memory::Memory<real> > > > stagedOnHost;
+    // The slab pointers below point at the start of the range of this process
+    const size_t rangeBegin = layout.begins[mpiConfig->getRank()];
+
     for (auto& snapshot : this->snapshots) {
-        auto& secondMoment = snapshot.second["variance"];
-        auto& volumesMoment = secondMoment.getVolumes();
+        auto& meanSnapshot = snapshot.second["mean"];
+        auto& varianceSnapshot = snapshot.second["variance"];
+        auto meanVolume = meanSnapshot.getVolumes().getConservedVolume();
+        auto m2Volume = varianceSnapshot.getVolumes().getConservedVolume();
+        auto meanSlab = makeSlabVolume(*meanVolume);
+        auto m2Slab = makeSlabVolume(*m2Volume);
+        const size_t slabOffset = getSlabOffset(*meanSlab);
+
+        size_t* count = &numberOfSamples[snapshot.first];
+        const real localCount = real(*count);
+
+        for (size_t var = 0; var < meanVolume->getNumberOfVariables(); ++var) {
+            auto meanOnHost = meanVolume->getScalarMemoryArea(var)->getHostMemory();
+            auto m2OnHost = m2Volume->getScalarMemoryArea(var)->getHostMemory();
+            auto meanSlabData = meanSlab->getScalarMemoryArea(var);
+            auto m2SlabData = m2Slab->getScalarMemoryArea(var);
+            auto meanSlabOnHost = meanSlabData->getHostMemory();
+            auto m2SlabOnHost = m2SlabData->getHostMemory();
 
-        auto& mean = snapshot.second["mean"];
-        auto& volumesMean = mean.getVolumes();
+            if (!meanSlabData->isOnHost()) {
+                stagedOnHost.push_back({meanSlabData, meanSlabOnHost});
+                stagedOnHost.push_back({m2SlabData, m2SlabOnHost});
+            }
 
-        volumesMoment.getConservedVolume()->subtractPower(
-            *volumesMean.getConservedVolume(), 2.);
+            real* meanSlabPointer = meanSlabOnHost->getPointer() + slabOffset;
+            real* m2SlabPointer = m2SlabOnHost->getPointer() + slabOffset;
 
+            reduction.addBuffer([meanOnHost, m2OnHost, localCount](size_t begin,
+            size_t length, WelfordState<real>* buffer) {
+                const real* mean = meanOnHost->getPointer();
+                const real* m2 = m2OnHost->getPointer();
+
+                for (size_t i = 0; i < length; ++i) {
+                    buffer[i].count = localCount;
+                    buffer[i].mean = mean[begin + i];
+                    buffer[i].m2 = m2[begin + i];
+                }
+            },
+            [meanSlabPointer, m2SlabPointer, rangeBegin, count](size_t begin,
+            size_t length, const WelfordState<real>* buffer) {
+                for (size_t i = 0; i < length; ++i) {
+                    meanSlabPointer[begin - rangeBegin + i] = buffer[i].mean;
+                    m2SlabPointer[begin - rangeBegin + i] = buffer[i].m2;
+                }
+
+                if (length > 0) {
+                    *count = size_t(buffer[0].count);
+                }
+            });
+        }
+
+        reduction.reduceBuffers();
+
+        // The full snapshots are packed, so they can be released already
+        meanSnapshot = StatisticsSnapshot(meanSnapshot.getTimestepInformation(),
+                alsfvm::volume::VolumePair(meanSlab));
+        varianceSnapshot = StatisticsSnapshot(
+                varianceSnapshot.getTimestepInformation(),
+                alsfvm::volume::VolumePair(m2Slab));
     }
+
+    reduction.finish();
+
+    for (auto& staged : stagedOnHost) {
+        staged.first->copyFrom(*staged.second);
+    }
+}
+
+void MeanVariance::finalizeStatistics() {
+    for (auto& snapshot : this->snapshots) {
+        auto& variance = snapshot.second["variance"];
+        const real count = real(numberOfSamples[snapshot.first]);
+
+        // M2 / n
+        *variance.getVolumes().getConservedVolume() *= 1 / count;
+    }
+}
+
+bool MeanVariance::supportsScatteredStatistics() const {
+    return true;
 }
 REGISTER_STATISTICS(cpu, meanvar, MeanVariance)
 REGISTER_STATISTICS(cuda, meanvar, MeanVariance)
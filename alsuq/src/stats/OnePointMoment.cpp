@@ -37,15 +37,34 @@ void OnePointMoment::computeStatistics(const alsfvm::volume::Volume&
             timestepInformation,
             conservedVariables);
 
+    const real count = real(++numberOfSamples[timestepInformation.getCurrentTime()]);
+    auto& moment = *m.getVolumes().getConservedVolume();
 
+    // m_n = (n - 1) / n * m_{n-1} + u^p / n
+    for (size_t var = 0; var < conservedVariables.getNumberOfVariables(); ++var) {
+        auto& momentMemory = *moment.getScalarMemoryArea(var);
+        momentMemory *= (count - 1) / count;
+        momentMemory.addPower(*conservedVariables.getScalarMemoryArea(var), p,
+            1 / count);
+    }
+}
 
+void OnePointMoment::finalizeStatistics() {
 
+}
 
-    m.getVolumes().getConservedVolume()->addPower(conservedVariables, p);
+bool OnePointMoment::supportsScatteredStatistics() const {
+    return true;
 }
 
-void OnePointMoment::finalizeStatistics() {
+real OnePointMoment::getCombineWeight(real time) const {
+    auto samplesAtTime = numberOfSamples.find(time);
+
+    if (samplesAtTime == numberOfSamples.end()) {
+        return 0;
+    }
 
+    return real(samplesAtTime->second);
 }
 
 REGISTER_STATISTICS(cpu, onepointmoment, OnePointMoment)
@@ -15,6 +15,7 @@
 
 #include "alsuq/stats/Statistics.hpp"
 #include "alsuq/mpi/utils.hpp"
+#include "alsfvm/volume/ensemble.hpp"
 namespace alsuq {
 namespace stats {
 
@@ -25,6 +26,29 @@ void Statistics::write(const alsfvm::volume::Volume& conservedVariables,
         timestepInformation);
 }
 
+void Statistics::writeEnsemble(const alsfvm::volume::Volume& conservedVariables,
+    const alsfvm::grid::Grid& grid,
+    const alsfvm::simulator::TimestepInformation& timestepInformation) {
+    computeStatisticsEnsemble(conservedVariables, grid, timestepInformation);
+}
+
+void Statistics::computeStatisticsEnsemble(const alsfvm::volume::Volume&
+    conservedVariables,
+    const alsfvm::grid::Grid& grid,
+    const alsfvm::simulator::TimestepInformation& timestepInformation) {
+    const size_t direction = alsfvm::volume::getEnsembleDirection(grid);
+    auto member = alsfvm::volume::makeEnsembleMemberVolume(conservedVariables,
+            direction);
+    const size_t ensembleSize = alsfvm::volume::getEnsembleSize(conservedVariables,
+            direction);
+
+    for (size_t m = 0; m < ensembleSize; ++m) {
+        alsfvm::volume::copyFromEnsembleMember(conservedVariables, direction, m,
+            *member);
+        computeStatistics(*member, grid, timestepInformation);
+    }
+}
+
 
 
 }
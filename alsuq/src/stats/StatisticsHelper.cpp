@@ -15,15 +15,18 @@
 
 #include "alsuq/stats/StatisticsHelper.hpp"
 #include "alsuq/mpi/utils.hpp"
-#include "alsutils/mpi/cuda.hpp"
 #include "alsutils/log.hpp"
 #include "alsutils/mpi/mpi_types.hpp"
+#include "alsuq/stats/PackedReduction.hpp"
+#include "alsuq/stats/ScatteredReduction.hpp"
+#include <algorithm>
 namespace alsuq {
 namespace stats {
 StatisticsHelper::StatisticsHelper(const StatisticsParameters& parameters)
 
-    : samples(parameters.getNumberOfSamples()),
-      mpiConfig(parameters.getMpiConfiguration()) {
+    : mpiConfig(parameters.getMpiConfiguration()),
+      scatterStatistics(parameters.getScatterStatistics()),
+      samples(parameters.getNumberOfSamples()) {
 
 }
 
@@ -33,52 +36,235 @@ void StatisticsHelper::addWriter(const std::string& name,
 }
 
 void StatisticsHelper::combineStatistics() {
+    if (scatterStatistics) {
+        scatterSnapshots();
+        return;
+    }
+
+    // All snapshots are summed onto rank 0 in a few large reductions, see
+    // PackedReduction. Memory on the GPU is staged through the host. Only
+    // rank 0 unpacks, so the other processes keep their undivided sums.
+    PackedReduction<real> reduction(alsutils::mpi::MpiTypes<real>::MPI_Real,
+        MPI_SUM, 0, mpiConfig->getCommunicator());
+
+    std::vector<std::pair<std::shared_ptr<alsfvm::memory::Memory<real> >,
+        std::shared_ptr<alsfvm::memory::Memory<real> > > > stagedOnHost;
 
     for (auto& snapshot : snapshots) {
+        const real weight = getCombineWeight(snapshot.first);
+
         for (auto& statistics : snapshot.second) {
             for (auto& volume : statistics.second.getVolumes()) {
 
                 for (size_t variable = 0; variable < volume->getNumberOfVariables();
                     variable++) {
 
+                    auto statisticsData = volume->getScalarMemoryArea(variable);
+                    auto statisticsDataOnHost = statisticsData->getHostMemory();
 
+                    if (!statisticsData->isOnHost()) {
+                        stagedOnHost.push_back({statisticsData, statisticsDataOnHost});
+                    }
 
-                    auto statisticsData = volume->getScalarMemoryArea(variable);
-                    auto statisticsDataToReduce = statisticsData;
+                    real* data = statisticsDataOnHost->getPointer();
+                    const real numberOfSamples = real(samples);
+
+                    reduction.addSegment(statisticsDataOnHost->getSize(),
+                    [data, weight](size_t begin, size_t count, real * buffer) {
+                        for (size_t i = 0; i < count; ++i) {
+                            buffer[i] = weight * data[begin + i];
+                        }
+                    },
+                    [data, numberOfSamples](size_t begin, size_t count,
+                    const real * buffer) {
+                        for (size_t i = 0; i < count; ++i) {
+                            data[begin + i] = buffer[i] / numberOfSamples;
+                        }
+                    });
+                }
+            }
+        }
+    }
+
+    reduction.reduce();
+
+    if (mpiConfig->getRank() == 0) {
+        for (auto& staged : stagedOnHost) {
+            staged.first->copyFrom(*staged.second);
+        }
+    }
+}
 
+void StatisticsHelper::scatterSnapshots() {
+    if (snapshots.empty()) {
+        return;
+    }
 
-                    // Check if we should copy to CPU
-                    if (!statisticsData->isOnHost() && !alsutils::mpi::hasGPUDirectSupport()) {
+    const auto& layout = makeSlabLayout(
+            *snapshots.begin()->second.begin()->second.getVolumes().getConservedVolume());
 
-                        statisticsDataToReduce = statisticsData->getHostMemory();
+    ScatteredReduction<real> reduction(alsutils::mpi::MpiTypes<real>::MPI_Real,
+        MPI_SUM, mpiConfig->getCommunicator(), layout.begins, layout.counts);
 
-                        ALSVINN_LOG(INFO, "Copying from GPU, now statisticsDataToReduce.isOnHost() = "
-                            << statisticsDataToReduce->isOnHost() );
+    std::vector<std::pair<std::shared_ptr<alsfvm::memory::Memory<real> >,
+        std::shared_ptr<alsfvm::memory::Memory<real> > > > stagedOnHost;
+    const real numberOfSamples = real(samples);
+    // The slab pointers below point at the start of the range of this process
+    const size_t rangeBegin = layout.begins[mpiConfig->getRank()];
 
-                    }
+    for (auto& snapshot : snapshots) {
+        std::map<std::string, std::shared_ptr<alsfvm::volume::Volume> > slabs;
+        const real weight = getCombineWeight(snapshot.first);
 
+        for (auto& statistics : snapshot.second) {
+            auto volume = statistics.second.getVolumes().getConservedVolume();
+
+            if (!(volume->getTotalDimensions() == snapshots.begin()->second.begin()
+                    ->second.getVolumes().getConservedVolume()->getTotalDimensions())) {
+                THROW("All snapshots need the same size to be scattered, "
+                    << statistics.first << " does not have it.");
+            }
 
-                    std::shared_ptr<alsfvm::memory::Memory<real> > dataReduced;
-                    //if (mpiConfig.getRank() == 0) {
-                    dataReduced = statisticsDataToReduce->makeInstance();
-                    //}
-                    MPI_SAFE_CALL(MPI_Reduce(statisticsDataToReduce->data(), dataReduced->data(),
-                            statisticsDataToReduce->getSize(), alsutils::mpi::MpiTypes<real>::MPI_Real,
-                            MPI_SUM, 0,
-                            mpiConfig->getCommunicator()));
+            auto slab = makeSlabVolume(*volume);
+            const size_t slabOffset = getSlabOffset(*slab);
+            slabs[statistics.first] = slab;
 
-                    if (mpiConfig->getRank() == 0) {
-                        statisticsData->copyFrom(*dataReduced);
-                    }
+            for (size_t variable = 0; variable < volume->getNumberOfVariables();
+                variable++) {
+                auto dataOnHost = volume->getScalarMemoryArea(variable)->getHostMemory();
+                auto slabData = slab->getScalarMemoryArea(variable);
+                auto slabDataOnHost = slabData->getHostMemory();
 
-                    *statisticsData /= samples;
+                if (!slabData->isOnHost()) {
+                    stagedOnHost.push_back({slabData, slabDataOnHost});
                 }
+
+                real* slabPointer = slabDataOnHost->getPointer() + slabOffset;
+
+                reduction.addBuffer([dataOnHost, weight](size_t begin, size_t count,
+                real * buffer) {
+                    const real* data = dataOnHost->getPointer() + begin;
+
+                    for (size_t i = 0; i < count; ++i) {
+                        buffer[i] = weight * data[i];
+                    }
+                },
+                [slabPointer, rangeBegin, numberOfSamples](size_t begin, size_t count,
+                const real * buffer) {
+                    for (size_t i = 0; i < count; ++i) {
+                        slabPointer[begin - rangeBegin + i] = buffer[i] / numberOfSamples;
+                    }
+                });
             }
         }
+
+        reduction.reduceBuffers();
+
+        // The full snapshots are packed, so they can be released already
+        for (auto& statistics : snapshot.second) {
+            statistics.second = StatisticsSnapshot(
+                    statistics.second.getTimestepInformation(),
+                    alsfvm::volume::VolumePair(slabs[statistics.first]));
+        }
+    }
+
+    reduction.finish();
+
+    for (auto& staged : stagedOnHost) {
+        staged.first->copyFrom(*staged.second);
+    }
+}
+
+real StatisticsHelper::getCombineWeight(real) const {
+    return 1;
+}
+
+const StatisticsHelper::SlabLayout& StatisticsHelper::makeSlabLayout(
+    const alsfvm::volume::Volume& volume) {
+    const auto innerSize = volume.getInnerSize();
+    const auto ghostCells = volume.getNumberOfGhostCells();
+    const auto totalSize = volume.getTotalDimensions();
+
+    slabLayout.reset(new SlabLayout());
+    auto& layout = *slabLayout;
+
+    layout.direction = innerSize.z > 1 ? 2 : (innerSize.y > 1 ? 1 : 0);
+    layout.planeSize = 1;
+
+    for (size_t d = 0; d < layout.direction; ++d) {
+        layout.planeSize *= totalSize[d];
+    }
+
+    const int cells = innerSize[layout.direction];
+    const int numberOfProcesses = mpiConfig->getNumberOfProcesses();
+
+    if (cells < numberOfProcesses) {
+        THROW("Can not scatter the statistics over " << numberOfProcesses
+            << " processes, there are only " << cells << " cells in direction "
+            << layout.direction << ". Use fewer sample groups, or do not set "
+            << "scatterStatistics.");
+    }
+
+    int firstCell = 0;
+
+    for (int process = 0; process < numberOfProcesses; ++process) {
+        const int numberOfCells = cells / numberOfProcesses
+            + int(process < cells % numberOfProcesses);
+
+        layout.firstCells.push_back(firstCell);
+        layout.numberOfCells.push_back(numberOfCells);
+        layout.begins.push_back((ghostCells[layout.direction] + firstCell)
+            * layout.planeSize);
+        layout.counts.push_back(numberOfCells * layout.planeSize);
+
+        firstCell += numberOfCells;
     }
+
+    return layout;
+}
+
+std::shared_ptr<alsfvm::volume::Volume> StatisticsHelper::makeSlabVolume(
+    const alsfvm::volume::Volume& volume) const {
+    auto numberOfCells = volume.getInnerSize();
+    numberOfCells[slabLayout->direction] =
+        slabLayout->numberOfCells[mpiConfig->getRank()];
+
+    auto slab = volume.makeInstance(numberOfCells);
+    slab->makeZero();
+    return slab;
+}
+
+size_t StatisticsHelper::getSlabOffset(const alsfvm::volume::Volume& slabVolume)
+const {
+    return slabVolume.getNumberOfGhostCells()[slabLayout->direction]
+        * slabLayout->planeSize;
 }
 
 void StatisticsHelper::writeStatistics(const alsfvm::grid::Grid& grid) {
+    std::unique_ptr<alsfvm::grid::Grid> slabGrid;
+
+    if (slabLayout) {
+        const size_t direction = slabLayout->direction;
+        const int rank = mpiConfig->getRank();
+        const int firstCell = slabLayout->firstCells[rank];
+        const int numberOfCells = slabLayout->numberOfCells[rank];
+
+        const auto cellLengths = grid.getCellLengths();
+        auto origin = grid.getOrigin();
+        auto top = grid.getTop();
+        auto dimensions = grid.getDimensions();
+        auto globalPosition = grid.getGlobalPosition();
+
+        origin[direction] += firstCell * cellLengths[direction];
+        top[direction] = origin[direction] + numberOfCells * cellLengths[direction];
+        dimensions[direction] = numberOfCells;
+        globalPosition[direction] += firstCell;
+
+        slabGrid.reset(new alsfvm::grid::Grid(origin, top, dimensions,
+                grid.getBoundaryConditions(), globalPosition, grid.getGlobalSize(),
+                cellLengths));
+    }
+
     for (auto& snapshot : snapshots) {
         for (auto& statistics : snapshot.second) {
             const auto& statisticsName = statistics.first;
@@ -90,6 +276,9 @@ void StatisticsHelper::writeStatistics(const alsfvm::grid::Grid& grid) {
                 if (ownGrid) {
                     writer->write(*volumes.getConservedVolume(),
                         *ownGrid, timestepInformation);
+                } else if (slabGrid) {
+                    writer->write(*volumes.getConservedVolume(),
+                        *slabGrid, timestepInformation);
                 } else {
                     writer->write(*volumes.getConservedVolume(),
                         grid, timestepInformation);
@@ -48,5 +48,13 @@ std::string StatisticsParameters::getPlatform() const {
     return platform;
 }
 
+void StatisticsParameters::setScatterStatistics(bool scatterStatistics) {
+    this->scatterStatistics = scatterStatistics;
+}
+
+bool StatisticsParameters::getScatterStatistics() const {
+    return scatterStatistics;
+}
+
 }
 }
@@ -81,6 +81,10 @@ void StatisticsTimer::finalizeStatistics() {
         (endTime - startTime).count();
 }
 
+bool StatisticsTimer::supportsScatteredStatistics() const {
+    return statistics->supportsScatteredStatistics();
+}
+
 void StatisticsTimer::writeStatistics(const alsfvm::grid::Grid& grids) {
     statistics->writeStatistics(grids);
 }
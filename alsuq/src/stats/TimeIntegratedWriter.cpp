@@ -50,6 +50,10 @@ void TimeIntegratedWriter::finalizeStatistics() {
     statistics->finalizeStatistics();
 }
 
+bool TimeIntegratedWriter::supportsScatteredStatistics() const {
+    return statistics->supportsScatteredStatistics();
+}
+
 void TimeIntegratedWriter::computeStatistics(const alsfvm::volume::Volume&
     conservedVariables,
     const alsfvm::grid::Grid& grid,
@@ -63,5 +67,13 @@ void TimeIntegratedWriter::computeStatistics(const alsfvm::volume::Volume&
 
 }
 
+void TimeIntegratedWriter::computeStatisticsEnsemble(
+    const alsfvm::volume::Volume& conservedVariables,
+    const alsfvm::grid::Grid& grid,
+    const alsfvm::simulator::TimestepInformation& timestepInformation) {
+    statistics->computeStatisticsEnsemble(conservedVariables, grid,
+        timestepInformation);
+}
+
 }
 }
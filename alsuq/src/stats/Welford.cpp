@@ -0,0 +1,58 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "alsuq/stats/Welford.hpp"
+#include "alsuq/mpi/utils.hpp"
+#include "alsutils/mpi/mpi_types.hpp"
+
+namespace alsuq {
+namespace stats {
+namespace {
+void mergeWelfordStates(void* in, void* inOut, int* length, MPI_Datatype*) {
+    const auto* states = static_cast<const WelfordState<real>*>(in);
+    auto* mergedStates = static_cast<WelfordState<real>*>(inOut);
+
+    for (int i = 0; i < *length; ++i) {
+        mergedStates[i].merge(states[i]);
+    }
+}
+}
+
+MPI_Datatype getWelfordMpiType() {
+    static_assert(sizeof(WelfordState<real>) == 3 * sizeof(real),
+        "WelfordState<real> has to be three consecutive reals");
+    static MPI_Datatype welfordType = []() {
+        MPI_Datatype type;
+        MPI_SAFE_CALL(MPI_Type_contiguous(3, alsutils::mpi::MpiTypes<real>::MPI_Real,
+                &type));
+        MPI_SAFE_CALL(MPI_Type_commit(&type));
+        return type;
+    }();
+
+    return welfordType;
+}
+
+MPI_Op getWelfordMpiOperation() {
+    static MPI_Op welfordOperation = []() {
+        MPI_Op operation;
+        // The merge is commutative up to rounding, like MPI_SUM is
+        MPI_SAFE_CALL(MPI_Op_create(&mergeWelfordStates, 1, &operation));
+        return operation;
+    }();
+
+    return welfordOperation;
+}
+}
+}
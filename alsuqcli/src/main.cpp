@@ -23,6 +23,7 @@
 #include "alsutils/config.hpp"
 #include "alsutils/write_run_report.hpp"
 #include "alsutils/mpi/set_cuda_device.hpp"
+#include "alsutils/mpi/safe_call.hpp"
 #include "alsutils/timer/Timer.hpp"
 
 int main(int argc, char** argv) {
@@ -108,7 +109,12 @@ int main(int argc, char** argv) {
 
 
         alsutils::mpi::setCudaDevice();
-        MPI_Init(&argc, &argv);
+
+        // The halo exchange is driven from a separate thread
+        // (see alsfvm::mpi::ProgressThread)
+        int threadSupport = MPI_THREAD_SINGLE;
+        MPI_SAFE_CALL(MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE,
+                &threadSupport));
 
         alsuq::mpi::ConfigurationPtr mpiConfig(new alsuq::mpi::Configuration(
                 MPI_COMM_WORLD));
@@ -117,6 +123,11 @@ int main(int argc, char** argv) {
                 mpiConfig->getRank())
             + ".txt");
 
+        if (threadSupport < MPI_THREAD_MULTIPLE) {
+            ALSVINN_LOG(WARNING, "MPI does not provide MPI_THREAD_MULTIPLE "
+                << "(provided level " << threadSupport << ").");
+        }
+
 
         alsutils::dumpInformationToLog();
         std::string inputfile = vm["input"].as<std::string>();
@@ -0,0 +1,97 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsutils/memory/AllocationPolicy.hpp"
+#include "alsutils/memory/MemoryPool.hpp"
+#include <new>
+#include <utility>
+
+namespace alsutils {
+namespace memory {
+
+//! Standard allocator handing out memory through allocateAligned.
+//! If it is given a pool, the blocks are recycled through that pool
+//! instead (see MemoryPool::getHostPool()).
+//!
+//! Unlike std::allocator, value initialization (eg. std::vector<T>(n))
+//! default initializes the elements. For arithmetic types this leaves
+//! the memory untouched, so the owner can do the first touch itself
+//! (see AllocationPolicy).
+template<class T>
+class AlignedAllocator {
+public:
+    typedef T value_type;
+
+    //! \param pool the pool to take the blocks from, or nullptr to
+    //!        allocate and free them directly
+    AlignedAllocator(MemoryPool* pool = nullptr)
+        : pool(pool) {}
+
+    template<class U>
+    AlignedAllocator(const AlignedAllocator<U>& other)
+        : pool(other.getPool()) {}
+
+    T* allocate(size_t n) {
+        if (pool) {
+            return static_cast<T*>(pool->acquire(n * sizeof(T)));
+        }
+
+        return static_cast<T*>(allocateAligned(n * sizeof(T),
+                    getAllocationPolicy()));
+    }
+
+    void deallocate(T* pointer, size_t n) {
+        if (pool) {
+            pool->release(pointer, n * sizeof(T));
+        } else {
+            deallocateAligned(pointer);
+        }
+    }
+
+    MemoryPool* getPool() const {
+        return pool;
+    }
+
+    template<class U>
+    void construct(U* pointer) {
+        ::new (static_cast<void*>(pointer)) U;
+    }
+
+    template<class U, class... Arguments>
+    void construct(U* pointer, Arguments&& ... arguments) {
+        ::new (static_cast<void*>(pointer)) U(std::forward<Arguments>(arguments)...);
+    }
+
+    template<class U>
+    struct rebind {
+        typedef AlignedAllocator<U> other;
+    };
+
+private:
+    MemoryPool* pool;
+};
+
+template<class T, class U>
+bool operator==(const AlignedAllocator<T>& a, const AlignedAllocator<U>& b) {
+    return a.getPool() == b.getPool();
+}
+
+template<class T, class U>
+bool operator!=(const AlignedAllocator<T>& a, const AlignedAllocator<U>& b) {
+    return !(a == b);
+}
+}
+}
@@ -0,0 +1,67 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <string>
+
+namespace alsutils {
+namespace memory {
+
+//! Decides how the host memory areas are allocated and first touched.
+//!
+//! On Linux a page is placed on the NUMA node of the thread that first
+//! writes to it. Touching the memory in parallel with the same (static)
+//! thread partition as the compute loops therefore keeps each thread's
+//! data on its own node.
+struct AllocationPolicy {
+    //! Touch the memory in parallel (with OpenMP) right after allocation,
+    //! otherwise the allocating thread touches all of it.
+    bool parallelFirstTouch = true;
+
+    //! Align large allocations to huge pages and advise the kernel to back
+    //! them with transparent huge pages (Linux only).
+    bool transparentHugePages = false;
+};
+
+//! The minimum alignment (in bytes) of every host allocation (a cache line)
+constexpr size_t minimumAlignment = 64;
+
+//! Gets the current allocation policy.
+//!
+//! The default can be changed through the environment variables
+//! ALSVINN_FIRST_TOUCH (parallel or serial) and ALSVINN_HUGE_PAGES
+//! (on or off).
+AllocationPolicy getAllocationPolicy();
+
+//! Overrides the allocation policy for all subsequent allocations
+void setAllocationPolicy(const AllocationPolicy& policy);
+
+//! \returns the alignment used for an allocation of the given size,
+//!          64 bytes for small allocations, a page (or huge page) for
+//!          larger ones.
+size_t getAlignment(size_t bytes, const AllocationPolicy& policy);
+
+//! Allocates uninitialized memory aligned according to getAlignment.
+//! Throws std::bad_alloc on failure.
+void* allocateAligned(size_t bytes, const AllocationPolicy& policy);
+
+//! Frees memory allocated with allocateAligned
+void deallocateAligned(void* pointer);
+
+//! Describes the policy, eg. "firstTouch=parallel, hugePages=off"
+std::string toString(const AllocationPolicy& policy);
+}
+}
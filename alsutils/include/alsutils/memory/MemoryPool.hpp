@@ -0,0 +1,129 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <boost/property_tree/ptree.hpp>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace alsutils {
+namespace memory {
+
+//! A size bucketed pool of raw memory blocks.
+//!
+//! Released blocks are kept in a free list per bucket and handed out again
+//! on the next acquire of the same bucket. This avoids the allocation and
+//! page fault cost when the same sizes are allocated over and over, eg.
+//! when running many short samples. Blocks of at least the granularity are
+//! rounded up to a multiple of the granularity, smaller blocks to a
+//! multiple of a cache line.
+//!
+//! The pool never holds more memory than was in use at the peak: when an
+//! acquire misses, pooled blocks of other sizes are freed until the
+//! pooled and the used bytes together are within the peak number of used
+//! bytes.
+//!
+//! The pools register themselves by name, so their counters can be added
+//! to the run report (see getStatisticsOfAllPools). Whether a memory area
+//! is taken from a pool is decided by alsfvm::memory::MemoryFactory.
+//!
+//! All member functions are thread safe.
+class MemoryPool {
+public:
+    typedef std::function<void*(size_t)> Allocator;
+    typedef std::function<void(void*)> Deallocator;
+
+    //! \param name the name in the report (has to be unique)
+    //! \param allocator called for bucket sizes on misses
+    //! \param deallocator frees the blocks returned by allocator
+    //! \param granularity the bucket size of large blocks, their sizes are
+    //!        rounded up to a multiple of this
+    MemoryPool(const std::string& name, Allocator allocator,
+        Deallocator deallocator, size_t granularity);
+
+    //! Frees all pooled blocks
+    ~MemoryPool();
+
+    MemoryPool(const MemoryPool&) = delete;
+    MemoryPool& operator=(const MemoryPool&) = delete;
+
+    //! Gets a block of at least the given size, from the pool if possible.
+    void* acquire(size_t bytes);
+
+    //! Returns a block obtained from acquire with the same size to the pool
+    //! (or frees it if the pool is disabled).
+    void release(void* pointer, size_t bytes);
+
+    //! Frees all pooled blocks
+    void clear();
+
+    //! When disabled, acquire and release go straight to the allocator
+    //! and deallocator. Disabling clears the pool.
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    //! The number of acquires served from the pool
+    size_t getNumberOfHits() const;
+
+    //! The number of acquires that had to allocate
+    size_t getNumberOfMisses() const;
+
+    //! The number of bytes currently held in the free lists
+    size_t getPooledBytes() const;
+
+    //! The number of bytes acquired and not yet released
+    size_t getBytesInUse() const;
+
+    //! The largest number of bytes in use at any time
+    size_t getPeakBytesInUse() const;
+
+    //! The hits, misses, pooled bytes and bytes in use
+    boost::property_tree::ptree getStatisticsAsPropertyTree() const;
+
+    //! The pool used for pooled host memory (see AlignedAllocator). Blocks
+    //! are allocated with allocateAligned.
+    static MemoryPool& getHostPool();
+
+    //! The statistics of all live pools, keyed by name
+    static boost::property_tree::ptree getStatisticsOfAllPools();
+
+private:
+    size_t getBucket(size_t bytes) const;
+
+    //! Removes pooled blocks (largest first) until the pooled and the used
+    //! bytes are within the peak. Must be called with the mutex held, the
+    //! blocks removed are returned (with their bucket) to be freed outside.
+    std::vector<std::pair<void*, size_t> > trim();
+
+    const std::string name;
+    const Allocator allocator;
+    const Deallocator deallocator;
+    const size_t granularity;
+
+    mutable std::mutex mutex;
+    std::map<size_t, std::vector<void*> > freeBlocks;
+    bool enabled;
+    size_t numberOfHits = 0;
+    size_t numberOfMisses = 0;
+    size_t pooledBytes = 0;
+    size_t bytesInUse = 0;
+    size_t peakBytesInUse = 0;
+};
+}
+}
@@ -21,8 +21,16 @@ namespace mpi {
 #ifdef ALSVINN_USE_MPI
 class Configuration {
 public:
+    //! @param ownsCommunicator if true, the communicator is freed (with
+    //!        MPI_Comm_free) when the configuration is destroyed
     Configuration(MPI_Comm communicator,
-        const std::string& platform = "cpu");
+        const std::string& platform = "cpu",
+        bool ownsCommunicator = false);
+
+    ~Configuration();
+
+    Configuration(const Configuration&) = delete;
+    Configuration& operator=(const Configuration&) = delete;
 
     MPI_Comm getCommunicator();
 
@@ -45,6 +53,7 @@ private:
     int numberOfNodes;
     MPI_Info info;
     const std::string platform = "cpu";
+    const bool ownsCommunicator = false;
 };
 #else
 class Configuration {};
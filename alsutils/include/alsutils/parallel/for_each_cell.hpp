@@ -0,0 +1,307 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsutils/types.hpp"
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <vector>
+
+#ifdef ALSVINN_USE_MPI
+    #include <mpi.h>
+    #include "alsutils/mpi/mpi_types.hpp"
+#endif
+
+///
+/// Parallel loops and reductions over boxes of indices (x, y, z). They
+/// only depend on the index box, so both the memory areas and the volumes
+/// (see alsfvm/volume/volume_foreach.hpp) use them.
+///
+
+namespace alsutils {
+namespace parallel {
+
+///
+/// Splits the index box [start, end) into tiles. The tiles are long in the
+/// x-direction (contiguous in memory) and short in y and z, so that there
+/// are enough tiles to keep every thread busy even for 2D grids with few
+/// rows or for thin 3D slabs.
+///
+class TileDecomposition {
+public:
+    TileDecomposition(const ivec3& start, const ivec3& end,
+        const ivec3& tileSize = {512, 4, 2})
+        : start(start), end(end), tileSize(tileSize) {
+        for (int d = 0; d < 3; ++d) {
+            const int length = std::max(0, end[d] - start[d]);
+            numberOfTiles[d] = (length + tileSize[d] - 1) / tileSize[d];
+        }
+    }
+
+    int getNumberOfTiles() const {
+        return numberOfTiles.x * numberOfTiles.y * numberOfTiles.z;
+    }
+
+    //! Computes the index box [tileStart, tileEnd) of the given tile.
+    //! Consecutive tiles are neighbours in x, then in y, then in z.
+    void getTile(int tile, ivec3& tileStart, ivec3& tileEnd) const {
+        const ivec3 tileIndex(tile % numberOfTiles.x,
+            (tile / numberOfTiles.x) % numberOfTiles.y,
+            tile / (numberOfTiles.x * numberOfTiles.y));
+
+        for (int d = 0; d < 3; ++d) {
+            tileStart[d] = start[d] + tileIndex[d] * tileSize[d];
+            tileEnd[d] = std::min(end[d], tileStart[d] + tileSize[d]);
+        }
+    }
+
+private:
+    ivec3 start;
+    ivec3 end;
+    ivec3 tileSize;
+    ivec3 numberOfTiles;
+};
+
+///
+/// Loops in parallel through every cell (x, y, z) with start <= (x, y, z) < end
+/// (componentwise). The box is split into tiles (see TileDecomposition) which
+/// are distributed statically over the threads of a single parallel region,
+/// so there is only one fork/join per call, independent of the number of
+/// z-slices.
+///
+/// Example:
+/// \code{.cpp}
+/// for_each_cell_index_parallel({ngx, ngy, ngz}, {nx - ngx, ny - ngy, nz - ngz},
+///     [&](int x, int y, int z) {
+///     out[view.index(x, y, z)] = 0;
+/// });
+/// \endcode
+///
+/// \note function is called concurrently, so it may only write to the cell
+///       it is given (or otherwise make sure there are no races).
+///
+template<class Function>
+inline void for_each_cell_index_parallel(const ivec3& start, const ivec3& end,
+    const Function& function) {
+    const TileDecomposition tiles(start, end);
+    const int numberOfTiles = tiles.getNumberOfTiles();
+
+    #pragma omp parallel for schedule(static)
+
+    for (int tile = 0; tile < numberOfTiles; ++tile) {
+        ivec3 tileStart, tileEnd;
+        tiles.getTile(tile, tileStart, tileEnd);
+
+        for (int z = tileStart.z; z < tileEnd.z; ++z) {
+            for (int y = tileStart.y; y < tileEnd.y; ++y) {
+                for (int x = tileStart.x; x < tileEnd.x; ++x) {
+                    function(x, y, z);
+                }
+            }
+        }
+    }
+}
+
+///
+/// Reduces function(x, y, z) over every cell with start <= (x, y, z) < end
+/// (componentwise) with reduction, which has to be associative (eg. max or
+/// plus). identity has to be the identity of the reduction.
+///
+/// Every tile (see TileDecomposition) is reduced by one thread into a
+/// private value, in cell order. The tile values are then combined
+/// pairwise, as a binary tree over the tile index. The tiles only depend on
+/// the box, so the result is the same (bitwise) for any number of threads,
+/// and sums are more accurate than when accumulated in one long loop.
+///
+/// See the reductions namespace for common reductions, and
+/// for_each_cell_reduce_all to also reduce over all MPI processes.
+///
+/// Example (maximum wave speed):
+/// \code{.cpp}
+/// real waveSpeed = for_each_cell_reduce(start, end, real(0),
+///     [&](int x, int y, int z) {
+///     return computeWaveSpeed(x, y, z);
+/// }, reductions::Max());
+/// \endcode
+///
+template<class T, class Function, class Reduction>
+inline T for_each_cell_reduce(const ivec3& start,
+    const ivec3& end,
+    const T& identity,
+    const Function& function,
+    const Reduction& reduction) {
+    const TileDecomposition tiles(start, end);
+    const int numberOfTiles = tiles.getNumberOfTiles();
+
+    if (numberOfTiles == 0) {
+        return identity;
+    }
+
+    std::vector<T> tileValues(numberOfTiles, identity);
+
+    #pragma omp parallel for schedule(static)
+
+    for (int tile = 0; tile < numberOfTiles; ++tile) {
+        ivec3 tileStart, tileEnd;
+        tiles.getTile(tile, tileStart, tileEnd);
+        T localValue = identity;
+
+        for (int z = tileStart.z; z < tileEnd.z; ++z) {
+            for (int y = tileStart.y; y < tileEnd.y; ++y) {
+                for (int x = tileStart.x; x < tileEnd.x; ++x) {
+                    localValue = reduction(localValue, function(x, y, z));
+                }
+            }
+        }
+
+        tileValues[tile] = localValue;
+    }
+
+    for (int width = 1; width < numberOfTiles; width *= 2) {
+        for (int tile = 0; tile < numberOfTiles - width; tile += 2 * width) {
+            tileValues[tile] = reduction(tileValues[tile], tileValues[tile + width]);
+        }
+    }
+
+    return tileValues[0];
+}
+
+///
+/// Common reductions for for_each_cell_reduce
+///
+namespace reductions {
+
+#ifdef ALSVINN_USE_MPI
+//! Does MPI_Allreduce in place on the reals in value (eg. a real or a
+//! std::array<real, N>)
+template<class T>
+inline void allReduceReals(T& value, MPI_Op operation, MPI_Comm communicator) {
+    static_assert(sizeof(T) % sizeof(real) == 0,
+        "Can only reduce types made of reals over MPI");
+    MPI_Allreduce(MPI_IN_PLACE, &value, int(sizeof(T) / sizeof(real)),
+        alsutils::mpi::MpiTypes<real>::MPI_Real, operation, communicator);
+}
+#endif
+
+//! a + b, also componentwise for std::array
+struct Sum {
+    template<class T>
+    T operator()(const T& a, const T& b) const {
+        return a + b;
+    }
+
+    template<class T, size_t N>
+    std::array<T, N> operator()(std::array<T, N> a,
+        const std::array<T, N>& b) const {
+        for (size_t i = 0; i < N; ++i) {
+            a[i] += b[i];
+        }
+
+        return a;
+    }
+
+#ifdef ALSVINN_USE_MPI
+    template<class T>
+    static void allReduce(T& value, MPI_Comm communicator) {
+        allReduceReals(value, MPI_SUM, communicator);
+    }
+#endif
+};
+
+struct Max {
+    template<class T>
+    T operator()(const T& a, const T& b) const {
+        return std::max(a, b);
+    }
+
+#ifdef ALSVINN_USE_MPI
+    template<class T>
+    static void allReduce(T& value, MPI_Comm communicator) {
+        allReduceReals(value, MPI_MAX, communicator);
+    }
+#endif
+};
+
+struct Min {
+    template<class T>
+    T operator()(const T& a, const T& b) const {
+        return std::min(a, b);
+    }
+
+#ifdef ALSVINN_USE_MPI
+    template<class T>
+    static void allReduce(T& value, MPI_Comm communicator) {
+        allReduceReals(value, MPI_MIN, communicator);
+    }
+#endif
+};
+
+//! The smallest and largest value, reduced with MinMax
+template<class T>
+struct Range {
+    T minimum;
+    T maximum;
+
+    //! The identity (an empty range)
+    static Range empty() {
+        return {std::numeric_limits<T>::max(), std::numeric_limits<T>::lowest()};
+    }
+
+    static Range of(const T& value) {
+        return {value, value};
+    }
+};
+
+struct MinMax {
+    template<class T>
+    Range<T> operator()(const Range<T>& a, const Range<T>& b) const {
+        return {std::min(a.minimum, b.minimum), std::max(a.maximum, b.maximum)};
+    }
+
+#ifdef ALSVINN_USE_MPI
+    //! Both bounds in one reduction, as the minimum of (minimum, -maximum)
+    template<class T>
+    static void allReduce(Range<T>& value, MPI_Comm communicator) {
+        std::array<T, 2> bounds = {value.minimum, -value.maximum};
+        allReduceReals(bounds, MPI_MIN, communicator);
+        value.minimum = bounds[0];
+        value.maximum = -bounds[1];
+    }
+#endif
+};
+}
+
+#ifdef ALSVINN_USE_MPI
+///
+/// Same as for_each_cell_reduce, then the results of all processes in
+/// communicator are reduced (reduction has to be one of the reductions with
+/// allReduce, eg. reductions::Sum).
+///
+template<class T, class Function, class Reduction>
+inline T for_each_cell_reduce_all(const ivec3& start,
+    const ivec3& end,
+    const T& identity,
+    const Function& function,
+    const Reduction& reduction,
+    MPI_Comm communicator) {
+    T value = for_each_cell_reduce(start, end, identity, function, reduction);
+    Reduction::allReduce(value, communicator);
+    return value;
+}
+#endif
+
+} // namespace parallel
+} // namespace alsutils
@@ -0,0 +1,55 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <string>
+
+namespace alsutils {
+namespace simd {
+
+//! The vector instruction sets we have specialized kernels for,
+//! ordered from the least to the most capable.
+enum class InstructionSet {
+    scalar = 0,
+    sse = 1,
+    avx2 = 2,
+    avx512 = 3
+};
+
+//! \returns the most capable instruction set supported by the CPU we are
+//!          currently running on
+InstructionSet getHighestSupportedInstructionSet();
+
+//! \returns true if the CPU we are running on supports the given
+//!          instruction set
+bool isInstructionSetSupported(InstructionSet instructionSet);
+
+//! Gets the instruction set that the vectorized kernels should use.
+//!
+//! This is the highest supported instruction set, unless it has been
+//! lowered through setInstructionSet or the environment variable
+//! ALSVINN_SIMD_INSTRUCTION_SET (one of scalar, sse, avx2, avx512).
+InstructionSet getInstructionSet();
+
+//! Overrides the instruction set used by the vectorized kernels.
+//! Throws if the CPU does not support the instruction set.
+void setInstructionSet(InstructionSet instructionSet);
+
+std::string toString(InstructionSet instructionSet);
+
+//! Parses the name of an instruction set, throws on unknown names.
+InstructionSet instructionSetFromString(const std::string& name);
+}
+}
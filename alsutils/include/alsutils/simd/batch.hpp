@@ -0,0 +1,336 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cmath>
+#include <cstddef>
+
+namespace alsutils {
+namespace simd {
+
+///
+/// Mask resulting from comparing two batches lane by lane.
+///
+template<int W>
+struct batch_mask {
+    bool values[W];
+
+    bool operator[](int lane) const {
+        return values[lane];
+    }
+};
+
+///
+/// A batch of W values of type T that are processed in lock step.
+///
+/// Every operation is a plain loop over the lanes marked with
+/// "omp simd", so the compiler maps the batch onto whatever vector
+/// registers the translation unit is compiled for. This keeps the type
+/// portable while still letting us compile the same kernel once per
+/// instruction set (see alsutils/simd/InstructionSet.hpp).
+///
+/// \note The Tag parameter is used to give the instantiations in each
+///       instruction set specific translation unit distinct (internal)
+///       symbols. Without it the linker could merge eg. an AVX2 compiled
+///       copy of an inline function into code that runs on an SSE machine.
+///
+template<class T, int W, class Tag = void>
+struct batch {
+    static_assert(W > 0, "Batch width must be positive");
+
+    typedef T value_type;
+    static constexpr int width = W;
+
+    T values[W];
+
+    batch() {
+        #pragma omp simd
+        for (int i = 0; i < W; ++i) {
+            values[i] = T(0);
+        }
+    }
+
+    batch(T value) {
+        #pragma omp simd
+        for (int i = 0; i < W; ++i) {
+            values[i] = value;
+        }
+    }
+
+    //! Loads W consecutive values starting at pointer
+    static batch load(const T* pointer) {
+        batch result;
+
+        #pragma omp simd
+        for (int i = 0; i < W; ++i) {
+            result.values[i] = pointer[i];
+        }
+
+        return result;
+    }
+
+    //! Loads the first count (0 < count <= W) values starting at pointer.
+    //! The remaining lanes are filled with pointer[0], so that they always
+    //! hold a valid value for the computation.
+    static batch loadPartial(const T* pointer, int count) {
+        batch result(pointer[0]);
+
+        for (int i = 1; i < count; ++i) {
+            result.values[i] = pointer[i];
+        }
+
+        return result;
+    }
+
+    //! Stores all W lanes starting at pointer
+    void store(T* pointer) const {
+        #pragma omp simd
+        for (int i = 0; i < W; ++i) {
+            pointer[i] = values[i];
+        }
+    }
+
+    //! Stores the first count lanes starting at pointer
+    void storePartial(T* pointer, int count) const {
+        for (int i = 0; i < count; ++i) {
+            pointer[i] = values[i];
+        }
+    }
+
+    T& operator[](int lane) {
+        return values[lane];
+    }
+
+    const T& operator[](int lane) const {
+        return values[lane];
+    }
+
+    batch& operator+=(const batch& other) {
+        #pragma omp simd
+        for (int i = 0; i < W; ++i) {
+            values[i] += other.values[i];
+        }
+
+        return *this;
+    }
+
+    batch& operator-=(const batch& other) {
+        #pragma omp simd
+        for (int i = 0; i < W; ++i) {
+            values[i] -= other.values[i];
+        }
+
+        return *this;
+    }
+
+    batch& operator*=(const batch& other) {
+        #pragma omp simd
+        for (int i = 0; i < W; ++i) {
+            values[i] *= other.values[i];
+        }
+
+        return *this;
+    }
+
+    batch& operator/=(const batch& other) {
+        #pragma omp simd
+        for (int i = 0; i < W; ++i) {
+            values[i] /= other.values[i];
+        }
+
+        return *this;
+    }
+
+    batch operator-() const {
+        batch result;
+
+        #pragma omp simd
+        for (int i = 0; i < W; ++i) {
+            result.values[i] = -values[i];
+        }
+
+        return result;
+    }
+};
+
+template<class T, int W, class Tag>
+inline batch<T, W, Tag> operator+(batch<T, W, Tag> a,
+    const batch<T, W, Tag>& b) {
+    return a += b;
+}
+
+template<class T, int W, class Tag>
+inline batch<T, W, Tag> operator-(batch<T, W, Tag> a,
+    const batch<T, W, Tag>& b) {
+    return a -= b;
+}
+
+template<class T, int W, class Tag>
+inline batch<T, W, Tag> operator*(batch<T, W, Tag> a,
+    const batch<T, W, Tag>& b) {
+    return a *= b;
+}
+
+template<class T, int W, class Tag>
+inline batch<T, W, Tag> operator/(batch<T, W, Tag> a,
+    const batch<T, W, Tag>& b) {
+    return a /= b;
+}
+
+template<class T, int W, class Tag>
+inline batch<T, W, Tag> operator+(T a, const batch<T, W, Tag>& b) {
+    return batch<T, W, Tag>(a) + b;
+}
+
+template<class T, int W, class Tag>
+inline batch<T, W, Tag> operator-(T a, const batch<T, W, Tag>& b) {
+    return batch<T, W, Tag>(a) - b;
+}
+
+template<class T, int W, class Tag>
+inline batch<T, W, Tag> operator*(T a, const batch<T, W, Tag>& b) {
+    return batch<T, W, Tag>(a) * b;
+}
+
+template<class T, int W, class Tag>
+inline batch<T, W, Tag> operator/(T a, const batch<T, W, Tag>& b) {
+    return batch<T, W, Tag>(a) / b;
+}
+
+template<class T, int W, class Tag>
+inline batch<T, W, Tag> operator+(batch<T, W, Tag> a, T b) {
+    return a += batch<T, W, Tag>(b);
+}
+
+template<class T, int W, class Tag>
+inline batch<T, W, Tag> operator-(batch<T, W, Tag> a, T b) {
+    return a -= batch<T, W, Tag>(b);
+}
+
+template<class T, int W, class Tag>
+inline batch<T, W, Tag> operator*(batch<T, W, Tag> a, T b) {
+    return a *= batch<T, W, Tag>(b);
+}
+
+template<class T, int W, class Tag>
+inline batch<T, W, Tag> operator/(batch<T, W, Tag> a, T b) {
+    return a /= batch<T, W, Tag>(b);
+}
+
+#define ALSUTILS_SIMD_BATCH_COMPARISON(OP) \
+    template<class T, int W, class Tag> \
+    inline batch_mask<W> operator OP(const batch<T, W, Tag>& a, \
+        const batch<T, W, Tag>& b) { \
+        batch_mask<W> mask; \
+        _Pragma("omp simd") \
+        for (int i = 0; i < W; ++i) { \
+            mask.values[i] = a.values[i] OP b.values[i]; \
+        } \
+        return mask; \
+    } \
+    template<class T, int W, class Tag> \
+    inline batch_mask<W> operator OP(const batch<T, W, Tag>& a, T b) { \
+        return a OP batch<T, W, Tag>(b); \
+    }
+
+ALSUTILS_SIMD_BATCH_COMPARISON( < )
+ALSUTILS_SIMD_BATCH_COMPARISON( <= )
+ALSUTILS_SIMD_BATCH_COMPARISON( > )
+ALSUTILS_SIMD_BATCH_COMPARISON( >= )
+ALSUTILS_SIMD_BATCH_COMPARISON( == )
+
+#undef ALSUTILS_SIMD_BATCH_COMPARISON
+
+//! Lane wise mask ? a : b
+template<class T, int W, class Tag>
+inline batch<T, W, Tag> select(const batch_mask<W>& mask,
+    const batch<T, W, Tag>& a,
+    const batch<T, W, Tag>& b) {
+    batch<T, W, Tag> result;
+
+    #pragma omp simd
+    for (int i = 0; i < W; ++i) {
+        result.values[i] = mask.values[i] ? a.values[i] : b.values[i];
+    }
+
+    return result;
+}
+
+template<class T, int W, class Tag>
+inline batch<T, W, Tag> sqrt(const batch<T, W, Tag>& a) {
+    batch<T, W, Tag> result;
+
+    #pragma omp simd
+    for (int i = 0; i < W; ++i) {
+        result.values[i] = std::sqrt(a.values[i]);
+    }
+
+    return result;
+}
+
+template<class T, int W, class Tag>
+inline batch<T, W, Tag> fabs(const batch<T, W, Tag>& a) {
+    batch<T, W, Tag> result;
+
+    #pragma omp simd
+    for (int i = 0; i < W; ++i) {
+        result.values[i] = a.values[i] < T(0) ? -a.values[i] : a.values[i];
+    }
+
+    return result;
+}
+
+//! Lane wise minimum. As fmin, NaN in b is ignored.
+template<class T, int W, class Tag>
+inline batch<T, W, Tag> fmin(const batch<T, W, Tag>& a,
+    const batch<T, W, Tag>& b) {
+    batch<T, W, Tag> result;
+
+    #pragma omp simd
+    for (int i = 0; i < W; ++i) {
+        result.values[i] = b.values[i] < a.values[i] ? b.values[i] : a.values[i];
+    }
+
+    return result;
+}
+
+//! Lane wise maximum. As fmax, NaN in b is ignored.
+template<class T, int W, class Tag>
+inline batch<T, W, Tag> fmax(const batch<T, W, Tag>& a,
+    const batch<T, W, Tag>& b) {
+    batch<T, W, Tag> result;
+
+    #pragma omp simd
+    for (int i = 0; i < W; ++i) {
+        result.values[i] = b.values[i] > a.values[i] ? b.values[i] : a.values[i];
+    }
+
+    return result;
+}
+
+//! Computes the maximum over all lanes
+template<class T, int W, class Tag>
+inline T horizontalMax(const batch<T, W, Tag>& a) {
+    T result = a.values[0];
+
+    for (int i = 1; i < W; ++i) {
+        result = a.values[i] > result ? a.values[i] : result;
+    }
+
+    return result;
+}
+
+}
+}
@@ -28,6 +28,8 @@
 #include "alsutils/get_hostname.hpp"
 #include "alsutils/mpi/get_mpi_version.hpp"
 #include "alsutils/io/TextFileCache.hpp"
+#include "alsutils/simd/InstructionSet.hpp"
+#include "alsutils/memory/AllocationPolicy.hpp"
 #include <boost/filesystem.hpp>
 
 #include "alsutils/get_python_version.hpp"
@@ -65,6 +67,12 @@ boost::property_tree::ptree makeBasicReport() {
             boost::posix_time::second_clock::local_time()));
 
     propertyTree.put("report.CPU", alsutils::getCPUName());
+    propertyTree.put("report.simdInstructionSet",
+        simd::toString(simd::getInstructionSet()));
+    propertyTree.put("report.simdHighestSupportedInstructionSet",
+        simd::toString(simd::getHighestSupportedInstructionSet()));
+    propertyTree.put("report.hostAllocationPolicy",
+        memory::toString(memory::getAllocationPolicy()));
     propertyTree.put("report.revision", getVersionControlID());
     propertyTree.put("report.versionControlStatus", getVersionControlStatus());
     propertyTree.put("report.buildType", getBuildType());
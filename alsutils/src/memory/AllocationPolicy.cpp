@@ -0,0 +1,138 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "alsutils/memory/AllocationPolicy.hpp"
+#include "alsutils/memory/MemoryPool.hpp"
+#include "alsutils/error/Exception.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <boost/algorithm/string.hpp>
+#ifdef __linux__
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace alsutils {
+namespace memory {
+namespace {
+
+constexpr size_t hugePageSize = size_t(2) << 20;
+
+bool readSwitchFromEnvironment(const char* name, const char* on,
+    const char* off, bool defaultValue) {
+    const char* fromEnvironment = std::getenv(name);
+
+    if (fromEnvironment == nullptr || std::string(fromEnvironment) == "") {
+        return defaultValue;
+    }
+
+    const auto value = boost::algorithm::to_lower_copy(
+            boost::trim_copy(std::string(fromEnvironment)));
+
+    if (value == on) {
+        return true;
+    } else if (value == off) {
+        return false;
+    }
+
+    THROW("Unknown value " << name << "=" << fromEnvironment << ", expected "
+        << on << " or " << off);
+}
+
+std::atomic<bool>& getParallelFirstTouch() {
+    static std::atomic<bool> parallelFirstTouch{readSwitchFromEnvironment(
+            "ALSVINN_FIRST_TOUCH", "parallel", "serial", true)};
+    return parallelFirstTouch;
+}
+
+std::atomic<bool>& getTransparentHugePages() {
+    static std::atomic<bool> transparentHugePages{readSwitchFromEnvironment(
+            "ALSVINN_HUGE_PAGES", "on", "off", false)};
+    return transparentHugePages;
+}
+
+size_t getPageSize() {
+#ifdef __linux__
+    static const size_t pageSize = size_t(sysconf(_SC_PAGESIZE));
+    return pageSize;
+#else
+    return 4096;
+#endif
+}
+}
+
+AllocationPolicy getAllocationPolicy() {
+    AllocationPolicy policy;
+    policy.parallelFirstTouch = getParallelFirstTouch().load();
+    policy.transparentHugePages = getTransparentHugePages().load();
+    return policy;
+}
+
+void setAllocationPolicy(const AllocationPolicy& policy) {
+    getParallelFirstTouch().store(policy.parallelFirstTouch);
+    getTransparentHugePages().store(policy.transparentHugePages);
+
+    // The pooled blocks were allocated (and aligned) with the old policy
+    MemoryPool::getHostPool().clear();
+}
+
+size_t getAlignment(size_t bytes, const AllocationPolicy& policy) {
+    if (policy.transparentHugePages && bytes >= hugePageSize) {
+        return hugePageSize;
+    } else if (bytes >= getPageSize()) {
+        return getPageSize();
+    } else {
+        return minimumAlignment;
+    }
+}
+
+void* allocateAligned(size_t bytes, const AllocationPolicy& policy) {
+    const size_t alignment = getAlignment(bytes, policy);
+
+    void* pointer = nullptr;
+
+    // posix_memalign does not like zero sized allocations on all platforms
+    if (posix_memalign(&pointer, alignment, std::max(bytes, alignment)) != 0) {
+        throw std::bad_alloc();
+    }
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+
+    if (alignment == hugePageSize) {
+        // Only a hint, the kernel may not have THP enabled
+        madvise(pointer, bytes - bytes % hugePageSize, MADV_HUGEPAGE);
+    }
+
+#endif
+
+    return pointer;
+}
+
+void deallocateAligned(void* pointer) {
+    std::free(pointer);
+}
+
+std::string toString(const AllocationPolicy& policy) {
+    return std::string("firstTouch=")
+        + (policy.parallelFirstTouch ? "parallel" : "serial")
+        + ", hugePages=" + (policy.transparentHugePages ? "on" : "off")
+        + ", alignment=" + std::to_string(minimumAlignment) + "/"
+        + std::to_string(getPageSize())
+        + (policy.transparentHugePages ? "/" + std::to_string(hugePageSize) : "");
+}
+}
+}
@@ -0,0 +1,234 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "alsutils/memory/MemoryPool.hpp"
+#include "alsutils/memory/AllocationPolicy.hpp"
+#include "alsutils/error/Exception.hpp"
+#include <algorithm>
+
+namespace alsutils {
+namespace memory {
+namespace {
+
+std::mutex& getRegistryMutex() {
+    static std::mutex registryMutex;
+    return registryMutex;
+}
+
+std::map<std::string, const MemoryPool*>& getRegistry() {
+    static std::map<std::string, const MemoryPool*> registry;
+    return registry;
+}
+}
+
+MemoryPool::MemoryPool(const std::string& name, Allocator allocator,
+    Deallocator deallocator, size_t granularity)
+    : name(name), allocator(allocator), deallocator(deallocator),
+      granularity(granularity), enabled(true) {
+    if (granularity == 0) {
+        THROW("The granularity of memory pool " << name << " has to be positive");
+    }
+
+    std::lock_guard<std::mutex> lock(getRegistryMutex());
+
+    if (getRegistry().count(name) > 0) {
+        THROW("A memory pool named " << name << " already exists");
+    }
+
+    getRegistry()[name] = this;
+}
+
+MemoryPool::~MemoryPool() {
+    clear();
+
+    std::lock_guard<std::mutex> lock(getRegistryMutex());
+    getRegistry().erase(name);
+}
+
+size_t MemoryPool::getBucket(size_t bytes) const {
+    // Small blocks are only rounded to a cache line, so that eg. the small
+    // scratch areas do not take a whole page each
+    const size_t roundTo = bytes < granularity ? minimumAlignment : granularity;
+    return std::max(size_t(1), (bytes + roundTo - 1) / roundTo) * roundTo;
+}
+
+void* MemoryPool::acquire(size_t bytes) {
+    const size_t bucket = getBucket(bytes);
+    std::vector<std::pair<void*, size_t> > blocksToFree;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        bytesInUse += bucket;
+        peakBytesInUse = std::max(peakBytesInUse, bytesInUse);
+
+        if (enabled) {
+            auto& blocks = freeBlocks[bucket];
+
+            if (!blocks.empty()) {
+                void* pointer = blocks.back();
+                blocks.pop_back();
+                pooledBytes -= bucket;
+                numberOfHits++;
+                return pointer;
+            }
+        }
+
+        numberOfMisses++;
+        blocksToFree = trim();
+    }
+
+    for (auto& block : blocksToFree) {
+        deallocator(block.first);
+    }
+
+    try {
+        return allocator(bucket);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(mutex);
+        bytesInUse -= bucket;
+        throw;
+    }
+}
+
+void MemoryPool::release(void* pointer, size_t bytes) {
+    if (pointer == nullptr) {
+        return;
+    }
+
+    const size_t bucket = getBucket(bytes);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        bytesInUse -= bucket;
+
+        if (enabled) {
+            freeBlocks[bucket].push_back(pointer);
+            pooledBytes += bucket;
+            return;
+        }
+    }
+
+    deallocator(pointer);
+}
+
+std::vector<std::pair<void*, size_t> > MemoryPool::trim() {
+    std::vector<std::pair<void*, size_t> > blocksToFree;
+
+    for (auto bucket = freeBlocks.rbegin(); bucket != freeBlocks.rend()
+        && pooledBytes + bytesInUse > peakBytesInUse; ++bucket) {
+        auto& blocks = bucket->second;
+
+        while (!blocks.empty() && pooledBytes + bytesInUse > peakBytesInUse) {
+            blocksToFree.push_back(std::make_pair(blocks.back(), bucket->first));
+            blocks.pop_back();
+            pooledBytes -= bucket->first;
+        }
+    }
+
+    return blocksToFree;
+}
+
+void MemoryPool::clear() {
+    std::map<size_t, std::vector<void*> > blocksToFree;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        blocksToFree.swap(freeBlocks);
+        pooledBytes = 0;
+    }
+
+    for (auto& bucket : blocksToFree) {
+        for (void* pointer : bucket.second) {
+            deallocator(pointer);
+        }
+    }
+}
+
+void MemoryPool::setEnabled(bool enabled) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->enabled = enabled;
+    }
+
+    if (!enabled) {
+        clear();
+    }
+}
+
+bool MemoryPool::isEnabled() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return enabled;
+}
+
+size_t MemoryPool::getNumberOfHits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return numberOfHits;
+}
+
+size_t MemoryPool::getNumberOfMisses() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return numberOfMisses;
+}
+
+size_t MemoryPool::getPooledBytes() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return pooledBytes;
+}
+
+size_t MemoryPool::getBytesInUse() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytesInUse;
+}
+
+size_t MemoryPool::getPeakBytesInUse() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return peakBytesInUse;
+}
+
+boost::property_tree::ptree MemoryPool::getStatisticsAsPropertyTree() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    boost::property_tree::ptree statistics;
+    statistics.put("enabled", enabled);
+    statistics.put("hits", numberOfHits);
+    statistics.put("misses", numberOfMisses);
+    statistics.put("pooledBytes", pooledBytes);
+    statistics.put("bytesInUse", bytesInUse);
+    statistics.put("peakBytesInUse", peakBytesInUse);
+    return statistics;
+}
+
+MemoryPool& MemoryPool::getHostPool() {
+    // The alignment only depends on the size of the block (the bucket), so
+    // it is the same for all blocks in a bucket.
+    static MemoryPool hostPool("host", [](size_t bytes) {
+        return allocateAligned(bytes, getAllocationPolicy());
+    }, [](void* pointer) {
+        deallocateAligned(pointer);
+    }, 4096);
+
+    return hostPool;
+}
+
+boost::property_tree::ptree MemoryPool::getStatisticsOfAllPools() {
+    std::lock_guard<std::mutex> lock(getRegistryMutex());
+    boost::property_tree::ptree statistics;
+
+    for (const auto& pool : getRegistry()) {
+        // the names may contain dots, which are path separators by default
+        statistics.add_child(boost::property_tree::ptree::path_type(pool.first, '/'),
+            pool.second->getStatisticsAsPropertyTree());
+    }
+
+    return statistics;
+}
+}
+}
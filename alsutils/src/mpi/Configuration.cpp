@@ -20,13 +20,26 @@ namespace alsutils {
 namespace mpi {
 
 Configuration::Configuration(MPI_Comm communicator,
-    const std::string& platform)
-    : communicator(communicator), platform(platform) {
+    const std::string& platform,
+    bool ownsCommunicator)
+    : communicator(communicator), platform(platform),
+      ownsCommunicator(ownsCommunicator) {
     MPI_Comm_rank(communicator, &nodeNumber);
     MPI_Comm_size(communicator, &numberOfNodes);
     info = MPI_INFO_NULL;
 }
 
+Configuration::~Configuration() {
+    if (ownsCommunicator) {
+        int finalized = 0;
+        MPI_Finalized(&finalized);
+
+        if (!finalized) {
+            MPI_Comm_free(&communicator);
+        }
+    }
+}
+
 MPI_Comm Configuration::getCommunicator() {
     return communicator;
 }
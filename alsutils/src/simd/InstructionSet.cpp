@@ -0,0 +1,127 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "alsutils/simd/InstructionSet.hpp"
+#include "alsutils/error/Exception.hpp"
+#include <atomic>
+#include <cstdlib>
+#include <boost/algorithm/string.hpp>
+
+namespace alsutils {
+namespace simd {
+namespace {
+
+InstructionSet detectHighestSupportedInstructionSet() {
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx512f")) {
+        return InstructionSet::avx512;
+    }
+
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return InstructionSet::avx2;
+    }
+
+    if (__builtin_cpu_supports("sse4.2")) {
+        return InstructionSet::sse;
+    }
+
+#endif
+    return InstructionSet::scalar;
+}
+
+InstructionSet getInitialInstructionSet() {
+    const char* fromEnvironment = std::getenv("ALSVINN_SIMD_INSTRUCTION_SET");
+
+    if (fromEnvironment != nullptr && std::string(fromEnvironment) != "") {
+        auto instructionSet = instructionSetFromString(fromEnvironment);
+
+        if (!isInstructionSetSupported(instructionSet)) {
+            THROW("ALSVINN_SIMD_INSTRUCTION_SET=" << fromEnvironment
+                << " is not supported by this CPU.");
+        }
+
+        return instructionSet;
+    }
+
+    return getHighestSupportedInstructionSet();
+}
+
+std::atomic<int>& getCurrentInstructionSet() {
+    static std::atomic<int> current{static_cast<int>(getInitialInstructionSet())};
+    return current;
+}
+}
+
+InstructionSet getHighestSupportedInstructionSet() {
+    static const InstructionSet highest = detectHighestSupportedInstructionSet();
+    return highest;
+}
+
+bool isInstructionSetSupported(InstructionSet instructionSet) {
+    return int(instructionSet) <= int(getHighestSupportedInstructionSet());
+}
+
+InstructionSet getInstructionSet() {
+    return InstructionSet(getCurrentInstructionSet().load());
+}
+
+void setInstructionSet(InstructionSet instructionSet) {
+    if (!isInstructionSetSupported(instructionSet)) {
+        THROW("Instruction set " << toString(instructionSet)
+            << " is not supported by this CPU. The highest supported is "
+            << toString(getHighestSupportedInstructionSet()));
+    }
+
+    getCurrentInstructionSet().store(int(instructionSet));
+}
+
+std::string toString(InstructionSet instructionSet) {
+    switch (instructionSet) {
+    case InstructionSet::scalar:
+        return "scalar";
+
+    case InstructionSet::sse:
+        return "sse";
+
+    case InstructionSet::avx2:
+        return "avx2";
+
+    case InstructionSet::avx512:
+        return "avx512";
+    }
+
+    THROW("Unknown instruction set " << int(instructionSet));
+}
+
+InstructionSet instructionSetFromString(const std::string& name) {
+    const auto lowerCaseName = boost::algorithm::to_lower_copy(
+            boost::trim_copy(name));
+
+    for (auto instructionSet : {
+            InstructionSet::scalar, InstructionSet::sse,
+            InstructionSet::avx2, InstructionSet::avx512
+        }) {
+        if (toString(instructionSet) == lowerCaseName) {
+            return instructionSet;
+        }
+    }
+
+    THROW("Unknown instruction set " << name
+        << ", supported are scalar, sse, avx2 and avx512.");
+}
+}
+}
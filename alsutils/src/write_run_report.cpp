@@ -27,6 +27,7 @@
 #include <boost/filesystem.hpp>
 #include "alsutils/make_basic_report.hpp"
 #include "alsutils/timer/TimerDatabase.hpp"
+#include "alsutils/memory/MemoryPool.hpp"
 #ifdef ALSVINN_HAVE_CUDA
     #include "alsutils/cuda/get_device_properties.hpp"
 #endif
@@ -50,6 +51,8 @@ void writeRunReport(const std::string& executable,
 
     propertyTree.add_child("report.timings",
         alsutils::timer::TimerDatabase::getInstance().getTimesAsPropertyTree());
+    propertyTree.add_child("report.memoryPools",
+        alsutils::memory::MemoryPool::getStatisticsOfAllPools());
     propertyTree.put("report.executable", executable);
     propertyTree.put("report.name", name);
 
@@ -56,6 +56,8 @@ int main(int argc, char** argv) {
         ("help", "Produces this help message")
 
 #ifdef ALSVINN_USE_MPI
+        ("automatic", "Divides all cores available between the directions, "
+            "choosing the split with the least communication")
         ("automatic-x,x", "Divides all cores available in the X direction")
         ("automatic-y,y", "Divides all cores available in the Y direction")
         ("automatic-z,z", "Divides all cores available in the Z direction")
@@ -125,7 +127,11 @@ int main(int argc, char** argv) {
         alsutils::mpi::setCudaDevice();
         int mpiRank;
 
-        MPI_SAFE_CALL(MPI_Init(NULL, NULL));
+        // The halo exchange is driven from a separate thread
+        // (see alsfvm::mpi::ProgressThread)
+        int threadSupport = MPI_THREAD_SINGLE;
+        MPI_SAFE_CALL(MPI_Init_thread(NULL, NULL, MPI_THREAD_MULTIPLE,
+                &threadSupport));
 
 
         MPI_SAFE_CALL(MPI_Comm_rank(MPI_COMM_WORLD, &mpiRank));
@@ -139,6 +145,11 @@ int main(int argc, char** argv) {
             + ".txt");
         ALSVINN_LOG(INFO, "MPI enabled");
 
+        if (threadSupport < MPI_THREAD_MULTIPLE) {
+            ALSVINN_LOG(WARNING, "MPI does not provide MPI_THREAD_MULTIPLE "
+                << "(provided level " << threadSupport << ").");
+        }
+
 #else
         ALSVINN_LOG(INFO, "MPI disabled");
 
@@ -184,12 +195,16 @@ int main(int argc, char** argv) {
 
         }
 
-        if (numberOfProcessors != multiX * multiY * multiZ) {
-            THROW("The total number of processors required is: " << multiX * multiY * multiZ
-                << "\n" << "The total number given was: " << numberOfProcessors);
-        }
+        if (vm.count("automatic")) {
+            setup.enableMPI(MPI_COMM_WORLD);
+        } else {
+            if (numberOfProcessors != multiX * multiY * multiZ) {
+                THROW("The total number of processors required is: " << multiX * multiY * multiZ
+                    << "\n" << "The total number given was: " << numberOfProcessors);
+            }
 
-        setup.enableMPI(MPI_COMM_WORLD, multiX, multiY, multiZ);
+            setup.enableMPI(MPI_COMM_WORLD, multiX, multiY, multiZ);
+        }
 #endif
 
 
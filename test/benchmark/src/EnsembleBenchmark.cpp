@@ -0,0 +1,176 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Compares running B small samples one by one (a new simulator for every
+// sample, as alsuq does without <ensembleSize>) to advancing all of them as
+// one ensemble (SimulatorParameters::setEnsembleSize), where the samples are
+// stacked along the first unused direction of the grid.
+//
+// Run as
+//
+//     ./test/benchmark/alsbenchmark --gtest_filter=EnsembleBenchmark.*
+//
+
+#include <gtest/gtest.h>
+#include "alsfvm/simulator/Simulator.hpp"
+#include "alsfvm/diffusion/DiffusionFactory.hpp"
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+
+using namespace alsfvm;
+
+namespace {
+const int numberOfTimesteps = 20;
+
+//! A smooth periodic profile in x, shifted by a different amount per member
+class ShiftedSineInitialData : public init::InitialData {
+public:
+    ShiftedSineInitialData(real shift)
+        : shift(shift) {
+
+    }
+
+    void setInitialData(volume::Volume& conservedVolume,
+        volume::Volume&,
+        equation::CellComputer&,
+        grid::Grid&) override {
+        const auto ghostCells = conservedVolume.getNumberOfGhostCells();
+        const auto innerSize = conservedVolume.getInnerSize();
+        const auto totalSize = conservedVolume.getTotalDimensions();
+        const size_t lastVariable = conservedVolume.getNumberOfVariables() - 1;
+
+        for (size_t var = 0; var < conservedVolume.getNumberOfVariables(); ++var) {
+            real* values = conservedVolume.getScalarMemoryArea(var)->getPointer();
+
+            for (int y = 0; y < innerSize.y; ++y) {
+                for (int x = 0; x < innerSize.x; ++x) {
+                    const real profile = std::sin(2 * M_PI * (x + shift) / innerSize.x);
+
+                    // density and energy positive, momentum oscillating
+                    values[(y + ghostCells.y) * totalSize.x + x + ghostCells.x] =
+                        (var == 0 || var == lastVariable) ? 2 + 0.5 * profile : 0.1 * profile;
+                }
+            }
+        }
+    }
+
+    void setParameters(const init::Parameters&) override {}
+
+    boost::property_tree::ptree getDescription() const override {
+        return boost::property_tree::ptree();
+    }
+
+private:
+    const real shift;
+};
+
+//! Creates the simulator, sets the initial data of every member and
+//! performs the timesteps, like one call of alsuq's Runner would.
+void runEnsemble(std::string equation, const std::string& flux,
+    const std::string& reconstruction, const ivec3& dimensions,
+    size_t ensembleSize, size_t firstMember) {
+    auto deviceConfiguration = alsfvm::make_shared<DeviceConfiguration>("cpu");
+    auto simulatorParameters = alsfvm::make_shared<simulator::SimulatorParameters>
+        (equation, "cpu");
+    simulatorParameters->setCFLNumber(0.4);
+    simulatorParameters->setEnsembleSize(ensembleSize);
+
+    auto memoryFactory = alsfvm::make_shared<memory::MemoryFactory>
+        (deviceConfiguration);
+    volume::VolumeFactory volumeFactory(equation, memoryFactory);
+    integrator::IntegratorFactory integratorFactory("rungekutta2");
+    boundary::BoundaryFactory boundaryFactory("periodic", deviceConfiguration);
+    numflux::NumericalFluxFactory numericalFluxFactory(equation, flux,
+        reconstruction, simulatorParameters, deviceConfiguration);
+    equation::CellComputerFactory cellComputerFactory(simulatorParameters,
+        deviceConfiguration);
+    auto grid = alsfvm::make_shared<grid::Grid>(rvec3(0, 0, 0), rvec3(1, 1, 0),
+            dimensions);
+    auto diffusionOperator = diffusion::DiffusionFactory().createDiffusionOperator(
+            equation, "none", "none", *grid, *simulatorParameters,
+            deviceConfiguration, memoryFactory, volumeFactory);
+
+    simulator::Simulator simulator(*simulatorParameters, grid, volumeFactory,
+        integratorFactory, boundaryFactory, numericalFluxFactory,
+        cellComputerFactory, memoryFactory, 1.0, deviceConfiguration, equation,
+        diffusionOperator, "ensemble");
+
+    for (size_t member = 0; member < ensembleSize; ++member) {
+        alsfvm::shared_ptr<init::InitialData> initialData(
+            new ShiftedSineInitialData(real(firstMember + member)));
+        simulator.setInitialValue(initialData, member);
+    }
+
+    for (int timestep = 0; timestep < numberOfTimesteps; ++timestep) {
+        simulator.performStep();
+    }
+}
+
+template<class Function>
+double timeInSeconds(const Function& function) {
+    auto start = std::chrono::high_resolution_clock::now();
+    function();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count();
+}
+
+void benchmarkEnsemble(const std::string& equation, const std::string& flux,
+    const std::string& reconstruction, const ivec3& dimensions) {
+    const size_t numberOfSamples = 64;
+
+    std::cout << numberOfSamples << " samples of " << equation << " (" << flux
+        << ", " << reconstruction << ") on " << dimensions << ", "
+        << numberOfTimesteps << " timesteps each" << std::endl;
+    std::cout << std::setw(14) << "ensembleSize" << std::setw(16) << "total [ms]"
+        << std::setw(20) << "per sample [ms]" << std::setw(12) << "speedup"
+        << std::endl;
+
+    double oneByOne = 0;
+
+    for (size_t ensembleSize : {
+            1, 4, 16, 64
+        }) {
+        const double time = timeInSeconds([&]() {
+            for (size_t first = 0; first < numberOfSamples; first += ensembleSize) {
+                runEnsemble(equation, flux, reconstruction, dimensions,
+                    ensembleSize, first);
+            }
+        });
+
+        if (ensembleSize == 1) {
+            oneByOne = time;
+        }
+
+        std::cout << std::setw(14) << ensembleSize
+            << std::setw(16) << time * 1e3
+            << std::setw(20) << time * 1e3 / numberOfSamples
+            << std::setw(12) << oneByOne / time << std::endl;
+    }
+}
+}
+
+TEST(EnsembleBenchmark, Burgers1D) {
+    benchmarkEnsemble("burgers", "godunov", "weno2", {256, 1, 1});
+}
+
+TEST(EnsembleBenchmark, Euler1D) {
+    benchmarkEnsemble("euler1", "hll3", "wenof2", {256, 1, 1});
+}
+
+TEST(EnsembleBenchmark, Euler2D) {
+    benchmarkEnsemble("euler2", "hll3", "wenof2", {64, 64, 1});
+}
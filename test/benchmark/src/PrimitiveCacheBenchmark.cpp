@@ -0,0 +1,134 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Measures the trade-off of the primitive variable cache of the standard CPU
+// flux engine (fvm.primitiveCache, see numflux::NumericalFluxCPU): p and u
+// are computed once per cell per flux evaluation and read back from memory,
+// instead of being recomputed (one division by rho and a dot product) for
+// every face in the stencil.
+//
+// For reference the same flux is also timed with WENO reconstruction, which
+// reconstructs the conserved variables at the faces, so that the extra
+// variables have to be computed from the face values and can not be cached.
+//
+// Run as
+//
+//     ./test/benchmark/alsbenchmark --gtest_filter=PrimitiveCacheBenchmark.*
+//
+
+#include <gtest/gtest.h>
+#include "alsfvm/types.hpp"
+#include "alsfvm/volume/VolumeFactory.hpp"
+#include "alsfvm/numflux/NumericalFluxFactory.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+using namespace alsfvm;
+
+namespace {
+const int numberOfRepetitions = 10;
+
+template<class Function>
+double timeInSeconds(const Function& function) {
+    // warm up (first touch, thread creation)
+    function();
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (int repetition = 0; repetition < numberOfRepetitions; ++repetition) {
+        function();
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count() / numberOfRepetitions;
+}
+
+double timeFlux(const std::string& equation, const std::string& flux,
+    const std::string& reconstruction, bool primitiveCache,
+    const ivec3& dimensions) {
+    auto deviceConfiguration = alsfvm::make_shared<DeviceConfiguration>("cpu");
+    auto simulatorParameters = alsfvm::make_shared<simulator::SimulatorParameters>
+        (equation, "cpu");
+    simulatorParameters->setPrimitiveCache(primitiveCache);
+    auto memoryFactory = alsfvm::make_shared<memory::MemoryFactory>
+        (deviceConfiguration);
+    volume::VolumeFactory volumeFactory(equation, memoryFactory);
+    grid::Grid grid(rvec3(0, 0, 0), rvec3(1, 1, 1), dimensions);
+
+    numflux::NumericalFluxFactory fluxFactory(equation, flux, reconstruction,
+        simulatorParameters, deviceConfiguration);
+    auto numericalFlux = fluxFactory.createNumericalFlux(grid);
+    const size_t ghostCells = numericalFlux->getNumberOfGhostCells();
+
+    auto conserved = volumeFactory.createConservedVolume(dimensions.x,
+            dimensions.y, dimensions.z, ghostCells);
+    auto output = volumeFactory.createConservedVolume(dimensions.x,
+            dimensions.y, dimensions.z, ghostCells);
+
+    for (size_t var = 0; var < conserved->getNumberOfVariables(); ++var) {
+        // density and energy 1, momentum 0.1
+        const real value = (var == 0
+                || var == conserved->getNumberOfVariables() - 1) ? 1 : 0.1;
+        conserved->getScalarMemoryArea(var)->makeZero();
+        *conserved->getScalarMemoryArea(var) += value;
+    }
+
+    rvec3 waveSpeed;
+    return timeInSeconds([&]() {
+        numericalFlux->computeFlux(*conserved, waveSpeed, true, *output);
+    });
+}
+
+void benchmarkPrimitiveCache(const std::string& equation,
+    const std::vector<std::string>& fluxes, const ivec3& dimensions) {
+    const int nsd = equation == "euler3" ? 3 : (equation == "euler2" ? 2 : 1);
+    const double numberOfCells = double(dimensions.x) * dimensions.y
+        * dimensions.z;
+
+    // Per cell and direction the standard engine reads the conserved
+    // variables (nsd+2 values), the cache additionally writes p and u once
+    // (nsd+1 values) and reads them back in every direction.
+    std::cout << "computeFlux (" << equation << ") on " << dimensions
+        << ", the cache moves " << (nsd + 1) * sizeof(real) * (nsd + 1)
+        << " more bytes per cell instead of computing p and u for every "
+        << "point of every face stencil" << std::endl;
+    std::cout << std::setw(10) << "flux" << std::setw(16) << "weno2 [ms]"
+        << std::setw(16) << "none [ms]" << std::setw(16) << "cached [ms]"
+        << std::setw(12) << "speedup" << std::setw(18) << "cached [ns/cell]"
+        << std::endl;
+
+    for (const auto& flux : fluxes) {
+        const double weno = timeFlux(equation, flux, "weno2", false, dimensions);
+        const double none = timeFlux(equation, flux, "none", false, dimensions);
+        const double cached = timeFlux(equation, flux, "none", true, dimensions);
+
+        std::cout << std::setw(10) << flux
+            << std::setw(16) << weno * 1e3
+            << std::setw(16) << none * 1e3
+            << std::setw(16) << cached * 1e3
+            << std::setw(12) << none / cached
+            << std::setw(18) << cached * 1e9 / numberOfCells << std::endl;
+    }
+}
+}
+
+TEST(PrimitiveCacheBenchmark, Euler2) {
+    benchmarkPrimitiveCache("euler2", {"hll3", "tecno4", "tecno6"},
+        {512, 512, 1});
+}
+
+TEST(PrimitiveCacheBenchmark, Euler3) {
+    benchmarkPrimitiveCache("euler3", {"hll3", "tecno4", "tecno6"},
+        {64, 64, 64});
+}
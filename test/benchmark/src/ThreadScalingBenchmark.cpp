@@ -0,0 +1,180 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Measures how the CPU kernels scale with the number of OpenMP threads.
+// Compares the old loop structure (serial z-loop with a parallel y-loop,
+// ie. one fork/join per z-slice) with the tiled single parallel region of
+// volume::for_each_cell_index_parallel, and times the full flux evaluation.
+//
+// Run as
+//
+//     ./test/benchmark/alsbenchmark --gtest_filter=ThreadScalingBenchmark.*
+//
+
+#include <gtest/gtest.h>
+#include "alsfvm/types.hpp"
+#include "alsfvm/volume/VolumeFactory.hpp"
+#include "alsfvm/volume/volume_foreach.hpp"
+#include "alsfvm/numflux/NumericalFluxFactory.hpp"
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <omp.h>
+
+using namespace alsfvm;
+
+namespace {
+const std::vector<int> threadCounts = {1, 8, 64};
+const int numberOfRepetitions = 10;
+
+template<class Function>
+double timeInSeconds(const Function& function) {
+    // warm up (first touch, thread creation)
+    function();
+    auto start = std::chrono::high_resolution_clock::now();
+
+    for (int repetition = 0; repetition < numberOfRepetitions; ++repetition) {
+        function();
+    }
+
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(end - start).count() / numberOfRepetitions;
+}
+
+// Three point average in the z-direction, parallelized as the kernels used to be.
+void averageSliced(const real* in, real* out, int nx, int ny, int nz) {
+    for (int z = 1; z < nz - 1; ++z) {
+        #pragma omp parallel for
+
+        for (int y = 0; y < ny; ++y) {
+            for (int x = 0; x < nx; ++x) {
+                const int index = z * nx * ny + y * nx + x;
+                out[index] = (in[index - nx * ny] + in[index] + in[index + nx * ny]) / 3;
+            }
+        }
+    }
+}
+
+void averageTiled(const real* in, real* out, int nx, int ny, int nz) {
+    volume::for_each_cell_index_parallel({0, 0, 1}, {nx, ny, nz - 1},
+    [&](int x, int y, int z) {
+        const int index = z * nx * ny + y * nx + x;
+        out[index] = (in[index - nx * ny] + in[index] + in[index + nx * ny]) / 3;
+    });
+}
+
+void benchmarkLoops(int nx, int ny, int nz) {
+    std::vector<real> in(nx * ny * nz, 1), out(nx * ny * nz, 0);
+
+    std::cout << "Three point stencil on " << nx << " x " << ny << " x " << nz
+        << std::endl;
+    std::cout << std::setw(10) << "threads" << std::setw(16) << "sliced [ms]"
+        << std::setw(16) << "tiled [ms]" << std::setw(12) << "speedup" << std::endl;
+
+    for (int threads : threadCounts) {
+        omp_set_num_threads(threads);
+        const double sliced = timeInSeconds([&]() {
+            averageSliced(in.data(), out.data(), nx, ny, nz);
+        });
+        const double tiled = timeInSeconds([&]() {
+            averageTiled(in.data(), out.data(), nx, ny, nz);
+        });
+
+        std::cout << std::setw(10) << threads
+            << std::setw(16) << sliced * 1e3
+            << std::setw(16) << tiled * 1e3
+            << std::setw(12) << sliced / tiled << std::endl;
+    }
+}
+
+void benchmarkFlux(const std::string& equation, const std::string& flux,
+    const std::string& reconstruction, const ivec3& dimensions) {
+    auto deviceConfiguration = alsfvm::make_shared<DeviceConfiguration>("cpu");
+    auto simulatorParameters = alsfvm::make_shared<simulator::SimulatorParameters>
+        (equation, "cpu");
+    auto memoryFactory = alsfvm::make_shared<memory::MemoryFactory>
+        (deviceConfiguration);
+    volume::VolumeFactory volumeFactory(equation, memoryFactory);
+    grid::Grid grid(rvec3(0, 0, 0), rvec3(1, 1, 1), dimensions);
+
+    numflux::NumericalFluxFactory fluxFactory(equation, flux, reconstruction,
+        simulatorParameters, deviceConfiguration);
+    auto numericalFlux = fluxFactory.createNumericalFlux(grid);
+    const size_t ghostCells = numericalFlux->getNumberOfGhostCells();
+
+    auto conserved = volumeFactory.createConservedVolume(dimensions.x,
+            dimensions.y, dimensions.z, ghostCells);
+    auto output = volumeFactory.createConservedVolume(dimensions.x,
+            dimensions.y, dimensions.z, ghostCells);
+
+    for (size_t var = 0; var < conserved->getNumberOfVariables(); ++var) {
+        // density and energy 1, momentum 0.1
+        const real value = (var == 0
+                || var == conserved->getNumberOfVariables() - 1) ? 1 : 0.1;
+        conserved->getScalarMemoryArea(var)->makeZero();
+        *conserved->getScalarMemoryArea(var) += value;
+    }
+
+    std::cout << "computeFlux (" << equation << ", " << flux << ", "
+        << reconstruction << ") on " << dimensions << std::endl;
+    std::cout << std::setw(10) << "threads" << std::setw(16) << "time [ms]"
+        << std::setw(12) << "speedup" << std::endl;
+
+    double serialTime = 0;
+
+    for (int threads : threadCounts) {
+        omp_set_num_threads(threads);
+        rvec3 waveSpeed;
+        const double time = timeInSeconds([&]() {
+            numericalFlux->computeFlux(*conserved, waveSpeed, true, *output);
+        });
+
+        if (threads == 1) {
+            serialTime = time;
+        }
+
+        std::cout << std::setw(10) << threads << std::setw(16) << time * 1e3
+            << std::setw(12) << serialTime / time << std::endl;
+    }
+}
+}
+
+class ThreadScalingBenchmark : public ::testing::Test {
+public:
+    ThreadScalingBenchmark() : maxThreads(omp_get_max_threads()) {}
+
+    ~ThreadScalingBenchmark() {
+        omp_set_num_threads(maxThreads);
+    }
+
+    const int maxThreads;
+};
+
+TEST_F(ThreadScalingBenchmark, StencilLoop3D) {
+    benchmarkLoops(128, 128, 128);
+}
+
+TEST_F(ThreadScalingBenchmark, StencilLoopThinSlab) {
+    // Few rows per slice: the sliced version can not use many threads
+    benchmarkLoops(1024, 4, 256);
+}
+
+TEST_F(ThreadScalingBenchmark, NumericalFlux3D) {
+    benchmarkFlux("euler3", "hll3", "wenof2", {64, 64, 64});
+}
+
+TEST_F(ThreadScalingBenchmark, NumericalFlux2D) {
+    benchmarkFlux("euler2", "hll3", "wenof2", {1024, 16, 1});
+}
@@ -0,0 +1,37 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "alsfvm/io/Writer.hpp"
+#include <vector>
+
+//! A writer for the tests: keeps a copy of every volume it is given, along
+//! with the grid and the time it was written at.
+class CopyWriter : public alsfvm::io::Writer {
+public:
+    void write(const alsfvm::volume::Volume& conservedVariables,
+        const alsfvm::grid::Grid& grid,
+        const alsfvm::simulator::TimestepInformation& timestepInformation) override {
+        auto copy = conservedVariables.makeInstance();
+        conservedVariables.copyTo(*copy);
+        volumes.push_back(copy);
+        grids.push_back(grid);
+        times.push_back(timestepInformation.getCurrentTime());
+    }
+
+    std::vector<alsfvm::volume::VolumePointer> volumes;
+    std::vector<alsfvm::grid::Grid> grids;
+    std::vector<alsfvm::real> times;
+};
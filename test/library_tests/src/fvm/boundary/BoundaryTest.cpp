@@ -18,12 +18,91 @@
 #include "alsfvm/boundary/BoundaryFactory.hpp"
 #include "alsfvm/volume/volume_foreach.hpp"
 #include "alsfvm/equation/euler/AllVariables.hpp"
+#include "alsfvm/boundary/Neumann.hpp"
+#include "alsfvm/boundary/Periodic.hpp"
 
 using namespace alsfvm;
 using namespace alsfvm::memory;
 using namespace alsfvm::volume;
 using namespace alsfvm::boundary;
 
+namespace {
+//! Applies the boundary conditions one cell at a time, direction by
+//! direction, side by side, nearest ghost layer first.
+template<class BoundaryConditions>
+void applyCellByCell(Volume& volume, const grid::Grid& grid, int ghostCells) {
+    const int n[3] = {int(volume.getTotalNumberOfXCells()),
+            int(volume.getTotalNumberOfYCells()),
+            int(volume.getTotalNumberOfZCells())
+        };
+
+    for (size_t var = 0; var < volume.getNumberOfVariables(); ++var) {
+        auto view = volume.getScalarMemoryArea(var)->getView();
+
+        for (int d = 0; d < int(grid.getActiveDimension()); ++d) {
+            for (int i = 0; i < 2; ++i) {
+                if (grid.getBoundaryCondition(2 * d + i) == MPI_BC) {
+                    continue;
+                }
+
+                int start[3] = {0, 0, 0};
+                int end[3] = {n[0], n[1], n[2]};
+                start[d] = i == 0 ? ghostCells : n[d] - ghostCells - 1;
+                end[d] = start[d] + 1;
+
+                for (int z = start[2]; z < end[2]; ++z) {
+                    for (int y = start[1]; y < end[1]; ++y) {
+                        for (int x = start[0]; x < end[0]; ++x) {
+                            for (int b = 1; b <= ghostCells; ++b) {
+                                BoundaryConditions::applyBoundary(view, x, y, z, b,
+                                    ghostCells, i == 1, d == 0, d == 1, d == 2);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+template<class BoundaryConditions>
+void checkSameAsCellByCell(const std::string& name, ivec3 size,
+    int ghostCells, const std::array<boundary::Type, 6>& conditions) {
+    auto deviceConfiguration = alsfvm::make_shared<DeviceConfiguration>("cpu");
+    auto memoryFactory = alsfvm::make_shared<MemoryFactory>(deviceConfiguration);
+    VolumeFactory volumeFactory("euler3", memoryFactory);
+    grid::Grid grid(rvec3(0, 0, 0), rvec3(1, 1, 1), size, conditions);
+
+    auto fused = volumeFactory.createConservedVolume(size.x, size.y, size.z,
+            ghostCells);
+    auto expected = volumeFactory.createConservedVolume(size.x, size.y, size.z,
+            ghostCells);
+
+    for (size_t var = 0; var < fused->getNumberOfVariables(); ++var) {
+        auto& a = *fused->getScalarMemoryArea(var);
+        auto& b = *expected->getScalarMemoryArea(var);
+
+        for (size_t i = 0; i < a.getSize(); ++i) {
+            a[i] = 1000 * var + real(i % 997);
+            b[i] = a[i];
+        }
+    }
+
+    BoundaryFactory(name, deviceConfiguration).createBoundary(
+        ghostCells)->applyBoundaryConditions(*fused, grid);
+    applyCellByCell<BoundaryConditions>(*expected, grid, ghostCells);
+
+    for (size_t var = 0; var < fused->getNumberOfVariables(); ++var) {
+        const auto& a = *fused->getScalarMemoryArea(var);
+        const auto& b = *expected->getScalarMemoryArea(var);
+
+        for (size_t i = 0; i < a.getSize(); ++i) {
+            ASSERT_EQ(b[i], a[i]) << "var = " << var << ", i = " << i;
+        }
+    }
+}
+}
+
 struct BoundaryTest : public ::testing::Test {
     alsfvm::shared_ptr<DeviceConfiguration> deviceConfiguration;
     alsfvm::shared_ptr<MemoryFactory> memoryFactory;
@@ -332,3 +411,24 @@ TEST_F(BoundaryTest, PeriodicTest2CellsVarying2D) {
         ASSERT_EQ(rho.at(ghostCells + nx, y, z), rho.index(2, y, z));
     }
 }
+
+TEST_F(BoundaryTest, NeumannSameAsCellByCell3D) {
+    auto conditions = boundary::allNeumann();
+    checkSameAsCellByCell<Neumann>("neumann", {64, 48, 5}, 3, conditions);
+
+    // Faces where the MPI exchange fills the ghost cells are left alone
+    conditions[3] = MPI_BC;
+    checkSameAsCellByCell<Neumann>("neumann", {7, 9, 11}, 2, conditions);
+}
+
+TEST_F(BoundaryTest, PeriodicSameAsCellByCell3D) {
+    auto conditions = boundary::allPeriodic();
+    checkSameAsCellByCell<Periodic>("periodic", {64, 48, 5}, 3, conditions);
+
+    // Fewer inner cells than ghost cells, the ghost cells are partly
+    // copied from other ghost cells
+    checkSameAsCellByCell<Periodic>("periodic", {2, 9, 1}, 3, conditions);
+
+    conditions[0] = MPI_BC;
+    checkSameAsCellByCell<Periodic>("periodic", {7, 9, 11}, 2, conditions);
+}
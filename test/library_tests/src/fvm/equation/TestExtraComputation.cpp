@@ -146,3 +146,28 @@ TEST_F(TestExtraComputation, CheckConstraints) {
 
 
 }
+
+TEST_F(TestExtraComputation, ConstraintReport) {
+    auto cellComputer = cellComputerFactory.createComputer();
+
+    transform_volume<euler::ConservedVariables<3>, euler::ConservedVariables<3>>
+        (*conservedVolume, *conservedVolume, [](const euler::ConservedVariables<3>& in)
+    -> euler::ConservedVariables<3> {
+        return euler::ConservedVariables<3>(0.5, rvec3{ 1, 1, 1 }, 4.4);
+    });
+
+    ASSERT_TRUE(cellComputer->checkConstraints(*conservedVolume).obeys());
+
+    const size_t lastIndex = conservedVolume->getScalarMemoryArea("rho")->getSize()
+        - 1;
+    conservedVolume->getScalarMemoryArea("rho")->getPointer()[lastIndex] = -0.4;
+    conservedVolume->getScalarMemoryArea("E")->getPointer()[7] = NAN;
+
+    const auto report = cellComputer->checkConstraints(*conservedVolume);
+
+    ASSERT_FALSE(report.obeys());
+    ASSERT_EQ(2u, report.numberOfViolatingCells);
+    ASSERT_EQ(7u, report.firstViolatingIndex);
+    ASSERT_TRUE(report.violations & ConstraintReport::conservedNotFinite);
+    ASSERT_TRUE(report.violations & ConstraintReport::equationConstraints);
+}
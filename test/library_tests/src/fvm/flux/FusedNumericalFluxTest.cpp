@@ -0,0 +1,194 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "alsfvm/types.hpp"
+#include "alsfvm/numflux/NumericalFluxFactory.hpp"
+#include "alsfvm/volume/VolumeFactory.hpp"
+#include <cmath>
+
+using namespace alsfvm;
+
+struct FusedNumericalFluxTestParameters {
+    std::string equation;
+    std::string flux;
+    std::string reconstruction;
+    ivec3 dimensions;
+
+    FusedNumericalFluxTestParameters(const std::string& equation,
+        const std::string& flux,
+        const std::string& reconstruction,
+        const ivec3& dimensions)
+        : equation(equation), flux(flux), reconstruction(reconstruction),
+          dimensions(dimensions) {
+
+    }
+};
+
+std::ostream& operator<<(std::ostream& os,
+    const FusedNumericalFluxTestParameters& parameters) {
+    os << "\n{\n\tequation = " << parameters.equation
+        << "\n\tflux = " << parameters.flux
+        << "\n\treconstruction = " << parameters.reconstruction
+        << "\n\tdimensions = " << parameters.dimensions
+        << "\n}\n" << std::endl;
+    return os;
+}
+
+class FusedNumericalFluxTest : public ::testing::TestWithParam
+    <FusedNumericalFluxTestParameters> {
+public:
+    FusedNumericalFluxTestParameters parameters;
+    alsfvm::shared_ptr<DeviceConfiguration> deviceConfiguration;
+    alsfvm::shared_ptr<simulator::SimulatorParameters> simulatorParameters;
+    alsfvm::shared_ptr<simulator::SimulatorParameters> simulatorParametersFused;
+    grid::Grid grid;
+    alsfvm::shared_ptr<memory::MemoryFactory> memoryFactory;
+    volume::VolumeFactory volumeFactory;
+
+    FusedNumericalFluxTest()
+        : parameters(GetParam()),
+          deviceConfiguration(new DeviceConfiguration("cpu")),
+          simulatorParameters(new simulator::SimulatorParameters(parameters.equation,
+                  "cpu")),
+          simulatorParametersFused(new simulator::SimulatorParameters(
+                  parameters.equation, "cpu")),
+          grid(rvec3(0, 0, 0), rvec3(1, 1, 1), parameters.dimensions),
+          memoryFactory(new memory::MemoryFactory(deviceConfiguration)),
+          volumeFactory(parameters.equation, memoryFactory) {
+        simulatorParametersFused->setFluxEngine("fused");
+    }
+
+    alsfvm::shared_ptr<numflux::NumericalFlux> makeFlux(
+        const alsfvm::shared_ptr<simulator::SimulatorParameters>& simulatorParameters) {
+        numflux::NumericalFluxFactory factory(parameters.equation, parameters.flux,
+            parameters.reconstruction, simulatorParameters, deviceConfiguration);
+        return factory.createNumericalFlux(grid);
+    }
+
+    // Fills every cell (including ghost cells) with a smooth, non-periodic
+    // state with positive density and pressure.
+    void fill(volume::Volume& volume) {
+        const size_t numberOfVariables = volume.getNumberOfVariables();
+
+        for (size_t var = 0; var < numberOfVariables; ++var) {
+            auto memory = volume.getScalarMemoryArea(var);
+            const size_t nx = volume.getTotalNumberOfXCells();
+            const size_t ny = volume.getTotalNumberOfYCells();
+            const size_t nz = volume.getTotalNumberOfZCells();
+
+            for (size_t z = 0; z < nz; ++z) {
+                for (size_t y = 0; y < ny; ++y) {
+                    for (size_t x = 0; x < nx; ++x) {
+                        const real s = std::sin(0.7 * x + 1.3 * y + 0.4 * z + var);
+                        real value = 0.2 * s;
+
+                        if (parameters.equation != "burgers") {
+                            if (var == 0) {
+                                value = 1 + 0.3 * s;
+                            } else if (var == numberOfVariables - 1) {
+                                value = 10 + s;
+                            }
+                        }
+
+                        (*memory)[z * nx * ny + y * nx + x] = value;
+                    }
+                }
+            }
+        }
+    }
+};
+
+TEST_P(FusedNumericalFluxTest, SameAsStandardFlux) {
+    auto standardFlux = makeFlux(simulatorParameters);
+    auto fusedFlux = makeFlux(simulatorParametersFused);
+
+    const size_t ghostCells = std::max(standardFlux->getNumberOfGhostCells(),
+            fusedFlux->getNumberOfGhostCells());
+    const ivec3 dimensions = parameters.dimensions;
+
+    auto conservedVariables = volumeFactory.createConservedVolume(dimensions.x,
+            dimensions.y, dimensions.z, ghostCells);
+    fill(*conservedVariables);
+
+    auto outputStandard = volumeFactory.createConservedVolume(dimensions.x,
+            dimensions.y, dimensions.z, ghostCells);
+    auto outputFused = volumeFactory.createConservedVolume(dimensions.x,
+            dimensions.y, dimensions.z, ghostCells);
+
+    outputStandard->makeZero();
+
+    // The fused engine must overwrite the interior, so we do not zero it
+    for (size_t var = 0; var < outputFused->getNumberOfVariables(); ++var) {
+        auto memory = outputFused->getScalarMemoryArea(var);
+
+        for (size_t i = 0; i < memory->getSize(); ++i) {
+            (*memory)[i] = 44;
+        }
+    }
+
+    rvec3 waveSpeedStandard(0, 0, 0);
+    rvec3 waveSpeedFused(0, 0, 0);
+    standardFlux->computeFlux(*conservedVariables, waveSpeedStandard, true,
+        *outputStandard, ivec3(0, 0, 0), ivec3(0, 0, 0));
+    fusedFlux->computeFlux(*conservedVariables, waveSpeedFused, true,
+        *outputFused, ivec3(0, 0, 0), ivec3(0, 0, 0));
+
+    ASSERT_NEAR(waveSpeedStandard.x, waveSpeedFused.x, 1e-12);
+    ASSERT_NEAR(waveSpeedStandard.y, waveSpeedFused.y, 1e-12);
+    ASSERT_NEAR(waveSpeedStandard.z, waveSpeedFused.z, 1e-12);
+
+    const size_t nx = outputStandard->getTotalNumberOfXCells();
+    const size_t ny = outputStandard->getTotalNumberOfYCells();
+    const size_t ngx = outputStandard->getNumberOfXGhostCells();
+    const size_t ngy = outputStandard->getNumberOfYGhostCells();
+    const size_t ngz = outputStandard->getNumberOfZGhostCells();
+
+    for (size_t var = 0; var < outputStandard->getNumberOfVariables(); ++var) {
+        auto standard = outputStandard->getScalarMemoryArea(var);
+        auto fused = outputFused->getScalarMemoryArea(var);
+
+        for (size_t z = ngz; z < ngz + dimensions.z; ++z) {
+            for (size_t y = ngy; y < ngy + dimensions.y; ++y) {
+                for (size_t x = ngx; x < ngx + dimensions.x; ++x) {
+                    const size_t index = z * nx * ny + y * nx + x;
+                    ASSERT_NEAR((*standard)[index], (*fused)[index], 1e-12)
+                            << "Mismatch at (" << x << ", " << y << ", " << z
+                                << "), variable " << var;
+                }
+            }
+        }
+    }
+}
+
+TEST_P(FusedNumericalFluxTest, UnknownEngineThrows) {
+    simulatorParametersFused->setFluxEngine("unknown");
+    ASSERT_ANY_THROW(makeFlux(simulatorParametersFused));
+}
+
+INSTANTIATE_TEST_CASE_P(FusedNumericalFluxTests,
+    FusedNumericalFluxTest,
+    ::testing::Values(
+        FusedNumericalFluxTestParameters("euler1", "hll3", "none", ivec3(40, 1, 1)),
+        FusedNumericalFluxTestParameters("euler1", "hll", "mc", ivec3(40, 1, 1)),
+        FusedNumericalFluxTestParameters("euler2", "hll3", "wenof2", ivec3(37, 21, 1)),
+        FusedNumericalFluxTestParameters("euler2", "tecno1", "weno2", ivec3(16, 40, 1)),
+        FusedNumericalFluxTestParameters("euler2", "central", "mm", ivec3(33, 9, 1)),
+        FusedNumericalFluxTestParameters("euler3", "hll3", "none", ivec3(35, 6, 5)),
+        FusedNumericalFluxTestParameters("euler3", "hll3", "wenof2", ivec3(12, 7, 9)),
+        FusedNumericalFluxTestParameters("burgers", "rusanov", "weno2", ivec3(40, 1,
+                1))
+    ));
@@ -0,0 +1,180 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include "alsfvm/types.hpp"
+#include "alsfvm/numflux/NumericalFluxFactory.hpp"
+#include "alsfvm/volume/VolumeFactory.hpp"
+#include <cmath>
+
+using namespace alsfvm;
+
+struct PrimitiveCacheTestParameters {
+    std::string equation;
+    std::string flux;
+    ivec3 dimensions;
+
+    PrimitiveCacheTestParameters(const std::string& equation,
+        const std::string& flux,
+        const ivec3& dimensions)
+        : equation(equation), flux(flux), dimensions(dimensions) {
+
+    }
+};
+
+std::ostream& operator<<(std::ostream& os,
+    const PrimitiveCacheTestParameters& parameters) {
+    os << "\n{\n\tequation = " << parameters.equation
+        << "\n\tflux = " << parameters.flux
+        << "\n\tdimensions = " << parameters.dimensions
+        << "\n}\n" << std::endl;
+    return os;
+}
+
+class PrimitiveCacheTest : public ::testing::TestWithParam
+    <PrimitiveCacheTestParameters> {
+public:
+    PrimitiveCacheTestParameters parameters;
+    alsfvm::shared_ptr<DeviceConfiguration> deviceConfiguration;
+    alsfvm::shared_ptr<simulator::SimulatorParameters> simulatorParameters;
+    alsfvm::shared_ptr<simulator::SimulatorParameters> simulatorParametersCached;
+    grid::Grid grid;
+    alsfvm::shared_ptr<memory::MemoryFactory> memoryFactory;
+    volume::VolumeFactory volumeFactory;
+
+    PrimitiveCacheTest()
+        : parameters(GetParam()),
+          deviceConfiguration(new DeviceConfiguration("cpu")),
+          simulatorParameters(new simulator::SimulatorParameters(parameters.equation,
+                  "cpu")),
+          simulatorParametersCached(new simulator::SimulatorParameters(
+                  parameters.equation, "cpu")),
+          grid(rvec3(0, 0, 0), rvec3(1, 1, 1), parameters.dimensions),
+          memoryFactory(new memory::MemoryFactory(deviceConfiguration)),
+          volumeFactory(parameters.equation, memoryFactory) {
+        simulatorParametersCached->setPrimitiveCache(true);
+    }
+
+    alsfvm::shared_ptr<numflux::NumericalFlux> makeFlux(
+        const alsfvm::shared_ptr<simulator::SimulatorParameters>& simulatorParameters,
+        const std::string& reconstruction = "none") {
+        numflux::NumericalFluxFactory factory(parameters.equation, parameters.flux,
+            reconstruction, simulatorParameters, deviceConfiguration);
+        return factory.createNumericalFlux(grid);
+    }
+
+    // Fills every cell (including ghost cells) with a smooth state with
+    // positive density and pressure.
+    void fill(volume::Volume& volume) {
+        const size_t numberOfVariables = volume.getNumberOfVariables();
+
+        for (size_t var = 0; var < numberOfVariables; ++var) {
+            auto memory = volume.getScalarMemoryArea(var);
+
+            for (size_t i = 0; i < memory->getSize(); ++i) {
+                const real s = std::sin(0.37 * i + var);
+                real value = 0.2 * s;
+
+                if (var == 0) {
+                    value = 1 + 0.3 * s;
+                } else if (var == numberOfVariables - 1) {
+                    value = 10 + s;
+                }
+
+                (*memory)[i] = value;
+            }
+        }
+    }
+
+    void compare(const ivec3& start, const ivec3& end) {
+        auto standardFlux = makeFlux(simulatorParameters);
+        auto cachedFlux = makeFlux(simulatorParametersCached);
+
+        const size_t ghostCells = standardFlux->getNumberOfGhostCells();
+        ASSERT_EQ(ghostCells, cachedFlux->getNumberOfGhostCells());
+        const ivec3 dimensions = parameters.dimensions;
+
+        auto conservedVariables = volumeFactory.createConservedVolume(dimensions.x,
+                dimensions.y, dimensions.z, ghostCells);
+        fill(*conservedVariables);
+
+        auto outputStandard = volumeFactory.createConservedVolume(dimensions.x,
+                dimensions.y, dimensions.z, ghostCells);
+        auto outputCached = volumeFactory.createConservedVolume(dimensions.x,
+                dimensions.y, dimensions.z, ghostCells);
+        outputStandard->makeZero();
+        outputCached->makeZero();
+
+        rvec3 waveSpeedStandard(0, 0, 0);
+        rvec3 waveSpeedCached(0, 0, 0);
+
+        // twice, so that the second evaluation reuses the cache volume
+        for (int evaluation = 0; evaluation < 2; ++evaluation) {
+            standardFlux->computeFlux(*conservedVariables, waveSpeedStandard, true,
+                *outputStandard, start, end);
+            cachedFlux->computeFlux(*conservedVariables, waveSpeedCached, true,
+                *outputCached, start, end);
+        }
+
+        ASSERT_NEAR(waveSpeedStandard.x, waveSpeedCached.x, 1e-12);
+        ASSERT_NEAR(waveSpeedStandard.y, waveSpeedCached.y, 1e-12);
+        ASSERT_NEAR(waveSpeedStandard.z, waveSpeedCached.z, 1e-12);
+
+        for (size_t var = 0; var < outputStandard->getNumberOfVariables(); ++var) {
+            auto standard = outputStandard->getScalarMemoryArea(var);
+            auto cached = outputCached->getScalarMemoryArea(var);
+
+            for (size_t i = 0; i < standard->getSize(); ++i) {
+                ASSERT_NEAR((*standard)[i], (*cached)[i], 1e-12)
+                        << "Mismatch at " << i << ", variable " << var;
+            }
+        }
+    }
+};
+
+TEST_P(PrimitiveCacheTest, SameAsWithoutCache) {
+    compare(ivec3(0, 0, 0), ivec3(0, 0, 0));
+}
+
+TEST_P(PrimitiveCacheTest, SameAsWithoutCacheOnSubdomain) {
+    const ivec3 offset(1, parameters.dimensions.y > 1, parameters.dimensions.z > 1);
+    compare(offset, -2 * offset);
+}
+
+TEST_P(PrimitiveCacheTest, ThrowsWithReconstruction) {
+    ASSERT_ANY_THROW(makeFlux(simulatorParametersCached, "weno2"));
+}
+
+INSTANTIATE_TEST_CASE_P(PrimitiveCacheTests,
+    PrimitiveCacheTest,
+    ::testing::Values(
+        PrimitiveCacheTestParameters("euler1", "hll", ivec3(40, 1, 1)),
+        PrimitiveCacheTestParameters("euler2", "hll3", ivec3(37, 21, 1)),
+        PrimitiveCacheTestParameters("euler2", "tecno4", ivec3(16, 20, 1)),
+        PrimitiveCacheTestParameters("euler3", "hll3", ivec3(13, 6, 5)),
+        PrimitiveCacheTestParameters("euler3", "tecno6", ivec3(9, 8, 7)),
+        PrimitiveCacheTestParameters("euler3", "rusanov", ivec3(11, 5, 6))
+    ));
+
+TEST(PrimitiveCacheOtherEquationTest, ThrowsForBurgers) {
+    auto deviceConfiguration = alsfvm::make_shared<DeviceConfiguration>("cpu");
+    auto simulatorParameters = alsfvm::make_shared<simulator::SimulatorParameters>
+        ("burgers", "cpu");
+    simulatorParameters->setPrimitiveCache(true);
+    grid::Grid grid(rvec3(0, 0, 0), rvec3(1, 1, 1), ivec3(20, 1, 1));
+    numflux::NumericalFluxFactory factory("burgers", "godunov", "none",
+        simulatorParameters, deviceConfiguration);
+    ASSERT_ANY_THROW(factory.createNumericalFlux(grid));
+}
@@ -0,0 +1,223 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "alsfvm/equation/euler/Euler.hpp"
+#include "alsfvm/numflux/euler/simd/flux_row.hpp"
+#include "alsutils/simd/batch.hpp"
+#include <random>
+#include <vector>
+
+using namespace alsfvm;
+using namespace alsfvm::equation::euler;
+using namespace alsfvm::numflux;
+using alsutils::simd::InstructionSet;
+
+namespace {
+
+// Compares the vectorized row kernels against the scalar flux, cell by cell,
+// for every instruction set the CPU supports.
+template<class Flux, int nsd, int direction>
+void checkFluxRow() {
+    const size_t count = 37; // not divisible by any batch width
+    const size_t offset = 3;
+    const size_t size = count + offset;
+    EulerParameters parameters;
+    Euler<nsd> equation(parameters);
+
+    std::mt19937 generator(nsd * 10 + direction);
+    std::uniform_real_distribution<real> positive(0.5, 2);
+    // Velocities large enough to also hit the supersonic branches
+    std::uniform_real_distribution<real> velocity(-4, 4);
+
+    std::vector<ConservedVariables<nsd>> left(size), right(size);
+    std::vector<std::vector<real>> leftData(nsd + 2, std::vector<real>(size));
+    std::vector<std::vector<real>> rightData(nsd + 2, std::vector<real>(size));
+
+    for (size_t i = 0; i < size; ++i) {
+        for (int side = 0; side < 2; ++side) {
+            const real rho = positive(generator);
+            typename Types<nsd>::rvec u;
+
+            for (int d = 0; d < nsd; ++d) {
+                u[d] = velocity(generator);
+            }
+
+            ConservedVariables<nsd> conserved;
+            conserved.rho = rho;
+            conserved.m = rho * u;
+            conserved.E = positive(generator) / (parameters.getGamma() - 1) +
+                0.5 * rho * u.dot(u);
+
+            // Make some faces have identical left and right states
+            if (side == 1 && i % 5 == 0) {
+                conserved = left[i];
+            }
+
+            (side == 0 ? left[i] : right[i]) = conserved;
+            auto& data = side == 0 ? leftData : rightData;
+
+            for (int var = 0; var < nsd + 2; ++var) {
+                data[var][i] = conserved[var];
+            }
+        }
+    }
+
+    std::vector<const real*> leftPointers, rightPointers;
+
+    for (int var = 0; var < nsd + 2; ++var) {
+        leftPointers.push_back(leftData[var].data());
+        rightPointers.push_back(rightData[var].data());
+    }
+
+    const auto highest = alsutils::simd::getHighestSupportedInstructionSet();
+
+    for (int isa = 0; isa <= int(highest); ++isa) {
+        const auto instructionSet = InstructionSet(isa);
+        std::vector<std::vector<real>> outputData(nsd + 2,
+            std::vector<real>(size, 42));
+        std::vector<real*> outputPointers;
+
+        for (int var = 0; var < nsd + 2; ++var) {
+            outputPointers.push_back(outputData[var].data());
+        }
+
+        const size_t first = 1;
+        const size_t rowCount = count - first;
+        const real waveSpeed = euler::simd::computeFluxRow <
+            euler::simd::simd_flux_traits<Flux>::kind, nsd, direction > (
+                instructionSet, equation.getGamma(),
+                leftPointers.data(), rightPointers.data(),
+                outputPointers.data(), first, rowCount, offset);
+
+        real expectedWaveSpeed = 0;
+
+        for (size_t i = first; i < first + rowCount; ++i) {
+            ConservedVariables<nsd> flux;
+            expectedWaveSpeed = std::max(expectedWaveSpeed,
+                    Flux::template computeFlux<direction>(equation,
+                        AllVariables<nsd>(left[i], equation.computeExtra(left[i])),
+                        AllVariables<nsd>(right[i + offset],
+                            equation.computeExtra(right[i + offset])),
+                        flux));
+
+            for (int var = 0; var < nsd + 2; ++var) {
+                ASSERT_NEAR(-flux[var], outputData[var][i],
+                    1e-10 * (1 + std::abs(flux[var])))
+                        << "instruction set = " << toString(instructionSet)
+                            << ", i = " << i << ", var = " << var;
+            }
+        }
+
+        ASSERT_NEAR(expectedWaveSpeed, waveSpeed, 1e-10 * expectedWaveSpeed)
+                << "instruction set = " << toString(instructionSet);
+
+        // Nothing outside the row is touched
+        for (int var = 0; var < nsd + 2; ++var) {
+            ASSERT_EQ(42, outputData[var][0]);
+            ASSERT_EQ(42, outputData[var][first + rowCount]);
+        }
+    }
+}
+
+template<template<int> class Flux>
+void checkAllDirections() {
+    checkFluxRow<Flux<1>, 1, 0>();
+    checkFluxRow<Flux<2>, 2, 0>();
+    checkFluxRow<Flux<2>, 2, 1>();
+    checkFluxRow<Flux<3>, 3, 0>();
+    checkFluxRow<Flux<3>, 3, 1>();
+    checkFluxRow<Flux<3>, 3, 2>();
+}
+
+template<int nsd>
+using EulerCentral = Central<Euler<nsd>>;
+}
+
+TEST(SIMDFluxTest, HLL) {
+    checkAllDirections<euler::HLL>();
+}
+
+TEST(SIMDFluxTest, HLL3) {
+    checkAllDirections<euler::HLL3>();
+}
+
+TEST(SIMDFluxTest, Rusanov) {
+    checkAllDirections<euler::Rusanov>();
+}
+
+TEST(SIMDFluxTest, Central) {
+    checkAllDirections<EulerCentral>();
+}
+
+TEST(SIMDFluxTest, RusanovMatchesDefinition) {
+    EulerParameters parameters;
+    Euler<1> equation(parameters);
+    AllVariables<1> left = equation.makeAllVariables(1, rvec1(0.5), 2.5);
+    AllVariables<1> right = equation.makeAllVariables(0.125, rvec1(-0.1), 0.25);
+
+    ConservedVariables<1> flux;
+    const real waveSpeed = euler::Rusanov<1>::computeFlux<0>(equation, left, right,
+            flux);
+
+    ConservedVariables<1> fluxLeft, fluxRight;
+    equation.computePointFlux<0>(left, fluxLeft);
+    equation.computePointFlux<0>(right, fluxRight);
+    const real expectedWaveSpeed = std::max(
+            equation.computeWaveSpeed<0>(left, left),
+            equation.computeWaveSpeed<0>(right, right));
+
+    ASSERT_EQ(expectedWaveSpeed, waveSpeed);
+
+    for (int var = 0; var < 3; ++var) {
+        ASSERT_DOUBLE_EQ(0.5 * (fluxLeft[var] + fluxRight[var])
+            - 0.5 * expectedWaveSpeed * (right.conserved()[var] - left.conserved()[var]), flux[var]);
+    }
+}
+
+TEST(SIMDFluxTest, BatchSelectAndPartialLoad) {
+    typedef alsutils::simd::batch<real, 4> batch;
+    const real values[] = {1, -2, 3, -4};
+    const auto a = batch::load(values);
+    const auto b = batch::loadPartial(values, 2);
+
+    ASSERT_EQ(1, b[2]);
+    ASSERT_EQ(1, b[3]);
+
+    const auto absolute = alsutils::simd::fabs(a);
+    const auto selected = alsutils::simd::select(a > real(0), a, batch(0));
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_EQ(std::abs(values[i]), absolute[i]);
+        ASSERT_EQ(values[i] > 0 ? values[i] : 0, selected[i]);
+    }
+
+    ASSERT_EQ(3, alsutils::simd::horizontalMax(a));
+    ASSERT_EQ(real(2), alsutils::simd::horizontalMax(
+            alsutils::simd::fmax(b, batch(2))));
+}
+
+TEST(SIMDFluxTest, InstructionSetNames) {
+    for (auto instructionSet : {
+            InstructionSet::scalar, InstructionSet::sse,
+            InstructionSet::avx2, InstructionSet::avx512
+        }) {
+        ASSERT_EQ(instructionSet, alsutils::simd::instructionSetFromString(
+                toString(instructionSet)));
+    }
+
+    ASSERT_ANY_THROW(alsutils::simd::instructionSetFromString("mmx"));
+    ASSERT_TRUE(alsutils::simd::isInstructionSetSupported(InstructionSet::scalar));
+}
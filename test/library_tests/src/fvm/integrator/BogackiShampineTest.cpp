@@ -0,0 +1,131 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include "alsfvm/integrator/BogackiShampine.hpp"
+#include <cmath>
+using namespace alsfvm;
+using namespace alsfvm::integrator;
+
+namespace {
+
+// Represents the system du/dt = u, with the given wave speed (for the CFL)
+class ODESystem : public System {
+public:
+    real waveSpeed;
+    ODESystem(real waveSpeed) : waveSpeed(waveSpeed) {}
+    size_t getNumberOfGhostCells() {
+        return 0;
+    }
+
+    void operator()( volume::Volume& conservedVariables,
+        rvec3& waveSpeeds, bool computeWaveSpeeds,
+        volume::Volume& output) override {
+        output.getScalarMemoryArea(0)->getPointer()[0] =
+            conservedVariables.getScalarMemoryArea(0)->getPointer()[0];
+        waveSpeeds = rvec3(waveSpeed, 0, 0);
+    }
+};
+
+// Makes sure we hit the end time exactly
+class EndTimeAdjuster : public TimestepAdjuster {
+public:
+    real adjustTimestep(real dt,
+        const simulator::TimestepInformation& timestepInformation) const override {
+        return std::min(dt, 1 - timestepInformation.getCurrentTime());
+    }
+};
+
+struct Result {
+    real value;
+    size_t numberOfSteps;
+    size_t numberOfRejectedSteps;
+};
+
+// Integrates du/dt = u, u(0) = 1 up to t = 1 the same way Simulator does
+Result integrate(real tolerance, real waveSpeed) {
+    std::vector<std::string> variableNames = { "u" };
+    auto configuration = alsfvm::make_shared<alsfvm::DeviceConfiguration>("cpu");
+    auto factory = alsfvm::make_shared<alsfvm::memory::MemoryFactory>
+        (configuration);
+
+    alsfvm::shared_ptr<System> system(new ODESystem(waveSpeed));
+    BogackiShampine integrator(system, tolerance);
+    alsfvm::shared_ptr<TimestepAdjuster> adjuster(new EndTimeAdjuster);
+    integrator.addTimestepAdjuster(adjuster);
+
+    std::vector<alsfvm::shared_ptr<alsfvm::volume::Volume> >
+    volumes(integrator.getNumberOfRegisters());
+
+    for (auto& volume : volumes) {
+        volume.reset(new alsfvm::volume::Volume(variableNames, factory, 1, 1, 1));
+        volume->getScalarMemoryArea(0)->getPointer()[0] = 1;
+    }
+
+    simulator::TimestepInformation timestepInformation;
+    size_t numberOfSteps = 0;
+
+    while (timestepInformation.getCurrentTime() < 1) {
+        real dt = 0;
+
+        do {
+            for (size_t substep = 0; substep < integrator.getNumberOfSubsteps();
+                ++substep) {
+                auto& output = volumes[integrator.getOutputRegister(substep)];
+                dt = integrator.performSubstep(volumes, rvec3(1, 1, 1), dt, 1,
+                        *output, substep, timestepInformation);
+            }
+        } while (!integrator.isStepAccepted());
+
+        volumes[0].swap(volumes[integrator.getSolutionRegister()]);
+        timestepInformation.incrementTime(dt);
+        numberOfSteps++;
+    }
+
+    return {volumes[0]->getScalarMemoryArea(0)->getPointer()[0],
+            numberOfSteps, integrator.getNumberOfRejectedSteps()};
+}
+}
+
+TEST(BogackiShampineTest, ReachesTolerance) {
+    // The CFL timestep is 1, far too large for the tolerance
+    for (real tolerance : {
+            1e-3, 1e-5, 1e-7
+        }) {
+        const auto result = integrate(tolerance, 1);
+
+        // The error accumulates over the steps, but should be close to
+        // the tolerance
+        EXPECT_LE(std::abs(result.value - std::exp(1.)), 10 * tolerance * std::exp(1.))
+                << "tolerance = " << tolerance;
+        EXPECT_GT(result.numberOfRejectedSteps, 0u);
+    }
+}
+
+TEST(BogackiShampineTest, FewerStepsForLooserTolerance) {
+    const auto tight = integrate(1e-8, 1);
+    const auto loose = integrate(1e-4, 1);
+
+    EXPECT_LT(loose.numberOfSteps, tight.numberOfSteps);
+    EXPECT_LT(std::abs(tight.value - std::exp(1.)), std::abs(loose.value - std::exp(1.)));
+}
+
+TEST(BogackiShampineTest, CappedByCFL) {
+    // With a loose tolerance, the CFL timestep 1/64 is used throughout
+    const auto result = integrate(1, 64);
+
+    EXPECT_EQ(64u, result.numberOfSteps);
+    EXPECT_EQ(0u, result.numberOfRejectedSteps);
+}
@@ -44,13 +44,23 @@ public:
 }
 struct IntegratorParameters {
     IntegratorParameters(const std::string& name,
-        double expectedConvergenceRate) :
+        double expectedConvergenceRate,
+        size_t startK = std::is_same<real, float>::value ? 3 : 5,
+        size_t endK = 9) :
         name(name),
-        expectedConvergenceRate(expectedConvergenceRate)
+        expectedConvergenceRate(expectedConvergenceRate),
+        startK(startK),
+        endK(endK)
     {}
 
     std::string name;
     double expectedConvergenceRate;
+
+    //! The resolutions are 2^(k+1) timesteps for startK <= k < endK. The
+    //! very accurate many stage methods reach round off at the finest
+    //! resolutions, so they use coarser ones.
+    size_t startK;
+    size_t endK;
 };
 
 std::ostream& operator<<(std::ostream& os,
@@ -67,11 +77,15 @@ public:
 
     IntegratorConvergenceTest() :
         name(GetParam().name),
-        expectedConvergenceRate(GetParam().expectedConvergenceRate) {
+        expectedConvergenceRate(GetParam().expectedConvergenceRate),
+        startK(GetParam().startK),
+        endK(GetParam().endK) {
     }
 
     std::string name;
     double expectedConvergenceRate;
+    size_t startK;
+    size_t endK;
 };
 
 TEST_P(IntegratorConvergenceTest, ConvergenceTest) {
@@ -97,10 +111,6 @@ TEST_P(IntegratorConvergenceTest, ConvergenceTest) {
     std::vector<double> errors;
     std::vector<double> resolutions;
 
-
-    const size_t startK = std::is_same<real, float>::value ? 3 : 5;
-    const size_t endK = std::is_same<real, float>::value ? 9 : 9;
-
     for (size_t k = startK; k < endK; ++k) {
         const size_t N = (2 << k);
         const double dt = real(1) / real(N);
@@ -109,7 +119,7 @@ TEST_P(IntegratorConvergenceTest, ConvergenceTest) {
         IntegratorFactory integratorFactory(name);
         auto integrator = integratorFactory.createIntegrator(flux);
         std::vector<alsfvm::shared_ptr<alsfvm::volume::Volume> >
-        volumes(integrator->getNumberOfSubsteps() + 1);
+        volumes(integrator->getNumberOfRegisters());
 
         for (auto& volume : volumes) {
             volume.reset(new alsfvm::volume::Volume(variableNames, factory, nx, ny, nz));
@@ -123,16 +133,17 @@ TEST_P(IntegratorConvergenceTest, ConvergenceTest) {
         for (size_t i = 0; i < N; i++) {
             for (size_t substep = 0; substep < integrator->getNumberOfSubsteps();
                 ++substep) {
-                auto& currentVolume = volumes[substep + 1];
+                auto& currentVolume = volumes[integrator->getOutputRegister(substep)];
 
                 // Note that we do not care about spatial resolution here
-                integrator->performSubstep(volumes, rvec3(1, 1, 1), 1, cfl, *currentVolume,
+                integrator->performSubstep(volumes, rvec3(1, 1, 1), 1,
+                    cfl / integrator->getCFLMultiplier(), *currentVolume,
                     substep, timestepInformation);
 
             }
 
             timestepInformation.incrementTime(dt);
-            volumes.back().swap(volumes.front());
+            volumes[integrator->getSolutionRegister()].swap(volumes.front());
             t += dt;
         }
 
@@ -159,7 +170,12 @@ INSTANTIATE_TEST_CASE_P(IntegratorConvergenceTests,
         IntegratorParameters("forwardeuler", 0.9),
         IntegratorParameters("rungekutta2", 1.9),
         IntegratorParameters("rungekutta3", 2.9),
-        IntegratorParameters("rungekutta4", 3.9)
+        IntegratorParameters("rungekutta4", 3.9),
+        IntegratorParameters("williamson3", 2.9),
+        IntegratorParameters("carpenterkennedy4", 3.9),
+        IntegratorParameters("ssprk43", 2.9),
+        IntegratorParameters("ssprk93", 2.9),
+        IntegratorParameters("ssprk104", 3.9, 3, 7)
     ));
 #else
 INSTANTIATE_TEST_CASE_P(IntegratorConvergenceTests,
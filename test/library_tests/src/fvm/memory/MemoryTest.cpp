@@ -612,3 +612,40 @@ TEST(HostMemoryTest, ViewIndexTest2D) {
 }
 
 
+
+TEST(HostMemoryTest, LinearCombinationTest) {
+    size_t size = 10;
+
+    alsfvm::memory::HostMemory<alsfvm::real> a(size);
+    alsfvm::memory::HostMemory<alsfvm::real> b(size);
+    alsfvm::memory::HostMemory<alsfvm::real> c(size);
+
+    for (size_t i = 0; i < size; i++) {
+        a[i] = i;
+        b[i] = 2 * i + 1;
+        c[i] = 42;
+    }
+
+    // c appears on both sides
+    c.assign(0.5 * a - 2 * b + 0.25 * c + 3 * (1 * a + 1 * b));
+
+    for (size_t i = 0; i < size; i++) {
+        const alsfvm::real expected = 0.5 * i - 2 * (2 * i + 1) + 0.25 * 42
+            + 3 * (i + 2 * i + 1);
+        ASSERT_DOUBLE_EQ(expected, c[i]);
+        ASSERT_EQ(i, a[i]);
+    }
+}
+
+TEST(HostMemoryTest, LinearCombinationTooManyTermsTest) {
+    alsfvm::memory::HostMemory<alsfvm::real> a(10);
+
+    auto combination = 1 * a;
+
+    for (size_t term = 1; term < 8; ++term) {
+        combination += 1 * a;
+    }
+
+    ASSERT_EQ(8u, combination.getNumberOfTerms());
+    ASSERT_THROW(combination += 1 * a, std::runtime_error);
+}
@@ -0,0 +1,80 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include "alsfvm/mpi/domain/CartesianDecomposition.hpp"
+#include "alsfvm/mpi/cartesian/block_size.hpp"
+
+using namespace alsfvm;
+
+TEST(CartesianDecompositionTest, UnevenBlocks) {
+    const ivec3 numberOfCells = {10, 8, 1};
+    const ivec3 numberOfProcessors = {3, 4, 1};
+
+    const int expectedSizes[] = {4, 3, 3};
+    const int expectedStarts[] = {0, 4, 7};
+
+    for (int x = 0; x < 3; ++x) {
+        for (int y = 0; y < 4; ++y) {
+            const ivec3 coordinates = {x, y, 0};
+            const auto size = alsfvm::mpi::cartesian::getBlockSize(numberOfCells,
+                    numberOfProcessors, coordinates);
+            const auto start = alsfvm::mpi::cartesian::getBlockStart(numberOfCells,
+                    numberOfProcessors, coordinates);
+
+            EXPECT_EQ(ivec3(expectedSizes[x], 2, 1), size);
+            EXPECT_EQ(ivec3(expectedStarts[x], 2 * y, 0), start);
+        }
+    }
+}
+
+TEST(CartesianDecompositionTest, NumberOfProcessorsPerDirection) {
+    typedef alsfvm::mpi::domain::CartesianDecomposition Decomposition;
+
+    grid::Grid cube({0, 0, 0}, {1, 1, 1}, {64, 64, 64});
+    EXPECT_EQ(ivec3(2, 2, 2), Decomposition::findNumberOfProcessorsPerDirection(8,
+            cube));
+
+    const auto twelve = Decomposition::findNumberOfProcessorsPerDirection(12, cube);
+    EXPECT_EQ(12, twelve.x * twelve.y * twelve.z);
+    EXPECT_EQ(3, std::max(twelve.x, std::max(twelve.y, twelve.z)));
+
+    // Prime number of processors can only be split in one direction
+    const auto prime = Decomposition::findNumberOfProcessorsPerDirection(7, cube);
+    EXPECT_EQ(7, prime.x * prime.y * prime.z);
+    EXPECT_EQ(7, std::max(prime.x, std::max(prime.y, prime.z)));
+
+    // Elongated grids are cut across the long direction
+    grid::Grid rectangle({0, 0, 0}, {4, 1, 0}, {128, 32, 1});
+    EXPECT_EQ(ivec3(4, 1, 1), Decomposition::findNumberOfProcessorsPerDirection(4,
+            rectangle));
+
+    grid::Grid line({0, 0, 0}, {1, 0, 0}, {100, 1, 1});
+    EXPECT_EQ(ivec3(3, 1, 1), Decomposition::findNumberOfProcessorsPerDirection(3,
+            line));
+
+    grid::Grid tooSmall({0, 0, 0}, {1, 0, 0}, {2, 1, 1});
+    EXPECT_THROW(Decomposition::findNumberOfProcessorsPerDirection(3, tooSmall),
+        std::runtime_error);
+
+    // With even blocks only, 6 processors can not split 96 x 35 as 6 x 1
+    grid::Grid uneven({0, 0, 0}, {1, 1, 0}, {96, 35, 1});
+    EXPECT_EQ(ivec3(3, 2, 1), Decomposition::findNumberOfProcessorsPerDirection(6,
+            uneven));
+    EXPECT_EQ(ivec3(6, 1, 1), Decomposition::findNumberOfProcessorsPerDirection(6,
+            uneven, true));
+    EXPECT_THROW(Decomposition::findNumberOfProcessorsPerDirection(9, uneven,
+            true), std::runtime_error);
+}
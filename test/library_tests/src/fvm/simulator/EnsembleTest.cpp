@@ -0,0 +1,253 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//! Checks that advancing samples as an ensemble gives the same as advancing
+//! them one by one. The samples are shifts (by whole cells, on a periodic
+//! domain) of each other, so that their timesteps are the same.
+#include <gtest/gtest.h>
+#include "alsfvm/simulator/Simulator.hpp"
+#include "alsfvm/diffusion/DiffusionFactory.hpp"
+#include "alsfvm/volume/ensemble.hpp"
+#include "CopyWriter.hpp"
+#include <cmath>
+#include <functional>
+
+using namespace alsfvm;
+
+namespace {
+typedef std::function<real(size_t variable, int x, int y)> CellFunction;
+
+//! Sets every inner cell from a function of the variable and the cell index
+class CellInitialData : public init::InitialData {
+public:
+    CellInitialData(const CellFunction& function)
+        : function(function) {
+
+    }
+
+    void setInitialData(volume::Volume& conservedVolume,
+        volume::Volume&,
+        equation::CellComputer&,
+        grid::Grid&) override {
+        const auto ghostCells = conservedVolume.getNumberOfGhostCells();
+        const auto innerSize = conservedVolume.getInnerSize();
+        const auto totalSize = conservedVolume.getTotalDimensions();
+
+        for (size_t var = 0; var < conservedVolume.getNumberOfVariables(); ++var) {
+            real* values = conservedVolume.getScalarMemoryArea(var)->getPointer();
+
+            for (int y = 0; y < innerSize.y; ++y) {
+                for (int x = 0; x < innerSize.x; ++x) {
+                    values[(y + ghostCells.y) * totalSize.x + x + ghostCells.x] =
+                        function(var, x, y);
+                }
+            }
+        }
+    }
+
+    void setParameters(const init::Parameters&) override {}
+
+    boost::property_tree::ptree getDescription() const override {
+        return boost::property_tree::ptree();
+    }
+
+private:
+    CellFunction function;
+};
+
+class EnsembleTest : public ::testing::Test {
+public:
+    const int numberOfTimesteps = 10;
+
+    alsfvm::shared_ptr<simulator::Simulator> makeSimulator(std::string equation,
+        const std::string& flux, const std::string& reconstruction,
+        alsfvm::shared_ptr<grid::Grid> grid, size_t ensembleSize) {
+        auto deviceConfiguration = alsfvm::make_shared<DeviceConfiguration>("cpu");
+        auto simulatorParameters = alsfvm::make_shared<simulator::SimulatorParameters>
+            (equation, "cpu");
+        simulatorParameters->setCFLNumber(0.4);
+        simulatorParameters->setEnsembleSize(ensembleSize);
+
+        auto memoryFactory = alsfvm::make_shared<memory::MemoryFactory>
+            (deviceConfiguration);
+        volume::VolumeFactory volumeFactory(equation, memoryFactory);
+        integrator::IntegratorFactory integratorFactory("rungekutta2");
+        boundary::BoundaryFactory boundaryFactory("periodic", deviceConfiguration);
+        numflux::NumericalFluxFactory numericalFluxFactory(equation, flux,
+            reconstruction, simulatorParameters, deviceConfiguration);
+        equation::CellComputerFactory cellComputerFactory(simulatorParameters,
+            deviceConfiguration);
+        auto diffusionOperator = diffusion::DiffusionFactory().createDiffusionOperator(
+                equation, "none", "none", *grid, *simulatorParameters,
+                deviceConfiguration, memoryFactory, volumeFactory);
+
+        return alsfvm::make_shared<simulator::Simulator>(*simulatorParameters, grid,
+                volumeFactory, integratorFactory, boundaryFactory,
+                numericalFluxFactory, cellComputerFactory, memoryFactory, 1.0,
+                deviceConfiguration, equation, diffusionOperator, "ensemble");
+    }
+
+    //! Advances the initial data given by makeInitialData(shift) for each of
+    //! the shifts, once as an ensemble and once one by one, and compares.
+    void runAndCompare(const std::string& equation, const std::string& flux,
+        const std::string& reconstruction, alsfvm::shared_ptr<grid::Grid> grid,
+        const std::vector<int>& shifts,
+        const std::function<CellFunction(int)>& makeInitialData) {
+        auto ensemble = makeSimulator(equation, flux, reconstruction, grid,
+                shifts.size());
+        ASSERT_EQ(shifts.size(), ensemble->getEnsembleSize());
+        auto ensembleWriter = alsfvm::make_shared<CopyWriter>();
+        ensemble->addWriter(ensembleWriter);
+
+        for (size_t member = 0; member < shifts.size(); ++member) {
+            alsfvm::shared_ptr<init::InitialData> initialData(
+                new CellInitialData(makeInitialData(shifts[member])));
+            ensemble->setInitialValue(initialData, member);
+        }
+
+        for (int timestep = 0; timestep < numberOfTimesteps; ++timestep) {
+            ensemble->performStep();
+        }
+
+        ensembleWriter->volumes.clear();
+        ensemble->callWriters();
+        ASSERT_EQ(shifts.size(), ensembleWriter->volumes.size());
+
+        for (size_t member = 0; member < shifts.size(); ++member) {
+            auto single = makeSimulator(equation, flux, reconstruction, grid, 1);
+            auto singleWriter = alsfvm::make_shared<CopyWriter>();
+            single->addWriter(singleWriter);
+            alsfvm::shared_ptr<init::InitialData> initialData(
+                new CellInitialData(makeInitialData(shifts[member])));
+            single->setInitialValue(initialData);
+
+            for (int timestep = 0; timestep < numberOfTimesteps; ++timestep) {
+                single->performStep();
+            }
+
+            ASSERT_NEAR(single->getCurrentTime(), ensemble->getCurrentTime(), 1e-14);
+
+            singleWriter->volumes.clear();
+            single->callWriters();
+
+            const auto& expected = *singleWriter->volumes[0];
+            const auto& actual = *ensembleWriter->volumes[member];
+            ASSERT_EQ(expected.getTotalDimensions(), actual.getTotalDimensions());
+            const auto size = expected.getTotalDimensions();
+
+            for (size_t var = 0; var < expected.getNumberOfVariables(); ++var) {
+                const real* expectedValues =
+                    expected.getScalarMemoryArea(var)->getPointer();
+                const real* actualValues = actual.getScalarMemoryArea(var)->getPointer();
+
+                for (int index = 0; index < size.x * size.y * size.z; ++index) {
+                    ASSERT_NEAR(expectedValues[index], actualValues[index], 1e-12)
+                            << "member " << member << ", variable " << var
+                            << ", index " << index;
+                }
+            }
+        }
+    }
+};
+}
+
+TEST(EnsembleVolumeTest, CopyToAndFromMembers) {
+    grid::Grid grid({0, 0, 0}, {1, 1, 0}, {8, 6, 1});
+    ASSERT_EQ(2, volume::getEnsembleDirection(grid));
+    ASSERT_EQ(ivec3(8, 6, 5), volume::getEnsembleDimensions(grid, 5));
+    ASSERT_EQ(ivec3(8, 6, 1), volume::getEnsembleDimensions(grid, 1));
+
+    auto deviceConfiguration = alsfvm::make_shared<DeviceConfiguration>("cpu");
+    auto memoryFactory = alsfvm::make_shared<memory::MemoryFactory>
+        (deviceConfiguration);
+    volume::VolumeFactory volumeFactory("euler2", memoryFactory);
+    auto ensemble = volumeFactory.createConservedVolume(8, 6, 5, 2);
+    auto member = volume::makeEnsembleMemberVolume(*ensemble, 2);
+    ASSERT_EQ(ivec3(12, 10, 1), member->getTotalDimensions());
+    ASSERT_EQ(5u, volume::getEnsembleSize(*ensemble, 2));
+
+    for (size_t m = 0; m < 5; ++m) {
+        for (size_t var = 0; var < member->getNumberOfVariables(); ++var) {
+            member->getScalarMemoryArea(var)->makeZero();
+            *member->getScalarMemoryArea(var) += real(10 * m + var);
+        }
+
+        volume::copyToEnsembleMember(*member, 2, m, *ensemble);
+    }
+
+    const size_t memberSize = volume::getEnsembleMemberSize(*ensemble, 2);
+    ASSERT_EQ(12u * 10u, memberSize);
+
+    for (size_t m = 0; m < 5; ++m) {
+        volume::copyFromEnsembleMember(*ensemble, 2, m, *member);
+
+        for (size_t var = 0; var < member->getNumberOfVariables(); ++var) {
+            const real* values = member->getScalarMemoryArea(var)->getPointer();
+            const real* ensembleValues = ensemble->getScalarMemoryArea(var)->getPointer()
+                + volume::getEnsembleMemberOffset(*ensemble, 2, m);
+
+            for (size_t index = 0; index < memberSize; ++index) {
+                ASSERT_EQ(real(10 * m + var), values[index]);
+                ASSERT_EQ(real(10 * m + var), ensembleValues[index]);
+            }
+        }
+    }
+
+    ASSERT_ANY_THROW(volume::copyToEnsembleMember(*member, 2, 5, *ensemble));
+    ASSERT_ANY_THROW(volume::getEnsembleDirection(grid::Grid({0, 0, 0}, {1, 1, 1},
+    {4, 4, 4})));
+}
+
+TEST_F(EnsembleTest, Burgers1D) {
+    const int N = 64;
+    auto grid = alsfvm::make_shared<grid::Grid>(rvec3{0, 0, 0}, rvec3{1, 0, 0},
+            ivec3{N, 1, 1});
+
+    runAndCompare("burgers", "godunov", "weno2", grid, {0, 5, 17, 32, 63},
+    [&](int shift) {
+        return [ = ](size_t, int x, int) {
+            return std::sin(2 * M_PI * (x + shift) / N);
+        };
+    });
+}
+
+TEST_F(EnsembleTest, Euler2D) {
+    const int N = 32;
+    const int M = 16;
+    auto grid = alsfvm::make_shared<grid::Grid>(rvec3{0, 0, 0}, rvec3{1, 1, 0},
+            ivec3{N, M, 1});
+
+    runAndCompare("euler2", "hll3", "wenof2", grid, {0, 3, 11},
+    [&](int shift) {
+        return [ = ](size_t variable, int x, int y) {
+            const real phaseX = 2 * M_PI * (x + shift) / N;
+            const real phaseY = 2 * M_PI * (y + 2 * shift) / M;
+            const real rho = 2 + 0.5 * std::sin(phaseX) * std::cos(phaseY);
+            const real ux = 0.4 * std::cos(phaseY);
+            const real uy = 0.2 * std::sin(phaseX);
+            const real p = 1 + 0.2 * std::cos(phaseX + phaseY);
+            const real values[] = {rho, rho * ux, rho * uy,
+                    p / 0.4 + 0.5 * rho * (ux * ux + uy * uy)
+                };
+            return values[variable];
+        };
+    });
+}
+
+TEST_F(EnsembleTest, ThrowsFor3D) {
+    auto grid = alsfvm::make_shared<grid::Grid>(rvec3{0, 0, 0}, rvec3{1, 1, 1},
+            ivec3{8, 8, 8});
+    ASSERT_ANY_THROW(makeSimulator("euler3", "hll3", "none", grid, 2));
+}
@@ -77,4 +77,140 @@ TEST_F(VolumeForEachTest, EulerTestForAllIndices) {
 
         ASSERT_TRUE(indexFound);
     }
-}
\ No newline at end of file
+}
+TEST_F(VolumeForEachTest, ParallelVisitsEveryIndexOnce) {
+    // Use a box that is not a multiple of the tile size
+    const ivec3 start(1, 2, 0);
+    const ivec3 end(1031, 13, 7);
+    const int sizeX = 1031;
+    const int sizeY = 13;
+    std::vector<int> visits(sizeX * sizeY * 7, 0);
+
+    for_each_cell_index_parallel(start, end, [&](int x, int y, int z) {
+        visits[z * sizeX * sizeY + y * sizeX + x]++;
+    });
+
+    for (int z = 0; z < 7; ++z) {
+        for (int y = 0; y < sizeY; ++y) {
+            for (int x = 0; x < sizeX; ++x) {
+                const bool inside = x >= start.x && y >= start.y && z >= start.z;
+                ASSERT_EQ(inside ? 1 : 0, visits[z * sizeX * sizeY + y * sizeX + x]);
+            }
+        }
+    }
+}
+
+TEST_F(VolumeForEachTest, ParallelReduce) {
+    const ivec3 end(600, 9, 5);
+
+    const int sum = for_each_cell_reduce(ivec3(0, 0, 0), end, 0,
+    [](int x, int y, int z) {
+        return 1;
+    }, [](int a, int b) {
+        return a + b;
+    });
+
+    ASSERT_EQ(600 * 9 * 5, sum);
+
+    const int maximum = for_each_cell_reduce(ivec3(0, 0, 0), end, 0,
+    [](int x, int y, int z) {
+        return x + 1000 * y + 100000 * z;
+    }, [](int a, int b) {
+        return std::max(a, b);
+    });
+
+    ASSERT_EQ(599 + 1000 * 8 + 100000 * 4, maximum);
+
+    // empty box gives the initial value
+    ASSERT_EQ(-1, for_each_cell_reduce(ivec3(3, 0, 0),
+    ivec3(3, 9, 5), -1, [](int, int, int) {
+        return 5;
+    }, [](int a, int b) {
+        return std::max(a, b);
+    }));
+}
+
+TEST_F(VolumeForEachTest, ReduceIsIndependentOfNumberOfThreads) {
+    const ivec3 end(1000, 13, 7);
+    auto value = [](int x, int y, int z) {
+        return std::sin(real(x + 1000 * y + 13000 * z)) * 1e-3 + 1.0 / (x + 1);
+    };
+
+#ifdef _OPENMP
+    const int maxThreads = omp_get_max_threads();
+#else
+    const int maxThreads = 1;
+#endif
+    std::vector<real> sums;
+
+    for (int threads : {
+            1, 2, 3, maxThreads
+        }) {
+#ifdef _OPENMP
+        omp_set_num_threads(threads);
+#endif
+        sums.push_back(for_each_cell_reduce(ivec3(0, 0, 0), end, real(0), value,
+                reductions::Sum()));
+    }
+
+#ifdef _OPENMP
+    omp_set_num_threads(maxThreads);
+#endif
+
+    for (real sum : sums) {
+        ASSERT_EQ(sums[0], sum);
+    }
+
+    real serialSum = 0;
+
+    for (int z = 0; z < end.z; ++z) {
+        for (int y = 0; y < end.y; ++y) {
+            for (int x = 0; x < end.x; ++x) {
+                serialSum += value(x, y, z);
+            }
+        }
+    }
+
+    ASSERT_NEAR(serialSum, sums[0], 1e-10 * std::abs(serialSum));
+}
+
+TEST_F(VolumeForEachTest, ReduceRangeAndComponents) {
+    const ivec3 end(70, 9, 5);
+
+    const auto range = for_each_cell_reduce(ivec3(0, 0, 0), end,
+            reductions::Range<real>::empty(), [](int x, int y, int z) {
+        return reductions::Range<real>::of(real(x - 2 * y + 3 * z));
+    }, reductions::MinMax());
+
+    ASSERT_EQ(-16, range.minimum);
+    ASSERT_EQ(69 + 12, range.maximum);
+
+    const auto sums = for_each_cell_reduce(ivec3(0, 0, 0), end,
+            std::array<real, 2> {{0, 0}}, [](int x, int y, int z) {
+        return std::array<real, 2> {{1, real(x)}};
+    }, reductions::Sum());
+
+    ASSERT_EQ(70 * 9 * 5, sums[0]);
+    ASSERT_EQ(9 * 5 * (69 * 70 / 2), sums[1]);
+}
+
+TEST_F(VolumeForEachTest, MidpointReduce) {
+    grid::Grid grid(rvec3(0, 0, 0), rvec3(1, 1, 1), ivec3(nx, ny, nz));
+    auto volume = volumeFactory.createConservedVolume(nx, ny, nz, 2);
+
+    real serialSum = 0;
+    size_t serialCount = 0;
+    for_each_midpoint(*volume, grid, [&](real x, real y, real z,
+    size_t index) {
+        serialSum += x + 2 * y + 3 * z + index;
+        serialCount++;
+    });
+
+    const real sum = for_each_midpoint_reduce(*volume, grid, real(0),
+    [](real x, real y, real z, size_t index) {
+        return x + 2 * y + 3 * z + index;
+    }, reductions::Sum());
+
+    ASSERT_EQ(nx * ny * nz, serialCount);
+    ASSERT_NEAR(serialSum, sum, 1e-10 * serialSum);
+}
@@ -0,0 +1,127 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include "alsfvm/volume/Volume.hpp"
+#include "alsfvm/volume/VolumeFactory.hpp"
+
+using namespace alsfvm;
+using namespace alsfvm::volume;
+
+namespace {
+class VolumeLayoutTest : public ::testing::Test {
+public:
+    const std::vector<std::string> variableNames{"rho", "mx", "my", "mz", "E"};
+    const size_t nx = 7;
+    const size_t ny = 5;
+    const size_t nz = 3;
+    const size_t ghostCells = 1;
+
+    std::shared_ptr<DeviceConfiguration> deviceConfiguration;
+    std::shared_ptr<alsfvm::memory::MemoryFactory> factory;
+
+    VolumeLayoutTest()
+        : deviceConfiguration(alsfvm::make_shared<DeviceConfiguration>("cpu")),
+          factory(alsfvm::make_shared<alsfvm::memory::MemoryFactory>(
+                  deviceConfiguration)) {
+    }
+
+    std::shared_ptr<Volume> makeVolume(const VolumeLayout& layout) {
+        return std::make_shared<Volume>(variableNames, factory, nx, ny, nz,
+                ghostCells, layout);
+    }
+
+    // Fills variable v, cell i with 1000 * v + i
+    void fill(Volume& volume) {
+        const size_t size = volume.getScalarMemoryArea(0)->getSize();
+        std::vector<real> buffer(size);
+
+        for (size_t var = 0; var < volume.getNumberOfVariables(); ++var) {
+            for (size_t i = 0; i < size; ++i) {
+                buffer[i] = 1000 * var + i;
+            }
+
+            volume.getScalarMemoryArea(var)->copyFromHost(buffer.data(),
+                buffer.size());
+        }
+    }
+
+    void expectEqual(const Volume& a, const Volume& b) {
+        const size_t size = a.getScalarMemoryArea(0)->getSize();
+        std::vector<real> bufferA(size), bufferB(size);
+
+        for (size_t var = 0; var < a.getNumberOfVariables(); ++var) {
+            a.getScalarMemoryArea(var)->copyToHost(bufferA.data(), size);
+            b.getScalarMemoryArea(var)->copyToHost(bufferB.data(), size);
+
+            for (size_t i = 0; i < size; ++i) {
+                ASSERT_EQ(bufferA[i], bufferB[i]) << "var = " << var << ", i = " << i;
+            }
+        }
+    }
+};
+}
+
+TEST_F(VolumeLayoutTest, FromString) {
+    EXPECT_EQ(VolumeLayout::separate, volumeLayoutFromString("separate").type);
+    EXPECT_EQ(VolumeLayout::contiguous,
+        volumeLayoutFromString(" Contiguous").type);
+    EXPECT_EQ("contiguous", toString(VolumeLayout(VolumeLayout::contiguous)));
+
+    EXPECT_THROW(volumeLayoutFromString("blocked"), std::runtime_error);
+    EXPECT_THROW(volumeLayoutFromString("interleaved"), std::runtime_error);
+}
+
+TEST_F(VolumeLayoutTest, ContiguousIsOneAllocation) {
+    auto volume = makeVolume(VolumeLayout(VolumeLayout::contiguous));
+    const size_t size = volume->getScalarMemoryArea(0)->getSize();
+    const size_t stride = alsfvm::memory::MemoryFactory::getContiguousStride(nx + 2,
+            ny + 2, nz + 2);
+    EXPECT_LE(size, stride);
+    EXPECT_EQ(0u, stride * sizeof(real) % 64);
+
+    const real* first = volume->getScalarMemoryArea(0)->getPointer();
+
+    for (size_t var = 0; var < variableNames.size(); ++var) {
+        EXPECT_EQ(first + var * stride,
+            volume->getScalarMemoryArea(var)->getPointer());
+    }
+
+    fill(*volume);
+
+    auto separate = makeVolume(VolumeLayout(VolumeLayout::separate));
+    volume->copyTo(*separate);
+    expectEqual(*volume, *separate);
+
+    // makeInstance keeps the layout
+    EXPECT_EQ(VolumeLayout::contiguous, volume->makeInstance()->getLayout().type);
+}
+
+TEST_F(VolumeLayoutTest, VolumeFactoryUsesLayout) {
+    VolumeFactory separateFactory("euler3", factory);
+    EXPECT_EQ(VolumeLayout::separate,
+        separateFactory.createConservedVolume(nx, ny, nz, 1)->getLayout().type);
+
+    VolumeFactory contiguousFactory("euler3", factory,
+        VolumeLayout(VolumeLayout::contiguous));
+    auto conserved = contiguousFactory.createConservedVolume(nx, ny, nz, 1);
+    EXPECT_EQ(VolumeLayout::contiguous, conserved->getLayout().type);
+    EXPECT_EQ(VolumeLayout::contiguous,
+        contiguousFactory.createExtraVolume(nx, ny, nz, 1)->getLayout().type);
+
+    EXPECT_EQ(conserved->getScalarMemoryArea(0)->getPointer()
+        + alsfvm::memory::MemoryFactory::getContiguousStride(nx + 2, ny + 2, nz + 2),
+        conserved->getScalarMemoryArea(1)->getPointer());
+}
@@ -190,3 +190,39 @@ TEST(VolumeTest, FactoryTestEuler1) {
     ASSERT_EQ(0, eulerExtra->getIndexFromName("p"));
     ASSERT_EQ(1, eulerExtra->getIndexFromName("ux"));
 }
+
+TEST(VolumeTest, AssignLinearCombination) {
+    std::vector<std::string> variableNames = { "alpha", "beta" };
+
+    const size_t nx = 10;
+    const size_t ny = 10;
+    const size_t nz = 1;
+
+    auto configuration = alsfvm::make_shared<alsfvm::DeviceConfiguration>("cpu");
+    auto factory = alsfvm::make_shared<alsfvm::memory::MemoryFactory>
+        (configuration);
+
+    Volume a(variableNames, factory, nx, ny, nz);
+    Volume b(variableNames, factory, nx, ny, nz);
+    Volume output(variableNames, factory, nx, ny, nz);
+
+    for (size_t var = 0; var < variableNames.size(); ++var) {
+        for (size_t i = 0; i < nx * ny; ++i) {
+            a.getScalarMemoryArea(var)->getPointer()[i] = i + var;
+            b.getScalarMemoryArea(var)->getPointer()[i] = 3;
+            output.getScalarMemoryArea(var)->getPointer()[i] = 2 * i;
+        }
+    }
+
+    output.assign(0.75 * a + 0.25 * b + 0.5 * output);
+
+    for (size_t var = 0; var < variableNames.size(); ++var) {
+        for (size_t i = 0; i < nx * ny; ++i) {
+            ASSERT_DOUBLE_EQ(0.75 * (i + var) + 0.25 * 3 + 0.5 * 2 * i,
+                output.getScalarMemoryArea(var)->getPointer()[i]);
+        }
+    }
+
+    Volume wrongSize(variableNames, factory, nx + 1, ny, nz);
+    ASSERT_ANY_THROW(output.assign(1 * a + 1 * wrongSize));
+}
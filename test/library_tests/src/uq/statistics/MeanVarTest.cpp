@@ -15,7 +15,14 @@
 
 #include <gtest/gtest.h>
 #include "alsuq/stats/StatisticsFactory.hpp"
+#include "alsuq/stats/MeanVariance.hpp"
+#include "alsfvm/volume/VolumeFactory.hpp"
+#include "alsfvm/volume/ensemble.hpp"
+#include "alsuq/mpi/Configuration.hpp"
+#include "CopyWriter.hpp"
+#include <cmath>
 using namespace alsuq::stats;
+
 TEST(MeanVarStatistics, ConstructTest) {
     StatisticsParameters params{boost::property_tree::ptree()};
     StatisticsFactory factory;
@@ -27,3 +34,143 @@ TEST(MeanVarStatistics, ConstructTest) {
     ASSERT_EQ("mean", meanVar->getStatisticsNames()[0]);
     ASSERT_EQ("variance", meanVar->getStatisticsNames()[1]);
 }
+
+TEST(MeanVarStatistics, EnsembleTest) {
+    // The ensemble is stacked along z, so this is a 2D grid with 5 members
+    const size_t ensembleSize = 5;
+    alsfvm::grid::Grid grid({0, 0, 0}, {1, 1, 0}, {7, 6, 1});
+    auto deviceConfiguration = alsfvm::make_shared<alsfvm::DeviceConfiguration>
+        ("cpu");
+    auto memoryFactory = alsfvm::make_shared<alsfvm::memory::MemoryFactory>
+        (deviceConfiguration);
+    alsfvm::volume::VolumeFactory volumeFactory("euler2", memoryFactory);
+    auto ensemble = volumeFactory.createConservedVolume(7, 6, ensembleSize, 2);
+
+    for (size_t var = 0; var < ensemble->getNumberOfVariables(); ++var) {
+        auto memory = ensemble->getScalarMemoryArea(var);
+
+        for (size_t index = 0; index < memory->getSize(); ++index) {
+            memory->getPointer()[index] = alsfvm::real((index * 7 + var * 3) % 11) / 3 - 1;
+        }
+    }
+
+    StatisticsParameters parameters{boost::property_tree::ptree()};
+    parameters.setNumberOfSamples(ensembleSize);
+    MeanVariance ensembleStatistics(parameters);
+    MeanVariance memberStatistics(parameters);
+
+    alsfvm::simulator::TimestepInformation timestepInformation;
+    ensembleStatistics.computeStatisticsEnsemble(*ensemble, grid,
+        timestepInformation);
+
+    auto member = alsfvm::volume::makeEnsembleMemberVolume(*ensemble, 2);
+
+    for (size_t m = 0; m < ensembleSize; ++m) {
+        alsfvm::volume::copyFromEnsembleMember(*ensemble, 2, m, *member);
+        memberStatistics.computeStatistics(*member, grid, timestepInformation);
+    }
+
+    for (const std::string name : {
+            "mean", "variance"
+        }) {
+        auto ensembleWriter = std::make_shared<CopyWriter>();
+        auto memberWriter = std::make_shared<CopyWriter>();
+        std::shared_ptr<alsfvm::io::Writer> writer = ensembleWriter;
+        ensembleStatistics.addWriter(name, writer);
+        writer = memberWriter;
+        memberStatistics.addWriter(name, writer);
+
+        ensembleStatistics.writeStatistics(grid);
+        memberStatistics.writeStatistics(grid);
+
+        ASSERT_EQ(1u, ensembleWriter->volumes.size());
+        ASSERT_EQ(1u, memberWriter->volumes.size());
+
+        const auto& actual = *ensembleWriter->volumes[0];
+        const auto& expected = *memberWriter->volumes[0];
+        ASSERT_EQ(expected.getTotalDimensions(), actual.getTotalDimensions());
+
+        for (size_t var = 0; var < expected.getNumberOfVariables(); ++var) {
+            const auto size = expected.getScalarMemoryArea(var)->getSize();
+
+            for (size_t index = 0; index < size; ++index) {
+                ASSERT_NEAR(expected.getScalarMemoryArea(var)->getPointer()[index],
+                    actual.getScalarMemoryArea(var)->getPointer()[index], 1e-12)
+                        << name << ", variable " << var << ", index " << index;
+            }
+        }
+    }
+}
+
+TEST(MeanVarStatistics, NearConstantVariance) {
+    // Values around 1e6 with a standard deviation around 1e-3, accumulating
+    // the sum of squares would leave no correct digits in the variance.
+    const size_t numberOfSamples = 200;
+    const int nx = 8;
+    auto deviceConfiguration = alsfvm::make_shared<alsfvm::DeviceConfiguration>
+        ("cpu");
+    auto memoryFactory = alsfvm::make_shared<alsfvm::memory::MemoryFactory>
+        (deviceConfiguration);
+    alsfvm::volume::VolumeFactory volumeFactory("burgers", memoryFactory);
+    alsfvm::grid::Grid grid({0, 0, 0}, {1, 0, 0}, {nx, 1, 1});
+    auto sample = volumeFactory.createConservedVolume(nx, 1, 1, 1);
+
+    auto value = [](size_t k, size_t cell) {
+        return 1e6 + 1e-3 * std::sin(double(k * 31 + cell * 7));
+    };
+
+    StatisticsParameters parameters{boost::property_tree::ptree()};
+    parameters.setNumberOfSamples(numberOfSamples);
+    parameters.setMpiConfiguration(std::make_shared<alsuq::mpi::Configuration>
+        (MPI_COMM_WORLD, "cpu"));
+    MeanVariance statistics(parameters);
+    alsfvm::simulator::TimestepInformation timestepInformation;
+
+    for (size_t k = 0; k < numberOfSamples; ++k) {
+        auto memory = sample->getScalarMemoryArea(0);
+
+        for (size_t cell = 0; cell < memory->getSize(); ++cell) {
+            memory->getPointer()[cell] = value(k, cell);
+        }
+
+        statistics.computeStatistics(*sample, grid, timestepInformation);
+    }
+
+    auto meanWriter = std::make_shared<CopyWriter>();
+    auto varianceWriter = std::make_shared<CopyWriter>();
+    std::shared_ptr<alsfvm::io::Writer> writer = meanWriter;
+    statistics.addWriter("mean", writer);
+    writer = varianceWriter;
+    statistics.addWriter("variance", writer);
+
+    statistics.combineStatistics();
+    statistics.finalizeStatistics();
+    statistics.writeStatistics(grid);
+
+    ASSERT_EQ(1u, meanWriter->volumes.size());
+    ASSERT_EQ(1u, varianceWriter->volumes.size());
+    const auto mean = meanWriter->volumes[0]->getScalarMemoryArea(0);
+    const auto variance = varianceWriter->volumes[0]->getScalarMemoryArea(0);
+
+    for (size_t cell = 0; cell < mean->getSize(); ++cell) {
+        long double expectedMean = 0;
+
+        for (size_t k = 0; k < numberOfSamples; ++k) {
+            expectedMean += value(k, cell);
+        }
+
+        expectedMean /= numberOfSamples;
+        long double expectedVariance = 0;
+
+        for (size_t k = 0; k < numberOfSamples; ++k) {
+            expectedVariance += (value(k, cell) - expectedMean)
+                * (value(k, cell) - expectedMean);
+        }
+
+        expectedVariance /= numberOfSamples;
+
+        ASSERT_NEAR(double(expectedMean), mean->getPointer()[cell], 1e-9);
+        ASSERT_NEAR(1, variance->getPointer()[cell] / double(expectedVariance), 1e-6)
+                << "cell " << cell;
+    }
+}
@@ -0,0 +1,125 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include "alsuq/stats/Welford.hpp"
+#include <cmath>
+#include <vector>
+
+using alsuq::stats::WelfordState;
+
+namespace {
+std::vector<double> makeValues(size_t numberOfValues, double offset,
+    double scale) {
+    std::vector<double> values(numberOfValues);
+
+    for (size_t i = 0; i < numberOfValues; ++i) {
+        values[i] = offset + scale * std::sin(double(i * i % 97));
+    }
+
+    return values;
+}
+
+//! Mean and M2 with the two pass algorithm in long double
+std::pair<long double, long double> twoPass(const std::vector<double>& values) {
+    long double mean = 0;
+
+    for (double value : values) {
+        mean += value;
+    }
+
+    mean /= values.size();
+    long double m2 = 0;
+
+    for (double value : values) {
+        m2 += (value - mean) * (value - mean);
+    }
+
+    return {mean, m2};
+}
+}
+
+TEST(WelfordTest, AddMatchesTwoPass) {
+    const auto values = makeValues(1000, 3, 2);
+    WelfordState<double> state;
+
+    for (double value : values) {
+        state.add(value);
+    }
+
+    const auto expected = twoPass(values);
+    ASSERT_EQ(1000, state.count);
+    ASSERT_NEAR(double(expected.first), state.mean, 1e-13);
+    ASSERT_NEAR(1, state.m2 / double(expected.second), 1e-12);
+}
+
+TEST(WelfordTest, MergeMatchesAdd) {
+    const auto values = makeValues(1000, 3, 2);
+
+    // Uneven parts, including an empty one
+    const std::vector<size_t> splits = {0, 0, 1, 17, 500, 1000};
+    WelfordState<double> merged;
+
+    for (size_t part = 0; part + 1 < splits.size(); ++part) {
+        WelfordState<double> partState;
+
+        for (size_t i = splits[part]; i < splits[part + 1]; ++i) {
+            partState.add(values[i]);
+        }
+
+        merged.merge(partState);
+    }
+
+    WelfordState<double> added;
+
+    for (double value : values) {
+        added.add(value);
+    }
+
+    ASSERT_EQ(added.count, merged.count);
+    ASSERT_NEAR(added.mean, merged.mean, 1e-13);
+    ASSERT_NEAR(1, merged.m2 / added.m2, 1e-12);
+}
+
+TEST(WelfordTest, NearConstantValues) {
+    // The variance is 1e-14 of the mean squared, so the sum of squares minus
+    // the squared sum has no correct digits left in double precision
+    const auto values = makeValues(4096, 1e6, 1e-1);
+    const auto expected = twoPass(values);
+
+    WelfordState<double> state;
+
+    for (double value : values) {
+        state.add(value);
+    }
+
+    ASSERT_NEAR(1, state.m2 / double(expected.second), 1e-6);
+
+    // Also when the values are merged pairwise
+    std::vector<WelfordState<double> > states(values.size());
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        states[i].add(values[i]);
+    }
+
+    for (size_t stride = 1; stride < states.size(); stride *= 2) {
+        for (size_t i = 0; i + stride < states.size(); i += 2 * stride) {
+            states[i].merge(states[i + stride]);
+        }
+    }
+
+    ASSERT_EQ(values.size(), states[0].count);
+    ASSERT_NEAR(1, states[0].m2 / double(expected.second), 1e-6);
+}
@@ -0,0 +1,91 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include "alsutils/memory/AllocationPolicy.hpp"
+#include "alsfvm/memory/HostMemory.hpp"
+#include <cstdint>
+
+using namespace alsutils::memory;
+
+namespace {
+// Restores the allocation policy when going out of scope
+struct PolicyGuard {
+    PolicyGuard() : policy(getAllocationPolicy()) {}
+    ~PolicyGuard() {
+        setAllocationPolicy(policy);
+    }
+    const AllocationPolicy policy;
+};
+
+bool isAligned(const void* pointer, size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(pointer) % alignment == 0;
+}
+}
+
+TEST(AllocationPolicyTest, Alignment) {
+    AllocationPolicy policy;
+    policy.transparentHugePages = false;
+
+    EXPECT_EQ(minimumAlignment, getAlignment(8, policy));
+    EXPECT_LE(size_t(4096), getAlignment(size_t(4) << 20, policy));
+
+    policy.transparentHugePages = true;
+    EXPECT_EQ(size_t(2) << 20, getAlignment(size_t(4) << 20, policy));
+    EXPECT_EQ(minimumAlignment, getAlignment(8, policy));
+
+    for (size_t bytes : {
+            size_t(0), size_t(8), size_t(100000), size_t(3) << 20
+        }) {
+        void* pointer = allocateAligned(bytes, policy);
+        EXPECT_TRUE(isAligned(pointer, getAlignment(bytes, policy)));
+        deallocateAligned(pointer);
+    }
+}
+
+TEST(AllocationPolicyTest, HostMemoryIsAlignedAndZeroed) {
+    PolicyGuard guard;
+
+    for (bool parallelFirstTouch : {
+            true, false
+        }) {
+        AllocationPolicy policy;
+        policy.parallelFirstTouch = parallelFirstTouch;
+        setAllocationPolicy(policy);
+        EXPECT_EQ(parallelFirstTouch, getAllocationPolicy().parallelFirstTouch);
+
+        for (size_t n : {
+                size_t(3), size_t(17), size_t(100)
+            }) {
+            alsfvm::memory::HostMemory<alsfvm::real> memory(n, n, 1);
+
+            EXPECT_TRUE(isAligned(memory.getPointer(), minimumAlignment));
+
+            for (size_t i = 0; i < memory.getSize(); ++i) {
+                ASSERT_EQ(0, memory.getPointer()[i]);
+            }
+        }
+    }
+}
+
+TEST(AllocationPolicyTest, ToString) {
+    AllocationPolicy policy;
+    policy.parallelFirstTouch = false;
+    policy.transparentHugePages = true;
+
+    const auto description = toString(policy);
+    EXPECT_NE(std::string::npos, description.find("firstTouch=serial"));
+    EXPECT_NE(std::string::npos, description.find("hugePages=on"));
+}
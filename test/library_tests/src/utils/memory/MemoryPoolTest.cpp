@@ -0,0 +1,212 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include "alsutils/memory/MemoryPool.hpp"
+#include "alsfvm/memory/HostMemory.hpp"
+#include "alsfvm/memory/MemoryFactory.hpp"
+#include <cstdlib>
+
+using namespace alsutils::memory;
+
+TEST(MemoryPoolTest, ReusesBlocksOfTheSameBucket) {
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    {
+        MemoryPool pool("MemoryPoolTest.ReusesBlocksOfTheSameBucket",
+        [&](size_t bytes) {
+            allocations++;
+            return std::malloc(bytes);
+        }, [&](void* pointer) {
+            deallocations++;
+            std::free(pointer);
+        }, 64);
+        pool.setEnabled(true);
+
+        void* first = pool.acquire(100);
+        EXPECT_EQ(1u, pool.getNumberOfMisses());
+        pool.release(first, 100);
+        EXPECT_EQ(128u, pool.getPooledBytes());
+
+        // 120 bytes is in the same bucket as 100 bytes
+        void* second = pool.acquire(120);
+        EXPECT_EQ(first, second);
+        EXPECT_EQ(1u, pool.getNumberOfHits());
+        EXPECT_EQ(0u, pool.getPooledBytes());
+
+        // A different bucket is a miss
+        void* third = pool.acquire(1000);
+        EXPECT_NE(second, third);
+        EXPECT_EQ(2u, pool.getNumberOfMisses());
+
+        pool.release(second, 120);
+        pool.release(third, 1000);
+        EXPECT_EQ(2u, allocations);
+        EXPECT_EQ(0u, deallocations);
+
+        auto statistics = MemoryPool::getStatisticsOfAllPools();
+        auto& ourStatistics = statistics.get_child(
+                boost::property_tree::ptree::path_type(
+                    "MemoryPoolTest.ReusesBlocksOfTheSameBucket", '/'));
+        EXPECT_EQ(1u, ourStatistics.get<size_t>("hits"));
+        EXPECT_EQ(2u, ourStatistics.get<size_t>("misses"));
+
+        pool.clear();
+        EXPECT_EQ(2u, deallocations);
+        EXPECT_EQ(0u, pool.getPooledBytes());
+    }
+    EXPECT_EQ(2u, deallocations);
+}
+
+TEST(MemoryPoolTest, DisabledPoolDoesNotKeepBlocks) {
+    size_t allocations = 0;
+    size_t deallocations = 0;
+    MemoryPool pool("MemoryPoolTest.DisabledPoolDoesNotKeepBlocks",
+    [&](size_t bytes) {
+        allocations++;
+        return std::malloc(bytes);
+    }, [&](void* pointer) {
+        deallocations++;
+        std::free(pointer);
+    }, 64);
+    pool.setEnabled(false);
+
+    for (int i = 0; i < 3; ++i) {
+        pool.release(pool.acquire(100), 100);
+    }
+
+    EXPECT_EQ(3u, allocations);
+    EXPECT_EQ(3u, deallocations);
+    EXPECT_EQ(0u, pool.getNumberOfHits());
+    EXPECT_EQ(0u, pool.getPooledBytes());
+}
+
+TEST(MemoryPoolTest, DuplicateNamesThrow) {
+    auto allocator = [](size_t bytes) {
+        return std::malloc(bytes);
+    };
+    MemoryPool pool("MemoryPoolTest.DuplicateNamesThrow", allocator, std::free,
+        64);
+
+    EXPECT_THROW(MemoryPool("MemoryPoolTest.DuplicateNamesThrow", allocator,
+            std::free, 64), std::runtime_error);
+}
+
+TEST(MemoryPoolTest, HostMemoryIsRecycledAndZeroed) {
+    auto& pool = MemoryPool::getHostPool();
+
+    if (!pool.isEnabled()) {
+        return;
+    }
+
+    const size_t n = 1000;
+    const void* firstPointer = nullptr;
+    {
+        alsfvm::memory::HostMemory<alsfvm::real> memory(n, 1, 1, true);
+        firstPointer = memory.getPointer();
+
+        for (size_t i = 0; i < n; ++i) {
+            memory[i] = 42;
+        }
+    }
+
+    const size_t hitsBefore = pool.getNumberOfHits();
+    alsfvm::memory::HostMemory<alsfvm::real> memory(n, 1, 1, true);
+
+    EXPECT_EQ(hitsBefore + 1, pool.getNumberOfHits());
+    EXPECT_EQ(firstPointer, memory.getPointer());
+
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(0, memory[i]);
+    }
+}
+
+TEST(MemoryPoolTest, SmallBlocksAreRoundedToCacheLines) {
+    MemoryPool pool("MemoryPoolTest.SmallBlocksAreRoundedToCacheLines",
+    [](size_t bytes) {
+        return std::malloc(bytes);
+    }, std::free, 4096);
+
+    void* small = pool.acquire(100);
+    EXPECT_EQ(128u, pool.getBytesInUse());
+    pool.release(small, 100);
+    EXPECT_EQ(128u, pool.getPooledBytes());
+
+    void* large = pool.acquire(5000);
+    EXPECT_EQ(8192u, pool.getBytesInUse());
+    pool.release(large, 5000);
+}
+
+TEST(MemoryPoolTest, NeverHoldsMoreThanThePeak) {
+    size_t deallocations = 0;
+    MemoryPool pool("MemoryPoolTest.NeverHoldsMoreThanThePeak",
+    [](size_t bytes) {
+        return std::malloc(bytes);
+    }, [&](void* pointer) {
+        deallocations++;
+        std::free(pointer);
+    }, 64);
+
+    // "The first sample" uses two blocks of 1024 bytes
+    void* first = pool.acquire(1024);
+    void* second = pool.acquire(1024);
+    pool.release(first, 1024);
+    pool.release(second, 1024);
+    EXPECT_EQ(2048u, pool.getPeakBytesInUse());
+    EXPECT_EQ(2048u, pool.getPooledBytes());
+
+    // "The next sample" has a different size, the old blocks have to go
+    // to make room for it
+    void* third = pool.acquire(512);
+    EXPECT_EQ(1u, deallocations);
+    EXPECT_EQ(1024u, pool.getPooledBytes());
+    EXPECT_LE(pool.getPooledBytes() + pool.getBytesInUse(),
+        pool.getPeakBytesInUse());
+
+    void* fourth = pool.acquire(1536);
+    EXPECT_EQ(2u, deallocations);
+    EXPECT_EQ(0u, pool.getPooledBytes());
+    EXPECT_EQ(2048u, pool.getPeakBytesInUse());
+
+    pool.release(third, 512);
+    pool.release(fourth, 1536);
+    EXPECT_EQ(0u, pool.getBytesInUse());
+    EXPECT_EQ(2048u, pool.getPooledBytes());
+}
+
+TEST(MemoryPoolTest, MemoryFactoryDecidesOnPooling) {
+    auto deviceConfiguration = alsfvm::make_shared<alsfvm::DeviceConfiguration>
+        ("cpu");
+
+    for (bool useMemoryPool : {
+            false, true
+        }) {
+        alsfvm::memory::MemoryFactory memoryFactory(deviceConfiguration,
+            useMemoryPool);
+        auto memory = memoryFactory.createScalarMemory(10, 10, 1);
+        auto hostMemory = std::dynamic_pointer_cast
+            <alsfvm::memory::HostMemory<alsfvm::real> >(memory);
+        ASSERT_TRUE(hostMemory);
+        EXPECT_EQ(useMemoryPool, hostMemory->isPooled());
+
+        auto instance = std::dynamic_pointer_cast
+            <alsfvm::memory::HostMemory<alsfvm::real> >(memory->makeInstance());
+        EXPECT_EQ(useMemoryPool, instance->isPooled());
+
+        auto areas = memoryFactory.createContiguousScalarMemory(10, 10, 1, 3);
+        EXPECT_EQ(useMemoryPool, std::dynamic_pointer_cast
+            <alsfvm::memory::HostMemory<alsfvm::real> >(areas[1])->isPooled());
+    }
+}
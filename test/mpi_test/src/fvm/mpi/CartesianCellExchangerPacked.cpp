@@ -0,0 +1,131 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//! Checks that the packed halo exchange gives the same ghost cells as the
+//! derived datatype exchange, and compares their timings.
+#include <gtest/gtest.h>
+#include "alsfvm/mpi/domain/CartesianDecomposition.hpp"
+#include "alsfvm/volume/make_volume.hpp"
+#include "alsfvm/mpi/CartesianCellExchanger.hpp"
+#include <chrono>
+#include <iostream>
+
+using namespace alsfvm;
+
+namespace {
+typedef alsfvm::mpi::CartesianCellExchanger::ExchangeMode ExchangeMode;
+
+class CartesianCellExchangerPackedTest : public ::testing::Test {
+public:
+    const std::string platform = "cpu";
+    const int ghostCells = 3;
+    const int N = 32;
+
+    alsfvm::mpi::ConfigurationPtr mpiConfiguration;
+    int numberOfProcessors;
+    int rank;
+    ivec6 neighbours;
+
+    CartesianCellExchangerPackedTest()
+        : mpiConfiguration(alsfvm::make_shared<alsfvm::mpi::Configuration>(MPI_COMM_WORLD,
+                  platform)),
+          numberOfProcessors(mpiConfiguration->getNumberOfProcesses()),
+          rank(mpiConfiguration->getRank()) {
+        auto grid = alsfvm::make_shared<grid::Grid>(rvec3{0, 0, 0}, rvec3{1, 1, 1},
+                ivec3{N * numberOfProcessors, N, N},
+                boundary::allPeriodic());
+
+        alsfvm::mpi::domain::CartesianDecomposition decomposer(numberOfProcessors, 1, 1);
+        neighbours = decomposer.decompose(mpiConfiguration,
+                *grid)->getCellExchanger()->getNeighbours();
+    }
+
+    volume::VolumePointer makeFilledVolume() {
+        auto volume = volume::makeConservedVolume(platform, "euler3", {N, N, N},
+                ghostCells);
+
+        for (size_t var = 0; var < volume->getNumberOfVariables(); ++var) {
+            auto& memory = *volume->getScalarMemoryArea(var);
+
+            for (size_t i = 0; i < memory.getSize(); ++i) {
+                memory[i] = 1000000 * rank + 10000 * var + real(i % 9973);
+            }
+        }
+
+        return volume;
+    }
+
+    double timeExchange(ExchangeMode mode, volume::Volume& volume,
+        int numberOfExchanges) {
+        alsfvm::mpi::CartesianCellExchanger exchanger(mpiConfiguration, neighbours, mode);
+
+        // warm up (this also sets up the datatypes and requests)
+        exchanger.exchangeCells(volume, volume).waitForAll();
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for (int i = 0; i < numberOfExchanges; ++i) {
+            exchanger.exchangeCells(volume, volume).waitForAll();
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        return std::chrono::duration<double>(end - start).count() / numberOfExchanges;
+    }
+};
+}
+
+TEST_F(CartesianCellExchangerPackedTest, SameGhostCellsAsDatatypes) {
+    auto datatypesVolume = makeFilledVolume();
+    auto packedVolume = makeFilledVolume();
+
+    alsfvm::mpi::CartesianCellExchanger datatypesExchanger(mpiConfiguration, neighbours,
+        ExchangeMode::datatypes);
+    alsfvm::mpi::CartesianCellExchanger packedExchanger(mpiConfiguration, neighbours,
+        ExchangeMode::packed);
+
+    // Twice, to make sure the persistent requests can be restarted
+    for (int exchange = 0; exchange < 2; ++exchange) {
+        datatypesExchanger.exchangeCells(*datatypesVolume,
+            *datatypesVolume).waitForAll();
+        packedExchanger.exchangeCells(*packedVolume, *packedVolume).waitForAll();
+
+        for (size_t var = 0; var < datatypesVolume->getNumberOfVariables(); ++var) {
+            const auto& expected = *datatypesVolume->getScalarMemoryArea(var);
+            const auto& actual = *packedVolume->getScalarMemoryArea(var);
+
+            for (size_t i = 0; i < expected.getSize(); ++i) {
+                ASSERT_EQ(expected[i], actual[i]) << "var = " << var << ", i = " << i;
+            }
+        }
+    }
+}
+
+TEST_F(CartesianCellExchangerPackedTest, Benchmark) {
+    const int numberOfExchanges = 50;
+    auto volume = makeFilledVolume();
+
+    const double datatypesTime = timeExchange(ExchangeMode::datatypes, *volume,
+            numberOfExchanges);
+    const double packedTime = timeExchange(ExchangeMode::packed, *volume,
+            numberOfExchanges);
+
+    if (rank == 0) {
+        std::cout << "Halo exchange of euler3 " << N << "^3 per rank, "
+            << numberOfProcessors << " ranks:\n"
+            << "\tdatatypes: " << datatypesTime * 1e6 << " us per exchange\n"
+            << "\tpacked:    " << packedTime * 1e6 << " us per exchange\n";
+    }
+}
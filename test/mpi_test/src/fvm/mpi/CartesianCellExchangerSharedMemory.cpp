@@ -0,0 +1,137 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//! Checks that the shared memory halo exchange gives the same ghost cells as
+//! the derived datatype exchange, and compares its timing to the packed one.
+#include <gtest/gtest.h>
+#include "alsfvm/mpi/domain/CartesianDecomposition.hpp"
+#include "alsfvm/volume/make_volume.hpp"
+#include "alsfvm/mpi/CartesianCellExchanger.hpp"
+#include <chrono>
+#include <iostream>
+
+using namespace alsfvm;
+
+namespace {
+typedef alsfvm::mpi::CartesianCellExchanger::ExchangeMode ExchangeMode;
+
+class CartesianCellExchangerSharedMemoryTest : public ::testing::Test {
+public:
+    const std::string platform = "cpu";
+    const int ghostCells = 3;
+    const int N = 32;
+
+    alsfvm::mpi::ConfigurationPtr mpiConfiguration;
+    int numberOfProcessors;
+    int rank;
+    ivec6 neighbours;
+
+    CartesianCellExchangerSharedMemoryTest()
+        : mpiConfiguration(alsfvm::make_shared<alsfvm::mpi::Configuration>(MPI_COMM_WORLD,
+                  platform)),
+          numberOfProcessors(mpiConfiguration->getNumberOfProcesses()),
+          rank(mpiConfiguration->getRank()) {
+        auto grid = alsfvm::make_shared<grid::Grid>(rvec3{0, 0, 0}, rvec3{1, 1, 1},
+                ivec3{N * numberOfProcessors, N, N},
+                boundary::allPeriodic());
+
+        alsfvm::mpi::domain::CartesianDecomposition decomposer(numberOfProcessors, 1, 1);
+        neighbours = decomposer.decompose(mpiConfiguration,
+                *grid)->getCellExchanger()->getNeighbours();
+    }
+
+    volume::VolumePointer makeFilledVolume(int exchange) {
+        auto volume = volume::makeConservedVolume(platform, "euler3", {N, N, N},
+                ghostCells);
+        fill(*volume, exchange);
+        return volume;
+    }
+
+    void fill(volume::Volume& volume, int exchange) {
+        for (size_t var = 0; var < volume.getNumberOfVariables(); ++var) {
+            auto& memory = *volume.getScalarMemoryArea(var);
+
+            for (size_t i = 0; i < memory.getSize(); ++i) {
+                memory[i] = 1000000 * rank + 10000 * var + 100 * exchange
+                    + real(i % 97);
+            }
+        }
+    }
+};
+}
+
+TEST_F(CartesianCellExchangerSharedMemoryTest, SameGhostCellsAsDatatypes) {
+    auto datatypesVolume = makeFilledVolume(0);
+    auto sharedVolume = makeFilledVolume(0);
+
+    alsfvm::mpi::CartesianCellExchanger datatypesExchanger(mpiConfiguration, neighbours,
+        ExchangeMode::datatypes);
+    alsfvm::mpi::CartesianCellExchanger sharedExchanger(mpiConfiguration, neighbours,
+        ExchangeMode::sharedMemory);
+
+    // New values every time, so a buffer that is read before it is
+    // overwritten would show up
+    for (int exchange = 0; exchange < 4; ++exchange) {
+        fill(*datatypesVolume, exchange);
+        fill(*sharedVolume, exchange);
+
+        datatypesExchanger.exchangeCells(*datatypesVolume,
+            *datatypesVolume).waitForAll();
+        sharedExchanger.exchangeCells(*sharedVolume, *sharedVolume).waitForAll();
+
+        for (size_t var = 0; var < datatypesVolume->getNumberOfVariables(); ++var) {
+            const auto& expected = *datatypesVolume->getScalarMemoryArea(var);
+            const auto& actual = *sharedVolume->getScalarMemoryArea(var);
+
+            for (size_t i = 0; i < expected.getSize(); ++i) {
+                ASSERT_EQ(expected[i], actual[i]) << "exchange = " << exchange
+                    << ", var = " << var << ", i = " << i;
+            }
+        }
+    }
+}
+
+TEST_F(CartesianCellExchangerSharedMemoryTest, Benchmark) {
+    const int numberOfExchanges = 50;
+    auto volume = makeFilledVolume(0);
+
+    double times[2];
+    const ExchangeMode modes[2] = {ExchangeMode::packed, ExchangeMode::sharedMemory};
+
+    for (int mode = 0; mode < 2; ++mode) {
+        alsfvm::mpi::CartesianCellExchanger exchanger(mpiConfiguration, neighbours,
+            modes[mode]);
+
+        // warm up (this also sets up the buffers and the window)
+        exchanger.exchangeCells(*volume, *volume).waitForAll();
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        auto start = std::chrono::high_resolution_clock::now();
+
+        for (int i = 0; i < numberOfExchanges; ++i) {
+            exchanger.exchangeCells(*volume, *volume).waitForAll();
+        }
+
+        auto end = std::chrono::high_resolution_clock::now();
+        times[mode] = std::chrono::duration<double>(end - start).count() /
+            numberOfExchanges;
+    }
+
+    if (rank == 0) {
+        std::cout << "Halo exchange of euler3 " << N << "^3 per rank, "
+            << numberOfProcessors << " ranks:\n"
+            << "\tpacked:        " << times[0] * 1e6 << " us per exchange\n"
+            << "\tshared memory: " << times[1] * 1e6 << " us per exchange\n";
+    }
+}
@@ -0,0 +1,159 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//! Checks domain decompositions where the number of cells is not divisible
+//! by the number of processors, and the automatic choice of processors.
+#include <gtest/gtest.h>
+#include "alsfvm/mpi/domain/CartesianDecomposition.hpp"
+#include "alsfvm/volume/make_volume.hpp"
+#include <algorithm>
+
+using namespace alsfvm;
+
+namespace {
+class CartesianDecompositionUnevenTest : public ::testing::Test {
+public:
+    const std::string platform = "cpu";
+    const int ghostCells = 2;
+
+    alsfvm::mpi::ConfigurationPtr mpiConfiguration;
+    int numberOfProcessors;
+
+    CartesianDecompositionUnevenTest()
+        : mpiConfiguration(alsfvm::make_shared<alsfvm::mpi::Configuration>(MPI_COMM_WORLD,
+                  platform)),
+          numberOfProcessors(mpiConfiguration->getNumberOfProcesses()) {
+
+    }
+
+    //! Checks that the local grids tile the global grid, and that the ghost
+    //! cells are exchanged with the right neighbours.
+    void checkDecomposition(const grid::Grid& globalGrid,
+        const ivec3& processors, bool reorderRanks) {
+        alsfvm::mpi::domain::CartesianDecomposition decomposition(processors.x,
+            processors.y, processors.z, reorderRanks);
+
+        auto information = decomposition.decompose(mpiConfiguration, globalGrid);
+        auto& grid = *information->getGrid();
+        const ivec3 size = grid.getDimensions();
+        const ivec3 position = grid.getGlobalPosition();
+        const ivec3 globalSize = globalGrid.getDimensions();
+
+        int numberOfCells = size.x * size.y * size.z;
+        int totalNumberOfCells = 0;
+        MPI_Allreduce(&numberOfCells, &totalNumberOfCells, 1, MPI_INT, MPI_SUM,
+            MPI_COMM_WORLD);
+        ASSERT_EQ(globalSize.x * globalSize.y * globalSize.z, totalNumberOfCells);
+
+        for (int d = 0; d < 2; ++d) {
+            int smallest, largest;
+            MPI_Allreduce(&size[d], &smallest, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+            MPI_Allreduce(&size[d], &largest, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+            ASSERT_LE(largest - smallest, 1);
+        }
+
+        auto volume = volume::makeConservedVolume(platform, "burgers", size,
+                ghostCells);
+        auto& u = *volume->getScalarMemoryArea(0);
+
+        auto globalIndex = [&](int x, int y) {
+            const int globalX = (position.x + x - ghostCells + globalSize.x) %
+                globalSize.x;
+            const int globalY = (position.y + y - ghostCells + globalSize.y) %
+                globalSize.y;
+            return real(globalX + 1000 * globalY);
+        };
+
+        const int nx = size.x + 2 * ghostCells;
+        const int ny = size.y + 2 * ghostCells;
+
+        for (int y = 0; y < ny; ++y) {
+            for (int x = 0; x < nx; ++x) {
+                u[y * nx + x] = -1;
+            }
+        }
+
+        for (int y = ghostCells; y < ny - ghostCells; ++y) {
+            for (int x = ghostCells; x < nx - ghostCells; ++x) {
+                u[y * nx + x] = globalIndex(x, y);
+            }
+        }
+
+        auto cellExchanger = information->getCellExchanger();
+        cellExchanger->exchangeCells(*volume, *volume).waitForAll();
+
+        const auto neighbours = cellExchanger->getNeighbours();
+
+        for (int y = 0; y < ny; ++y) {
+            for (int x = 0; x < nx; ++x) {
+                const bool ghostX = x < ghostCells || x >= nx - ghostCells;
+                const bool ghostY = y < ghostCells || y >= ny - ghostCells;
+
+                if (ghostX && ghostY) {
+                    continue;
+                }
+
+                if (ghostX && neighbours[x < ghostCells ? 0 : 1] < 0) {
+                    continue;
+                }
+
+                if (ghostY && neighbours[y < ghostCells ? 2 : 3] < 0) {
+                    continue;
+                }
+
+                ASSERT_EQ(globalIndex(x, y), u[y * nx + x])
+                        << "x = " << x << ", y = " << y;
+            }
+        }
+    }
+};
+}
+
+TEST_F(CartesianDecompositionUnevenTest, UnevenInX) {
+    // Not divisible by the number of processors (unless there is only one)
+    grid::Grid globalGrid({0, 0, 0}, {1, 1, 0}, {7 * numberOfProcessors + 1, 6, 1},
+        boundary::allPeriodic());
+
+    checkDecomposition(globalGrid, {numberOfProcessors, 1, 1}, false);
+}
+
+TEST_F(CartesianDecompositionUnevenTest, Automatic) {
+    grid::Grid globalGrid({0, 0, 0}, {1, 1, 0}, {23, 17, 1},
+        boundary::allPeriodic());
+
+    const auto processors =
+        alsfvm::mpi::domain::CartesianDecomposition::findNumberOfProcessorsPerDirection(
+            numberOfProcessors, globalGrid);
+
+    checkDecomposition(globalGrid, processors, true);
+}
+
+TEST_F(CartesianDecompositionUnevenTest, RequireEvenBlocks) {
+    grid::Grid evenGrid({0, 0, 0}, {1, 1, 0}, {7 * numberOfProcessors, 6, 1},
+        boundary::allPeriodic());
+    grid::Grid unevenGrid({0, 0, 0}, {1, 1, 0}, {7 * numberOfProcessors + 1, 6,
+            1}, boundary::allPeriodic());
+
+    alsfvm::mpi::domain::CartesianDecomposition decomposition(numberOfProcessors,
+        1, 1);
+    decomposition.setRequireEvenBlocks(true);
+
+    EXPECT_NO_THROW(decomposition.decompose(mpiConfiguration, evenGrid));
+
+    if (numberOfProcessors > 1) {
+        EXPECT_THROW(decomposition.decompose(mpiConfiguration, unevenGrid),
+            std::runtime_error);
+    }
+}
@@ -0,0 +1,363 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+//! Checks that exchanging the ghost cells for several substeps at once
+//! (deep halo) gives the same as exchanging them before every substep.
+#include <gtest/gtest.h>
+#include "alsfvm/mpi/domain/CartesianDecomposition.hpp"
+#include "alsfvm/volume/make_volume.hpp"
+#include "alsfvm/mpi/CartesianCellExchanger.hpp"
+#include "alsfvm/numflux/NumericalFluxFactory.hpp"
+#include "alsfvm/integrator/IntegratorFactory.hpp"
+#include "alsfvm/boundary/BoundaryFactory.hpp"
+#include "alsfvm/simulator/ConservedSystem.hpp"
+#include "alsfvm/simulator/Simulator.hpp"
+#include "alsfvm/diffusion/DiffusionFactory.hpp"
+#include "alsfvm/init/InitialData.hpp"
+#include <cmath>
+
+using namespace alsfvm;
+
+namespace {
+typedef alsfvm::mpi::CartesianCellExchanger::ExchangeMode ExchangeMode;
+
+struct DeepHaloParameters {
+    std::string reconstruction;
+    ExchangeMode exchangeMode;
+};
+
+class DeepHaloTest : public ::testing::TestWithParam<DeepHaloParameters> {
+public:
+    const std::string platform = "cpu";
+    const std::string equation = "euler2";
+    const int N = 16;
+    const int numberOfTimesteps = 3;
+
+    alsfvm::mpi::ConfigurationPtr mpiConfiguration;
+    int numberOfProcessors;
+    int rank;
+    ivec6 neighbours;
+
+    alsfvm::shared_ptr<DeviceConfiguration> deviceConfiguration;
+    alsfvm::shared_ptr<simulator::SimulatorParameters> simulatorParameters;
+    numflux::NumericalFluxFactory fluxFactory;
+    alsfvm::shared_ptr<grid::Grid> grid;
+
+    DeepHaloTest()
+        : mpiConfiguration(alsfvm::make_shared<alsfvm::mpi::Configuration>(MPI_COMM_WORLD,
+                  platform)),
+          numberOfProcessors(mpiConfiguration->getNumberOfProcesses()),
+          rank(mpiConfiguration->getRank()),
+          deviceConfiguration(new DeviceConfiguration(platform)),
+          simulatorParameters(new simulator::SimulatorParameters(equation, platform)),
+          fluxFactory(equation, "HLL3", GetParam().reconstruction,
+              simulatorParameters, deviceConfiguration) {
+        auto globalGrid = alsfvm::make_shared<grid::Grid>(rvec3{0, 0, 0},
+                rvec3{1, 1, 0},
+                ivec3{N * numberOfProcessors, N, 1},
+                boundary::allPeriodic());
+
+        // The y direction is periodic on each processor, the corners come
+        // from the boundary conditions of the neighbours in x
+        alsfvm::mpi::domain::CartesianDecomposition decomposer(numberOfProcessors, 1, 1);
+        auto domainInformation = decomposer.decompose(mpiConfiguration,
+                *globalGrid);
+        neighbours = domainInformation->getCellExchanger()->getNeighbours();
+        grid = domainInformation->getGrid();
+    }
+
+    //! Runs a few timesteps of rungekutta3, returns the final state
+    volume::VolumePointer run(size_t haloStages, real& redundantComputeFraction) {
+        auto numericalFlux = fluxFactory.createNumericalFlux(*grid);
+        const int ghostCells = int(haloStages *
+                numericalFlux->getNumberOfGhostCells());
+
+        auto cellExchanger =
+            alsfvm::make_shared<alsfvm::mpi::CartesianCellExchanger>
+            (mpiConfiguration, neighbours, GetParam().exchangeMode);
+        auto conservedSystem = alsfvm::make_shared<simulator::ConservedSystem>
+            (numericalFlux, alsfvm::make_shared<diffusion::NoDiffusion>());
+        conservedSystem->setCellExchanger(cellExchanger);
+        conservedSystem->setHaloStages(haloStages);
+
+        alsfvm::shared_ptr<integrator::System> system = conservedSystem;
+        integrator::IntegratorFactory integratorFactory("rungekutta3");
+        auto integrator = integratorFactory.createIntegrator(system);
+        integrator->addWaveSpeedAdjuster(cellExchanger);
+
+        boundary::BoundaryFactory boundaryFactory("periodic", deviceConfiguration);
+        auto boundary = boundaryFactory.createBoundary(ghostCells);
+
+        std::vector<volume::VolumePointer> volumes;
+
+        for (size_t i = 0; i < integrator->getNumberOfRegisters(); ++i) {
+            volumes.push_back(volume::makeConservedVolume(platform, equation,
+                    {N, N, 1}, ghostCells));
+        }
+
+        // A smooth, positive state in the interior, the ghost cells are
+        // left empty for the exchange to fill
+        for (int y = 0; y < N; ++y) {
+            for (int x = 0; x < N; ++x) {
+                const size_t index = (y + ghostCells) * (N + 2 * ghostCells)
+                    + x + ghostCells;
+                const real globalX = real(x + rank * N) / (N * numberOfProcessors);
+                const real globalY = real(y) / N;
+                const real phase = 2 * M_PI * (globalX + 2 * globalY);
+
+                volumes[0]->getScalarMemoryArea("rho")->getPointer()[index] =
+                    1 + 0.5 * std::sin(phase);
+                volumes[0]->getScalarMemoryArea("mx")->getPointer()[index] =
+                    0.3 * std::cos(phase);
+                volumes[0]->getScalarMemoryArea("my")->getPointer()[index] =
+                    -0.2 * std::sin(2 * phase);
+                volumes[0]->getScalarMemoryArea("E")->getPointer()[index] =
+                    10 + std::cos(phase);
+            }
+        }
+
+        boundary->applyBoundaryConditions(*volumes[0], *grid);
+
+        simulator::TimestepInformation timestepInformation;
+
+        for (int timestep = 0; timestep < numberOfTimesteps; ++timestep) {
+            real dt = 0;
+
+            for (size_t substep = 0; substep < integrator->getNumberOfSubsteps();
+                ++substep) {
+                auto& conservedNext = volumes[integrator->getOutputRegister(substep)];
+                conservedSystem->setSubstep(substep);
+                dt = integrator->performSubstep(volumes, grid->getCellLengths(),
+                        dt, 0.4, *conservedNext, substep, timestepInformation);
+                boundary->applyBoundaryConditions(*conservedNext, *grid);
+            }
+
+            const size_t solutionRegister = integrator->getSolutionRegister();
+
+            if (solutionRegister != 0) {
+                volumes[0].swap(volumes[solutionRegister]);
+            }
+
+            timestepInformation.incrementTime(dt);
+        }
+
+        redundantComputeFraction = conservedSystem->getRedundantComputeFraction();
+        return volumes[0];
+    }
+};
+}
+
+TEST_P(DeepHaloTest, SameAsExchangingEverySubstep) {
+    real referenceRedundantComputeFraction = 0;
+    auto reference = run(1, referenceRedundantComputeFraction);
+    ASSERT_EQ(0, referenceRedundantComputeFraction);
+
+    const int referenceGhostCells = reference->getNumberOfXGhostCells();
+
+    for (size_t haloStages : {
+            2, 3
+        }) {
+        real redundantComputeFraction = 0;
+        auto deepHalo = run(haloStages, redundantComputeFraction);
+
+        if (numberOfProcessors > 1) {
+            ASSERT_GT(redundantComputeFraction, 0);
+        }
+
+        const int ghostCells = deepHalo->getNumberOfXGhostCells();
+        ASSERT_EQ(int(haloStages) * referenceGhostCells, ghostCells);
+
+        for (size_t var = 0; var < reference->getNumberOfVariables(); ++var) {
+            const real* expected = reference->getScalarMemoryArea(var)->getPointer();
+            const real* actual = deepHalo->getScalarMemoryArea(var)->getPointer();
+
+            for (int y = 0; y < N; ++y) {
+                for (int x = 0; x < N; ++x) {
+                    const size_t expectedIndex = (y + referenceGhostCells)
+                        * (N + 2 * referenceGhostCells) + x + referenceGhostCells;
+                    const size_t actualIndex = (y + ghostCells)
+                        * (N + 2 * ghostCells) + x + ghostCells;
+
+                    ASSERT_EQ(expected[expectedIndex], actual[actualIndex])
+                            << "haloStages = " << haloStages << ", var = " << var
+                            << ", (x, y) = (" << x << ", " << y << ")";
+                }
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(DeepHaloTests,
+    DeepHaloTest,
+    ::testing::Values(
+        DeepHaloParameters{"none", ExchangeMode::datatypes},
+        DeepHaloParameters{"weno2", ExchangeMode::datatypes},
+        DeepHaloParameters{"weno2", ExchangeMode::packed},
+        DeepHaloParameters{"weno2", ExchangeMode::sharedMemory}));
+
+namespace {
+//! A smooth, positive Euler state as a function of the global cell index
+class SmoothInitialData : public init::InitialData {
+public:
+    void setInitialData(volume::Volume& conservedVolume,
+        volume::Volume&,
+        equation::CellComputer&,
+        grid::Grid& grid) override {
+        const auto ghostCells = conservedVolume.getNumberOfGhostCells();
+        const auto innerSize = conservedVolume.getInnerSize();
+        const auto totalSize = conservedVolume.getTotalDimensions();
+        const auto globalSize = grid.getGlobalSize();
+
+        for (int y = 0; y < innerSize.y; ++y) {
+            for (int x = 0; x < innerSize.x; ++x) {
+                const size_t index = (y + ghostCells.y) * totalSize.x + x
+                    + ghostCells.x;
+                const real globalX = real(x + grid.getGlobalPosition().x)
+                    / globalSize.x;
+                const real globalY = real(y + grid.getGlobalPosition().y)
+                    / globalSize.y;
+                const real phase = 2 * M_PI * (globalX + 2 * globalY);
+
+                conservedVolume.getScalarMemoryArea("rho")->getPointer()[index] =
+                    1 + 0.5 * std::sin(phase);
+                conservedVolume.getScalarMemoryArea("mx")->getPointer()[index] =
+                    0.3 * std::cos(phase);
+                conservedVolume.getScalarMemoryArea("my")->getPointer()[index] =
+                    -0.2 * std::sin(2 * phase);
+                conservedVolume.getScalarMemoryArea("E")->getPointer()[index] =
+                    10 + std::cos(phase);
+            }
+        }
+    }
+
+    void setParameters(const init::Parameters&) override {}
+
+    boost::property_tree::ptree getDescription() const override {
+        return boost::property_tree::ptree();
+    }
+};
+
+//! Keeps a copy of the last volume it is given
+class LastVolumeWriter : public io::Writer {
+public:
+    void write(const volume::Volume& conservedVariables,
+        const grid::Grid&,
+        const simulator::TimestepInformation&) override {
+        volume = conservedVariables.makeInstance();
+        conservedVariables.copyTo(*volume);
+    }
+
+    volume::VolumePointer volume;
+};
+
+//! Runs the whole Simulator (Simulator::performStep) with the wide stencil
+//! TeCNO fluxes, which read every ghost cell of the volume.
+class DeepHaloSimulatorTest : public ::testing::TestWithParam<std::string> {
+public:
+    const std::string platform = "cpu";
+    const std::string equation = "euler2";
+    const int N = 16;
+    const int numberOfTimesteps = 3;
+
+    volume::VolumePointer run(size_t haloStages) {
+        auto mpiConfiguration = alsfvm::make_shared<alsfvm::mpi::Configuration>
+            (MPI_COMM_WORLD, platform);
+        const int numberOfProcessors = mpiConfiguration->getNumberOfProcesses();
+        auto deviceConfiguration = alsfvm::make_shared<DeviceConfiguration>
+            (platform);
+        auto simulatorParameters = alsfvm::make_shared<simulator::SimulatorParameters>
+            (equation, platform);
+        simulatorParameters->setCFLNumber(0.4);
+        simulatorParameters->setHaloStages(haloStages);
+
+        auto globalGrid = alsfvm::make_shared<grid::Grid>(rvec3{0, 0, 0},
+                rvec3{1, 1, 0},
+                ivec3{N * numberOfProcessors, N, 1},
+                boundary::allPeriodic());
+        alsfvm::mpi::domain::CartesianDecomposition decomposer(numberOfProcessors, 1,
+            1);
+        auto domainInformation = decomposer.decompose(mpiConfiguration,
+                *globalGrid);
+        auto grid = domainInformation->getGrid();
+
+        auto memoryFactory = alsfvm::make_shared<memory::MemoryFactory>
+            (deviceConfiguration);
+        volume::VolumeFactory volumeFactory(equation, memoryFactory);
+        integrator::IntegratorFactory integratorFactory("rungekutta3");
+        boundary::BoundaryFactory boundaryFactory("periodic", deviceConfiguration);
+        numflux::NumericalFluxFactory numericalFluxFactory(equation, GetParam(),
+            "none", simulatorParameters, deviceConfiguration);
+        equation::CellComputerFactory cellComputerFactory(simulatorParameters,
+            deviceConfiguration);
+        auto diffusionOperator = diffusion::DiffusionFactory().createDiffusionOperator(
+                equation, "none", "none", *grid, *simulatorParameters,
+                deviceConfiguration, memoryFactory, volumeFactory);
+        std::string equationName = equation;
+
+        auto simulator = alsfvm::make_shared<simulator::Simulator>
+            (*simulatorParameters, grid, volumeFactory, integratorFactory,
+                boundaryFactory, numericalFluxFactory, cellComputerFactory,
+                memoryFactory, 1.0, deviceConfiguration, equationName,
+                diffusionOperator, "deephalo");
+        simulator->setCellExchanger(domainInformation->getCellExchanger());
+
+        auto writer = alsfvm::make_shared<LastVolumeWriter>();
+        simulator->addWriter(writer);
+
+        alsfvm::shared_ptr<init::InitialData> initialData(new SmoothInitialData);
+        simulator->setInitialValue(initialData);
+
+        for (int timestep = 0; timestep < numberOfTimesteps; ++timestep) {
+            simulator->performStep();
+        }
+
+        return writer->volume;
+    }
+};
+}
+
+TEST_P(DeepHaloSimulatorTest, SameAsExchangingEverySubstep) {
+    auto reference = run(1);
+    const auto referenceGhostCells = reference->getNumberOfGhostCells();
+
+    for (size_t haloStages : {
+            2, 3
+        }) {
+        auto deepHalo = run(haloStages);
+        const auto ghostCells = deepHalo->getNumberOfGhostCells();
+        ASSERT_EQ(int(haloStages) * referenceGhostCells.x, ghostCells.x);
+
+        for (size_t var = 0; var < reference->getNumberOfVariables(); ++var) {
+            const real* expected = reference->getScalarMemoryArea(var)->getPointer();
+            const real* actual = deepHalo->getScalarMemoryArea(var)->getPointer();
+
+            for (int y = 0; y < N; ++y) {
+                for (int x = 0; x < N; ++x) {
+                    const size_t expectedIndex = (y + referenceGhostCells.y)
+                        * reference->getTotalDimensions().x + x + referenceGhostCells.x;
+                    const size_t actualIndex = (y + ghostCells.y)
+                        * deepHalo->getTotalDimensions().x + x + ghostCells.x;
+
+                    ASSERT_EQ(expected[expectedIndex], actual[actualIndex])
+                            << "haloStages = " << haloStages << ", var = " << var
+                            << ", (x, y) = (" << x << ", " << y << ")";
+                }
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(DeepHaloSimulatorTests,
+    DeepHaloSimulatorTest,
+    ::testing::Values("tecno4", "tecno6"));
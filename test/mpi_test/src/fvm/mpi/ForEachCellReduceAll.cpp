@@ -0,0 +1,51 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+#include "alsfvm/volume/volume_foreach.hpp"
+#include <mpi.h>
+
+using namespace alsfvm;
+using namespace alsfvm::volume;
+
+TEST(ForEachCellReduceAll, ReducesOverAllProcesses) {
+    int rank, numberOfProcessors;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &numberOfProcessors);
+
+    const ivec3 end(40, 3, 2);
+    const int cells = 40 * 3 * 2;
+
+    const real sum = for_each_cell_reduce_all(ivec3(0, 0, 0), end, real(0),
+    [&](int, int, int) {
+        return real(rank + 1);
+    }, reductions::Sum(), MPI_COMM_WORLD);
+
+    ASSERT_EQ(cells * numberOfProcessors * (numberOfProcessors + 1) / 2, sum);
+
+    const real maximum = for_each_cell_reduce_all(ivec3(0, 0, 0), end, real(0),
+    [&](int x, int, int) {
+        return real(x + 100 * rank);
+    }, reductions::Max(), MPI_COMM_WORLD);
+
+    ASSERT_EQ(39 + 100 * (numberOfProcessors - 1), maximum);
+
+    const auto range = for_each_cell_reduce_all(ivec3(0, 0, 0), end,
+            reductions::Range<real>::empty(), [&](int x, int, int) {
+        return reductions::Range<real>::of(real(x - 100 * rank));
+    }, reductions::MinMax(), MPI_COMM_WORLD);
+
+    ASSERT_EQ(-100 * (numberOfProcessors - 1), range.minimum);
+    ASSERT_EQ(39, range.maximum);
+}
@@ -0,0 +1,220 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//! Checks that completing the halo exchange one side at a time (and
+//! computing the boundary slabs as the sides arrive) gives the same as
+//! waiting for the whole exchange.
+#include <gtest/gtest.h>
+#include "alsfvm/mpi/domain/CartesianDecomposition.hpp"
+#include "alsfvm/volume/make_volume.hpp"
+#include "alsfvm/mpi/CartesianCellExchanger.hpp"
+#include "alsfvm/numflux/NumericalFluxFactory.hpp"
+#include "alsfvm/simulator/ConservedSystem.hpp"
+#include <cmath>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+using namespace alsfvm;
+
+namespace {
+typedef alsfvm::mpi::CartesianCellExchanger::ExchangeMode ExchangeMode;
+
+class HaloExchangeOverlapTest : public ::testing::TestWithParam<ExchangeMode> {
+public:
+    const std::string platform = "cpu";
+    const std::string equation = "euler3";
+    const int N = 16;
+
+    alsfvm::mpi::ConfigurationPtr mpiConfiguration;
+    int numberOfProcessors;
+    int rank;
+    ivec6 neighbours;
+
+    alsfvm::shared_ptr<DeviceConfiguration> deviceConfiguration;
+    alsfvm::shared_ptr<simulator::SimulatorParameters> simulatorParameters;
+    numflux::NumericalFluxFactory fluxFactory;
+    grid::Grid grid;
+
+    HaloExchangeOverlapTest()
+        : mpiConfiguration(alsfvm::make_shared<alsfvm::mpi::Configuration>(MPI_COMM_WORLD,
+                  platform)),
+          numberOfProcessors(mpiConfiguration->getNumberOfProcesses()),
+          rank(mpiConfiguration->getRank()),
+          deviceConfiguration(new DeviceConfiguration(platform)),
+          simulatorParameters(new simulator::SimulatorParameters(equation, platform)),
+          fluxFactory(equation, "HLL3", "weno2", simulatorParameters,
+              deviceConfiguration),
+          grid(rvec3{0, 0, 0}, rvec3{1, 1, 1}, ivec3{N, N, N},
+              boundary::allPeriodic()) {
+        auto globalGrid = alsfvm::make_shared<grid::Grid>(rvec3{0, 0, 0},
+                rvec3{1, 1, 1},
+                ivec3{N * numberOfProcessors, N, N},
+                boundary::allPeriodic());
+
+        alsfvm::mpi::domain::CartesianDecomposition decomposer(numberOfProcessors, 1, 1);
+        neighbours = decomposer.decompose(mpiConfiguration,
+                *globalGrid)->getCellExchanger()->getNeighbours();
+    }
+
+    volume::VolumePointer makeFilledVolume(int ghostCells) {
+        auto volume = volume::makeConservedVolume(platform, equation, {N, N, N},
+                ghostCells);
+
+        // A smooth, positive state that differs between the ranks
+        auto& rho = *volume->getScalarMemoryArea("rho");
+        auto& mx = *volume->getScalarMemoryArea("mx");
+        auto& my = *volume->getScalarMemoryArea("my");
+        auto& mz = *volume->getScalarMemoryArea("mz");
+        auto& E = *volume->getScalarMemoryArea("E");
+
+        for (size_t i = 0; i < rho.getSize(); ++i) {
+            const real x = real(i) / rho.getSize() + rank;
+            rho[i] = 1 + 0.5 * std::sin(7 * x);
+            mx[i] = 0.2 * std::cos(5 * x);
+            my[i] = 0.1 * std::sin(3 * x);
+            mz[i] = -0.3 * std::cos(11 * x);
+            E[i] = 10 + std::sin(13 * x);
+        }
+
+        return volume;
+    }
+};
+}
+
+TEST_P(HaloExchangeOverlapTest, WaitForAnyGroupCompletesEachSideOnce) {
+    auto overlapVolume = makeFilledVolume(3);
+    auto referenceVolume = makeFilledVolume(3);
+
+    alsfvm::mpi::CartesianCellExchanger overlapExchanger(mpiConfiguration,
+        neighbours, GetParam());
+    alsfvm::mpi::CartesianCellExchanger referenceExchanger(mpiConfiguration,
+        neighbours, GetParam());
+
+    for (int exchange = 0; exchange < 2; ++exchange) {
+        auto requests = overlapExchanger.exchangeCells(*overlapVolume,
+                *overlapVolume);
+
+        std::set<int> expectedSides;
+
+        for (int side = 0; side < 6; ++side) {
+            if (overlapExchanger.hasMessageSide(side)) {
+                expectedSides.insert(side);
+            }
+
+            ASSERT_EQ(overlapExchanger.hasMessageSide(side), requests.hasGroup(side));
+        }
+
+        std::set<int> completedSides;
+        int side;
+
+        while ((side = requests.waitForAnyGroup()) >= 0) {
+            ASSERT_EQ(0u, completedSides.count(side));
+            completedSides.insert(side);
+        }
+
+        ASSERT_EQ(expectedSides, completedSides);
+
+        referenceExchanger.exchangeCells(*referenceVolume,
+            *referenceVolume).waitForAll();
+
+        for (size_t var = 0; var < referenceVolume->getNumberOfVariables(); ++var) {
+            const auto& expected = *referenceVolume->getScalarMemoryArea(var);
+            const auto& actual = *overlapVolume->getScalarMemoryArea(var);
+
+            for (size_t i = 0; i < expected.getSize(); ++i) {
+                ASSERT_EQ(expected[i], actual[i]) << "var = " << var << ", i = " << i;
+            }
+        }
+    }
+}
+
+TEST_P(HaloExchangeOverlapTest, ConservedSystemSameAsBlockingExchange) {
+    auto numericalFlux = fluxFactory.createNumericalFlux(grid);
+    const int ghostCells = int(numericalFlux->getNumberOfGhostCells());
+
+    auto conservedVariables = makeFilledVolume(ghostCells);
+    auto output = makeFilledVolume(ghostCells);
+    auto referenceConservedVariables = makeFilledVolume(ghostCells);
+    auto referenceOutput = makeFilledVolume(ghostCells);
+
+    auto cellExchanger = alsfvm::make_shared<alsfvm::mpi::CartesianCellExchanger>
+        (mpiConfiguration, neighbours, GetParam());
+    alsfvm::mpi::CartesianCellExchanger referenceExchanger(mpiConfiguration,
+        neighbours, GetParam());
+
+    simulator::ConservedSystem system(numericalFlux,
+        alsfvm::make_shared<diffusion::NoDiffusion>());
+    system.setCellExchanger(cellExchanger);
+
+    // Twice, to make sure the progress thread can be reused
+    for (int evaluation = 0; evaluation < 2; ++evaluation) {
+        rvec3 waveSpeed = 0;
+        system(*conservedVariables, waveSpeed, true, *output);
+
+        referenceExchanger.exchangeCells(*referenceConservedVariables,
+            *referenceConservedVariables).waitForAll();
+        rvec3 referenceWaveSpeed = 0;
+        numericalFlux->computeFlux(*referenceConservedVariables, referenceWaveSpeed,
+            true, *referenceOutput, {0, 0, 0}, {0, 0, 0});
+
+        for (int k = 0; k < 3; ++k) {
+            ASSERT_EQ(referenceWaveSpeed[k], waveSpeed[k]);
+        }
+
+        for (size_t var = 0; var < output->getNumberOfVariables(); ++var) {
+            const auto& expected = *referenceOutput->getScalarMemoryArea(var);
+            const auto& actual = *output->getScalarMemoryArea(var);
+
+            for (int z = ghostCells; z < N + ghostCells; ++z) {
+                for (int y = ghostCells; y < N + ghostCells; ++y) {
+                    for (int x = ghostCells; x < N + ghostCells; ++x) {
+                        const size_t index = (z * expected.getSizeY() + y) *
+                            expected.getSizeX() + x;
+                        ASSERT_EQ(expected[index], actual[index])
+                                << "var = " << var << ", (x, y, z) = ("
+                                << x << ", " << y << ", " << z << ")";
+                    }
+                }
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(HaloExchangeOverlapTests,
+    HaloExchangeOverlapTest,
+    ::testing::Values(ExchangeMode::datatypes, ExchangeMode::packed,
+        ExchangeMode::sharedMemory));
+
+TEST(ProgressThreadTest, RunsOnTheCallingThreadWithoutThreadSupport) {
+    for (bool runOnThread : {
+            true, false
+        }) {
+        alsfvm::mpi::ProgressThread progressThread(runOnThread);
+        std::thread::id jobThread;
+
+        progressThread.submit([&]() {
+            jobThread = std::this_thread::get_id();
+        });
+        progressThread.wait();
+
+        EXPECT_EQ(runOnThread, jobThread != std::this_thread::get_id());
+
+        progressThread.submit([]() {
+            throw std::runtime_error("job failed");
+        });
+        EXPECT_THROW(progressThread.wait(), std::runtime_error);
+    }
+}
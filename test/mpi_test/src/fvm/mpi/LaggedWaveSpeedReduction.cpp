@@ -0,0 +1,125 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+#include "alsfvm/mpi/LaggedWaveSpeedReduction.hpp"
+#include "alsutils/mpi/mpi_types.hpp"
+
+using namespace alsfvm;
+
+namespace {
+//! Checks that all processors got the same value
+void expectSameOnAllProcessors(const rvec3& values) {
+    for (int d = 0; d < 3; ++d) {
+        real minimum, maximum;
+        MPI_Allreduce(&values[d], &minimum, 1,
+            alsutils::mpi::MpiTypes<real>::MPI_Real, MPI_MIN, MPI_COMM_WORLD);
+        MPI_Allreduce(&values[d], &maximum, 1,
+            alsutils::mpi::MpiTypes<real>::MPI_Real, MPI_MAX, MPI_COMM_WORLD);
+        EXPECT_EQ(minimum, maximum);
+    }
+}
+
+class LaggedWaveSpeedReductionTest : public ::testing::Test {
+public:
+    alsfvm::mpi::ConfigurationPtr configuration;
+    int rank;
+    int numberOfProcessors;
+
+    LaggedWaveSpeedReductionTest()
+        : configuration(alsfvm::make_shared<alsfvm::mpi::Configuration>
+              (MPI_COMM_WORLD, "cpu")),
+          rank(configuration->getRank()),
+          numberOfProcessors(configuration->getNumberOfProcesses()) {
+    }
+
+    //! The local wave speeds at the given step, the global maximum is on
+    //! the last processor
+    rvec3 getLocalWaveSpeeds(int step, real growth) const {
+        const real base = 1 + real(rank) / numberOfProcessors + growth * step;
+        return {base, 2 * base, 0};
+    }
+
+    rvec3 getGlobalWaveSpeeds(int step, real growth) const {
+        const real base = 1 + real(numberOfProcessors - 1) / numberOfProcessors
+            + growth * step;
+        return {base, 2 * base, 0};
+    }
+};
+}
+
+TEST_F(LaggedWaveSpeedReductionTest, ExtrapolatesPreviousMaximum) {
+    const real safetyFactor = 0.8;
+    const real growth = 0.01;
+    alsfvm::mpi::LaggedWaveSpeedReduction reduction(configuration,
+        safetyFactor);
+
+    // The first estimate is exact
+    auto estimate = reduction.estimateMaximum(getLocalWaveSpeeds(0, growth));
+    expectSameOnAllProcessors(estimate);
+
+    for (int d = 0; d < 3; ++d) {
+        EXPECT_EQ(getGlobalWaveSpeeds(0, growth)[d], estimate[d]);
+    }
+
+    // The second only knows the first maximum
+    estimate = reduction.estimateMaximum(getLocalWaveSpeeds(1, growth));
+    expectSameOnAllProcessors(estimate);
+
+    for (int d = 0; d < 3; ++d) {
+        EXPECT_DOUBLE_EQ(getGlobalWaveSpeeds(0, growth)[d] / safetyFactor,
+            estimate[d]);
+    }
+
+    // Then the trend is added
+    for (int step = 2; step < 10; ++step) {
+        estimate = reduction.estimateMaximum(getLocalWaveSpeeds(step, growth));
+        expectSameOnAllProcessors(estimate);
+
+        for (int d = 0; d < 3; ++d) {
+            const real last = getGlobalWaveSpeeds(step - 1, growth)[d];
+            const real secondLast = getGlobalWaveSpeeds(step - 2, growth)[d];
+            EXPECT_NEAR((2 * last - secondLast) / safetyFactor, estimate[d], 1e-12);
+            EXPECT_GE(estimate[d], getGlobalWaveSpeeds(step, growth)[d]);
+        }
+    }
+
+    EXPECT_EQ(0u, reduction.getNumberOfUnderestimates());
+}
+
+TEST_F(LaggedWaveSpeedReductionTest, FallsBackToExactMaximum) {
+    alsfvm::mpi::LaggedWaveSpeedReduction reduction(configuration, 0.9);
+
+    reduction.estimateMaximum(getLocalWaveSpeeds(0, 0));
+    reduction.estimateMaximum(getLocalWaveSpeeds(0, 0));
+
+    // A sudden jump on one processor is missed by the estimate of this
+    // step...
+    rvec3 local = getLocalWaveSpeeds(0, 0);
+
+    if (rank == 0) {
+        local.x = 100;
+    }
+
+    auto estimate = reduction.estimateMaximum(local);
+    expectSameOnAllProcessors(estimate);
+    EXPECT_LT(estimate.x, 100);
+
+    // ...and found in the next, which uses the exact maximum
+    estimate = reduction.estimateMaximum(getLocalWaveSpeeds(0, 0));
+    expectSameOnAllProcessors(estimate);
+    EXPECT_EQ(1u, reduction.getNumberOfUnderestimates());
+    EXPECT_EQ(getGlobalWaveSpeeds(0, 0).x, estimate.x);
+    EXPECT_EQ(getGlobalWaveSpeeds(0, 0).y, estimate.y);
+}
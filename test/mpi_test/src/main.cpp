@@ -29,7 +29,8 @@ int main(int argc, char** argv) {
     setenv("MPICH_RDMA_ENABLED_CUDA", "1", 1);
     setenv("MV2_USE_CUDA", "1", 1);
 #endif
-    MPI_Init(NULL, NULL);
+    int threadSupport;
+    MPI_Init_thread(NULL, NULL, MPI_THREAD_MULTIPLE, &threadSupport);
 #ifdef DALSVINN_HAS_GPU_DIRECT
 
     int rank, size;
@@ -0,0 +1,216 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+#include "alsuq/mpi/SimpleLoadBalancer.hpp"
+#include "alsuq/mpi/StaticSampleScheduler.hpp"
+#include "alsuq/mpi/DynamicSampleScheduler.hpp"
+#include <mpi.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+using alsuq::ivec3;
+
+namespace {
+std::vector<size_t> makeSamples(size_t numberOfSamples) {
+    std::vector<size_t> samples(numberOfSamples);
+
+    for (size_t i = 0; i < numberOfSamples; ++i) {
+        // Not starting at zero, as with <sampleStart>
+        samples[i] = 1000 + i;
+    }
+
+    return samples;
+}
+
+//! Runs the scheduler to the end, and checks that every sample was taken
+//! by exactly one group, and by every process in that group.
+void checkAllSamplesTakenOnce(alsuq::mpi::SampleScheduler& scheduler,
+    const std::vector<size_t>& samples,
+    alsuq::mpi::ConfigurationPtr worldConfiguration,
+    alsuq::mpi::ConfigurationPtr spatialConfiguration,
+    bool slowFirstGroup) {
+
+    std::vector<size_t> samplesTaken;
+
+    for (auto chunk = scheduler.nextSamples(); !chunk.empty();
+        chunk = scheduler.nextSamples()) {
+        for (size_t sample : chunk) {
+            ASSERT_TRUE(samplesTaken.empty() || samplesTaken.back() < sample)
+                    << "The samples must come in increasing order";
+            samplesTaken.push_back(sample);
+
+            if (slowFirstGroup && worldConfiguration->getRank() == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+        }
+    }
+
+    ASSERT_FALSE(samplesTaken.empty());
+
+    // Every process in the group has the same samples
+    std::vector<size_t> samplesOfGroupLeader = samplesTaken;
+    int numberOfSamplesOfGroupLeader = int(samplesTaken.size());
+    MPI_Bcast(&numberOfSamplesOfGroupLeader, 1, MPI_INT, 0,
+        spatialConfiguration->getCommunicator());
+    samplesOfGroupLeader.resize(numberOfSamplesOfGroupLeader);
+    MPI_Bcast(samplesOfGroupLeader.data(), numberOfSamplesOfGroupLeader,
+        MPI_UNSIGNED_LONG, 0, spatialConfiguration->getCommunicator());
+    ASSERT_EQ(samplesOfGroupLeader, samplesTaken);
+
+    // Count how often each sample was taken, only once per group
+    std::vector<int> timesTaken(samples.size(), 0);
+
+    if (spatialConfiguration->getRank() == 0) {
+        for (size_t sample : samplesTaken) {
+            timesTaken[sample - samples[0]]++;
+        }
+    }
+
+    std::vector<int> timesTakenTotal(samples.size(), 0);
+    MPI_Allreduce(timesTaken.data(), timesTakenTotal.data(), int(samples.size()),
+        MPI_INT, MPI_SUM, worldConfiguration->getCommunicator());
+
+    for (size_t i = 0; i < samples.size(); ++i) {
+        ASSERT_EQ(1, timesTakenTotal[i]) << "for sample " << samples[i];
+    }
+}
+
+class SampleSchedulerTest : public ::testing::TestWithParam<int> {
+public:
+    SampleSchedulerTest()
+        : worldConfiguration(new alsuq::mpi::Configuration(MPI_COMM_WORLD)) {
+        MPI_Comm_size(MPI_COMM_WORLD, &numberOfProcesses);
+    }
+
+    alsuq::mpi::ConfigurationPtr worldConfiguration;
+    int numberOfProcesses;
+};
+}
+
+TEST_P(SampleSchedulerTest, StaticWithoutDivisibility) {
+    const int processesPerSample = GetParam();
+
+    if (numberOfProcesses % processesPerSample != 0) {
+        return;
+    }
+
+    const int multiSample = numberOfProcesses / processesPerSample;
+
+    for (size_t numberOfSamples : {
+            size_t(multiSample), size_t(multiSample + 1), size_t(7 * multiSample + 3)
+        }) {
+        auto samples = makeSamples(numberOfSamples);
+        alsuq::mpi::SimpleLoadBalancer loadBalancer(samples);
+        auto loadBalanced = loadBalancer.loadBalance(multiSample,
+                ivec3(processesPerSample, 1, 1), *worldConfiguration);
+        const auto& samplesForProcess = std::get<0>(loadBalanced);
+
+        // the shares differ by at most one
+        ASSERT_LE(samplesForProcess.size(), numberOfSamples / multiSample + 1);
+        ASSERT_GE(samplesForProcess.size(), numberOfSamples / multiSample);
+
+        alsuq::mpi::StaticSampleScheduler scheduler(samplesForProcess);
+        checkAllSamplesTakenOnce(scheduler, samples, worldConfiguration,
+            std::get<2>(loadBalanced), false);
+    }
+}
+
+TEST_P(SampleSchedulerTest, StaticNeedsOneSamplePerGroup) {
+    const int processesPerSample = GetParam();
+
+    if (numberOfProcesses % processesPerSample != 0
+        || numberOfProcesses / processesPerSample < 2) {
+        return;
+    }
+
+    const int multiSample = numberOfProcesses / processesPerSample;
+    alsuq::mpi::SimpleLoadBalancer loadBalancer(makeSamples(multiSample - 1));
+    ASSERT_ANY_THROW(loadBalancer.loadBalance(multiSample,
+            ivec3(processesPerSample, 1, 1), *worldConfiguration));
+}
+
+TEST_P(SampleSchedulerTest, DynamicTakesEverySampleOnce) {
+    const int processesPerSample = GetParam();
+
+    if (numberOfProcesses % processesPerSample != 0) {
+        return;
+    }
+
+    const int multiSample = numberOfProcesses / processesPerSample;
+
+    for (size_t chunkSize : {
+            1, 3, 1000
+        }) {
+        for (size_t numberOfSamples : {
+                size_t(multiSample), size_t(5 * multiSample + 2)
+            }) {
+            for (bool slowFirstGroup : {
+                    false, true
+                }) {
+                auto samples = makeSamples(numberOfSamples);
+                alsuq::mpi::SimpleLoadBalancer loadBalancer(samples);
+                auto loadBalanced = loadBalancer.loadBalance(multiSample,
+                        ivec3(processesPerSample, 1, 1), *worldConfiguration);
+
+                alsuq::mpi::DynamicSampleScheduler scheduler(samples, chunkSize,
+                    worldConfiguration, std::get<1>(loadBalanced),
+                    std::get<2>(loadBalanced));
+
+                checkAllSamplesTakenOnce(scheduler, samples, worldConfiguration,
+                    std::get<2>(loadBalanced), slowFirstGroup);
+            }
+        }
+    }
+}
+
+TEST_P(SampleSchedulerTest, DynamicServesTheCounterWhileRankZeroComputes) {
+    const int processesPerSample = GetParam();
+    int threadSupport = MPI_THREAD_SINGLE;
+    MPI_Query_thread(&threadSupport);
+
+    if (numberOfProcesses % processesPerSample != 0
+        || numberOfProcesses / processesPerSample < 2
+        || threadSupport != MPI_THREAD_MULTIPLE) {
+        return;
+    }
+
+    const int multiSample = numberOfProcesses / processesPerSample;
+    const size_t numberOfSamples = 10 * multiSample;
+    auto samples = makeSamples(numberOfSamples);
+    alsuq::mpi::SimpleLoadBalancer loadBalancer(samples);
+    auto loadBalanced = loadBalancer.loadBalance(multiSample,
+            ivec3(processesPerSample, 1, 1), *worldConfiguration);
+
+    alsuq::mpi::DynamicSampleScheduler scheduler(samples, 1,
+        worldConfiguration, std::get<1>(loadBalanced), std::get<2>(loadBalanced));
+
+    // The first group computes (without calling MPI) for much longer than
+    // the others need for all the remaining samples
+    for (auto chunk = scheduler.nextSamples(); !chunk.empty();
+        chunk = scheduler.nextSamples()) {
+        if (std::get<1>(loadBalanced)->getRank() == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        }
+    }
+
+    if (worldConfiguration->getRank() == 0) {
+        ASSERT_LT(scheduler.getNumberOfSamplesTaken(), numberOfSamples / 2);
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(SampleSchedulerTests,
+    SampleSchedulerTest,
+    ::testing::Values(1, 2));
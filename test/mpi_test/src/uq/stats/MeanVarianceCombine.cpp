@@ -0,0 +1,110 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include "alsuq/stats/MeanVariance.hpp"
+#include "alsuq/mpi/Configuration.hpp"
+#include "alsfvm/volume/VolumeFactory.hpp"
+#include "CopyWriter.hpp"
+#include <cmath>
+#include <mpi.h>
+
+using namespace alsuq::stats;
+
+namespace {
+double sampleValue(size_t sample, size_t cell) {
+    return 1e6 + 1e-3 * std::sin(double(sample * 31 + cell * 7));
+}
+}
+
+TEST(MeanVarianceCombine, UnevenSampleGroups) {
+    // Rank r computes r + 1 of the samples, so that the merge has to weigh
+    // the groups by their number of samples
+    auto mpiConfiguration = std::make_shared<alsuq::mpi::Configuration>
+        (MPI_COMM_WORLD, "cpu");
+    const size_t rank = mpiConfiguration->getRank();
+    const size_t numberOfProcesses = mpiConfiguration->getNumberOfProcesses();
+    const size_t numberOfSamples = numberOfProcesses * (numberOfProcesses + 1) / 2;
+    const size_t firstSample = rank * (rank + 1) / 2;
+
+    const int nx = 16;
+    auto deviceConfiguration = alsfvm::make_shared<alsfvm::DeviceConfiguration>
+        ("cpu");
+    auto memoryFactory = alsfvm::make_shared<alsfvm::memory::MemoryFactory>
+        (deviceConfiguration);
+    alsfvm::volume::VolumeFactory volumeFactory("burgers", memoryFactory);
+    alsfvm::grid::Grid grid({0, 0, 0}, {1, 0, 0}, {nx, 1, 1});
+    auto sample = volumeFactory.createConservedVolume(nx, 1, 1, 1);
+
+    StatisticsParameters parameters{boost::property_tree::ptree()};
+    parameters.setNumberOfSamples(numberOfSamples);
+    parameters.setMpiConfiguration(mpiConfiguration);
+    MeanVariance statistics(parameters);
+    alsfvm::simulator::TimestepInformation timestepInformation;
+
+    for (size_t k = firstSample; k < firstSample + rank + 1; ++k) {
+        auto memory = sample->getScalarMemoryArea(0);
+
+        for (size_t cell = 0; cell < memory->getSize(); ++cell) {
+            memory->getPointer()[cell] = sampleValue(k, cell);
+        }
+
+        statistics.computeStatistics(*sample, grid, timestepInformation);
+    }
+
+    statistics.combineStatistics();
+
+    if (rank != 0) {
+        return;
+    }
+
+    auto meanWriter = std::make_shared<CopyWriter>();
+    auto varianceWriter = std::make_shared<CopyWriter>();
+    std::shared_ptr<alsfvm::io::Writer> writer = meanWriter;
+    statistics.addWriter("mean", writer);
+    writer = varianceWriter;
+    statistics.addWriter("variance", writer);
+
+    statistics.finalizeStatistics();
+    statistics.writeStatistics(grid);
+
+    const auto mean = meanWriter->volumes.at(0)->getScalarMemoryArea(0);
+    const auto variance = varianceWriter->volumes.at(0)->getScalarMemoryArea(0);
+
+    for (size_t cell = 0; cell < mean->getSize(); ++cell) {
+        long double expectedMean = 0;
+
+        for (size_t k = 0; k < numberOfSamples; ++k) {
+            expectedMean += sampleValue(k, cell);
+        }
+
+        expectedMean /= numberOfSamples;
+        long double expectedVariance = 0;
+
+        for (size_t k = 0; k < numberOfSamples; ++k) {
+            expectedVariance += (sampleValue(k, cell) - expectedMean)
+                * (sampleValue(k, cell) - expectedMean);
+        }
+
+        expectedVariance /= numberOfSamples;
+
+        ASSERT_NEAR(double(expectedMean), mean->getPointer()[cell], 1e-9);
+
+        if (numberOfSamples > 1) {
+            ASSERT_NEAR(1, variance->getPointer()[cell] / double(expectedVariance),
+                1e-6) << "cell " << cell;
+        }
+    }
+}
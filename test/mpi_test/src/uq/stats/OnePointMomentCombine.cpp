@@ -0,0 +1,158 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include "alsuq/stats/OnePointMoment.hpp"
+#include "alsuq/mpi/Configuration.hpp"
+#include "alsfvm/volume/VolumeFactory.hpp"
+#include "CopyWriter.hpp"
+#include <mpi.h>
+
+using namespace alsuq::stats;
+
+namespace {
+double sampleValue(size_t sample, size_t cell, size_t time) {
+    return double(sample * 3 + cell + 100 * time);
+}
+}
+
+TEST(OnePointMomentCombine, SeveralSnapshots) {
+    // Every snapshot (time) is reduced, all of them in the same reductions
+    auto mpiConfiguration = std::make_shared<alsuq::mpi::Configuration>
+        (MPI_COMM_WORLD, "cpu");
+    const size_t rank = mpiConfiguration->getRank();
+    const size_t numberOfSamples = mpiConfiguration->getNumberOfProcesses();
+    const size_t numberOfTimes = 4;
+
+    const int nx = 10;
+    auto deviceConfiguration = alsfvm::make_shared<alsfvm::DeviceConfiguration>
+        ("cpu");
+    auto memoryFactory = alsfvm::make_shared<alsfvm::memory::MemoryFactory>
+        (deviceConfiguration);
+    alsfvm::volume::VolumeFactory volumeFactory("burgers", memoryFactory);
+    alsfvm::grid::Grid grid({0, 0, 0}, {1, 0, 0}, {nx, 1, 1});
+    auto sample = volumeFactory.createConservedVolume(nx, 1, 1, 1);
+
+    boost::property_tree::ptree configuration;
+    configuration.put("p", 1);
+    StatisticsParameters parameters(configuration);
+    parameters.setNumberOfSamples(numberOfSamples);
+    parameters.setMpiConfiguration(mpiConfiguration);
+    OnePointMoment statistics(parameters);
+
+    for (size_t time = 0; time < numberOfTimes; ++time) {
+        auto memory = sample->getScalarMemoryArea(0);
+
+        for (size_t cell = 0; cell < memory->getSize(); ++cell) {
+            memory->getPointer()[cell] = sampleValue(rank, cell, time);
+        }
+
+        alsfvm::simulator::TimestepInformation timestepInformation(alsuq::real(time), time);
+        statistics.computeStatistics(*sample, grid, timestepInformation);
+    }
+
+    statistics.combineStatistics();
+
+    if (rank != 0) {
+        return;
+    }
+
+    auto writer = std::make_shared<CopyWriter>();
+    std::shared_ptr<alsfvm::io::Writer> writerPointer = writer;
+    statistics.addWriter("m1", writerPointer);
+    statistics.finalizeStatistics();
+    statistics.writeStatistics(grid);
+
+    ASSERT_EQ(numberOfTimes, writer->volumes.size());
+
+    for (size_t snapshot = 0; snapshot < numberOfTimes; ++snapshot) {
+        const size_t time = size_t(writer->times[snapshot]);
+        const auto m1 = writer->volumes[snapshot]->getScalarMemoryArea(0);
+
+        for (size_t cell = 0; cell < m1->getSize(); ++cell) {
+            double expected = 0;
+
+            for (size_t k = 0; k < numberOfSamples; ++k) {
+                expected += sampleValue(k, cell, time);
+            }
+
+            ASSERT_NEAR(expected / numberOfSamples, m1->getPointer()[cell], 1e-12);
+        }
+    }
+}
+
+TEST(OnePointMomentCombine, UnevenSampleGroups) {
+    // Rank r computes r + 1 of the samples, so that the merge has to weigh
+    // the running means by their number of samples
+    auto mpiConfiguration = std::make_shared<alsuq::mpi::Configuration>
+        (MPI_COMM_WORLD, "cpu");
+    const size_t rank = mpiConfiguration->getRank();
+    const size_t numberOfProcesses = mpiConfiguration->getNumberOfProcesses();
+    const size_t numberOfSamples = numberOfProcesses * (numberOfProcesses + 1) / 2;
+    const size_t firstSample = rank * (rank + 1) / 2;
+
+    const int nx = 10;
+    auto deviceConfiguration = alsfvm::make_shared<alsfvm::DeviceConfiguration>
+        ("cpu");
+    auto memoryFactory = alsfvm::make_shared<alsfvm::memory::MemoryFactory>
+        (deviceConfiguration);
+    alsfvm::volume::VolumeFactory volumeFactory("burgers", memoryFactory);
+    alsfvm::grid::Grid grid({0, 0, 0}, {1, 0, 0}, {nx, 1, 1});
+    auto sample = volumeFactory.createConservedVolume(nx, 1, 1, 1);
+
+    boost::property_tree::ptree configuration;
+    configuration.put("p", 2);
+    StatisticsParameters parameters(configuration);
+    parameters.setNumberOfSamples(numberOfSamples);
+    parameters.setMpiConfiguration(mpiConfiguration);
+    OnePointMoment statistics(parameters);
+
+    alsfvm::simulator::TimestepInformation timestepInformation;
+
+    for (size_t k = firstSample; k < firstSample + rank + 1; ++k) {
+        auto memory = sample->getScalarMemoryArea(0);
+
+        for (size_t cell = 0; cell < memory->getSize(); ++cell) {
+            memory->getPointer()[cell] = sampleValue(k, cell, 0);
+        }
+
+        statistics.computeStatistics(*sample, grid, timestepInformation);
+    }
+
+    statistics.combineStatistics();
+
+    if (rank != 0) {
+        return;
+    }
+
+    auto writer = std::make_shared<CopyWriter>();
+    std::shared_ptr<alsfvm::io::Writer> writerPointer = writer;
+    statistics.addWriter("m2", writerPointer);
+    statistics.finalizeStatistics();
+    statistics.writeStatistics(grid);
+
+    ASSERT_EQ(1u, writer->volumes.size());
+    const auto m2 = writer->volumes[0]->getScalarMemoryArea(0);
+
+    for (size_t cell = 0; cell < m2->getSize(); ++cell) {
+        double expected = 0;
+
+        for (size_t k = 0; k < numberOfSamples; ++k) {
+            expected += sampleValue(k, cell, 0) * sampleValue(k, cell, 0);
+        }
+
+        ASSERT_NEAR(expected / numberOfSamples, m2->getPointer()[cell], 1e-9);
+    }
+}
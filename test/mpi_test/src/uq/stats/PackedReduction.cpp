@@ -0,0 +1,86 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include "alsuq/stats/PackedReduction.hpp"
+#include <mpi.h>
+
+using alsuq::stats::PackedReduction;
+
+namespace {
+class PackedReductionTest : public ::testing::TestWithParam<size_t> {
+public:
+    PackedReductionTest() {
+        MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        MPI_Comm_size(MPI_COMM_WORLD, &numberOfProcesses);
+    }
+
+    int rank = 0;
+    int numberOfProcesses = 0;
+};
+}
+
+TEST_P(PackedReductionTest, SumsEverySegment) {
+    // Including empty segments and segments longer than a chunk
+    const std::vector<size_t> sizes = {0, 5, 13, 1, 0, 40, 2};
+    std::vector<std::vector<double> > data(sizes.size());
+    std::vector<std::vector<int> > timesUnpacked(sizes.size());
+
+    PackedReduction<double> reduction(MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD,
+        GetParam());
+
+    for (size_t segment = 0; segment < sizes.size(); ++segment) {
+        data[segment].resize(sizes[segment]);
+        timesUnpacked[segment].resize(sizes[segment], 0);
+
+        for (size_t i = 0; i < sizes[segment]; ++i) {
+            data[segment][i] = rank * 1000 + segment * 100 + i;
+        }
+
+        double* values = data[segment].data();
+        int* unpacked = timesUnpacked[segment].data();
+        reduction.addSegment(sizes[segment],
+        [values](size_t begin, size_t count, double * buffer) {
+            std::copy(values + begin, values + begin + count, buffer);
+        },
+        [values, unpacked](size_t begin, size_t count, const double * buffer) {
+            for (size_t i = 0; i < count; ++i) {
+                values[begin + i] = buffer[i];
+                unpacked[begin + i]++;
+            }
+        });
+    }
+
+    reduction.reduce();
+
+    const double rankSum = 1000.0 * numberOfProcesses * (numberOfProcesses - 1) / 2;
+
+    for (size_t segment = 0; segment < sizes.size(); ++segment) {
+        for (size_t i = 0; i < sizes[segment]; ++i) {
+            if (rank == 0) {
+                ASSERT_EQ(1, timesUnpacked[segment][i]);
+                ASSERT_EQ(rankSum + numberOfProcesses * double(segment * 100 + i),
+                    data[segment][i]);
+            } else {
+                ASSERT_EQ(0, timesUnpacked[segment][i]);
+                ASSERT_EQ(rank * 1000 + double(segment * 100 + i), data[segment][i]);
+            }
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(ChunkSizes, PackedReductionTest,
+    ::testing::Values(size_t(1), size_t(7), size_t(64),
+        PackedReduction<double>::defaultChunkSize));
@@ -0,0 +1,316 @@
+/* Copyright (c) 2018 ETH Zurich, Kjetil Olsen Lye
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+#include "alsuq/stats/MeanVariance.hpp"
+#include "alsuq/stats/OnePointMoment.hpp"
+#include "alsuq/stats/ScatteredReduction.hpp"
+#include "alsuq/mpi/Configuration.hpp"
+#include "alsfvm/volume/VolumeFactory.hpp"
+#include "CopyWriter.hpp"
+#include <cmath>
+#include <mpi.h>
+
+using namespace alsuq::stats;
+using alsuq::ivec3;
+using alsuq::rvec3;
+
+namespace {
+double sampleValue(size_t sample, const ivec3& cell) {
+    return 1e3 + std::sin(double(sample * 31 + cell.x * 7 + cell.y * 5 + cell.z * 3));
+}
+
+//! Returns the value of the given inner cell of the first variable
+double getCell(const alsfvm::volume::Volume& volume, const ivec3& cell) {
+    const auto ghostCells = volume.getNumberOfGhostCells();
+    const auto totalSize = volume.getTotalDimensions();
+    const ivec3 index = cell + ghostCells;
+    return volume.getScalarMemoryArea(0)->getPointer()[(index.z * totalSize.y +
+                    index.y) * totalSize.x + index.x];
+}
+
+void setCell(alsfvm::volume::Volume& volume, const ivec3& cell, double value) {
+    const auto ghostCells = volume.getNumberOfGhostCells();
+    const auto totalSize = volume.getTotalDimensions();
+    const ivec3 index = cell + ghostCells;
+    volume.getScalarMemoryArea(0)->getPointer()[(index.z * totalSize.y +
+            index.y) * totalSize.x + index.x] = value;
+}
+
+class ScatterStatisticsTest : public ::testing::TestWithParam<ivec3> {
+public:
+    ScatterStatisticsTest()
+        : mpiConfiguration(std::make_shared<alsuq::mpi::Configuration>
+              (MPI_COMM_WORLD, "cpu")),
+          rank(mpiConfiguration->getRank()),
+          numberOfProcesses(mpiConfiguration->getNumberOfProcesses()) {
+
+    }
+
+    //! Computes the given statistics with rank r computing r + 1 samples,
+    //! scatters them, and returns the writers of each statistics name
+    std::map<std::string, std::shared_ptr<CopyWriter> > computeAndScatter(
+        const std::string& name, const ivec3& size,
+        boost::property_tree::ptree configuration = boost::property_tree::ptree()) {
+        auto deviceConfiguration = alsfvm::make_shared<alsfvm::DeviceConfiguration>
+            ("cpu");
+        auto memoryFactory = alsfvm::make_shared<alsfvm::memory::MemoryFactory>
+            (deviceConfiguration);
+        alsfvm::volume::VolumeFactory volumeFactory("burgers", memoryFactory);
+        auto sample = volumeFactory.createConservedVolume(size.x, size.y, size.z, 2);
+
+        StatisticsParameters parameters(configuration);
+        parameters.setNumberOfSamples(getNumberOfSamples());
+        parameters.setMpiConfiguration(mpiConfiguration);
+        parameters.setScatterStatistics(true);
+
+        std::shared_ptr<Statistics> statistics;
+
+        if (name == "meanvar") {
+            statistics.reset(new MeanVariance(parameters));
+        } else {
+            statistics.reset(new OnePointMoment(parameters));
+        }
+
+        EXPECT_TRUE(statistics->supportsScatteredStatistics());
+        alsfvm::simulator::TimestepInformation timestepInformation;
+        const size_t firstSample = rank * (rank + 1) / 2;
+
+        for (size_t k = firstSample; k < firstSample + rank + 1; ++k) {
+            forEachCell(size, [&](const ivec3 & cell) {
+                setCell(*sample, cell, sampleValue(k, cell));
+            });
+
+            statistics->write(*sample, *makeGrid(size), timestepInformation);
+        }
+
+        std::map<std::string, std::shared_ptr<CopyWriter> > writers;
+
+        for (const auto& statisticsName : statistics->getStatisticsNames()) {
+            writers[statisticsName] = std::make_shared<CopyWriter>();
+            std::shared_ptr<alsfvm::io::Writer> writer = writers[statisticsName];
+            statistics->addWriter(statisticsName, writer);
+        }
+
+        statistics->combineStatistics();
+        statistics->finalizeStatistics();
+        statistics->writeStatistics(*makeGrid(size));
+
+        return writers;
+    }
+
+    std::shared_ptr<alsfvm::grid::Grid> makeGrid(const ivec3& size) {
+        return std::make_shared<alsfvm::grid::Grid>(rvec3(0, 0, 0),
+                rvec3(1, size.y > 1 ? 1 : 0, size.z > 1 ? 1 : 0), size);
+    }
+
+    size_t getNumberOfSamples() const {
+        return numberOfProcesses * (numberOfProcesses + 1) / 2;
+    }
+
+    template<class Function>
+    void forEachCell(const ivec3& size, const Function& function) {
+        for (int z = 0; z < size.z; ++z) {
+            for (int y = 0; y < size.y; ++y) {
+                for (int x = 0; x < size.x; ++x) {
+                    function(ivec3(x, y, z));
+                }
+            }
+        }
+    }
+
+    //! Checks that the slabs of all processes together cover every cell
+    //! exactly once, and that the slab grid is where the slab is
+    void checkSlabs(const CopyWriter& writer, const ivec3& size) {
+        ASSERT_EQ(1u, writer.volumes.size());
+        const auto& grid = writer.grids[0];
+        const auto& volume = *writer.volumes[0];
+        ASSERT_EQ(size, grid.getGlobalSize());
+        ASSERT_EQ(grid.getDimensions(), volume.getInnerSize());
+
+        const size_t direction = size.z > 1 ? 2 : (size.y > 1 ? 1 : 0);
+
+        for (size_t d = 0; d < 3; ++d) {
+            if (d != direction) {
+                ASSERT_EQ(size[d], grid.getDimensions()[d]);
+                ASSERT_EQ(0, grid.getGlobalPosition()[d]);
+            }
+        }
+
+        ASSERT_NEAR(grid.getGlobalPosition()[direction] * grid.getCellLengths()[direction],
+            grid.getOrigin()[direction], 1e-12);
+
+        std::vector<int> slabs = {grid.getGlobalPosition()[direction],
+                grid.getDimensions()[direction]
+            };
+        std::vector<int> allSlabs(2 * numberOfProcesses);
+        MPI_Allgather(slabs.data(), 2, MPI_INT, allSlabs.data(), 2, MPI_INT,
+            MPI_COMM_WORLD);
+
+        int covered = 0;
+
+        for (int process = 0; process < numberOfProcesses; ++process) {
+            ASSERT_EQ(covered, allSlabs[2 * process]);
+            ASSERT_LT(0, allSlabs[2 * process + 1]);
+            covered += allSlabs[2 * process + 1];
+        }
+
+        ASSERT_EQ(size[direction], covered);
+    }
+
+    std::shared_ptr<alsuq::mpi::Configuration> mpiConfiguration;
+    const int rank;
+    const int numberOfProcesses;
+};
+}
+
+TEST_P(ScatterStatisticsTest, MeanVariance) {
+    const ivec3 size = GetParam();
+    auto writers = computeAndScatter("meanvar", size);
+
+    checkSlabs(*writers["mean"], size);
+    checkSlabs(*writers["variance"], size);
+
+    const auto& grid = writers["mean"]->grids[0];
+    const auto& mean = *writers["mean"]->volumes[0];
+    const auto& variance = *writers["variance"]->volumes[0];
+    const size_t numberOfSamples = getNumberOfSamples();
+
+    forEachCell(grid.getDimensions(), [&](const ivec3 & cell) {
+        const ivec3 globalCell = cell + grid.getGlobalPosition();
+        long double expectedMean = 0;
+
+        for (size_t k = 0; k < numberOfSamples; ++k) {
+            expectedMean += sampleValue(k, globalCell);
+        }
+
+        expectedMean /= numberOfSamples;
+        long double expectedVariance = 0;
+
+        for (size_t k = 0; k < numberOfSamples; ++k) {
+            expectedVariance += (sampleValue(k, globalCell) - expectedMean)
+                * (sampleValue(k, globalCell) - expectedMean);
+        }
+
+        expectedVariance /= numberOfSamples;
+
+        ASSERT_NEAR(double(expectedMean), getCell(mean, cell), 1e-10);
+        ASSERT_NEAR(double(expectedVariance), getCell(variance, cell), 1e-10);
+    });
+}
+
+TEST_P(ScatterStatisticsTest, OnePointMoment) {
+    const ivec3 size = GetParam();
+    boost::property_tree::ptree configuration;
+    configuration.put("p", 2);
+    auto writers = computeAndScatter("onepointmoment", size, configuration);
+
+    checkSlabs(*writers["m2"], size);
+
+    const auto& grid = writers["m2"]->grids[0];
+    const auto& m2 = *writers["m2"]->volumes[0];
+    const size_t numberOfSamples = getNumberOfSamples();
+
+    forEachCell(grid.getDimensions(), [&](const ivec3 & cell) {
+        const ivec3 globalCell = cell + grid.getGlobalPosition();
+        double expected = 0;
+
+        for (size_t k = 0; k < numberOfSamples; ++k) {
+            expected += std::pow(sampleValue(k, globalCell), 2);
+        }
+
+        ASSERT_NEAR(1, getCell(m2, cell) / (expected / numberOfSamples), 1e-12);
+    });
+}
+
+INSTANTIATE_TEST_CASE_P(ScatterStatisticsTests, ScatterStatisticsTest,
+    ::testing::Values(ivec3(23, 1, 1), ivec3(6, 7, 1), ivec3(4, 3, 5)));
+
+class ScatteredReductionTest : public ::testing::TestWithParam<size_t> {
+};
+
+TEST_P(ScatteredReductionTest, EveryProcessGetsItsRange) {
+    int rank = 0;
+    int numberOfProcesses = 0;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &numberOfProcesses);
+
+    // Uneven ranges, with a gap at the start and the last process owning
+    // nothing
+    std::vector<size_t> begins;
+    std::vector<size_t> counts;
+    size_t begin = 3;
+
+    for (int process = 0; process < numberOfProcesses; ++process) {
+        const size_t count = (process + 1 == numberOfProcesses
+                && numberOfProcesses > 1) ? 0 : size_t(2 + process);
+        begins.push_back(begin);
+        counts.push_back(count);
+        begin += count;
+    }
+
+    const size_t bufferSize = begin;
+    const size_t numberOfBuffers = 5;
+    ScatteredReduction<double> reduction(MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD,
+        begins, counts, GetParam());
+
+    std::vector<std::vector<double> > buffers(numberOfBuffers,
+        std::vector<double>(bufferSize));
+    std::vector<std::vector<double> > reduced(numberOfBuffers,
+        std::vector<double>(counts[rank], 0));
+    std::vector<std::vector<int> > timesUnpacked(numberOfBuffers,
+        std::vector<int>(counts[rank], 0));
+
+    for (size_t buffer = 0; buffer < numberOfBuffers; ++buffer) {
+        for (size_t i = 0; i < bufferSize; ++i) {
+            buffers[buffer][i] = rank * 1000 + buffer * 100 + i;
+        }
+
+        const double* data = buffers[buffer].data();
+        double* reducedBuffer = reduced[buffer].data();
+        int* unpacked = timesUnpacked[buffer].data();
+        const size_t rangeBegin = begins[rank];
+        reduction.addBuffer([data](size_t begin, size_t count, double * out) {
+            std::copy(data + begin, data + begin + count, out);
+        }, [reducedBuffer, unpacked, rangeBegin](size_t begin, size_t count,
+        const double * in) {
+            for (size_t i = 0; i < count; ++i) {
+                reducedBuffer[begin - rangeBegin + i] = in[i];
+                unpacked[begin - rangeBegin + i]++;
+            }
+        });
+
+        // Reduce in groups of different sizes
+        if (buffer == 0 || buffer == 3) {
+            reduction.reduceBuffers();
+        }
+    }
+
+    reduction.finish();
+
+    const double rankSum = 1000.0 * numberOfProcesses * (numberOfProcesses - 1) / 2;
+
+    for (size_t buffer = 0; buffer < numberOfBuffers; ++buffer) {
+        for (size_t i = 0; i < counts[rank]; ++i) {
+            ASSERT_EQ(1, timesUnpacked[buffer][i]);
+            ASSERT_EQ(rankSum + numberOfProcesses * double(buffer * 100 + begins[rank] + i),
+                reduced[buffer][i]);
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(ChunkSizes, ScatteredReductionTest,
+    ::testing::Values(size_t(1), size_t(7), size_t(64),
+        ScatteredReduction<double>::defaultChunkSize));